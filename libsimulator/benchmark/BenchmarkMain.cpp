@@ -1,5 +1,9 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
+#include "benchmarkBatchRunner.hpp"
 #include "benchmarkCollisionGeometry.hpp"
+#include "benchmarkGeometryBundle.hpp"
+#include "benchmarkPairInteractions.hpp"
+#include "benchmarkScenarios.hpp"
 
 #include <benchmark/benchmark.h>
 
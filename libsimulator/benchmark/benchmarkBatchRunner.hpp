@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "BatchRunner.hpp"
+#include "Simulation.hpp"
+#include "benchmarkScenarios.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Runs a batch of street network simulations that share one GeometryBundle on state.range(0)
+/// threads. Every thread routes its agents through the shared routing engine, so the iterations
+/// per second only grow with the threads as long as the engine is not a point of contention.
+inline void bmRunBatch(benchmark::State& state)
+{
+    constexpr size_t simulations = 16;
+    constexpr size_t agents = 1000;
+    constexpr uint64_t maxIterations = 50;
+    const auto threads = static_cast<size_t>(state.range(0));
+    const auto description = scenario::buildLayout(scenario::Layout::StreetNetwork, agents);
+    const auto bundle = scenario::buildBundle(description);
+
+    uint64_t iterations = 0;
+    for(auto _ : state) {
+        state.PauseTiming();
+        std::vector<std::unique_ptr<Simulation>> batch{};
+        std::vector<Simulation*> pointers{};
+        for(size_t index = 0; index < simulations; ++index) {
+            batch.push_back(
+                scenario::makeSimulation(scenario::Model::CFSM, description, bundle, agents));
+            if(!batch.back()) {
+                state.SkipWithError("The geometry has too little room for the agents");
+                return;
+            }
+            pointers.push_back(batch.back().get());
+        }
+        state.ResumeTiming();
+
+        for(const auto& result : RunBatch(pointers, maxIterations, threads)) {
+            iterations += result.iterations;
+        }
+    }
+
+    const auto total = static_cast<double>(iterations);
+    state.counters["iterations/s"] = benchmark::Counter(total, benchmark::Counter::kIsRate);
+    // Few agents reach the exit within 'maxIterations', the count is close to exact.
+    state.counters["agent_steps/s"] =
+        benchmark::Counter(total * static_cast<double>(agents), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(bmRunBatch)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CollisionGeometry.hpp"
+#include "GeometryBundle.hpp"
+#include "buildGeometries.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+/// Builds the grids and the navigation mesh of the geometry, as every new simulation does.
+inline void bmGeometryBundleBuild(benchmark::State& state, CollisionGeometry geometry)
+{
+    for(auto _ : state) {
+        GeometryBundle bundle{std::make_shared<const CollisionGeometry>(geometry.Polygon())};
+        benchmark::DoNotOptimize(bundle);
+    }
+}
+
+/// Restores the same bundle from its encoded form instead.
+inline void bmGeometryBundleDeserialize(benchmark::State& state, CollisionGeometry geometry)
+{
+    const auto data =
+        GeometryBundle{std::make_shared<const CollisionGeometry>(std::move(geometry))}.Serialize();
+    for(auto _ : state) {
+        auto bundle = GeometryBundle::Deserialize(data);
+        benchmark::DoNotOptimize(bundle);
+    }
+    state.counters["bytes"] = static_cast<double>(data.size());
+}
+
+BENCHMARK_CAPTURE(bmGeometryBundleBuild, large_street_network, buildLargeStreetNetwork())
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bmGeometryBundleBuild, grosser_stern, buildGrosserStern())
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bmGeometryBundleDeserialize, large_street_network, buildLargeStreetNetwork())
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bmGeometryBundleDeserialize, grosser_stern, buildGrosserStern())
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CollisionFreeSpeedModel.hpp"
+#include "CollisionGeometry.hpp"
+#include "GenericAgent.hpp"
+#include "GeometryBuilder.hpp"
+#include "Journey.hpp"
+#include "OperationalModel.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+#include "Simulation.hpp"
+#include "SocialForceModel.hpp"
+#include "StageDescription.hpp"
+#include "benchmarkScenarios.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Benchmarks of the pair phase, see OperationalModel::PairInteractionRadius, in a crowd dense
+// enough that every agent has dozens of others within the cut-off radius. Both models run once
+// with the pair phase and once with a neighbor query per agent for comparison. Only the time of
+// the operational decision system is reported, the other phases do not depend on the mode.
+
+namespace pairs
+{
+// Closer than the scenario benchmarks place agents, still clear of every model's constraints.
+constexpr double agentSpacing = 0.7;
+
+inline std::unique_ptr<OperationalModel> makeModel(scenario::Model model, bool pairwise)
+{
+    if(model == scenario::Model::SFM) {
+        return std::make_unique<SocialForceModel>(120000.0, 240000.0, pairwise);
+    }
+    return std::make_unique<CollisionFreeSpeedModel>(8.0, 0.1, 5.0, 0.02, pairwise);
+}
+
+/// Square room packed with 'agents' agents on a grid, all heading to an exit in one corner.
+inline std::unique_ptr<Simulation>
+makeSimulation(scenario::Model model, bool pairwise, size_t agents)
+{
+    const auto perRow = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(agents))));
+    const double side = static_cast<double>(perRow) * agentSpacing + 4.0;
+    const scenario::Box exit{{side - 2.0, side - 2.0}, {side - 0.5, side - 0.5}};
+
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea(scenario::Box{{0.0, 0.0}, {side, side}}.Points());
+    auto simulation = std::make_unique<Simulation>(
+        makeModel(model, pairwise), std::make_unique<CollisionGeometry>(builder.Build()), 0.01);
+    simulation->SetTimerLogLevel(2);
+    const auto stageId = simulation->AddStage(ExitDescription{Polygon{exit.Points()}});
+    const auto journeyId = simulation->AddJourney({{stageId, NonTransitionDescription{}}});
+
+    std::vector<GenericAgent> newAgents{};
+    newAgents.reserve(agents);
+    for(size_t index = 0; index < agents; ++index) {
+        const Point position{
+            1.0 + static_cast<double>(index % perRow) * agentSpacing,
+            1.0 + static_cast<double>(index / perRow) * agentSpacing};
+        newAgents.emplace_back(
+            GenericAgent::ID{}, journeyId, stageId, position, scenario::makeState(model));
+    }
+    simulation->AddAgents(std::move(newAgents));
+    return simulation;
+}
+} // namespace pairs
+
+inline void bmDenseCrowd(benchmark::State& state, scenario::Model model, bool pairwise)
+{
+    const auto agents = static_cast<size_t>(state.range(0));
+    const auto simulation = pairs::makeSimulation(model, pairwise, agents);
+    const std::string phase = "Operational Decision System";
+    const auto before = simulation->GetTimerDurations();
+
+    uint64_t agentSteps = 0;
+    for(auto _ : state) {
+        agentSteps += simulation->AgentCount();
+        simulation->Iterate();
+    }
+
+    const auto durations = simulation->GetTimerDurations();
+    const auto elapsed = durations.contains(phase) ? durations.at(phase) : 0;
+    const auto seconds =
+        static_cast<double>(elapsed - (before.contains(phase) ? before.at(phase) : 0)) / 1e6;
+    if(seconds > 0.0) {
+        state.counters[phase + " agent_steps/s"] = static_cast<double>(agentSteps) / seconds;
+    }
+}
+
+BENCHMARK_CAPTURE(bmDenseCrowd, SFM_pairwise, scenario::Model::SFM, true)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bmDenseCrowd, SFM_per_agent, scenario::Model::SFM, false)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bmDenseCrowd, CFSM_pairwise, scenario::Model::CFSM, true)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(bmDenseCrowd, CFSM_per_agent, scenario::Model::CFSM, false)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
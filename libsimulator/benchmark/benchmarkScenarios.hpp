@@ -0,0 +1,432 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AnticipationVelocityModel.hpp"
+#include "CollisionFreeSpeedModel.hpp"
+#include "CollisionFreeSpeedModelV2.hpp"
+#include "CollisionFreeSpeedModelV3.hpp"
+#include "CollisionGeometry.hpp"
+#include "GeneralizedCentrifugalForceModel.hpp"
+#include "GenericAgent.hpp"
+#include "GeometryBuilder.hpp"
+#include "GeometryBundle.hpp"
+#include "Journey.hpp"
+#include "OperationalModel.hpp"
+#include "OperationalModelState.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+#include "Simulation.hpp"
+#include "SocialForceModel.hpp"
+#include "StageDescription.hpp"
+#include "WarpDriverModel.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// End-to-end benchmarks that build a Simulation for every operational model in several
+// geometries and iterate it. Each benchmark iteration is one call to Simulation::Iterate, setting
+// up the simulation is not measured. Next to the time per iteration they report iterations and
+// agent steps per second, in total and for the time spent in each phase of the iteration.
+// Run with --benchmark_format=json or --benchmark_out=<file> to track the results over time.
+
+namespace scenario
+{
+enum class Model { CFSM, CFSMV2, CFSMV3, AVM, SFM, GCFM, WarpDriver };
+
+enum class Layout { Corridor, Bottleneck, OpenPlaza, StreetNetwork };
+
+// Agents are placed on a grid with this spacing and at least half of it away from walls, which
+// keeps every model's constraints satisfied.
+constexpr double agentSpacing = 1.0;
+// Share of the walkable area that is left free when sizing a geometry for a number of agents.
+constexpr double spareArea = 1.3;
+
+struct Box {
+    Point min;
+    Point max;
+
+    std::vector<Point> Points() const
+    {
+        return {min, {max.x, min.y}, max, {min.x, max.y}};
+    }
+};
+
+struct LayoutDescription {
+    std::vector<Point> accessibleArea;
+    std::vector<std::vector<Point>> exclusions;
+    std::vector<Box> exits;
+    // Agents are placed inside this box only.
+    Box placement;
+};
+
+inline LayoutDescription corridor(size_t agents)
+{
+    constexpr double width = 10.0;
+    const double length = std::ceil(static_cast<double>(agents) * spareArea / (width - 1.0)) + 10.0;
+    return {
+        Box{{0.0, 0.0}, {length, width}}.Points(),
+        {},
+        {Box{{length - 2.0, 0.5}, {length - 0.5, width - 0.5}}},
+        Box{{0.0, 0.0}, {length - 4.0, width}}};
+}
+
+inline LayoutDescription bottleneck(size_t agents)
+{
+    const double side = std::ceil(std::sqrt(static_cast<double>(agents) * spareArea)) + 2.0;
+    const double door = 1.2;
+    const double lower = side / 2.0 - door / 2.0;
+    const double upper = side / 2.0 + door / 2.0;
+    return {
+        {{0.0, 0.0},
+         {side, 0.0},
+         {side, lower},
+         {side + 10.0, lower},
+         {side + 10.0, upper},
+         {side, upper},
+         {side, side},
+         {0.0, side}},
+        {},
+        {Box{{side + 8.0, lower + 0.1}, {side + 9.5, upper - 0.1}}},
+        Box{{0.0, 0.0}, {side, side}}};
+}
+
+inline LayoutDescription openPlaza(size_t agents)
+{
+    const double side = std::ceil(std::sqrt(static_cast<double>(agents) * spareArea)) + 10.0;
+    const double mid = side / 2.0;
+    return {
+        Box{{0.0, 0.0}, {side, side}}.Points(),
+        {},
+        {Box{{0.5, mid - 2.0}, {2.0, mid + 2.0}},
+         Box{{side - 2.0, mid - 2.0}, {side - 0.5, mid + 2.0}},
+         Box{{mid - 2.0, 0.5}, {mid + 2.0, 2.0}},
+         Box{{mid - 2.0, side - 2.0}, {mid + 2.0, side - 0.5}}},
+        Box{{4.0, 4.0}, {side - 4.0, side - 4.0}}};
+}
+
+inline LayoutDescription streetNetwork(size_t agents)
+{
+    constexpr double street = 6.0;
+    constexpr double block = 24.0;
+    constexpr double period = street + block;
+    constexpr double streetShare = 1.0 - (block * block) / (period * period);
+    const auto blocks = static_cast<size_t>(std::ceil(
+        std::sqrt(static_cast<double>(agents) * spareArea / streetShare) / period));
+    const double side = static_cast<double>(blocks) * period + street;
+    LayoutDescription layout{
+        Box{{0.0, 0.0}, {side, side}}.Points(),
+        {},
+        {Box{{side - street + 0.5, side - street + 0.5}, {side - 0.5, side - 0.5}}},
+        Box{{0.0, 0.0}, {side, side}}};
+    for(size_t x = 0; x < blocks; ++x) {
+        for(size_t y = 0; y < blocks; ++y) {
+            const Point min{
+                street + static_cast<double>(x) * period, street + static_cast<double>(y) * period};
+            layout.exclusions.push_back(Box{min, min + Point{block, block}}.Points());
+        }
+    }
+    return layout;
+}
+
+inline LayoutDescription buildLayout(Layout layout, size_t agents)
+{
+    switch(layout) {
+        case Layout::Corridor:
+            return corridor(agents);
+        case Layout::Bottleneck:
+            return bottleneck(agents);
+        case Layout::OpenPlaza:
+            return openPlaza(agents);
+        case Layout::StreetNetwork:
+            return streetNetwork(agents);
+    }
+    return {};
+}
+
+inline std::unique_ptr<OperationalModel> makeModel(Model model)
+{
+    switch(model) {
+        case Model::CFSM:
+            return std::make_unique<CollisionFreeSpeedModel>(8.0, 0.1, 5.0, 0.02);
+        case Model::CFSMV2:
+            return std::make_unique<CollisionFreeSpeedModelV2>();
+        case Model::CFSMV3:
+            return std::make_unique<CollisionFreeSpeedModelV3>();
+        case Model::AVM:
+            return std::make_unique<AnticipationVelocityModel>(0.3, 42);
+        case Model::SFM:
+            return std::make_unique<SocialForceModel>(120000.0, 240000.0);
+        case Model::GCFM:
+            return std::make_unique<GeneralizedCentrifugalForceModel>(
+                0.3, 0.2, 2.0, 2.0, 0.1, 0.1, 9.0, 3.0);
+        case Model::WarpDriver:
+            return std::make_unique<WarpDriverModel>(0.3);
+    }
+    return {};
+}
+
+inline OperationalModelState makeState(Model model)
+{
+    switch(model) {
+        case Model::CFSM:
+            return CollisionFreeSpeedModelState{};
+        case Model::CFSMV2:
+            return CollisionFreeSpeedModelV2State{};
+        case Model::CFSMV3:
+            return CollisionFreeSpeedModelV3State{};
+        case Model::AVM:
+            return AnticipationVelocityModelState{};
+        case Model::SFM:
+            return SocialForceModelState{};
+        case Model::GCFM:
+            return GeneralizedCentrifugalForceModelState{};
+        case Model::WarpDriver:
+            return WarpDriverModelState{};
+    }
+    return {};
+}
+
+// Grid positions inside 'layout.placement' that are walkable, clear of walls and not on an exit.
+inline std::vector<Point>
+placeAgents(const LayoutDescription& layout, const CollisionGeometry& geometry, size_t count)
+{
+    std::vector<Polygon> exits{};
+    for(const auto& exit : layout.exits) {
+        exits.emplace_back(exit.Points());
+    }
+    std::vector<Point> positions{};
+    positions.reserve(count);
+    // Offset from whole meters so that no position is exactly half a spacing away from a wall.
+    constexpr double offset = agentSpacing * 0.75;
+    const auto& [min, max] = layout.placement;
+    for(double x = min.x + offset; x < max.x && positions.size() < count; x += agentSpacing) {
+        for(double y = min.y + offset; y < max.y && positions.size() < count; y += agentSpacing) {
+            const Point position{x, y};
+            if(!geometry.InsideGeometry(position)) {
+                continue;
+            }
+            const auto walls = geometry.LineSegmentsInDistanceTo(agentSpacing / 2.0, position);
+            if(walls.begin() != walls.end()) {
+                continue;
+            }
+            bool onExit = false;
+            for(const auto& exit : exits) {
+                onExit = onExit || exit.IsInside(position);
+            }
+            if(!onExit) {
+                positions.push_back(position);
+            }
+        }
+    }
+    return positions;
+}
+
+// Phases of Simulation::Iterate reported per benchmark.
+inline const std::vector<std::string> phases{
+    "Agent Removal System",
+    "Neighborhood Search",
+    "Stage System",
+    "Strategical Decision System",
+    "Tactical Decision System",
+    "Operational Decision System"};
+
+inline GeometryBundle buildBundle(const LayoutDescription& description)
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea(description.accessibleArea);
+    for(const auto& exclusion : description.exclusions) {
+        builder.ExcludeFromAccessibleArea(exclusion);
+    }
+    return GeometryBundle{std::make_shared<const CollisionGeometry>(builder.Build())};
+}
+
+/// Simulation of 'agents' agents in 'description', each heading to its nearest exit. 'bundle' has
+/// to be built from 'description'. Returns nullptr if the layout has too little room for the
+/// agents.
+inline std::unique_ptr<Simulation> makeSimulation(
+    Model model,
+    const LayoutDescription& description,
+    const GeometryBundle& bundle,
+    size_t agents)
+{
+    const auto positions = placeAgents(description, bundle.Geometry(), agents);
+    if(positions.size() < agents) {
+        return nullptr;
+    }
+
+    auto simulation = std::make_unique<Simulation>(makeModel(model), bundle, 0.01);
+    simulation->SetTimerLogLevel(2);
+    std::vector<std::pair<Journey::ID, BaseStage::ID>> targets{};
+    std::vector<Point> exitCenters{};
+    for(const auto& exit : description.exits) {
+        const auto stageId = simulation->AddStage(ExitDescription{Polygon{exit.Points()}});
+        const auto journeyId = simulation->AddJourney({{stageId, NonTransitionDescription{}}});
+        targets.emplace_back(journeyId, stageId);
+        exitCenters.push_back((exit.min + exit.max) * 0.5);
+    }
+    std::vector<GenericAgent> newAgents{};
+    newAgents.reserve(agents);
+    for(const auto& position : positions) {
+        size_t nearest = 0;
+        for(size_t index = 1; index < exitCenters.size(); ++index) {
+            if((exitCenters[index] - position).Norm() < (exitCenters[nearest] - position).Norm()) {
+                nearest = index;
+            }
+        }
+        newAgents.emplace_back(
+            GenericAgent::ID{},
+            targets[nearest].first,
+            targets[nearest].second,
+            position,
+            makeState(model));
+    }
+    simulation->AddAgents(std::move(newAgents));
+    return simulation;
+}
+
+/// Simulation of 'agents' agents in 'layout' with a geometry of its own.
+inline std::unique_ptr<Simulation> makeSimulation(Model model, Layout layout, size_t agents)
+{
+    const auto description = buildLayout(layout, agents);
+    return makeSimulation(model, description, buildBundle(description), agents);
+}
+} // namespace scenario
+
+inline void bmScenario(benchmark::State& state, scenario::Model model, scenario::Layout layout)
+{
+    const auto agents = static_cast<size_t>(state.range(0));
+    const auto simulationPtr = scenario::makeSimulation(model, layout, agents);
+    if(!simulationPtr) {
+        state.SkipWithError("The geometry has too little room for the agents");
+        return;
+    }
+    auto& simulation = *simulationPtr;
+    const auto durationsBefore = simulation.GetTimerDurations();
+
+    uint64_t agentSteps = 0;
+    for(auto _ : state) {
+        agentSteps += simulation.AgentCount();
+        simulation.Iterate();
+    }
+
+    const auto iterations = static_cast<double>(state.iterations());
+    const auto steps = static_cast<double>(agentSteps);
+    state.counters["iterations/s"] = benchmark::Counter(iterations, benchmark::Counter::kIsRate);
+    state.counters["agent_steps/s"] = benchmark::Counter(steps, benchmark::Counter::kIsRate);
+    const auto durations = simulation.GetTimerDurations();
+    for(const auto& phase : scenario::phases) {
+        const auto iter = durations.find(phase);
+        if(iter == durations.end()) {
+            continue;
+        }
+        const auto before = durationsBefore.contains(phase) ? durationsBefore.at(phase) : 0;
+        const auto seconds = static_cast<double>(iter->second - before) / 1e6;
+        if(seconds > 0.0) {
+            state.counters[phase + " iterations/s"] = iterations / seconds;
+            state.counters[phase + " agent_steps/s"] = steps / seconds;
+        }
+    }
+}
+
+/// Memory mode of bmScenario: tracks the peak of Simulation::MemoryReport over the iterations
+/// instead of the time, reported in total and per agent the simulation started with. The total
+/// leaves out the geometry and the profiler, see MemoryBreakdown::sharedBytes.
+inline void
+bmScenarioMemory(benchmark::State& state, scenario::Model model, scenario::Layout layout)
+{
+    const auto agents = static_cast<size_t>(state.range(0));
+    const auto simulation = scenario::makeSimulation(model, layout, agents);
+    if(!simulation) {
+        state.SkipWithError("The geometry has too little room for the agents");
+        return;
+    }
+
+    auto peak = simulation->MemoryReport();
+    for(auto _ : state) {
+        simulation->Iterate();
+        auto report = simulation->MemoryReport();
+        if(report.Total() > peak.Total()) {
+            peak = std::move(report);
+        }
+    }
+
+    const auto total = static_cast<double>(peak.Total());
+    state.counters["peak_bytes"] = total;
+    state.counters["peak_bytes/agent"] = total / static_cast<double>(agents);
+    // The scenario runs a single simulation, so the shared parts belong to it alone.
+    for(const auto* parts : {&peak.bytes, &peak.sharedBytes}) {
+        for(const auto& [part, bytes] : *parts) {
+            state.counters[part + " bytes/agent"] =
+                static_cast<double>(bytes) / static_cast<double>(agents);
+        }
+    }
+}
+
+// Runs with 100k agents and the memory mode take minutes per scenario. They are only registered
+// in builds configured with BUILD_LARGE_BENCHMARKS.
+inline void scenarioSizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->Arg(1000)->Arg(10000);
+#ifdef JPS_LARGE_BENCHMARKS
+    benchmark->Arg(100000);
+#endif
+    benchmark->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+// Memory does not depend on the timing, a fixed number of iterations lets agents spread out.
+inline void scenarioMemorySizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->Arg(1000)->Arg(10000)->Arg(100000)->Iterations(200)->Unit(benchmark::kMillisecond);
+}
+
+#ifdef JPS_LARGE_BENCHMARKS
+#define JPS_SCENARIO_BENCHMARK(model, layout)                                                      \
+    BENCHMARK_CAPTURE(                                                                             \
+        bmScenario, model##_##layout, scenario::Model::model, scenario::Layout::layout)            \
+        ->Apply(scenarioSizes);                                                                    \
+    BENCHMARK_CAPTURE(                                                                             \
+        bmScenarioMemory, model##_##layout, scenario::Model::model, scenario::Layout::layout)      \
+        ->Apply(scenarioMemorySizes)
+#else
+#define JPS_SCENARIO_BENCHMARK(model, layout)                                                      \
+    BENCHMARK_CAPTURE(                                                                             \
+        bmScenario, model##_##layout, scenario::Model::model, scenario::Layout::layout)            \
+        ->Apply(scenarioSizes)
+#endif
+
+JPS_SCENARIO_BENCHMARK(CFSM, Corridor);
+JPS_SCENARIO_BENCHMARK(CFSM, Bottleneck);
+JPS_SCENARIO_BENCHMARK(CFSM, OpenPlaza);
+JPS_SCENARIO_BENCHMARK(CFSM, StreetNetwork);
+JPS_SCENARIO_BENCHMARK(CFSMV2, Corridor);
+JPS_SCENARIO_BENCHMARK(CFSMV2, Bottleneck);
+JPS_SCENARIO_BENCHMARK(CFSMV2, OpenPlaza);
+JPS_SCENARIO_BENCHMARK(CFSMV2, StreetNetwork);
+JPS_SCENARIO_BENCHMARK(CFSMV3, Corridor);
+JPS_SCENARIO_BENCHMARK(CFSMV3, Bottleneck);
+JPS_SCENARIO_BENCHMARK(CFSMV3, OpenPlaza);
+JPS_SCENARIO_BENCHMARK(CFSMV3, StreetNetwork);
+JPS_SCENARIO_BENCHMARK(AVM, Corridor);
+JPS_SCENARIO_BENCHMARK(AVM, Bottleneck);
+JPS_SCENARIO_BENCHMARK(AVM, OpenPlaza);
+JPS_SCENARIO_BENCHMARK(AVM, StreetNetwork);
+JPS_SCENARIO_BENCHMARK(SFM, Corridor);
+JPS_SCENARIO_BENCHMARK(SFM, Bottleneck);
+JPS_SCENARIO_BENCHMARK(SFM, OpenPlaza);
+JPS_SCENARIO_BENCHMARK(SFM, StreetNetwork);
+JPS_SCENARIO_BENCHMARK(GCFM, Corridor);
+JPS_SCENARIO_BENCHMARK(GCFM, Bottleneck);
+JPS_SCENARIO_BENCHMARK(GCFM, OpenPlaza);
+JPS_SCENARIO_BENCHMARK(GCFM, StreetNetwork);
+JPS_SCENARIO_BENCHMARK(WarpDriver, Corridor);
+JPS_SCENARIO_BENCHMARK(WarpDriver, Bottleneck);
+JPS_SCENARIO_BENCHMARK(WarpDriver, OpenPlaza);
+JPS_SCENARIO_BENCHMARK(WarpDriver, StreetNetwork);
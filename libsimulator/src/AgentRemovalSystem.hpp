@@ -2,6 +2,7 @@
 #pragma once
 
 #include "GenericAgent.hpp"
+#include "OperationalModel.hpp"
 #include "StageManager.hpp"
 
 #include <algorithm>
@@ -22,25 +23,28 @@ public:
     void
     Run(AgentContainer<Agent>& agents,
         std::vector<GenericAgent::ID>& removedAgentIds,
-        StageManager& stageManager) const;
+        StageManager& stageManager,
+        OperationalModel& model) const;
 };
 
 template <typename Agent>
 void AgentRemovalSystem<Agent>::Run(
     AgentContainer<Agent>& agents,
     std::vector<GenericAgent::ID>& removedAgentIds,
-    StageManager& stageManager) const
+    StageManager& stageManager,
+    OperationalModel& model) const
 {
 
     auto iter = std::remove_if(
         std::begin(agents),
         std::end(agents),
-        [&removedAgentIds, &stageManager](const GenericAgent& agent) {
+        [&removedAgentIds, &stageManager, &model](const GenericAgent& agent) {
             auto found =
                 std::find(std::begin(removedAgentIds), std::end(removedAgentIds), agent.id) !=
                 std::end(removedAgentIds);
             if(found) {
                 stageManager.HandleRemoveAgent(agent.stageId);
+                model.ReleaseState(agent.state);
             }
             return found;
         });
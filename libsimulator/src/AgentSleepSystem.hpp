@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "GenericAgent.hpp"
+#include "NeighborhoodSearch.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Settings of idle agent culling.
+///
+/// Agents that kept their target and stayed within 'idleRadius' of one spot for 'stepsToSleep'
+/// consecutive steps are put to sleep: the tactical and operational systems skip them and they
+/// stay where they are. A spot rather than a speed is used because agents waiting at their
+/// target tend to jitter around it. A sleeping agent wakes as soon as its target changes, e.g.
+/// because its stage released it, or a moving agent comes within 'wakeRadius'.
+struct AgentSleep {
+    /// Distance in m an agent may move and still count as idle, 0 disables culling.
+    double idleRadius{0.0};
+    /// Consecutive idle steps after which an agent is put to sleep.
+    uint32_t stepsToSleep{50};
+    /// Radius around a sleeping agent in which a moving agent wakes it.
+    double wakeRadius{1.0};
+
+    bool Enabled() const { return idleRadius > 0.0; }
+};
+
+class AgentSleepSystem
+{
+    AgentSleep _settings{};
+    size_t _sleeping{0};
+    uint64_t _skippedSteps{0};
+    std::vector<GenericAgent*> _woken{};
+
+public:
+    AgentSleepSystem() = default;
+    ~AgentSleepSystem() = default;
+    AgentSleepSystem(const AgentSleepSystem& other) = delete;
+    AgentSleepSystem& operator=(const AgentSleepSystem& other) = delete;
+    AgentSleepSystem(AgentSleepSystem&& other) = delete;
+    AgentSleepSystem& operator=(AgentSleepSystem&& other) = delete;
+
+    void SetSettings(const AgentSleep& settings)
+    {
+        if(settings.idleRadius < 0.0) {
+            throw SimulationError("Idle radius needs to be >= 0, got {}", settings.idleRadius);
+        }
+        if(settings.stepsToSleep == 0) {
+            throw SimulationError("Steps to sleep needs to be > 0");
+        }
+        if(settings.wakeRadius <= 0.0) {
+            throw SimulationError("Wake radius needs to be > 0, got {}", settings.wakeRadius);
+        }
+        _settings = settings;
+    }
+
+    const AgentSleep& Settings() const { return _settings; }
+
+    /// Number of agents asleep after the last call to Update.
+    size_t Sleeping() const { return _sleeping; }
+
+    /// Agent steps skipped in total because the agents were asleep.
+    uint64_t SkippedSteps() const { return _skippedSteps; }
+
+    /// Wakes sleeping agents whose target changed or that have a moving agent within the wake
+    /// radius, all of them if culling got disabled. Needs to run after the strategic and before
+    /// the tactical system, with 'neighborhoodSearch' reflecting the current positions.
+    void Wake(const NeighborhoodSearch<GenericAgent>& neighborhoodSearch, auto&& agents)
+    {
+        if(_sleeping == 0) {
+            return;
+        }
+        // Collect first, an agent woken here does not count as moving before it stepped.
+        _woken.clear();
+        for(auto& agent : agents) {
+            if(!agent.idle.sleeping) {
+                continue;
+            }
+            bool wake = !_settings.Enabled() || agent.finalTarget != agent.idle.target;
+            if(!wake) {
+                neighborhoodSearch.ForEachInRange(
+                    agent.Position(), _settings.wakeRadius, [&](const GenericAgent& other) {
+                        wake = wake || (!other.idle.sleeping && other.idle.steps == 0);
+                    });
+            }
+            if(wake) {
+                _woken.push_back(&agent);
+            }
+        }
+        for(auto* agent : _woken) {
+            agent->idle.sleeping = false;
+            agent->idle.steps = 0;
+        }
+        _sleeping -= _woken.size();
+    }
+
+    /// Counts the idle steps of all agents after the operational step and puts agents to sleep
+    /// that were idle for long enough. Without culling enabled nothing falls asleep.
+    void Update(auto&& agents)
+    {
+        const double idleRadiusSquared = _settings.idleRadius * _settings.idleRadius;
+        _sleeping = 0;
+        for(auto& agent : agents) {
+            auto& idle = agent.idle;
+            if(idle.sleeping) {
+                ++_sleeping;
+                ++_skippedSteps;
+                continue;
+            }
+            const bool isIdle = _settings.Enabled() && idle.target == agent.finalTarget &&
+                                DistanceSquared(agent.Position(), idle.position) <=
+                                    idleRadiusSquared;
+            if(isIdle) {
+                ++idle.steps;
+            } else {
+                idle.steps = 0;
+                idle.position = agent.Position();
+            }
+            idle.target = agent.finalTarget;
+            if(idle.steps >= _settings.stepsToSleep) {
+                idle.sleeping = true;
+                ++_sleeping;
+            }
+        }
+    }
+};
@@ -6,10 +6,15 @@
 #include "GeometricFunctions.hpp"
 #include "LineSegment.hpp"
 #include "Point.hpp"
+#include "RandomStream.hpp"
+#include "VerletList.hpp"
 
 #include <algorithm>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <ranges>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -48,6 +53,17 @@ public:
     {
     }
 
+    /// Serves neighbor queries up to the list's cutoff from the candidates of the agent at
+    /// 'index' in 'verletList' instead of the neighborhood search.
+    AgentView(
+        const EnvironmentQuery& world,
+        const GenericAgent& agent,
+        const VerletList* verletList,
+        size_t index)
+        : _world(world), _agent(agent), _verletList(verletList), _index(index)
+    {
+    }
+
     struct AcceptAllNeighbors {
         bool operator()(const NeighborView&) const { return true; }
     };
@@ -57,6 +73,14 @@ public:
     std::vector<NeighborView> OtherAgentsInRange(double radius, Pred filter = {}) const
     {
         std::vector<NeighborView> neighbors{};
+        if(ServedByVerletList(radius)) {
+            ForEachCandidateInRange(radius, [&](const NeighborView& neighbor, bool) {
+                if(filter(neighbor)) {
+                    neighbors.push_back(neighbor);
+                }
+            });
+            return neighbors;
+        }
         _world.ForEachAgentInRange(_agent.Position(), radius, [&](const GenericAgent& candidate) {
             if(candidate.id == _agent.id) {
                 return;
@@ -69,6 +93,26 @@ public:
         return neighbors;
     }
 
+    /// All agents within 'radius' this agent has line of sight to, excluding this agent. Same as
+    /// OtherAgentsInRange with a NoGeometryBetween filter on 'boundaries', but skips the test for
+    /// pairs the Verlet list already knows to have a clear sight.
+    template <typename Range>
+    std::vector<NeighborView> OtherAgentsInSight(double radius, const Range& boundaries) const
+    {
+        if(!ServedByVerletList(radius)) {
+            return OtherAgentsInRange(radius, [this, &boundaries](const NeighborView& neighbor) {
+                return NoGeometryBetween(neighbor.RelativePosition, boundaries);
+            });
+        }
+        std::vector<NeighborView> neighbors{};
+        ForEachCandidateInRange(radius, [&](const NeighborView& neighbor, bool clearSight) {
+            if(clearSight || NoGeometryBetween(neighbor.RelativePosition, boundaries)) {
+                neighbors.push_back(neighbor);
+            }
+        });
+        return neighbors;
+    }
+
     /// Whether the straight line to a point at 'RelativePosition' is free of geometry.
     /// 'boundaries' must be in the same relative coordinate frame (agent at origin),
     /// i.e. come from WallsNearby() or WallsInRange().
@@ -85,6 +129,26 @@ public:
     }
 
 private:
+    bool ServedByVerletList(double radius) const
+    {
+        return _verletList != nullptr && radius <= _verletList->Cutoff();
+    }
+
+    /// Calls 'fn' with the view of and the clear sight flag for every Verlet list candidate
+    /// within 'radius'. Uses the same distance test as NeighborhoodSearch::ForEachInRange.
+    template <typename Fn>
+    void ForEachCandidateInRange(double radius, Fn&& fn) const
+    {
+        const auto origin = _agent.Position();
+        const auto radiusSquared = radius * radius;
+        for(const auto& candidate : _verletList->CandidatesOf(_index)) {
+            const auto& other = _verletList->Agent(candidate.index);
+            if(DistanceSquared(other.Position(), origin) <= radiusSquared) {
+                fn(NeighborView{other.Position() - origin, &other.state}, candidate.clearSight);
+            }
+        }
+    }
+
     /// The segments as seen from the agent. Lazy range, no copies.
     /// Must stay above WallsNearby() and WallsInRange() in code: an 'auto' return type is
     /// deduced from the body, so unlike other members this one cannot be called before it is
@@ -120,14 +184,28 @@ public:
 protected:
     const EnvironmentQuery& _world;
     const GenericAgent& _agent;
+    const VerletList* _verletList{nullptr};
+    size_t _index{0};
 };
 
-/// An AgentView plus what only holds for one step (dT + next target).
+/// An AgentView plus what only holds for one step (dT + next target + random numbers).
 class AgentStep : public AgentView
 {
 public:
-    AgentStep(const EnvironmentQuery& world, const GenericAgent& agent, double dt)
-        : AgentView(world, agent), _dt(dt)
+    AgentStep(
+        const EnvironmentQuery& world,
+        const GenericAgent& agent,
+        double dt,
+        uint64_t iteration,
+        Point pairInteraction = {},
+        std::span<const NeighborView> pairNeighbors = {},
+        const VerletList* verletList = nullptr,
+        size_t index = 0)
+        : AgentView(world, agent, verletList, index)
+        , _dt(dt)
+        , _iteration(iteration)
+        , _pairInteraction(pairInteraction)
+        , _pairNeighbors(pairNeighbors)
     {
     }
 
@@ -135,8 +213,68 @@ public:
 
     Point ToNextTarget() const { return _agent.nextTarget - _agent.Position(); }
 
+    /// Random numbers for this agent in this step. Every call returns a new stream starting at
+    /// the same position, a model takes one stream per step and draws everything from it.
+    RandomStream Random(uint64_t seed) const
+    {
+        return RandomStream{seed, _agent.id.getID(), _iteration};
+    }
+
+    /// Sum of OperationalModel::ComputePairInteraction over all pairs of this agent. Zero for
+    /// models without a pair phase.
+    Point PairInteraction() const { return _pairInteraction; }
+
+    /// The agents this agent has a pair with, what OtherAgentsInSight would return for the pair
+    /// radius, in no particular order. Empty for models without a pair phase.
+    std::span<const NeighborView> PairNeighbors() const { return _pairNeighbors; }
+
 private:
     double _dt;
+    uint64_t _iteration;
+    Point _pairInteraction;
+    std::span<const NeighborView> _pairNeighbors;
+};
+
+/// All agents of one operational step, for models that advance them in a single call. Unlike
+/// AgentStep this exposes absolute positions, batch models work on whole arrays of agents and
+/// express relations between them themselves.
+class AgentBatch
+{
+public:
+    AgentBatch(
+        const EnvironmentQuery& world,
+        const AgentContainer<GenericAgent>& agents,
+        std::span<const uint8_t> stepping,
+        double dt,
+        uint64_t iteration)
+        : _world(world), _agents(agents), _stepping(stepping), _dt(dt), _iteration(iteration)
+    {
+    }
+
+    const EnvironmentQuery& World() const { return _world; }
+
+    const AgentContainer<GenericAgent>& Agents() const { return _agents; }
+
+    size_t Size() const { return _agents.size(); }
+
+    /// Whether the agent at 'index' steps in this batch. Agents that do not step, e.g. sleeping
+    /// ones, are still part of the batch as neighbors of the others.
+    bool Steps(size_t index) const { return _stepping.empty() || _stepping[index] != 0; }
+
+    double dt() const { return _dt; }
+
+    /// The per agent view of the agent at 'index'.
+    AgentStep Step(size_t index) const
+    {
+        return AgentStep{_world, _agents[index], _dt, _iteration, {}, {}, nullptr, index};
+    }
+
+private:
+    const EnvironmentQuery& _world;
+    const AgentContainer<GenericAgent>& _agents;
+    std::span<const uint8_t> _stepping;
+    double _dt;
+    uint64_t _iteration;
 };
 
 // Both views are passed by reference and never deleted through a base pointer; keeping
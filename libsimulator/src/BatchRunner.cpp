@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "BatchRunner.hpp"
+
+#include "OperationalModelType.hpp"
+#include "Simulation.hpp"
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace
+{
+BatchRunResult runToCompletion(Simulation& simulation, uint64_t maxIterations)
+{
+    BatchRunResult result{};
+    try {
+        while(simulation.AgentCount() > 0 && result.iterations < maxIterations) {
+            simulation.Iterate();
+            ++result.iterations;
+        }
+        result.finished = simulation.AgentCount() == 0;
+    } catch(const std::exception& e) {
+        result.error = e.what();
+    }
+    return result;
+}
+} // namespace
+
+std::vector<BatchRunResult>
+RunBatch(std::span<Simulation* const> simulations, uint64_t maxIterations, size_t threads)
+{
+    for(size_t index = 0; index < simulations.size(); ++index) {
+        const auto* simulation = simulations[index];
+        if(simulation == nullptr) {
+            throw SimulationError("Simulation {} of the batch is missing", index);
+        }
+        if(simulation->ModelType() == OperationalModelType::CUSTOM_MODEL) {
+            throw SimulationError(
+                "Simulation {} of the batch uses a custom model, which cannot run in a batch",
+                index);
+        }
+    }
+    auto sorted = std::vector<Simulation*>(simulations.begin(), simulations.end());
+    std::sort(sorted.begin(), sorted.end());
+    if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        throw SimulationError("A simulation is contained more than once in the batch");
+    }
+
+    std::vector<BatchRunResult> results(simulations.size());
+    if(threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, simulations.size());
+
+    std::atomic<size_t> next{0};
+    const auto work = [&]() {
+        for(size_t index = next++; index < simulations.size(); index = next++) {
+            results[index] = runToCompletion(*simulations[index], maxIterations);
+        }
+    };
+    std::vector<std::thread> workers{};
+    workers.reserve(threads);
+    for(size_t worker = 0; worker < threads; ++worker) {
+        workers.emplace_back(work);
+    }
+    for(auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
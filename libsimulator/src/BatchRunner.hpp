@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+class Simulation;
+
+/// Outcome of running one simulation of a batch.
+struct BatchRunResult {
+    /// Iterations this simulation was advanced by.
+    uint64_t iterations{0};
+    /// True if all agents left the simulation before 'maxIterations' was reached.
+    bool finished{false};
+    /// Message of the error that stopped this simulation, empty if it ran without error.
+    std::string error{};
+};
+
+/// Runs independent simulations on 'threads' worker threads, 0 uses one thread per core. Every
+/// simulation is iterated until it has no agents left or it was advanced by 'maxIterations'. The
+/// simulations may share a GeometryBundle but nothing else, each one is only ever touched by one
+/// thread. Simulations with a custom model are rejected, their callbacks need the interpreter.
+/// An error in one simulation stops only that simulation, it is reported in its result.
+std::vector<BatchRunResult>
+RunBatch(std::span<Simulation* const> simulations, uint64_t maxIterations, size_t threads = 0);
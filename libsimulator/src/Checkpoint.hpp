@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "SimulationError.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Binary encoding helpers for simulation checkpoints and geometry bundles.
+///
+/// Both are a raw dump of trivially copyable values in host byte order. They are meant for
+/// warm starts and forks within one installation, not as an archival or exchange format.
+namespace checkpoint
+{
+constexpr char MAGIC[8] = {'J', 'P', 'S', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t FORMAT_VERSION = 2;
+
+class Writer
+{
+    std::vector<uint8_t> _buffer{};
+
+public:
+    template <typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto pos = _buffer.size();
+        _buffer.resize(pos + sizeof(T));
+        std::memcpy(_buffer.data() + pos, &value, sizeof(T));
+    }
+
+    template <typename T>
+    void WriteVector(const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write(static_cast<uint64_t>(values.size()));
+        const auto pos = _buffer.size();
+        _buffer.resize(pos + values.size() * sizeof(T));
+        if(!values.empty()) {
+            std::memcpy(_buffer.data() + pos, values.data(), values.size() * sizeof(T));
+        }
+    }
+
+    void WriteString(const std::string& value)
+    {
+        WriteVector(std::vector<char>(std::begin(value), std::end(value)));
+    }
+
+    std::vector<uint8_t> Release() { return std::move(_buffer); }
+};
+
+class Reader
+{
+    std::span<const uint8_t> _data;
+    size_t _pos{0};
+    // Kind of data read, named in errors.
+    const char* _what;
+
+public:
+    explicit Reader(std::span<const uint8_t> data, const char* what = "checkpoint")
+        : _data(data), _what(what)
+    {
+    }
+
+    template <typename T>
+    T Read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, _data.data() + _pos, sizeof(T));
+        _pos += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> ReadVector()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto count = Read<uint64_t>();
+        if(count > (_data.size() - _pos) / sizeof(T)) {
+            throw SimulationError("Corrupt {}: unexpected end of data", _what);
+        }
+        std::vector<T> values(count);
+        if(count > 0) {
+            std::memcpy(values.data(), _data.data() + _pos, count * sizeof(T));
+        }
+        _pos += count * sizeof(T);
+        return values;
+    }
+
+    std::string ReadString()
+    {
+        const auto chars = ReadVector<char>();
+        return {std::begin(chars), std::end(chars)};
+    }
+
+    bool AtEnd() const { return _pos == _data.size(); }
+
+private:
+    void require(size_t bytes) const
+    {
+        if(_data.size() - _pos < bytes) {
+            throw SimulationError("Corrupt {}: unexpected end of data", _what);
+        }
+    }
+};
+} // namespace checkpoint
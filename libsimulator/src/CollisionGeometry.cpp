@@ -3,8 +3,10 @@
 
 #include "AABB.hpp"
 #include "CfgCgal.hpp"
+#include "Checkpoint.hpp"
 #include "GeometricFunctions.hpp"
 #include "LineSegment.hpp"
+#include "MemoryUsage.hpp"
 #include "Point.hpp"
 
 #include <CGAL/Boolean_set_operations_2/oriented_side.h>
@@ -14,6 +16,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <set>
@@ -216,3 +219,79 @@ CollisionGeometry::AccessibleArea() const
 {
     return _accessibleArea;
 }
+
+size_t CollisionGeometry::MemoryUsage() const
+{
+    using jps::memory::HeapBytes;
+    size_t polygon = _accessibleAreaPolygon.outer_boundary().size() * sizeof(K::Point_2);
+    for(const auto& hole : _accessibleAreaPolygon.holes()) {
+        polygon += sizeof(Poly) + hole.size() * sizeof(K::Point_2);
+    }
+    const auto& [exterior, holes] = _accessibleArea;
+    return polygon + HeapBytes(_segments) + HeapBytes(_grid) + HeapBytes(_approximateGrid) +
+           HeapBytes(exterior) + HeapBytes(holes);
+}
+
+template <typename Grid>
+void writeGrid(checkpoint::Writer& writer, const Grid& grid)
+{
+    writer.Write(static_cast<uint64_t>(grid.size()));
+    for(const auto& [cell, segments] : grid) {
+        writer.Write(cell);
+        writer.WriteVector(std::vector<LineSegment>(segments.begin(), segments.end()));
+    }
+}
+
+template <typename Grid>
+Grid readGrid(checkpoint::Reader& reader)
+{
+    Grid grid{};
+    const auto cellCount = reader.Read<uint64_t>();
+    for(uint64_t index = 0; index < cellCount; ++index) {
+        const auto cell = reader.Read<Cell>();
+        const auto segments = reader.ReadVector<LineSegment>();
+        grid.emplace(cell, typename Grid::mapped_type(segments.begin(), segments.end()));
+    }
+    return grid;
+}
+
+void CollisionGeometry::Serialize(checkpoint::Writer& writer) const
+{
+    const auto& [exterior, holes] = _accessibleArea;
+    writer.WriteVector(exterior);
+    writer.Write(static_cast<uint64_t>(holes.size()));
+    for(const auto& hole : holes) {
+        writer.WriteVector(hole);
+    }
+    writer.WriteVector(_segments);
+    writeGrid(writer, _grid);
+    writeGrid(writer, _approximateGrid);
+}
+
+CollisionGeometry CollisionGeometry::Deserialize(checkpoint::Reader& reader)
+{
+    const auto toPoly = [](const std::vector<Point>& points) {
+        Poly poly{};
+        for(const auto& p : points) {
+            poly.push_back(K::Point_2(p.x, p.y));
+        }
+        return poly;
+    };
+
+    CollisionGeometry geometry{};
+    auto exterior = reader.ReadVector<Point>();
+    std::vector<std::vector<Point>> holes{};
+    std::vector<Poly> holePolygons{};
+    const auto holeCount = reader.Read<uint64_t>();
+    for(uint64_t index = 0; index < holeCount; ++index) {
+        holes.emplace_back(reader.ReadVector<Point>());
+        holePolygons.emplace_back(toPoly(holes.back()));
+    }
+    geometry._accessibleAreaPolygon =
+        PolyWithHoles(toPoly(exterior), holePolygons.begin(), holePolygons.end());
+    geometry._accessibleArea = std::make_tuple(std::move(exterior), std::move(holes));
+    geometry._segments = reader.ReadVector<LineSegment>();
+    geometry._grid = readGrid<decltype(_grid)>(reader);
+    geometry._approximateGrid = readGrid<decltype(_approximateGrid)>(reader);
+    return geometry;
+}
@@ -17,6 +17,11 @@
 #include <vector>
 
 class CollisionGeometry;
+namespace checkpoint
+{
+class Reader;
+class Writer;
+} // namespace checkpoint
 
 double dist(LineSegment l, Point p);
 
@@ -152,7 +157,15 @@ public:
 
     const PolyWithHoles& Polygon() const { return _accessibleAreaPolygon; }
     double MinApproxRadius() const { return CELL_EXTEND; }
+    /// Heap memory held by the polygon, its line segments and both grids, see
+    /// jps::memory::HeapBytes.
+    size_t MemoryUsage() const;
+    /// Appends the polygon, the line segments and both grids to 'writer', see GeometryBundle.
+    void Serialize(checkpoint::Writer& writer) const;
+    /// Restores a geometry written by 'Serialize' without rasterising the line segments again.
+    static CollisionGeometry Deserialize(checkpoint::Reader& reader);
 
 private:
+    CollisionGeometry() = default;
     void insertIntoApproximateGrid(const LineSegment& ls);
 };
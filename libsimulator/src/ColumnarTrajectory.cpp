@@ -0,0 +1,432 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "ColumnarTrajectory.hpp"
+
+#include "Simulation.hpp"
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+constexpr size_t HEADER_SIZE = 96;
+constexpr size_t FRAME_COUNT_OFFSET = 72;
+
+/// Unsigned integer of the same size as T, fixed width fields are stored through it so that
+/// files do not depend on the host byte order.
+template <typename T>
+using BitsOf = std::conditional_t<sizeof(T) == sizeof(uint64_t), uint64_t, uint32_t>;
+
+template <typename T>
+void put(std::vector<uint8_t>& out, T value)
+{
+    static_assert(sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t));
+    const auto bits = std::bit_cast<BitsOf<T>>(value);
+    for(size_t byte = 0; byte < sizeof(T); ++byte) {
+        out.push_back(static_cast<uint8_t>(bits >> (8 * byte)));
+    }
+}
+
+template <typename T>
+T load(const uint8_t* data)
+{
+    static_assert(sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t));
+    BitsOf<T> bits{0};
+    for(size_t byte = 0; byte < sizeof(T); ++byte) {
+        bits |= static_cast<BitsOf<T>>(data[byte]) << (8 * byte);
+    }
+    return std::bit_cast<T>(bits);
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while(value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t zigzag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void write(std::ofstream& out, const std::vector<uint8_t>& bytes)
+{
+    out.write(
+        reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+/// Bounds checked cursor over the mapped file.
+struct Cursor {
+    const uint8_t* pos;
+    const uint8_t* end;
+
+    uint64_t varint()
+    {
+        uint64_t value{0};
+        for(int shift = 0; shift < 64; shift += 7) {
+            if(pos == end) {
+                throw SimulationError("Truncated trajectory file");
+            }
+            const auto byte = *pos++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw SimulationError("Malformed varint in trajectory file");
+    }
+
+    template <typename T>
+    T get()
+    {
+        if(static_cast<size_t>(end - pos) < sizeof(T)) {
+            throw SimulationError("Truncated trajectory file");
+        }
+        const auto value = load<T>(pos);
+        pos += sizeof(T);
+        return value;
+    }
+};
+
+/// Quantised frame as used by the delta coder on both sides.
+struct QuantisedFrame {
+    std::vector<uint64_t> ids{};
+    std::vector<int64_t> qx{};
+    std::vector<int64_t> qy{};
+};
+
+/// Calls 'fn(agentIndex, previousIndex)' for each agent of 'ids', 'previousIndex' is the index of
+/// the same id in 'prevIds' or -1. Both ranges are sorted by id.
+template <typename Fn>
+void matchPrevious(
+    const std::vector<uint64_t>& ids,
+    const std::vector<uint64_t>& prevIds,
+    Fn&& fn)
+{
+    size_t p = 0;
+    for(size_t i = 0; i < ids.size(); ++i) {
+        while(p < prevIds.size() && prevIds[p] < ids[i]) {
+            ++p;
+        }
+        fn(i, (p < prevIds.size() && prevIds[p] == ids[i]) ? static_cast<int64_t>(p) : -1);
+    }
+}
+} // namespace
+
+ColumnarTrajectoryWriter::ColumnarTrajectoryWriter(Options options) : _options(std::move(options))
+{
+    if(_options.everyNthFrame < 1) {
+        throw SimulationError("'every_nth_frame' has to be > 0");
+    }
+    if(_options.framesPerChunk < 1) {
+        throw SimulationError("'frames_per_chunk' has to be > 0");
+    }
+    if(!(_options.quantisation > 0)) {
+        throw SimulationError("'quantisation' has to be > 0");
+    }
+}
+
+ColumnarTrajectoryWriter::~ColumnarTrajectoryWriter()
+{
+    try {
+        Close();
+    } catch(const std::exception&) {
+        // Errors cannot be reported from a destructor, call 'Close()' to observe them.
+    }
+}
+
+void ColumnarTrajectoryWriter::BeginWriting(
+    double dT,
+    const std::string& geometryWkt,
+    int64_t geometryHash,
+    AABB bounds)
+{
+    if(_begun) {
+        throw SimulationError("Trajectory writer has already begun writing");
+    }
+    // Large stream buffer, frames are appended in big sequential writes.
+    _streamBuffer.resize(1 << 20);
+    _out.rdbuf()->pubsetbuf(
+        _streamBuffer.data(), static_cast<std::streamsize>(_streamBuffer.size()));
+    _out.open(_options.outputFile, std::ios::binary | std::ios::trunc);
+    if(!_out) {
+        throw SimulationError("Cannot open {} for writing", _options.outputFile.string());
+    }
+
+    std::vector<uint8_t> header{};
+    header.insert(
+        std::end(header),
+        std::begin(columnar_trajectory::MAGIC),
+        std::end(columnar_trajectory::MAGIC));
+    put(header, columnar_trajectory::FORMAT_VERSION);
+    put(header, _options.framesPerChunk);
+    put(header, 1.0 / dT / static_cast<double>(_options.everyNthFrame));
+    put(header, _options.quantisation);
+    put(header, bounds.xmin);
+    put(header, bounds.xmax);
+    put(header, bounds.ymin);
+    put(header, bounds.ymax);
+    put(header, geometryHash);
+    put(header, uint64_t{0});
+    put(header, uint64_t{0});
+    put(header, static_cast<uint64_t>(geometryWkt.size()));
+    header.insert(std::end(header), std::begin(geometryWkt), std::end(geometryWkt));
+    write(_out, header);
+
+    _bounds = bounds;
+    _begun = true;
+}
+
+void ColumnarTrajectoryWriter::WriteIterationState(const Simulation& simulation)
+{
+    const auto iteration = simulation.Iteration();
+    if(iteration % _options.everyNthFrame != 0) {
+        return;
+    }
+    const auto& agents = simulation.Agents();
+    _frameIds.clear();
+    _frameXs.clear();
+    _frameYs.clear();
+    for(const auto& agent : agents) {
+        const auto pos = agent.Position();
+        _frameIds.push_back(agent.id.getID());
+        _frameXs.push_back(pos.x);
+        _frameYs.push_back(pos.y);
+    }
+    WriteFrame(iteration, _frameIds, _frameXs, _frameYs);
+}
+
+void ColumnarTrajectoryWriter::WriteFrame(
+    uint64_t iteration,
+    std::span<const uint64_t> ids,
+    std::span<const double> xs,
+    std::span<const double> ys)
+{
+    if(!_begun || !_out.is_open()) {
+        throw SimulationError("Trajectory writer is not writing, call 'BeginWriting' first");
+    }
+    if(ids.size() != xs.size() || ids.size() != ys.size()) {
+        throw SimulationError("Frame columns differ in length");
+    }
+    if(!_iterations.empty() && iteration <= _iterations.back()) {
+        throw SimulationError(
+            "Frame iterations have to increase, got {} after {}", iteration, _iterations.back());
+    }
+
+    const auto count = ids.size();
+    _order.resize(count);
+    for(size_t i = 0; i < count; ++i) {
+        _order[i] = {ids[i], i};
+    }
+    std::sort(std::begin(_order), std::end(_order));
+
+    const auto q = _options.quantisation;
+    _ids.resize(count);
+    _qx.resize(count);
+    _qy.resize(count);
+    for(size_t i = 0; i < count; ++i) {
+        const auto src = _order[i].second;
+        _ids[i] = _order[i].first;
+        _qx[i] = std::llround((xs[src] - _bounds.xmin) / q);
+        _qy[i] = std::llround((ys[src] - _bounds.ymin) / q);
+    }
+
+    const bool keyframe = _offsets.size() % _options.framesPerChunk == 0;
+    if(keyframe) {
+        _prevIds.clear();
+    }
+
+    _record.clear();
+    putVarint(_record, count);
+    uint64_t lastId{0};
+    for(const auto id : _ids) {
+        putVarint(_record, id - lastId);
+        lastId = id;
+    }
+    auto encodeColumn = [this](
+                            const std::vector<int64_t>& current,
+                            const std::vector<int64_t>& previous) {
+        matchPrevious(_ids, _prevIds, [&](size_t i, int64_t p) {
+            putVarint(_record, zigzag(current[i] - (p >= 0 ? previous[p] : 0)));
+        });
+    };
+    encodeColumn(_qx, _prevQx);
+    encodeColumn(_qy, _prevQy);
+
+    _offsets.push_back(static_cast<uint64_t>(_out.tellp()));
+    _iterations.push_back(iteration);
+    write(_out, _record);
+    if(!_out) {
+        throw SimulationError("Error writing to {}", _options.outputFile.string());
+    }
+    std::swap(_prevIds, _ids);
+    std::swap(_prevQx, _qx);
+    std::swap(_prevQy, _qy);
+}
+
+void ColumnarTrajectoryWriter::Close()
+{
+    if(!_out.is_open()) {
+        return;
+    }
+    std::vector<uint8_t> tail{};
+    tail.reserve(_offsets.size() * 2 * sizeof(uint64_t));
+    for(size_t frame = 0; frame < _offsets.size(); ++frame) {
+        put(tail, _offsets[frame]);
+        put(tail, _iterations[frame]);
+    }
+    const auto indexOffset = static_cast<uint64_t>(_out.tellp());
+    write(_out, tail);
+
+    std::vector<uint8_t> counts{};
+    put(counts, static_cast<uint64_t>(_offsets.size()));
+    put(counts, indexOffset);
+    _out.seekp(static_cast<std::streamoff>(FRAME_COUNT_OFFSET));
+    write(_out, counts);
+    _out.close();
+    if(_out.fail()) {
+        throw SimulationError("Error writing to {}", _options.outputFile.string());
+    }
+}
+
+ColumnarTrajectoryReader::ColumnarTrajectoryReader(const std::filesystem::path& file)
+    : _file(file.string().c_str(), boost::interprocess::read_only)
+    , _region(_file, boost::interprocess::read_only)
+    , _data(static_cast<const uint8_t*>(_region.get_address()))
+    , _size(_region.get_size())
+{
+    Cursor cursor{_data, _data + _size};
+    if(_size < HEADER_SIZE ||
+       std::memcmp(_data, columnar_trajectory::MAGIC, sizeof(columnar_trajectory::MAGIC)) != 0) {
+        throw SimulationError("{} is not a trajectory file", file.string());
+    }
+    cursor.pos += sizeof(columnar_trajectory::MAGIC);
+    const auto version = cursor.get<uint32_t>();
+    if(version != columnar_trajectory::FORMAT_VERSION) {
+        throw SimulationError(
+            "Unsupported trajectory file version {}, expected {}",
+            version,
+            columnar_trajectory::FORMAT_VERSION);
+    }
+    _framesPerChunk = cursor.get<uint32_t>();
+    _fps = cursor.get<double>();
+    _quantisation = cursor.get<double>();
+    _bounds.xmin = cursor.get<double>();
+    _bounds.xmax = cursor.get<double>();
+    _bounds.ymin = cursor.get<double>();
+    _bounds.ymax = cursor.get<double>();
+    _geometryHash = cursor.get<int64_t>();
+    _frameCount = cursor.get<uint64_t>();
+    const auto indexOffset = cursor.get<uint64_t>();
+    const auto wktLength = cursor.get<uint64_t>();
+    if(wktLength > _size - HEADER_SIZE) {
+        throw SimulationError("Truncated trajectory file");
+    }
+    _wkt.assign(reinterpret_cast<const char*>(cursor.pos), wktLength);
+
+    if(_framesPerChunk == 0) {
+        throw SimulationError("Malformed trajectory file header");
+    }
+    if(indexOffset == 0 && _frameCount == 0) {
+        throw SimulationError("Trajectory file {} was not closed properly", file.string());
+    }
+    if(indexOffset > _size || (_size - indexOffset) / (2 * sizeof(uint64_t)) < _frameCount) {
+        throw SimulationError("Truncated trajectory file");
+    }
+    _index = _data + indexOffset;
+}
+
+columnar_trajectory::Frame ColumnarTrajectoryReader::Frame(uint64_t index) const
+{
+    if(index >= _frameCount) {
+        throw SimulationError("Frame {} out of range, recording has {} frames", index, _frameCount);
+    }
+
+    QuantisedFrame prev{};
+    QuantisedFrame current{};
+    for(auto frame = index - index % _framesPerChunk; frame <= index; ++frame) {
+        const auto offset = indexEntry(frame, 0);
+        if(offset >= _size) {
+            throw SimulationError("Truncated trajectory file");
+        }
+        Cursor cursor{_data + offset, _data + _size};
+        const auto count = cursor.varint();
+        // Every agent takes at least one byte, reject counts the file cannot hold.
+        if(count > _size - offset) {
+            throw SimulationError("Malformed frame record in trajectory file");
+        }
+        current.ids.resize(count);
+        current.qx.resize(count);
+        current.qy.resize(count);
+        uint64_t lastId{0};
+        for(auto& id : current.ids) {
+            lastId += cursor.varint();
+            id = lastId;
+        }
+        auto decodeColumn = [&](std::vector<int64_t>& column,
+                                const std::vector<int64_t>& previous) {
+            matchPrevious(current.ids, prev.ids, [&](size_t i, int64_t p) {
+                column[i] = unzigzag(cursor.varint()) + (p >= 0 ? previous[p] : 0);
+            });
+        };
+        decodeColumn(current.qx, prev.qx);
+        decodeColumn(current.qy, prev.qy);
+        std::swap(prev, current);
+    }
+
+    columnar_trajectory::Frame result{};
+    result.iteration = indexEntry(index, 1);
+    result.ids = std::move(prev.ids);
+    result.xs.reserve(result.ids.size());
+    result.ys.reserve(result.ids.size());
+    for(size_t i = 0; i < result.ids.size(); ++i) {
+        result.xs.push_back(_bounds.xmin + static_cast<double>(prev.qx[i]) * _quantisation);
+        result.ys.push_back(_bounds.ymin + static_cast<double>(prev.qy[i]) * _quantisation);
+    }
+    return result;
+}
+
+uint64_t ColumnarTrajectoryReader::Iteration(uint64_t index) const
+{
+    if(index >= _frameCount) {
+        throw SimulationError("Frame {} out of range, recording has {} frames", index, _frameCount);
+    }
+    return indexEntry(index, 1);
+}
+
+uint64_t ColumnarTrajectoryReader::FrameIndexOfIteration(uint64_t iteration) const
+{
+    // Iterations increase from frame to frame, binary search the index.
+    uint64_t first{0};
+    uint64_t count{_frameCount};
+    while(count > 0) {
+        const auto step = count / 2;
+        if(indexEntry(first + step, 1) < iteration) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    if(first == _frameCount || indexEntry(first, 1) != iteration) {
+        throw SimulationError("Iteration {} was not recorded", iteration);
+    }
+    return first;
+}
+
+uint64_t ColumnarTrajectoryReader::indexEntry(uint64_t index, size_t field) const
+{
+    return load<uint64_t>(_index + (index * 2 + field) * sizeof(uint64_t));
+}
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AABB.hpp"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Simulation;
+
+/// Compact, columnar on-disk representation of trajectory data.
+///
+/// Layout (all fixed width fields little endian, independent of the host byte order):
+///   header   magic "JPSTRAJ\0", u32 version, u32 framesPerChunk, f64 fps, f64 quantisation,
+///            f64 xmin/xmax/ymin/ymax, i64 geometryHash, u64 frameCount, u64 indexOffset,
+///            u64 wktLength, wkt bytes
+///   frames   one record per frame: varint agent count followed by the id, x and y columns
+///   index    frameCount pairs of u64 file offset and u64 simulation iteration, one per frame
+///            record
+///
+/// Agents are stored sorted by id. Ids are delta encoded within a frame. Positions are quantised
+/// to multiples of 'quantisation' and stored as zigzag varints. The first frame of every chunk
+/// stores absolute values, all other frames store the difference to the same agent in the
+/// previous frame. Decoding a frame therefore touches at most 'framesPerChunk' records. Frames are
+/// numbered consecutively, the iteration stored with each frame maps them back to the simulation
+/// when not every iteration is written.
+namespace columnar_trajectory
+{
+constexpr char MAGIC[8] = {'J', 'P', 'S', 'T', 'R', 'A', 'J', '\0'};
+constexpr uint32_t FORMAT_VERSION = 2;
+
+struct Frame {
+    uint64_t iteration{};
+    std::vector<uint64_t> ids{};
+    std::vector<double> xs{};
+    std::vector<double> ys{};
+};
+} // namespace columnar_trajectory
+
+class ColumnarTrajectoryWriter
+{
+public:
+    struct Options {
+        std::filesystem::path outputFile{};
+        uint64_t everyNthFrame{4};
+        uint32_t framesPerChunk{32};
+        /// Positions are rounded to multiples of this value (in m).
+        double quantisation{1e-4};
+    };
+
+private:
+    Options _options;
+    std::ofstream _out{};
+    std::vector<char> _streamBuffer{};
+    std::vector<uint64_t> _offsets{};
+    std::vector<uint64_t> _iterations{};
+    AABB _bounds{};
+    // Encoder state, reused between frames
+    std::vector<uint64_t> _frameIds{};
+    std::vector<double> _frameXs{};
+    std::vector<double> _frameYs{};
+    std::vector<std::pair<uint64_t, size_t>> _order{};
+    std::vector<uint64_t> _ids{};
+    std::vector<int64_t> _qx{};
+    std::vector<int64_t> _qy{};
+    std::vector<uint64_t> _prevIds{};
+    std::vector<int64_t> _prevQx{};
+    std::vector<int64_t> _prevQy{};
+    std::vector<uint8_t> _record{};
+    bool _begun{false};
+
+public:
+    explicit ColumnarTrajectoryWriter(Options options);
+    ColumnarTrajectoryWriter(const ColumnarTrajectoryWriter& other) = delete;
+    ColumnarTrajectoryWriter& operator=(const ColumnarTrajectoryWriter& other) = delete;
+    ColumnarTrajectoryWriter(ColumnarTrajectoryWriter&& other) = delete;
+    ColumnarTrajectoryWriter& operator=(ColumnarTrajectoryWriter&& other) = delete;
+    /// Writes the index, see 'Close()'.
+    ~ColumnarTrajectoryWriter();
+
+    void BeginWriting(double dT, const std::string& geometryWkt, int64_t geometryHash, AABB bounds);
+    /// Encodes all agent positions if the current iteration is to be written.
+    void WriteIterationState(const Simulation& simulation);
+    /// Encodes one frame, ids do not need to be sorted. Iterations have to increase from frame
+    /// to frame.
+    void WriteFrame(
+        uint64_t iteration,
+        std::span<const uint64_t> ids,
+        std::span<const double> xs,
+        std::span<const double> ys);
+    /// Writes the frame index and patches the header. Calling it again has no effect.
+    void Close();
+
+    uint64_t EveryNthFrame() const { return _options.everyNthFrame; }
+};
+
+class ColumnarTrajectoryReader
+{
+    boost::interprocess::file_mapping _file;
+    boost::interprocess::mapped_region _region;
+    const uint8_t* _data{nullptr};
+    size_t _size{0};
+    uint32_t _framesPerChunk{};
+    double _fps{};
+    double _quantisation{};
+    AABB _bounds{};
+    int64_t _geometryHash{};
+    uint64_t _frameCount{};
+    const uint8_t* _index{nullptr};
+    std::string _wkt{};
+
+public:
+    explicit ColumnarTrajectoryReader(const std::filesystem::path& file);
+
+    uint64_t FrameCount() const { return _frameCount; }
+    double Fps() const { return _fps; }
+    double Quantisation() const { return _quantisation; }
+    AABB Bounds() const { return _bounds; }
+    int64_t GeometryHash() const { return _geometryHash; }
+    const std::string& GeometryWkt() const { return _wkt; }
+    /// Decodes a single frame. Only the records of the containing chunk are read.
+    columnar_trajectory::Frame Frame(uint64_t index) const;
+    /// Simulation iteration the frame was written at.
+    uint64_t Iteration(uint64_t index) const;
+    /// Index of the frame written at 'iteration', throws if that iteration was not written.
+    uint64_t FrameIndexOfIteration(uint64_t iteration) const;
+
+private:
+    uint64_t indexEntry(uint64_t index, size_t field) const;
+};
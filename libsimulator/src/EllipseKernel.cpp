@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "EllipseKernel.hpp"
+
+#include "Macros.hpp"
+
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+/// Boundary point of the ellipse (orientation, a, b) centered at the origin in direction of
+/// (dx, dy), written to (outX, outY).
+///
+/// Mirrors Ellipse::PointOnEllipse: (dx, dy) in the ellipse frame is (u, w), the boundary point
+/// there is (a * u / r, b * w / r) and gets rotated back. Directions shorter than J_EPS map to
+/// (a, 0).
+inline void boundaryTowards(
+    double orientationX,
+    double orientationY,
+    double a,
+    double b,
+    double dx,
+    double dy,
+    double& outX,
+    double& outY)
+{
+    const double u = dx * orientationX + dy * orientationY;
+    const double w = -dx * orientationY + dy * orientationX;
+    const double rSquared = u * u + w * w;
+    if(rSquared < J_EPS * J_EPS) {
+        outX = a * orientationX;
+        outY = a * orientationY;
+        return;
+    }
+    const double r = std::sqrt(rSquared);
+    const double sx = a * (u / r);
+    const double sy = b * (w / r);
+    outX = sx * orientationX - sy * orientationY;
+    outY = sx * orientationY + sy * orientationX;
+}
+
+inline double effectiveDistance(
+    double orientationX1,
+    double orientationY1,
+    double a1,
+    double b1,
+    double orientationX2,
+    double orientationY2,
+    double a2,
+    double b2,
+    double dx,
+    double dy)
+{
+    double x1{};
+    double y1{};
+    boundaryTowards(orientationX1, orientationY1, a1, b1, dx, dy, x1, y1);
+    double x2{};
+    double y2{};
+    boundaryTowards(orientationX2, orientationY2, a2, b2, -dx, -dy, x2, y2);
+    // Boundary point of the first minus boundary point of the second, which sits at (dx, dy).
+    const double ex = x1 - (dx + x2);
+    const double ey = y1 - (dy + y2);
+    return std::sqrt(ex * ex + ey * ey);
+}
+} // namespace
+
+EllipseShape::EllipseShape(const Ellipse& ellipse, double scale, double speed, Point orientation_)
+    : orientation(orientation_), a(ellipse.GetEA(speed)), b(ellipse.GetEB(scale))
+{
+}
+
+Point EllipseShape::BoundaryTowards(Point relative) const
+{
+    Point result{};
+    boundaryTowards(orientation.x, orientation.y, a, b, relative.x, relative.y, result.x, result.y);
+    return result;
+}
+
+double EffectiveDistance(const EllipseShape& first, const EllipseShape& second, Point relative)
+{
+    return effectiveDistance(
+        first.orientation.x,
+        first.orientation.y,
+        first.a,
+        first.b,
+        second.orientation.x,
+        second.orientation.y,
+        second.a,
+        second.b,
+        relative.x,
+        relative.y);
+}
+
+void EllipseBatch::Reserve(size_t count)
+{
+    _x.reserve(count);
+    _y.reserve(count);
+    _orientationX.reserve(count);
+    _orientationY.reserve(count);
+    _a.reserve(count);
+    _b.reserve(count);
+}
+
+void EllipseBatch::Clear()
+{
+    _x.clear();
+    _y.clear();
+    _orientationX.clear();
+    _orientationY.clear();
+    _a.clear();
+    _b.clear();
+}
+
+void EllipseBatch::Push(Point relative, const EllipseShape& shape)
+{
+    _x.push_back(relative.x);
+    _y.push_back(relative.y);
+    _orientationX.push_back(shape.orientation.x);
+    _orientationY.push_back(shape.orientation.y);
+    _a.push_back(shape.a);
+    _b.push_back(shape.b);
+}
+
+void EllipseBatch::EffectiveDistances(const EllipseShape& self, std::span<double> out) const
+{
+    assert(out.size() >= Size());
+    const size_t count = Size();
+    const double* x = _x.data();
+    const double* y = _y.data();
+    const double* orientationX = _orientationX.data();
+    const double* orientationY = _orientationY.data();
+    const double* a = _a.data();
+    const double* b = _b.data();
+    const double selfOrientationX = self.orientation.x;
+    const double selfOrientationY = self.orientation.y;
+    const double selfA = self.a;
+    const double selfB = self.b;
+    double* result = out.data();
+    for(size_t i = 0; i < count; ++i) {
+        result[i] = effectiveDistance(
+            selfOrientationX,
+            selfOrientationY,
+            selfA,
+            selfB,
+            orientationX[i],
+            orientationY[i],
+            a[i],
+            b[i],
+            x[i],
+            y[i]);
+    }
+}
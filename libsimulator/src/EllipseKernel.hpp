@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Ellipse.hpp"
+#include "Point.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/// An agent's ellipse for one step: heading and both semi-axes. GetEA/GetEB are evaluated once
+/// per agent and step instead of once per pair.
+///
+/// All distances are computed in the agent's own frame (agent at the origin), the boundary point
+/// towards a direction follows from two dot products without trigonometry or the separate
+/// transforms Ellipse::PointOnEllipse needs.
+struct EllipseShape {
+    Point orientation{};
+    /// Semi-axis along 'orientation', see Ellipse::GetEA.
+    double a{};
+    /// Semi-axis orthogonal to 'orientation', see Ellipse::GetEB.
+    double b{};
+
+    EllipseShape() = default;
+    EllipseShape(const Ellipse& ellipse, double scale, double speed, Point orientation);
+
+    /// Point on the boundary in direction of 'relative', relative to the center. Same as
+    /// Ellipse::PointOnEllipse for an ellipse centered at the origin.
+    Point BoundaryTowards(Point relative) const;
+};
+
+/// Same as Ellipse::EffectiveDistanceToEllipse with 'first' at the origin and 'second' at
+/// 'relative'.
+double EffectiveDistance(const EllipseShape& first, const EllipseShape& second, Point relative);
+
+/// The neighbors of one agent in structure of arrays layout, so that EffectiveDistances streams
+/// through contiguous arrays instead of chasing each neighbor's state.
+class EllipseBatch
+{
+    std::vector<double> _x{};
+    std::vector<double> _y{};
+    std::vector<double> _orientationX{};
+    std::vector<double> _orientationY{};
+    std::vector<double> _a{};
+    std::vector<double> _b{};
+
+public:
+    void Reserve(size_t count);
+    /// Removes all neighbors but keeps the capacity, so that a batch can be reused.
+    void Clear();
+    void Push(Point relative, const EllipseShape& shape);
+    size_t Size() const { return _x.size(); }
+
+    /// EffectiveDistance(self, neighbor, relative position of neighbor) for all neighbors in the
+    /// order they were pushed. 'out' needs to hold Size() elements.
+    void EffectiveDistances(const EllipseShape& self, std::span<double> out) const;
+};
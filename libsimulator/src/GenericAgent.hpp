@@ -8,6 +8,7 @@
 
 #include <fmt/core.h>
 
+#include <cstdint>
 #include <deque>
 #include <utility>
 class Journey;
@@ -26,6 +27,19 @@ struct GenericAgent {
 
     OperationalModelState state{};
 
+    /// Bookkeeping of AgentSleepSystem, not part of checkpoints: restored agents start awake.
+    struct Idle {
+        /// Consecutive steps the agent kept its target and stayed near 'position'.
+        uint32_t steps{0};
+        /// Target at the end of the last step.
+        Point target{};
+        /// Spot the agent is idling at, where it was when it last moved away from it.
+        Point position{};
+        /// Sleeping agents are skipped by the tactical and operational systems.
+        bool sleeping{false};
+    };
+    Idle idle{};
+
     const Point Position() const { return _position; }
     void MoveAlongSurface(Point delta) { _position += delta; }
 
@@ -40,6 +54,7 @@ struct GenericAgent {
         , stageId(stageId_)
         , finalTarget(position_)
         , state(std::move(state_))
+        , idle{.target = position_, .position = position_}
         , _position(position_)
     {
     }
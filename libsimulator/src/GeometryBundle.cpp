@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "GeometryBundle.hpp"
+
+#include "Checkpoint.hpp"
+#include "CollisionGeometry.hpp"
+#include "RoutingEngine.hpp"
+#include "SimulationError.hpp"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+GeometryBundle::GeometryBundle(std::shared_ptr<const CollisionGeometry> geometry)
+    : _geometry(std::move(geometry))
+{
+    if(!_geometry) {
+        throw SimulationError("A geometry bundle needs a geometry");
+    }
+    _routingEngine = std::make_shared<const RoutingEngine>(_geometry->Polygon());
+}
+
+GeometryBundle::GeometryBundle(
+    std::shared_ptr<const CollisionGeometry> geometry,
+    std::shared_ptr<const RoutingEngine> routingEngine)
+    : _geometry(std::move(geometry)), _routingEngine(std::move(routingEngine))
+{
+    if(!_geometry || !_routingEngine) {
+        throw SimulationError("A geometry bundle needs a geometry and a routing engine");
+    }
+}
+
+std::vector<uint8_t> GeometryBundle::Serialize() const
+{
+    checkpoint::Writer writer{};
+    for(const auto c : geometry_bundle::MAGIC) {
+        writer.Write(c);
+    }
+    writer.Write(geometry_bundle::BYTE_ORDER_TAG);
+    writer.Write(geometry_bundle::FORMAT_VERSION);
+    writer.WriteString(JPSCORE_VERSION);
+    _geometry->Serialize(writer);
+    _routingEngine->Serialize(writer);
+    return writer.Release();
+}
+
+GeometryBundle GeometryBundle::Deserialize(std::span<const uint8_t> data)
+{
+    checkpoint::Reader reader{data, "geometry bundle"};
+    for(const auto c : geometry_bundle::MAGIC) {
+        if(reader.Read<char>() != c) {
+            throw SimulationError("Data is not a geometry bundle");
+        }
+    }
+    // Bundles of format version 1 have no tag and fail here as well.
+    if(reader.Read<uint32_t>() != geometry_bundle::BYTE_ORDER_TAG) {
+        throw SimulationError(
+            "Geometry bundle was written on a machine with another byte order or by an older "
+            "version");
+    }
+    if(const auto version = reader.Read<uint32_t>(); version != geometry_bundle::FORMAT_VERSION) {
+        throw SimulationError(
+            "Unsupported geometry bundle version {}, expected {}",
+            version,
+            geometry_bundle::FORMAT_VERSION);
+    }
+    if(const auto library = reader.ReadString(); library != JPSCORE_VERSION) {
+        throw SimulationError(
+            "Geometry bundle was written by JuPedSim {}, this is JuPedSim {}",
+            library,
+            JPSCORE_VERSION);
+    }
+    auto geometry =
+        std::make_shared<const CollisionGeometry>(CollisionGeometry::Deserialize(reader));
+    std::shared_ptr<const RoutingEngine> routingEngine = RoutingEngine::Deserialize(reader);
+    if(!reader.AtEnd()) {
+        throw SimulationError("Corrupt geometry bundle: trailing data");
+    }
+    return GeometryBundle{std::move(geometry), std::move(routingEngine)};
+}
+
+void GeometryBundle::Save(const std::filesystem::path& file) const
+{
+    const auto data = Serialize();
+    std::ofstream out{file, std::ios::binary | std::ios::trunc};
+    out.write(
+        reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    out.close();
+    if(out.fail()) {
+        throw SimulationError("Error writing to {}", file.string());
+    }
+}
+
+GeometryBundle GeometryBundle::Load(const std::filesystem::path& file)
+{
+    if(!std::filesystem::is_regular_file(file) || std::filesystem::file_size(file) == 0) {
+        throw SimulationError("{} is not a geometry bundle", file.string());
+    }
+    const boost::interprocess::file_mapping mapping{
+        file.string().c_str(), boost::interprocess::read_only};
+    const boost::interprocess::mapped_region region{mapping, boost::interprocess::read_only};
+    return Deserialize({static_cast<const uint8_t*>(region.get_address()), region.get_size()});
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "CollisionGeometry.hpp"
+#include "RoutingEngine.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace geometry_bundle
+{
+constexpr char MAGIC[8] = {'J', 'P', 'S', 'G', 'E', 'O', 'M', '\0'};
+/// Written in the byte order of the machine right after MAGIC, reads differently on a machine
+/// with the other byte order.
+constexpr uint32_t BYTE_ORDER_TAG = 0x01020304;
+constexpr uint32_t FORMAT_VERSION = 2;
+} // namespace geometry_bundle
+
+/// Collision geometry and routing engine of one walkable area. Both are immutable once built, so
+/// a bundle can be shared by any number of simulations, also on different threads, instead of
+/// every simulation building the triangulation and the grids again.
+class GeometryBundle
+{
+    std::shared_ptr<const CollisionGeometry> _geometry;
+    std::shared_ptr<const RoutingEngine> _routingEngine;
+
+public:
+    /// Builds the routing engine for 'geometry'.
+    explicit GeometryBundle(std::shared_ptr<const CollisionGeometry> geometry);
+    /// Bundles a routing engine that was built for 'geometry'.
+    GeometryBundle(
+        std::shared_ptr<const CollisionGeometry> geometry,
+        std::shared_ptr<const RoutingEngine> routingEngine);
+
+    const CollisionGeometry& Geometry() const { return *_geometry; }
+    const RoutingEngine& Routing() const { return *_routingEngine; }
+    const std::shared_ptr<const CollisionGeometry>& SharedGeometry() const { return _geometry; }
+    const std::shared_ptr<const RoutingEngine>& SharedRouting() const { return _routingEngine; }
+
+    /// Encodes the geometry with its grids and the routing engine with its triangulation and
+    /// navigation mesh. Like checkpoints, the data is meant for the same JuPedSim version on the
+    /// same machine type, the header records the byte order and the version.
+    std::vector<uint8_t> Serialize() const;
+    /// Restores a bundle encoded with 'Serialize'. Nothing is built again, so this is much faster
+    /// than building the bundle from the polygon. Throws SimulationError for bundles written with
+    /// another byte order or by another JuPedSim version and for corrupt data.
+    static GeometryBundle Deserialize(std::span<const uint8_t> data);
+    /// Writes the encoded bundle to 'file'.
+    void Save(const std::filesystem::path& file) const;
+    /// Maps 'file' written by 'Save' into memory and restores the bundle from it.
+    static GeometryBundle Load(const std::filesystem::path& file);
+};
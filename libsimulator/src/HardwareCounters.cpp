@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "HardwareCounters.hpp"
+
+#include <fmt/core.h>
+
+#include <array>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr std::array<uint64_t, HardwareCounterValues::count> events{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    // Usually counts last level cache misses.
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+
+int openCounter(uint64_t event, int groupFd)
+{
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = event;
+    // The times let Read scale the values when the kernel multiplexes the counters.
+    attr.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // The group is enabled at once after all counters are opened.
+    attr.disabled = groupFd == -1 ? 1 : 0;
+    // Allowed with perf_event_paranoid up to 2.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+} // namespace
+
+HardwareCounters::HardwareCounters() : _thread(std::this_thread::get_id())
+{
+    int error = 0;
+    for(size_t index = 0; index < events.size(); ++index) {
+        const int fd = openCounter(events[index], _leader);
+        if(fd == -1) {
+            if(error == 0) {
+                error = errno;
+            }
+            continue;
+        }
+        if(_leader == closed) {
+            _leader = fd;
+        }
+        _fds[index] = fd;
+        _slots[index] = _opened++;
+    }
+    if(_leader == closed) {
+        _reason = fmt::format("perf_event_open failed: {}", std::strerror(error));
+        return;
+    }
+    ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+HardwareCounters::~HardwareCounters()
+{
+    for(const int fd : _fds) {
+        if(fd != closed) {
+            close(fd);
+        }
+    }
+}
+
+HardwareCounterValues HardwareCounters::Read() const
+{
+    HardwareCounterValues values{};
+    if(_leader == closed) {
+        return values;
+    }
+    // Layout of the read: the number of counters, the times the group was enabled and running
+    // on the PMU, followed by the values of the counters.
+    constexpr size_t header = 3;
+    std::array<uint64_t, header + HardwareCounterValues::count> buffer{};
+    const auto expected = static_cast<ssize_t>((header + _opened) * sizeof(uint64_t));
+    if(read(_leader, buffer.data(), sizeof(buffer)) < expected) {
+        return values;
+    }
+    const uint64_t enabled = buffer[1];
+    const uint64_t running = buffer[2];
+    if(running == 0) {
+        return values;
+    }
+    // Estimates the full counts if the group only ran part of the time, like perf stat.
+    const bool multiplexed = running < enabled;
+    const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+    for(size_t index = 0; index < HardwareCounterValues::count; ++index) {
+        if(_fds[index] == closed) {
+            continue;
+        }
+        const uint64_t value = buffer[header + _slots[index]];
+        values.values[index] =
+            multiplexed ? static_cast<uint64_t>(static_cast<double>(value) * scale) : value;
+    }
+    return values;
+}
+
+#else
+
+HardwareCounters::HardwareCounters()
+    : _thread(std::this_thread::get_id()), _reason("Hardware counters are only supported on Linux")
+{
+}
+
+HardwareCounters::~HardwareCounters() = default;
+
+HardwareCounterValues HardwareCounters::Read() const
+{
+    return {};
+}
+
+#endif
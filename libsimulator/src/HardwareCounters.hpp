@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+
+/// Values of the hardware counters of HardwareCounters. Counters that could not be opened stay 0.
+struct HardwareCounterValues {
+    static constexpr size_t count = 4;
+    static constexpr std::array<std::string_view, count> names{
+        "cycles", "instructions", "llc_misses", "branch_misses"};
+
+    std::array<uint64_t, count> values{};
+
+    HardwareCounterValues& operator+=(const HardwareCounterValues& other)
+    {
+        for(size_t index = 0; index < count; ++index) {
+            values[index] += other.values[index];
+        }
+        return *this;
+    }
+
+    // Counters that went backwards, e.g. because a read failed, count as 0.
+    HardwareCounterValues operator-(const HardwareCounterValues& other) const
+    {
+        HardwareCounterValues difference{};
+        for(size_t index = 0; index < count; ++index) {
+            if(values[index] >= other.values[index]) {
+                difference.values[index] = values[index] - other.values[index];
+            }
+        }
+        return difference;
+    }
+};
+
+/// Hardware performance counters (cycles, instructions, last level cache misses and branch
+/// misses) of the calling thread in user space, opened as one perf_event_open group so that all
+/// of them are read at once.
+///
+/// The counters only count the thread that constructed them, reading them on another thread
+/// returns the counts of the constructing thread, see OnCallingThread. If the kernel has to share
+/// the hardware between more counters than it has, it multiplexes them and Read scales the values
+/// by the fraction of the time the group was counting, so they are estimates in that case.
+///
+/// Counters are only available on Linux and only if the kernel allows it, see
+/// /proc/sys/kernel/perf_event_paranoid. If the group cannot be opened at all, Available() is
+/// false and Reason() tells why. Single counters the hardware does not provide, e.g. in virtual
+/// machines, are left out and read as 0.
+class HardwareCounters
+{
+    static constexpr int closed = -1;
+    // File descriptors of the counters in the order of HardwareCounterValues::names.
+    std::array<int, HardwareCounterValues::count> _fds{closed, closed, closed, closed};
+    // The first counter that could be opened leads the group.
+    int _leader{closed};
+    // Positions of the counters in the group read, for the counters that are open.
+    std::array<size_t, HardwareCounterValues::count> _slots{};
+    size_t _opened{0};
+    std::thread::id _thread;
+    std::string _reason{};
+
+public:
+    HardwareCounters();
+    ~HardwareCounters();
+    HardwareCounters(const HardwareCounters& other) = delete;
+    HardwareCounters& operator=(const HardwareCounters& other) = delete;
+    HardwareCounters(HardwareCounters&& other) = delete;
+    HardwareCounters& operator=(HardwareCounters&& other) = delete;
+
+    bool Available() const { return _leader != closed; }
+    /// Whether the counter at 'index' of HardwareCounterValues::names could be opened.
+    bool Opened(size_t index) const { return _fds[index] != closed; }
+    /// Whether the calling thread is the one the counters count.
+    bool OnCallingThread() const { return std::this_thread::get_id() == _thread; }
+    /// Why the counters are not available, empty if they are.
+    const std::string& Reason() const { return _reason; }
+    /// Current values of the counters since they were opened, all 0 if they are not available.
+    HardwareCounterValues Read() const;
+};
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "GenericAgent.hpp"
+#include "MemoryUsage.hpp"
 #include "Point.hpp"
 #include "SimulationError.hpp"
 #include "Stage.hpp"
@@ -90,6 +91,8 @@ class Transition
 public:
     virtual ~Transition() = default;
     virtual BaseStage* NextStage() = 0;
+    /// Memory held by the transition, including the transition itself.
+    virtual size_t MemoryUsage() const = 0;
 };
 
 class FixedTransition : public Transition
@@ -101,6 +104,7 @@ public:
     FixedTransition(BaseStage* next_) : next(next_) {};
 
     BaseStage* NextStage() override { return next; }
+    size_t MemoryUsage() const override { return sizeof(*this); }
 };
 
 class RoundRobinTransition : public Transition
@@ -137,6 +141,14 @@ public:
         nextCalled = (nextCalled + 1) % sumWeights;
         return candidate;
     }
+
+    size_t MemoryUsage() const override
+    {
+        return sizeof(*this) + jps::memory::HeapBytes(weightedStages);
+    }
+
+    uint64_t NextCalled() const { return nextCalled; }
+    void NextCalled(uint64_t value) { nextCalled = value % sumWeights; }
 };
 
 class LeastTargetedTransition : public Transition
@@ -158,6 +170,11 @@ public:
             [](auto const& a, auto const& b) { return a->CountTargeting() < b->CountTargeting(); });
         return *leastTargeted;
     }
+
+    size_t MemoryUsage() const override
+    {
+        return sizeof(*this) + jps::memory::HeapBytes(targetCandidates);
+    }
 };
 
 struct JourneyNode {
@@ -179,23 +196,48 @@ public:
 
     Journey(std::map<BaseStage::ID, JourneyNode> stages_) : stages(std::move(stages_)) {}
 
+    /// Creates a journey with a given id, used when restoring checkpoints.
+    Journey(std::map<BaseStage::ID, JourneyNode> stages_, ID id_)
+        : id(id_), stages(std::move(stages_))
+    {
+    }
+
     ID Id() const { return id; }
 
     std::tuple<Point, BaseStage::ID> Target(const GenericAgent& agent) const
     {
-        auto& node = stages.at(agent.stageId);
+        return Target(agent, Node(agent.stageId), true);
+    }
+
+    /// Same as Target(agent) with the node of the agent's stage already looked up. With
+    /// 'mayBeCompleted' false the agent is known not to have completed the stage.
+    static std::tuple<Point, BaseStage::ID>
+    Target(const GenericAgent& agent, const JourneyNode& node, bool mayBeCompleted)
+    {
         auto stage = node.stage;
         const auto& transition = node.transition;
 
-        if(stage->IsCompleted(agent)) {
+        if(mayBeCompleted && stage->IsCompleted(agent)) {
             stage = transition->NextStage();
         }
 
         return std::make_tuple(stage->Target(agent), stage->Id());
     }
 
+    const JourneyNode& Node(BaseStage::ID stageId) const { return stages.at(stageId); }
+
     size_t CountStages() const { return stages.size(); }
 
+    /// Memory held by the journey, including the journey itself and its transitions.
+    size_t MemoryUsage() const
+    {
+        size_t bytes = sizeof(*this) + jps::memory::HeapBytes(stages);
+        for(const auto& [_, node] : stages) {
+            bytes += node.transition ? node.transition->MemoryUsage() : 0;
+        }
+        return bytes;
+    }
+
     bool ContainsStage(BaseStage::ID stageId) const
     {
         const auto find_iter = stages.find(stageId);
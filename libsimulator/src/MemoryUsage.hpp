@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/// Bytes held by the parts of a Simulation, see Simulation::MemoryReport.
+struct MemoryBreakdown {
+    /// Bytes by part held by this simulation alone, e.g. "agents" or "timer".
+    std::map<std::string, size_t> bytes{};
+    /// Bytes by part the simulation may share with other simulations or with the whole process,
+    /// e.g. "routing_engine" of a shared GeometryBundle or "profiler". Not included in Total, sum
+    /// them once per process instead of once per simulation.
+    std::map<std::string, size_t> sharedBytes{};
+
+    /// Sum of 'bytes'.
+    size_t Total() const
+    {
+        size_t total = 0;
+        for(const auto& [_, partBytes] : bytes) {
+            total += partBytes;
+        }
+        return total;
+    }
+};
+
+/// Estimates of the heap memory held by standard containers, including the memory held by their
+/// elements. They follow the layout of libstdc++ (deque blocks, tree and hash nodes) and leave
+/// out the overhead of the allocator itself. Types without an overload hold no heap memory.
+namespace jps::memory
+{
+template <typename T>
+size_t HeapBytes(const T&);
+inline size_t HeapBytes(const std::string& value);
+template <typename T>
+size_t HeapBytes(const std::vector<T>& values);
+template <typename T>
+size_t HeapBytes(const std::deque<T>& values);
+template <typename T, typename Compare>
+size_t HeapBytes(const std::set<T, Compare>& values);
+template <typename Key, typename T, typename Compare>
+size_t HeapBytes(const std::map<Key, T, Compare>& values);
+template <typename T, typename Hash, typename Equal>
+size_t HeapBytes(const std::unordered_set<T, Hash, Equal>& values);
+template <typename Key, typename T, typename Hash, typename Equal>
+size_t HeapBytes(const std::unordered_map<Key, T, Hash, Equal>& values);
+
+// Color and three links of a red-black tree node.
+constexpr size_t treeNodeOverhead = 4 * sizeof(void*);
+// Link to the next node and the cached hash of a hash table node.
+constexpr size_t hashNodeOverhead = 2 * sizeof(void*);
+
+template <typename T>
+size_t HeapBytes(const T&)
+{
+    return 0;
+}
+
+inline size_t HeapBytes(const std::string& value)
+{
+    // Short strings are stored inline.
+    return value.capacity() > 15 ? value.capacity() + 1 : 0;
+}
+
+template <typename Range>
+size_t ElementHeapBytes(const Range& values)
+{
+    size_t bytes = 0;
+    for(const auto& value : values) {
+        bytes += HeapBytes(value);
+    }
+    return bytes;
+}
+
+template <typename T>
+size_t HeapBytes(const std::vector<T>& values)
+{
+    return values.capacity() * sizeof(T) + ElementHeapBytes(values);
+}
+
+template <typename T>
+size_t HeapBytes(const std::deque<T>& values)
+{
+    constexpr size_t perBlock = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+    const size_t blocks = values.size() / perBlock + 1;
+    // The map of block pointers has at least 8 entries.
+    const size_t map = std::max<size_t>(8, blocks + 2) * sizeof(T*);
+    return blocks * perBlock * sizeof(T) + map + ElementHeapBytes(values);
+}
+
+template <typename T, typename Compare>
+size_t HeapBytes(const std::set<T, Compare>& values)
+{
+    return values.size() * (sizeof(T) + treeNodeOverhead) + ElementHeapBytes(values);
+}
+
+template <typename Key, typename T, typename Compare>
+size_t HeapBytes(const std::map<Key, T, Compare>& values)
+{
+    size_t bytes = values.size() * (sizeof(std::pair<const Key, T>) + treeNodeOverhead);
+    for(const auto& [key, value] : values) {
+        bytes += HeapBytes(key) + HeapBytes(value);
+    }
+    return bytes;
+}
+
+template <typename T, typename Hash, typename Equal>
+size_t HeapBytes(const std::unordered_set<T, Hash, Equal>& values)
+{
+    return values.bucket_count() * sizeof(void*) + values.size() * (sizeof(T) + hashNodeOverhead) +
+           ElementHeapBytes(values);
+}
+
+template <typename Key, typename T, typename Hash, typename Equal>
+size_t HeapBytes(const std::unordered_map<Key, T, Hash, Equal>& values)
+{
+    size_t bytes = values.bucket_count() * sizeof(void*) +
+                   values.size() * (sizeof(std::pair<const Key, T>) + hashNodeOverhead);
+    for(const auto& [key, value] : values) {
+        bytes += HeapBytes(key) + HeapBytes(value);
+    }
+    return bytes;
+}
+} // namespace jps::memory
@@ -3,6 +3,9 @@
 
 #include "AABB.hpp"
 #include "CfgCgal.hpp"
+#include "Checkpoint.hpp"
+#include "MemoryUsage.hpp"
+#include "SimulationError.hpp"
 #include "glm/ext/vector_double2.hpp"
 #include "glm/ext/vector_double3.hpp"
 #include "glm/ext/vector_float2.hpp"
@@ -544,6 +547,57 @@ glm::dvec2 Mesh::Vertex(size_t index) const
     return vertices.at(index);
 }
 
+size_t Mesh::MemoryUsage() const
+{
+    using jps::memory::HeapBytes;
+    size_t bytes = HeapBytes(vertices) + HeapBytes(polygons) + HeapBytes(boundingBoxes);
+    for(const auto& polygon : polygons) {
+        bytes += HeapBytes(polygon.vertices) + HeapBytes(polygon.neighbors);
+    }
+    return bytes;
+}
+
+void Mesh::Serialize(checkpoint::Writer& writer) const
+{
+    writer.WriteVector(vertices);
+    writer.Write(static_cast<uint64_t>(polygons.size()));
+    for(const auto& polygon : polygons) {
+        writer.WriteVector(polygon.vertices);
+        writer.WriteVector(polygon.neighbors);
+    }
+    writer.WriteVector(boundingBoxes);
+}
+
+Mesh Mesh::Deserialize(checkpoint::Reader& reader)
+{
+    Mesh mesh{};
+    mesh.vertices = reader.ReadVector<glm::dvec2>();
+    const auto polygonCount = reader.Read<uint64_t>();
+    for(uint64_t index = 0; index < polygonCount; ++index) {
+        auto& polygon = mesh.polygons.emplace_back();
+        polygon.vertices = reader.ReadVector<size_t>();
+        polygon.neighbors = reader.ReadVector<size_t>();
+    }
+    mesh.boundingBoxes = reader.ReadVector<AABB>();
+    if(mesh.boundingBoxes.size() != mesh.polygons.size()) {
+        throw SimulationError("Corrupt geometry bundle: mesh does not match its bounding boxes");
+    }
+    // Routing indexes with these without further checks.
+    for(const auto& polygon : mesh.polygons) {
+        for(const auto vertex : polygon.vertices) {
+            if(vertex >= mesh.vertices.size()) {
+                throw SimulationError("Corrupt geometry bundle: mesh vertex out of range");
+            }
+        }
+        for(const auto neighbor : polygon.neighbors) {
+            if(neighbor != Polygon::InvalidIndex && neighbor >= mesh.polygons.size()) {
+                throw SimulationError("Corrupt geometry bundle: mesh neighbor out of range");
+            }
+        }
+    }
+    return mesh;
+}
+
 static int toPolyanyaIndex(size_t idx)
 {
     if(idx == std::numeric_limits<size_t>::max()) {
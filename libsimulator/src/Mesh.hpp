@@ -13,6 +13,12 @@
 #include <tuple>
 #include <vector>
 
+namespace checkpoint
+{
+class Reader;
+class Writer;
+} // namespace checkpoint
+
 class Mesh
 {
 public:
@@ -48,12 +54,19 @@ public:
     glm::dvec2 Vertex(size_t index) const;
     size_t CountVertices() const { return vertices.size(); }
     size_t CountPolygons() const { return polygons.size(); }
+    /// Heap memory held by the mesh, see jps::memory::HeapBytes.
+    size_t MemoryUsage() const;
+    /// Appends the vertices, polygons and bounding boxes to 'writer', see GeometryBundle.
+    void Serialize(checkpoint::Writer& writer) const;
+    /// Restores a mesh written by 'Serialize'.
+    static Mesh Deserialize(checkpoint::Reader& reader);
     std::stringstream IntoLibPolyanyaMeshDescription() const;
     const Mesh::Polygon& Polygons(size_t index) const { return polygons.at(index); }
     const AABB& AxisAlignedBoundingBox(size_t index) const { return boundingBoxes.at(index); }
     bool TriangleContains(const size_t, glm::dvec2 p) const;
 
 private:
+    Mesh() = default;
     void mergeDeadEnds();
     void smartMerge(bool keep_deadends);
     bool isValid() const;
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/// Settings of the multi-rate integration of the operational step.
+///
+/// At the start of every iteration each agent is put on a level from its local density: level k
+/// advances in 2^k steps of dT / 2^k, so agents in dense spots get smaller steps while the free
+/// walking crowd takes the full dT. All levels are interleaved in sub-steps of the finest level
+/// in use, an agent always sees the others where their latest step left them.
+struct MultiRateStepping {
+    /// Highest level, 0 disables multi-rate stepping.
+    uint32_t maxLevel{0};
+    /// Radius around an agent its neighbors are counted in.
+    double radius{1.0};
+    /// Each 'neighborsPerLevel' neighbors within 'radius' raise an agent one level.
+    uint32_t neighborsPerLevel{2};
+
+    /// Largest supported 'maxLevel', i.e. at most 256 sub-steps per iteration.
+    static constexpr uint32_t levelLimit{8};
+
+    bool Enabled() const { return maxLevel > 0; }
+
+    uint32_t Level(size_t neighbors) const
+    {
+        return static_cast<uint32_t>(
+            std::min<size_t>(maxLevel, neighbors / std::max<uint32_t>(neighborsPerLevel, 1)));
+    }
+};
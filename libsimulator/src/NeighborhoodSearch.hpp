@@ -2,6 +2,7 @@
 #pragma once
 #include "GenericAgent.hpp"
 #include "HashCombine.hpp"
+#include "MemoryUsage.hpp"
 #include "Point.hpp"
 
 #include <algorithm>
@@ -78,6 +79,9 @@ private:
 public:
     explicit NeighborhoodSearch(double cellSize) : _cellSize(cellSize) {};
 
+    /// Heap memory held by the buckets, see jps::memory::HeapBytes.
+    size_t MemoryUsage() const { return jps::memory::HeapBytes(_grid); }
+
     void AddAgent(const Value& item)
     {
         auto index = getIndex(item.Position());
@@ -4,18 +4,47 @@
 #include "AgentView.hpp"
 #include "EnvironmentQuery.hpp"
 #include "GenericAgent.hpp"
+#include "LineSegment.hpp"
+#include "MemoryUsage.hpp"
+#include "MultiRateStepping.hpp"
+#include "NeighborhoodSearch.hpp"
 #include "OperationalModel.hpp"
 #include "OperationalModelType.hpp"
+#include "Point.hpp"
+#include "SimulationError.hpp"
+#include "VerletList.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
+#include <optional>
+#include <span>
 #include <utility>
+#include <vector>
 
 class OperationalDecisionSystem
 {
     std::unique_ptr<OperationalModel> _model{};
     AgentContainer<GenericAgent> _next{};
+    // Buffers of the pair phase, kept between iterations to reuse their memory.
+    std::vector<Point> _pairInteractions{};
+    std::vector<std::vector<NeighborView>> _pairNeighbors{};
+    std::vector<std::vector<LineSegment>> _pairWalls{};
+    // Cell of every agent with its index, sorted by cell and index.
+    std::vector<std::pair<Grid2DIndex, size_t>> _pairCells{};
+    std::optional<VerletList> _verletList{};
+    MultiRateStepping _multiRate{};
+    // Buffers of the multi-rate step, kept between iterations to reuse their memory.
+    std::vector<uint32_t> _levels{};
+    std::vector<uint8_t> _stepping{};
+    std::vector<std::pair<size_t, GenericAgent>> _stepped{};
+    // Buffers of the batch step, kept between iterations to reuse their memory.
+    std::vector<OperationalModelState*> _nextStates{};
+    std::vector<Point> _movements{};
 
 public:
     OperationalDecisionSystem(std::unique_ptr<OperationalModel>&& model) : _model(std::move(model))
@@ -29,20 +58,109 @@ public:
 
     OperationalModelType ModelType() const { return _model->Type(); }
 
+    const OperationalModel& Model() const { return *_model; }
+    OperationalModel& Model() { return *_model; }
+
+    /// Serves the model's neighbor queries from Verlet lists built at its NeighborRadius() plus
+    /// 'skin', see VerletList. A skin of 0 switches them off again.
+    void SetVerletSkin(double skin)
+    {
+        if(skin < 0.0) {
+            throw SimulationError("Verlet skin needs to be >= 0, got {}", skin);
+        }
+        if(skin == 0.0) {
+            _verletList.reset();
+            return;
+        }
+        const double cutoff = _model->NeighborRadius();
+        if(cutoff <= 0.0) {
+            throw SimulationError("The operational model does not support Verlet lists");
+        }
+        _verletList.emplace(cutoff, skin);
+    }
+
+    double VerletSkin() const { return _verletList ? _verletList->Skin() : 0.0; }
+
+    /// Heap memory held by the double buffer of the agents and the buffers kept between
+    /// iterations, including the Verlet lists, see jps::memory::HeapBytes.
+    size_t MemoryUsage() const
+    {
+        using jps::memory::HeapBytes;
+        return HeapBytes(_next) + HeapBytes(_pairInteractions) + HeapBytes(_pairNeighbors) +
+               HeapBytes(_pairWalls) + HeapBytes(_pairCells) +
+               (_verletList ? _verletList->MemoryUsage() : 0) + HeapBytes(_levels) +
+               HeapBytes(_stepping) + HeapBytes(_stepped) + HeapBytes(_nextStates) +
+               HeapBytes(_movements);
+    }
+
+    /// See MultiRateStepping, takes effect in RunMultiRate.
+    void SetMultiRateStepping(const MultiRateStepping& settings)
+    {
+        if(settings.maxLevel > MultiRateStepping::levelLimit) {
+            throw SimulationError(
+                "Multi-rate max level needs to be <= {}, got {}",
+                MultiRateStepping::levelLimit,
+                settings.maxLevel);
+        }
+        if(settings.radius <= 0.0) {
+            throw SimulationError("Multi-rate radius needs to be > 0, got {}", settings.radius);
+        }
+        if(settings.neighborsPerLevel == 0) {
+            throw SimulationError("Multi-rate neighbors per level needs to be > 0");
+        }
+        if(settings.Enabled() && _model->SupportsBatchStep()) {
+            throw SimulationError("The operational model does not support multi-rate stepping");
+        }
+        _multiRate = settings;
+    }
+
+    const MultiRateStepping& MultiRate() const { return _multiRate; }
+
     void
     Run(double dT,
         double /*t_in_sec*/,
+        uint64_t iteration,
         const NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
         const CollisionGeometry& geometry,
         AgentContainer<GenericAgent>& agents)
     {
         const EnvironmentQuery envQuery{geometry, neighborhoodSearch};
+        if(_model->SupportsBatchStep()) {
+            RunBatch(dT, iteration, envQuery, agents);
+            return;
+        }
+        const double pairRadius = _model->PairInteractionRadius();
+        if(pairRadius > 0.0) {
+            // Sleeping agents do not step, only their pairs with awake agents are needed.
+            _stepping.clear();
+            if(std::any_of(std::begin(agents), std::end(agents), isSleeping)) {
+                for(const auto& agent : agents) {
+                    _stepping.push_back(isSleeping(agent) ? 0 : 1);
+                }
+            }
+            ComputePairInteractions(pairRadius, envQuery, agents, _stepping);
+        }
+        if(_verletList) {
+            _verletList->Update(agents, envQuery);
+        }
+        const VerletList* verletList = _verletList ? &*_verletList : nullptr;
         _next.clear();
         std::copy(std::begin(agents), std::end(agents), std::back_inserter(_next));
         for(size_t index = 0; index < agents.size(); ++index) {
             const auto& current = agents[index];
+            if(isSleeping(current)) {
+                continue;
+            }
             auto& next = _next[index];
-            const AgentStep step{envQuery, current, dT};
+            const AgentStep step{
+                envQuery,
+                current,
+                dT,
+                iteration,
+                pairRadius > 0.0 ? _pairInteractions[index] : Point{},
+                pairRadius > 0.0 ? _pairNeighbors[index] : std::span<const NeighborView>{},
+                verletList,
+                index};
             const Point movement = _model->ComputeNextState(current.state, next.state, step);
             next.MoveAlongSurface(movement);
         }
@@ -51,8 +169,234 @@ public:
         // access) and Simulation::Iterate rebuilds the neighborhood grid right after this
         // step.
         agents.swap(_next);
+        _model->CommitStates();
     }
 
+    /// Advances all agents by 'dT' like Run, but with the step size of each agent chosen by
+    /// MultiRate(). Agents on level k take 2^k steps of dT / 2^k. 'neighborhoodSearch' is
+    /// updated after every sub-step so that the agents stepping next see current positions.
+    void RunMultiRate(
+        double dT,
+        uint64_t iteration,
+        NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
+        const CollisionGeometry& geometry,
+        AgentContainer<GenericAgent>& agents)
+    {
+        const EnvironmentQuery envQuery{geometry, neighborhoodSearch};
+        const size_t count = agents.size();
+        _levels.resize(count);
+        uint32_t finestLevel = 0;
+        for(size_t index = 0; index < count; ++index) {
+            const auto& agent = agents[index];
+            if(isSleeping(agent)) {
+                _levels[index] = 0;
+                continue;
+            }
+            size_t neighbors = 0;
+            envQuery.ForEachAgentInRange(
+                agent.Position(), _multiRate.radius, [&](const GenericAgent& other) {
+                    if(other.id != agent.id) {
+                        ++neighbors;
+                    }
+                });
+            _levels[index] = _multiRate.Level(neighbors);
+            finestLevel = std::max(finestLevel, _levels[index]);
+        }
+
+        const double pairRadius = _model->PairInteractionRadius();
+        const uint64_t subSteps = uint64_t{1} << finestLevel;
+        _stepping.resize(count);
+        for(uint64_t subStep = 0; subStep < subSteps; ++subStep) {
+            // Level k steps every 2^(finestLevel - k)-th sub-step.
+            for(size_t index = 0; index < count; ++index) {
+                const bool steps = subStep % (subSteps >> _levels[index]) == 0;
+                _stepping[index] = steps && !isSleeping(agents[index]) ? 1 : 0;
+            }
+            if(subStep > 0) {
+                neighborhoodSearch.Update(agents);
+            }
+            if(pairRadius > 0.0) {
+                ComputePairInteractions(pairRadius, envQuery, agents, _stepping);
+            }
+            if(_verletList) {
+                _verletList->Update(agents, envQuery);
+            }
+            const VerletList* verletList = _verletList ? &*_verletList : nullptr;
+            // Every sub-step gets its own random streams.
+            const uint64_t randomIteration = (iteration << _multiRate.maxLevel) + subStep;
+            _stepped.clear();
+            for(size_t index = 0; index < count; ++index) {
+                if(_stepping[index] == 0) {
+                    continue;
+                }
+                const auto& current = agents[index];
+                auto next = current;
+                const AgentStep step{
+                    envQuery,
+                    current,
+                    dT / static_cast<double>(uint64_t{1} << _levels[index]),
+                    randomIteration,
+                    pairRadius > 0.0 ? _pairInteractions[index] : Point{},
+                    pairRadius > 0.0 ? _pairNeighbors[index] : std::span<const NeighborView>{},
+                    verletList,
+                    index};
+                const Point movement = _model->ComputeNextState(current.state, next.state, step);
+                next.MoveAlongSurface(movement);
+                _stepped.emplace_back(index, std::move(next));
+            }
+            // All agents of a sub-step see the same positions, written back only afterwards.
+            for(auto& [index, next] : _stepped) {
+                agents[index] = std::move(next);
+            }
+            _model->CommitStates();
+        }
+    }
+
+private:
+    /// Agents put to sleep by AgentSleepSystem keep their state and position.
+    static bool isSleeping(const GenericAgent& agent) { return agent.idle.sleeping; }
+
+    /// Run for models with SupportsBatchStep(), all agents are handed to the model at once.
+    void RunBatch(
+        double dT,
+        uint64_t iteration,
+        const EnvironmentQuery& envQuery,
+        AgentContainer<GenericAgent>& agents)
+    {
+        const size_t count = agents.size();
+        _stepping.clear();
+        if(std::any_of(std::begin(agents), std::end(agents), isSleeping)) {
+            for(const auto& agent : agents) {
+                _stepping.push_back(isSleeping(agent) ? 0 : 1);
+            }
+        }
+        _next.clear();
+        std::copy(std::begin(agents), std::end(agents), std::back_inserter(_next));
+        _nextStates.clear();
+        for(auto& next : _next) {
+            _nextStates.push_back(&next.state);
+        }
+        _movements.assign(count, Point{});
+        const AgentBatch batch{envQuery, agents, _stepping, dT, iteration};
+        _model->ComputeNextStates(batch, _nextStates, _movements);
+        for(size_t index = 0; index < count; ++index) {
+            if(batch.Steps(index)) {
+                _next[index].MoveAlongSurface(_movements[index]);
+            } else {
+                _next[index].state = agents[index].state;
+            }
+        }
+        // Safe for the same reasons as in Run.
+        agents.swap(_next);
+        _model->CommitStates();
+    }
+
+    /// Evaluates every unordered pair of agents within 'radius' once and sums the results per
+    /// agent into _pairInteractions. The partners each agent sees are collected in
+    /// _pairNeighbors, so models need no neighbor query of their own. The agents are binned into
+    /// cells of size 'radius' and each cell is paired with itself and half of its neighbors, so
+    /// every pair is found exactly once. Cells and agents are visited in sorted order, so the
+    /// sums do not depend on anything but the agents themselves. If 'stepping' is not empty only
+    /// agents marked in it get their sums, pairs of two unmarked agents are skipped.
+    void ComputePairInteractions(
+        double radius,
+        const EnvironmentQuery& envQuery,
+        const AgentContainer<GenericAgent>& agents,
+        std::span<const uint8_t> stepping)
+    {
+        const size_t count = agents.size();
+        const auto steps = [stepping](size_t index) {
+            return stepping.empty() || stepping[index] != 0;
+        };
+        _pairInteractions.assign(count, Point{});
+        _pairNeighbors.resize(count);
+        for(auto& neighbors : _pairNeighbors) {
+            neighbors.clear();
+        }
+        _pairWalls.resize(count);
+        _pairCells.clear();
+        // Walls as seen from each agent, the same ones AgentView::WallsNearby() yields. Line of
+        // sight is decided per side with these, as if each agent had queried its neighbors.
+        for(size_t index = 0; index < count; ++index) {
+            const auto origin = agents[index].Position();
+            _pairCells.emplace_back(
+                Grid2DIndex{
+                    static_cast<int32_t>(std::floor(origin.x / radius)),
+                    static_cast<int32_t>(std::floor(origin.y / radius))},
+                index);
+            auto& walls = _pairWalls[index];
+            walls.clear();
+            if(!steps(index)) {
+                continue;
+            }
+            for(const auto& segment : envQuery.LineSegmentsInRange(origin)) {
+                walls.push_back({segment.p1 - origin, segment.p2 - origin});
+            }
+        }
+        std::sort(std::begin(_pairCells), std::end(_pairCells));
+
+        const auto radiusSquared = radius * radius;
+        const auto evaluate = [&](size_t index, size_t other) {
+            // The lower index is the first agent of the pair, as if it had queried the other.
+            if(other < index) {
+                std::swap(index, other);
+            }
+            const auto& first = agents[index];
+            const auto& second = agents[other];
+            const auto origin = first.Position();
+            if(DistanceSquared(second.Position(), origin) > radiusSquared) {
+                return;
+            }
+            const Point relative = second.Position() - origin;
+            const bool firstSees =
+                steps(index) && envQuery.NoGeometryBetween(Point{}, relative, _pairWalls[index]);
+            const bool secondSees =
+                steps(other) && envQuery.NoGeometryBetween(Point{}, -relative, _pairWalls[other]);
+            if(!firstSees && !secondSees) {
+                return;
+            }
+            const auto interaction =
+                _model->ComputePairInteraction(first.state, second.state, relative);
+            if(firstSees) {
+                _pairInteractions[index] += interaction.onFirst;
+                _pairNeighbors[index].push_back({relative, &second.state});
+            }
+            if(secondSees) {
+                _pairInteractions[other] += interaction.onSecond;
+                _pairNeighbors[other].push_back({-relative, &first.state});
+            }
+        };
+
+        // Neighboring cells of which each pair of cells is visited from one side only.
+        constexpr std::array<std::pair<int32_t, int32_t>, 4> halfStencil{
+            {{0, 1}, {1, -1}, {1, 0}, {1, 1}}};
+        const auto cellOrder = [](const auto& entry, const Grid2DIndex& cell) {
+            return entry.first < cell;
+        };
+        for(auto begin = std::begin(_pairCells); begin != std::end(_pairCells);) {
+            const auto cell = begin->first;
+            const auto end = std::find_if(begin, std::end(_pairCells), [cell](const auto& entry) {
+                return !(entry.first == cell);
+            });
+            for(auto first = begin; first != end; ++first) {
+                for(auto second = std::next(first); second != end; ++second) {
+                    evaluate(first->second, second->second);
+                }
+            }
+            for(const auto& [dx, dy] : halfStencil) {
+                const Grid2DIndex neighbor{cell.idx + dx, cell.idy + dy};
+                auto second = std::lower_bound(end, std::end(_pairCells), neighbor, cellOrder);
+                for(; second != std::end(_pairCells) && second->first == neighbor; ++second) {
+                    for(auto first = begin; first != end; ++first) {
+                        evaluate(first->second, second->second);
+                    }
+                }
+            }
+            begin = end;
+        }
+    }
+
+public:
     void ValidateAgent(
         const GenericAgent& agent,
         const NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
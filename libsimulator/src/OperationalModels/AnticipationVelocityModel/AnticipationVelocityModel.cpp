@@ -8,6 +8,7 @@
 #include "OperationalModel.hpp"
 #include "OperationalModelType.hpp"
 #include "Point.hpp"
+#include "RandomStream.hpp"
 #include "SimulationError.hpp"
 
 #include <algorithm>
@@ -18,7 +19,7 @@
 #include <vector>
 
 AnticipationVelocityModel::AnticipationVelocityModel(double pushoutStrength, uint64_t rng_seed)
-    : _pushoutStrength(pushoutStrength), gen(rng_seed)
+    : _pushoutStrength(pushoutStrength), _rngSeed(rng_seed)
 {
 }
 
@@ -36,15 +37,13 @@ Point AnticipationVelocityModel::ComputeNextState(
     auto _w = step.WallsNearby();
     const std::vector<WallView> boundaries(_w.begin(), _w.end());
     // Exclude occluded and self agents
-    auto neighborhood =
-        step.OtherAgentsInRange(_cutOffRadius, [&step, &boundaries](const NeighborView& n) {
-            return step.NoGeometryBetween(n.RelativePosition, boundaries);
-        });
+    auto neighborhood = step.OtherAgentsInSight(_cutOffRadius, boundaries);
 
+    auto rng = step.Random(_rngSeed);
     const auto toNextTarget = step.ToNextTarget();
     Point neighborRepulsion{};
     for(const auto& neighbor : neighborhood) {
-        neighborRepulsion += NeighborRepulsion(currentState, toNextTarget, neighbor);
+        neighborRepulsion += NeighborRepulsion(currentState, toNextTarget, neighbor, rng);
     }
 
     const auto desiredDirection = toNextTarget.Normalized();
@@ -60,7 +59,7 @@ Point AnticipationVelocityModel::ComputeNextState(
         spacing = std::min(spacing, GetSpacing(currentState, neighbor, direction));
     }
 
-    const auto optimal_speed = OptimalSpeed(currentState, spacing, currentState.timeGap);
+    const auto optimal_speed = OptimalSpeed(currentState, spacing, currentState.timeGap, rng);
     // Wall sliding behavior
     direction = HandleWallAvoidance(
         direction,
@@ -173,7 +172,8 @@ void AnticipationVelocityModel::CheckModelConstraint(
 double AnticipationVelocityModel::OptimalSpeed(
     const State& currentState,
     double spacing,
-    double time_gap) const
+    double time_gap,
+    RandomStream& rng) const
 {
     constexpr double creep_speed = 0.01;
 
@@ -181,7 +181,7 @@ double AnticipationVelocityModel::OptimalSpeed(
 
     if(std::abs(speed) < creep_speed) {
         // Random shuffle: forward, backward, or stop
-        const auto r = gen() % 3;
+        const auto r = rng.Below(3);
         speed = (r == 0) ? creep_speed : (r == 1) ? -creep_speed : 0.0;
     }
 
@@ -211,7 +211,8 @@ double AnticipationVelocityModel::GetSpacing(
 
 Point AnticipationVelocityModel::CalculateInfluenceDirection(
     const Point& desiredDirection,
-    const Point& predictedDirection) const
+    const Point& predictedDirection,
+    RandomStream& rng) const
 {
     // Eq. (5)
     const Point orthogonalDirection = Point(-desiredDirection.y, desiredDirection.x).Normalized();
@@ -219,7 +220,7 @@ Point AnticipationVelocityModel::CalculateInfluenceDirection(
     Point influenceDirection = orthogonalDirection;
     if(fabs(alignment) < J_EPS) {
         // Choose a random direction (left or right)
-        if(gen() % 2 == 0) {
+        if(rng.Below(2) == 0) {
             influenceDirection = -orthogonalDirection;
         }
     } else if(alignment > 0) {
@@ -231,7 +232,8 @@ Point AnticipationVelocityModel::CalculateInfluenceDirection(
 Point AnticipationVelocityModel::NeighborRepulsion(
     const State& currentState,
     Point toNextTarget,
-    const NeighborView& neighbor) const
+    const NeighborView& neighbor,
+    RandomStream& rng) const
 {
     const auto& neighborState = std::get<State>(*neighbor.state);
 
@@ -264,7 +266,7 @@ Point AnticipationVelocityModel::NeighborRepulsion(
         distp12 + neighborState.velocity * neighborState.anticipationTime; // e_ij(t+ta)
 
     // Compute adjusted influence direction
-    const auto influenceDirection = CalculateInfluenceDirection(d1, newep12);
+    const auto influenceDirection = CalculateInfluenceDirection(d1, newep12, rng);
     return influenceDirection * interactionStrength;
 }
 
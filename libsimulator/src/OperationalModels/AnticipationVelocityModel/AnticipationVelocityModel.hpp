@@ -9,9 +9,10 @@
 #include <fmt/core.h>
 
 #include <cstdint>
-#include <random>
+#include <memory>
 #include <vector>
 
+class RandomStream;
 struct NeighborView;
 struct WallView;
 
@@ -24,24 +25,34 @@ private:
     /// Add a small outward component to maintain minimum distance from walls.
     double _pushoutStrength{0.3};
     double _cutOffRadius{3};
-    // Shared sequential RNG: draws must stay on the model to keep simulations deterministic.
-    mutable std::mt19937 gen;
+    // Seed of the per agent random streams, see AgentStep::Random.
+    uint64_t _rngSeed;
 
 public:
     AnticipationVelocityModel(double pushoutStrength, uint64_t rng_seed);
     ~AnticipationVelocityModel() override = default;
+    std::unique_ptr<OperationalModel> Clone() const override
+    {
+        return std::make_unique<AnticipationVelocityModel>(*this);
+    }
     OperationalModelType Type() const override;
     Point ComputeNextState(
         const OperationalModelState& current,
         OperationalModelState& next,
         const AgentStep& step) const override;
     void CheckModelConstraint(const GenericAgent& agent, const AgentView& view) const override;
+    double NeighborRadius() const override { return _cutOffRadius; }
 
 private:
-    double OptimalSpeed(const State& currentState, double spacing, double time_gap) const;
+    double OptimalSpeed(
+        const State& currentState,
+        double spacing,
+        double time_gap,
+        RandomStream& rng) const;
     Point CalculateInfluenceDirection(
         const Point& desiredDirection,
-        const Point& predictedDirection) const;
+        const Point& predictedDirection,
+        RandomStream& rng) const;
     double GetSpacing(
         const State& currentState,
         const NeighborView& neighbor,
@@ -49,7 +60,8 @@ private:
     Point NeighborRepulsion(
         const State& currentState,
         Point toNextTarget,
-        const NeighborView& neighbor) const;
+        const NeighborView& neighbor,
+        RandomStream& rng) const;
 
     Point HandleWallAvoidance(
         const Point& direction,
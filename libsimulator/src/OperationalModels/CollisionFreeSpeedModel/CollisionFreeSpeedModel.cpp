@@ -13,17 +13,20 @@
 #include <cmath>
 #include <cstdlib>
 #include <limits>
+#include <span>
 #include <vector>
 
 CollisionFreeSpeedModel::CollisionFreeSpeedModel(
     double strengthNeighborRepulsion_,
     double rangeNeighborRepulsion_,
     double strengthGeometryRepulsion_,
-    double rangeGeometryRepulsion_)
+    double rangeGeometryRepulsion_,
+    bool pairwise_)
     : strengthNeighborRepulsion(strengthNeighborRepulsion_)
     , rangeNeighborRepulsion(rangeNeighborRepulsion_)
     , strengthGeometryRepulsion(strengthGeometryRepulsion_)
     , rangeGeometryRepulsion(rangeGeometryRepulsion_)
+    , _pairwise(pairwise_)
 {
 }
 
@@ -40,14 +43,17 @@ Point CollisionFreeSpeedModel::ComputeNextState(
     const auto& currentState = std::get<State>(current);
     auto _w = step.WallsNearby();
     const std::vector<WallView> boundaries(_w.begin(), _w.end());
-    const auto neighborhood =
-        step.OtherAgentsInRange(_cutOffRadius, [&step, &boundaries](const NeighborView& n) {
-            return step.NoGeometryBetween(n.RelativePosition, boundaries);
-        });
 
-    Point neighborRepulsion{};
-    for(const auto& neighbor : neighborhood) {
-        neighborRepulsion += NeighborRepulsion(currentState, neighbor);
+    // The pair phase hands over the repulsion and the neighbors in sight for the spacing below.
+    std::vector<NeighborView> queried{};
+    std::span<const NeighborView> neighborhood = step.PairNeighbors();
+    Point neighborRepulsion = step.PairInteraction();
+    if(!_pairwise) {
+        queried = step.OtherAgentsInSight(_cutOffRadius, boundaries);
+        neighborhood = queried;
+        for(const auto& neighbor : neighborhood) {
+            neighborRepulsion += NeighborRepulsion(currentState, neighbor);
+        }
     }
 
     Point boundaryRepulsion{};
@@ -114,6 +120,26 @@ void CollisionFreeSpeedModel::CheckModelConstraint(const GenericAgent& agent, co
     }
 }
 
+double CollisionFreeSpeedModel::PairInteractionRadius() const
+{
+    return _pairwise ? _cutOffRadius : 0.0;
+}
+
+PairInteraction CollisionFreeSpeedModel::ComputePairInteraction(
+    const OperationalModelState& first,
+    const OperationalModelState& second,
+    Point relative) const
+{
+    const auto& firstState = std::get<State>(first);
+    const auto& secondState = std::get<State>(second);
+    // NeighborRepulsion from both sides, only the direction changes sign.
+    const auto [distance, direction] = relative.NormAndNormalized();
+    const auto l = firstState.radius + secondState.radius;
+    const auto magnitude =
+        this->strengthNeighborRepulsion * exp((l - distance) / this->rangeNeighborRepulsion);
+    return {direction * -magnitude, direction * magnitude};
+}
+
 double CollisionFreeSpeedModel::OptimalSpeed(
     const State& currentState,
     double spacing,
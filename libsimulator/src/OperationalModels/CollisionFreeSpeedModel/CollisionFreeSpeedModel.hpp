@@ -8,6 +8,8 @@
 
 #include <fmt/core.h>
 
+#include <memory>
+
 struct NeighborView;
 struct WallView;
 
@@ -22,20 +24,34 @@ private:
     double rangeNeighborRepulsion{0.1};
     double strengthGeometryRepulsion{5.0};
     double rangeGeometryRepulsion{0.02};
+    // Evaluate the neighbor repulsion once per pair and step and take the neighbors for the
+    // spacing from the pair phase, see OperationalModel::PairInteractionRadius.
+    bool _pairwise{false};
 
 public:
     CollisionFreeSpeedModel(
         double strengthNeighborRepulsion,
         double rangeNeighborRepulsion,
         double strengthGeometryRepulsion,
-        double rangeGeometryRepulsion);
+        double rangeGeometryRepulsion,
+        bool pairwise = false);
     ~CollisionFreeSpeedModel() override = default;
+    std::unique_ptr<OperationalModel> Clone() const override
+    {
+        return std::make_unique<CollisionFreeSpeedModel>(*this);
+    }
     OperationalModelType Type() const override;
     Point ComputeNextState(
         const OperationalModelState& current,
         OperationalModelState& next,
         const AgentStep& step) const override;
     void CheckModelConstraint(const GenericAgent& agent, const AgentView& view) const override;
+    double NeighborRadius() const override { return _cutOffRadius; }
+    double PairInteractionRadius() const override;
+    PairInteraction ComputePairInteraction(
+        const OperationalModelState& first,
+        const OperationalModelState& second,
+        Point relative) const override;
 
 private:
     double OptimalSpeed(const State& currentState, double spacing, double time_gap) const;
@@ -28,10 +28,7 @@ Point CollisionFreeSpeedModelV2::ComputeNextState(
     const auto& currentState = std::get<State>(current);
     auto _w = step.WallsNearby();
     const std::vector<WallView> boundaries(_w.begin(), _w.end());
-    auto neighborhood =
-        step.OtherAgentsInRange(_cutOffRadius, [&step, &boundaries](const NeighborView& n) {
-            return step.NoGeometryBetween(n.RelativePosition, boundaries);
-        });
+    auto neighborhood = step.OtherAgentsInSight(_cutOffRadius, boundaries);
 
     Point neighborRepulsion{};
     for(const auto& neighbor : neighborhood) {
@@ -73,10 +73,7 @@ Point CollisionFreeSpeedModelV3::ComputeNextState(
     const auto& currentState = std::get<State>(current);
     auto _w = step.WallsNearby();
     const std::vector<WallView> boundaries(_w.begin(), _w.end());
-    auto neighborhood =
-        step.OtherAgentsInRange(_cutOffRadius, [&step, &boundaries](const NeighborView& n) {
-            return step.NoGeometryBetween(n.RelativePosition, boundaries);
-        });
+    auto neighborhood = step.OtherAgentsInSight(_cutOffRadius, boundaries);
 
     Point boundaryRepulsion{};
     for(const auto& wall : boundaries) {
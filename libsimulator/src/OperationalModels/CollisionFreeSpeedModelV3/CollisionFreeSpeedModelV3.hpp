@@ -8,6 +8,8 @@
 
 #include <fmt/core.h>
 
+#include <memory>
+
 struct NeighborView;
 struct WallView;
 
@@ -22,12 +24,17 @@ private:
 public:
     CollisionFreeSpeedModelV3() = default;
     ~CollisionFreeSpeedModelV3() override = default;
+    std::unique_ptr<OperationalModel> Clone() const override
+    {
+        return std::make_unique<CollisionFreeSpeedModelV3>(*this);
+    }
     OperationalModelType Type() const override;
     Point ComputeNextState(
         const OperationalModelState& current,
         OperationalModelState& next,
         const AgentStep& step) const override;
     void CheckModelConstraint(const GenericAgent& agent, const AgentView& view) const override;
+    double NeighborRadius() const override { return _cutOffRadius; }
 
 private:
     double OptimalSpeed(const State& currentState, double spacing, double time_gap) const;
@@ -14,12 +14,13 @@
 ///
 /// Per-agent custom state should be stored in GenericAgent::model as CustomModel::State. In
 /// ComputeNextState(), "next" arrives as an exact copy of "current"; the model overwrites only the
-/// fields it changes and returns how far it wants to move. CustomModel::State stores its payload
-/// in std::any, so model implementations must agree on the concrete stored type and retrieve it
+/// fields it changes and returns how far it wants to move. CustomModel::State type-erases its
+/// payload, so model implementations must agree on the concrete stored type and retrieve it
 /// with the exact typed accessors.
 ///
 /// Payload types must be copy-constructible because GenericAgent values are copied during
-/// simulation queries, e.g. by NeighborhoodSearch.
+/// simulation queries, e.g. by NeighborhoodSearch. Small trivially copyable payloads are copied
+/// with memcpy, see CustomModelState.
 ///
 /// @code
 /// class MyModel : public CustomModel
@@ -37,7 +38,7 @@
 /// @endcode
 ///
 /// @note CustomModel is still abstract. It cannot be instantiated directly.
-/// @warning std::any payloads are type-erased. A mismatched accessor type throws std::bad_any_cast.
+/// @warning Payloads are type-erased. A mismatched accessor type throws std::bad_any_cast.
 class CustomModel : public OperationalModel
 {
 public:
@@ -4,45 +4,170 @@
 #include "FormatAny.hpp"
 
 #include <any>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 
+/// Type-erased per-agent state of a CustomModel.
+///
+/// Trivially copyable payloads of up to 'inlineCapacity' bytes are stored inline and copied with
+/// memcpy, so agents with such states are copied without allocating or calling into the payload.
+/// Models with large or non-trivial per-agent state should keep it in storage of their own and
+/// store a handle here, see OperationalModel::AdoptState. Other payloads are stored on the heap.
 class CustomModelState
 {
-    std::any value{};
-    FormatFn format{};
+public:
+    static constexpr size_t inlineCapacity = 48;
+
+private:
+    template <typename T>
+    static constexpr bool storedInline = std::is_trivially_copyable_v<T> &&
+                                         sizeof(T) <= inlineCapacity &&
+                                         alignof(T) <= alignof(std::max_align_t);
+
+    struct Ops {
+        const std::type_info& type;
+        FormatFn format;
+        // Only set for payloads on the heap.
+        void* (*clone)(const void*);
+        void (*destroy)(void*);
+    };
+
+    template <typename T>
+    static void* clone(const void* value)
+    {
+        return new T(*static_cast<const T*>(value));
+    }
+
+    template <typename T>
+    static void destroy(void* value)
+    {
+        delete static_cast<T*>(value);
+    }
+
+    template <typename T>
+    static constexpr Ops opsFor{
+        typeid(T),
+        makeFormatFn<T>(),
+        storedInline<T> ? nullptr : &clone<T>,
+        storedInline<T> ? nullptr : &destroy<T>};
+
+    alignas(std::max_align_t) std::array<std::byte, inlineCapacity> _inline{};
+    void* _heap{nullptr};
+    const Ops* _ops{nullptr};
 
 public:
     template <typename T>
         requires(!std::is_same_v<std::decay_t<T>, CustomModelState>)
-    explicit CustomModelState(T&& value) : value(std::forward<T>(value)), format(makeFormatFn<T>())
+    explicit CustomModelState(T&& value) : _ops(&opsFor<std::decay_t<T>>)
     {
         using Stored = std::decay_t<T>;
         static_assert(
             std::is_copy_constructible_v<Stored>,
             "CustomModelState payloads must be copy-constructible");
+        if constexpr(storedInline<Stored>) {
+            std::construct_at(reinterpret_cast<Stored*>(_inline.data()), std::forward<T>(value));
+        } else {
+            _heap = new Stored(std::forward<T>(value));
+        }
+    }
+
+    CustomModelState(const CustomModelState& other)
+        : _inline(other._inline)
+        , _heap(other._heap != nullptr ? other._ops->clone(other._heap) : nullptr)
+        , _ops(other._ops)
+    {
+    }
+
+    CustomModelState(CustomModelState&& other) noexcept
+        : _inline(other._inline), _heap(other._heap), _ops(other._ops)
+    {
+        if(other._heap != nullptr) {
+            other._heap = nullptr;
+            other._ops = nullptr;
+        }
+    }
+
+    CustomModelState& operator=(const CustomModelState& other)
+    {
+        if(this != &other) {
+            CustomModelState copy{other};
+            swap(copy);
+        }
+        return *this;
+    }
+
+    CustomModelState& operator=(CustomModelState&& other) noexcept
+    {
+        CustomModelState moved{std::move(other)};
+        swap(moved);
+        return *this;
+    }
+
+    ~CustomModelState()
+    {
+        if(_heap != nullptr) {
+            _ops->destroy(_heap);
+        }
+    }
+
+    /// Whether the payload is of type T.
+    template <typename T>
+    bool Holds() const
+    {
+        return _ops != nullptr && _ops->type == typeid(T);
     }
 
+    /// Throws std::bad_any_cast if the payload is not of type T.
     template <typename T>
     T& Get()
     {
-        return std::any_cast<T&>(value);
+        return *std::launder(static_cast<T*>(payload<T>()));
     }
 
     template <typename T>
     const T& Get() const
     {
-        return std::any_cast<const T&>(value);
+        return *std::launder(static_cast<const T*>(payload<T>()));
     }
 
     template <typename T>
     void Set(T&& newValue)
     {
         using Stored = std::decay_t<T>;
-        std::any_cast<Stored&>(value) = std::forward<T>(newValue);
+        Get<Stored>() = std::forward<T>(newValue);
     }
 
     friend struct fmt::formatter<CustomModelState>;
+
+private:
+    void swap(CustomModelState& other) noexcept
+    {
+        std::swap(_inline, other._inline);
+        std::swap(_heap, other._heap);
+        std::swap(_ops, other._ops);
+    }
+
+    template <typename T>
+    void* payload() const
+    {
+        if(!Holds<T>()) {
+            throw std::bad_any_cast{};
+        }
+        return address();
+    }
+
+    void* address() const
+    {
+        if(_heap != nullptr) {
+            return _heap;
+        }
+        return const_cast<std::byte*>(_inline.data());
+    }
 };
 
 template <>
@@ -51,6 +176,9 @@ struct fmt::formatter<CustomModelState> {
 
     auto format(const CustomModelState& value, fmt::format_context& ctx) const
     {
-        return value.format(value.value, ctx);
+        if(value._ops == nullptr) {
+            return fmt::format_to(ctx.out(), "<moved-from>");
+        }
+        return value._ops->format(value.address(), ctx);
     }
 };
@@ -2,18 +2,18 @@
 #pragma once
 
 /// @file FormatAny.hpp
-/// Helpers for formatting values stored in std::any.
+/// Helpers for formatting type-erased values, see CustomModelState.
 
 #include <fmt/core.h>
 
-#include <any>
 #include <concepts>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <typeinfo>
 
-using FormatFn = fmt::format_context::iterator (*)(const std::any& value, fmt::format_context& ctx);
+using FormatFn = fmt::format_context::iterator (*)(const void* value, fmt::format_context& ctx);
 
 template <typename T>
 concept ToStringResult = std::same_as<std::remove_cvref_t<T>, std::string> ||
@@ -26,23 +26,20 @@ concept HasToString = requires(const T& value) {
 };
 
 template <typename T>
-auto makeFormatFn()
+constexpr auto makeFormatFn()
 {
     using Stored = std::decay_t<T>;
     if constexpr(fmt::formattable<Stored, char>) {
-        return [](const std::any& any, fmt::format_context& ctx) {
-            return fmt::format_to(ctx.out(), "{}", std::any_cast<const Stored&>(any));
+        return [](const void* value, fmt::format_context& ctx) {
+            return fmt::format_to(ctx.out(), "{}", *static_cast<const Stored*>(value));
         };
     } else if constexpr(HasToString<Stored>) {
-        return [](const std::any& any, fmt::format_context& ctx) {
-            const auto& value = std::any_cast<const Stored&>(any);
-            return fmt::format_to(ctx.out(), "{}", value.ToString());
+        return [](const void* value, fmt::format_context& ctx) {
+            return fmt::format_to(ctx.out(), "{}", static_cast<const Stored*>(value)->ToString());
         };
     } else {
-        return [](const std::any& any, fmt::format_context& ctx) {
-            const auto& value = std::any_cast<const Stored&>(any);
-            const auto addr = static_cast<const void*>(std::addressof(value));
-            return fmt::format_to(ctx.out(), "<{}@{}>", any.type().name(), addr);
+        return [](const void* value, fmt::format_context& ctx) {
+            return fmt::format_to(ctx.out(), "<{}@{}>", typeid(Stored).name(), value);
         };
     }
 }
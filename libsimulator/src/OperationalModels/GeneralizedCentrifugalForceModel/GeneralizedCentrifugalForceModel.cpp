@@ -3,6 +3,7 @@
 
 #include "AgentView.hpp"
 #include "Ellipse.hpp"
+#include "EllipseKernel.hpp"
 #include "GenericAgent.hpp"
 #include "Macros.hpp"
 #include "Mathematics.hpp"
@@ -15,6 +16,7 @@
 
 #include <optional>
 #include <stdexcept>
+#include <vector>
 
 GeneralizedCentrifugalForceModel::GeneralizedCentrifugalForceModel(
     double strengthNeighborRepulsion_,
@@ -36,6 +38,18 @@ GeneralizedCentrifugalForceModel::GeneralizedCentrifugalForceModel(
 {
 }
 
+namespace
+{
+/// The agent's ellipse for this step.
+EllipseShape shapeOf(const GeneralizedCentrifugalForceModelState& state)
+{
+    const Ellipse ellipse{state.Av, state.AMin, state.BMax, state.BMin};
+    // Avoid division by zero by setting scale to 1 when v0 is 0
+    const double scale = (state.v0 == 0.0) ? 1.0 : state.speed / state.v0;
+    return {ellipse, scale, state.speed, state.orientation};
+}
+} // namespace
+
 OperationalModelType GeneralizedCentrifugalForceModel::Type() const
 {
     return OperationalModelType::GENERALIZED_CENTRIFUGAL_FORCE;
@@ -49,13 +63,24 @@ Point GeneralizedCentrifugalForceModel::ComputeNextState(
     const auto& currentState = std::get<State>(current);
     auto _w = step.WallsNearby();
     const std::vector<WallView> boundaries(_w.begin(), _w.end());
-    const auto neighborhood =
-        step.OtherAgentsInRange(_cutOffRadius, [&step, &boundaries](const NeighborView& n) {
-            return step.NoGeometryBetween(n.RelativePosition, boundaries);
-        });
-    Point F_rep;
+    const auto neighborhood = step.OtherAgentsInSight(_cutOffRadius, boundaries);
+    // The own ellipse is the same for all pairs, the effective distances to all neighbors are
+    // computed in one pass. The buffers are reused by all agents a thread steps, so they only
+    // allocate until they have grown to the largest neighborhood.
+    const auto shape = shapeOf(currentState);
+    thread_local EllipseBatch neighborShapes{};
+    thread_local std::vector<double> distances{};
+    neighborShapes.Clear();
+    neighborShapes.Reserve(neighborhood.size());
     for(const auto& neighbor : neighborhood) {
-        F_rep += ForceRepPed(currentState, neighbor);
+        neighborShapes.Push(neighbor.RelativePosition, shapeOf(std::get<State>(*neighbor.state)));
+    }
+    distances.resize(neighborhood.size());
+    neighborShapes.EffectiveDistances(shape, distances);
+
+    Point F_rep;
+    for(size_t index = 0; index < neighborhood.size(); ++index) {
+        F_rep += ForceRepPed(currentState, neighborhood[index], distances[index]);
     }
 
     // ForceDriv leaves e0 untouched when the agent has practically arrived; the default
@@ -64,7 +89,7 @@ Point GeneralizedCentrifugalForceModel::ComputeNextState(
     // repulsive forces to the walls and transitions that are not my target
     Point repwall{};
     for(const auto& wall : boundaries) {
-        repwall += ForceRepWall(currentState, wall);
+        repwall += ForceRepWall(currentState, shape, wall);
     }
 
     const Point fd = ForceDriv(
@@ -181,7 +206,8 @@ Point GeneralizedCentrifugalForceModel::ForceDriv(
 
 Point GeneralizedCentrifugalForceModel::ForceRepPed(
     const State& currentState,
-    const NeighborView& neighbor) const
+    const NeighborView& neighbor,
+    double dist_eff) const
 {
     const auto& neighborState = std::get<State>(*neighbor.state);
     Point F_rep;
@@ -195,7 +221,6 @@ Point GeneralizedCentrifugalForceModel::ForceRepPed(
     double K_ij;
     double nom; // nominator of Frep
     double px; // hermite Interpolation value
-    const auto dist_eff = AgentToAgentSpacing(currentState, neighbor);
     const auto agent1_mass = currentState.mass;
 
     //          smax    dist_intpol_left      dist_intpol_right       dist_eff_max
@@ -292,6 +317,7 @@ Point GeneralizedCentrifugalForceModel::ForceRepPed(
 
 inline Point GeneralizedCentrifugalForceModel::ForceRepWall(
     const State& currentState,
+    const EllipseShape& shape,
     const WallView& wall) const
 {
     Point F = Point(0.0, 0.0);
@@ -309,7 +335,7 @@ inline Point GeneralizedCentrifugalForceModel::ForceRepWall(
     double vn = w.NormalComp(
         currentState.orientation *
         currentState.speed); // normal component of the velocity on the wall
-    F = ForceRepStatPoint(currentState, wall.closest_point, mind, vn);
+    F = ForceRepStatPoint(currentState, shape, wall.closest_point, mind, vn);
 
     return F; // line --> l != 0
 }
@@ -326,6 +352,7 @@ inline Point GeneralizedCentrifugalForceModel::ForceRepWall(
 // TODO: use effective DistanceToEllipse and simplify this function.
 Point GeneralizedCentrifugalForceModel::ForceRepStatPoint(
     const State& currentState,
+    const EllipseShape& shape,
     const Point& p,
     double l,
     double vn) const
@@ -340,9 +367,6 @@ Point GeneralizedCentrifugalForceModel::ForceRepStatPoint(
 
     double tmp;
     double bla;
-    Point r;
-    Point pinE; // vorher x1, y1
-    const Ellipse E{currentState.Av, currentState.AMin, currentState.BMax, currentState.BMin};
 
     if(d < J_EPS)
         return Point(0.0, 0.0);
@@ -355,13 +379,9 @@ Point GeneralizedCentrifugalForceModel::ForceRepStatPoint(
         return Point(0.0, 0.0);
     double K_ij;
     K_ij = 0.5 * bla / v.Norm(); // K_ij
-    // Punkt auf der Ellipse
-    pinE = p.TransformToEllipseCoordinates(
-        Point{}, currentState.orientation.x, currentState.orientation.y);
     const auto v0 = currentState.v0;
     // Punkt auf der Ellipse
-    r = E.PointOnEllipse(
-        pinE, currentState.speed / v0, Point{}, currentState.speed, currentState.orientation);
+    const Point r = shape.BoundaryTowards(p);
     // interpolierte Kraft
     F_rep = ForceInterpolation(v0, K_ij, e_ij, vn, d, r.Norm(), l);
     return F_rep;
@@ -428,25 +448,10 @@ double GeneralizedCentrifugalForceModel::AgentToAgentSpacing(
     const State& currentState,
     const NeighborView& neighbor) const
 {
-    const auto& neighborState = std::get<State>(*neighbor.state);
-    const Ellipse E1{currentState.Av, currentState.AMin, currentState.BMax, currentState.BMin};
-    const Ellipse E2{neighborState.Av, neighborState.AMin, neighborState.BMax, neighborState.BMin};
-    const auto v0_1 = currentState.v0;
-    const auto v0_2 = neighborState.v0;
-    // Avoid division by zero by setting scale to 1 when v0 is 0
-    const double scale1 = (v0_1 == 0.0) ? 1.0 : currentState.speed / v0_1;
-    const double scale2 = (v0_2 == 0.0) ? 1.0 : neighborState.speed / v0_2;
-
     // The ellipse distance is translation invariant, so we evaluate it in the frame of the
     // agent that asked, which sits at the origin.
-    return E1.EffectiveDistanceToEllipse(
-        E2,
-        Point{0.0, 0.0},
-        neighbor.RelativePosition,
-        scale1,
-        scale2,
-        currentState.speed,
-        neighborState.speed,
-        currentState.orientation,
-        neighborState.orientation);
+    return EffectiveDistance(
+        shapeOf(currentState),
+        shapeOf(std::get<State>(*neighbor.state)),
+        neighbor.RelativePosition);
 }
@@ -7,6 +7,9 @@
 
 #include <fmt/core.h>
 
+#include <memory>
+
+struct EllipseShape;
 struct NeighborView;
 struct WallView;
 
@@ -37,6 +40,10 @@ public:
         double maxNeighborRepulsionForce,
         double maxGeometryRepulsionForce);
     ~GeneralizedCentrifugalForceModel() override = default;
+    std::unique_ptr<OperationalModel> Clone() const override
+    {
+        return std::make_unique<GeneralizedCentrifugalForceModel>(*this);
+    }
 
     OperationalModelType Type() const override;
     Point ComputeNextState(
@@ -44,6 +51,7 @@ public:
         OperationalModelState& next,
         const AgentStep& step) const override;
     void CheckModelConstraint(const GenericAgent& agent, const AgentView& view) const override;
+    double NeighborRadius() const override { return _cutOffRadius; }
 
 private:
     /**
@@ -67,16 +75,24 @@ private:
      *
      * @param self State of the pedestrian the force acts on
      * @param neighbor The other pedestrian, seen from the first one
+     * @param dist_eff Effective distance between both ellipses, see EffectiveDistance
      *
      * @return Point
      */
-    Point ForceRepPed(const State& currentState, const NeighborView& neighbor) const;
+    Point ForceRepPed(const State& currentState, const NeighborView& neighbor, double dist_eff)
+        const;
     /**
      * Sum of the repulsive forces of all walls surrounding the pedestrian.
      * @see ForceRepWall
      */
-    Point ForceRepWall(const State& currentState, const WallView& wall) const;
-    Point ForceRepStatPoint(const State& currentState, const Point& p, double l, double vn) const;
+    Point
+    ForceRepWall(const State& currentState, const EllipseShape& shape, const WallView& wall) const;
+    Point ForceRepStatPoint(
+        const State& currentState,
+        const EllipseShape& shape,
+        const Point& p,
+        double l,
+        double vn) const;
     Point ForceInterpolation(
         double v0,
         double K_ij,
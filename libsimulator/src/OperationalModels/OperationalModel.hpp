@@ -8,12 +8,22 @@
 
 #include <fmt/core.h>
 
+#include <memory>
+#include <span>
 #include <string>
 
+class AgentBatch;
 class AgentStep;
 class AgentView;
 struct GenericAgent;
 
+/// Result of OperationalModel::ComputePairInteraction, what each agent of the pair contributes to
+/// the other one.
+struct PairInteraction {
+    Point onFirst{};
+    Point onSecond{};
+};
+
 template <typename T>
 void validateConstraint(
     T value,
@@ -66,4 +76,61 @@ public:
         const AgentStep& step) const = 0;
 
     virtual void CheckModelConstraint(const GenericAgent& agent, const AgentView& view) const = 0;
+
+    /// Whether the model advances all agents of a step in one call to ComputeNextStates instead
+    /// of one call to ComputeNextState per agent. Meant for models with a high per call cost,
+    /// e.g. models implemented in Python.
+    virtual bool SupportsBatchStep() const { return false; }
+
+    /// Batch counterpart of ComputeNextState. 'next' and 'movements' hold one entry per agent of
+    /// 'batch', entries of agents that do not step in this batch are ignored. "next" arrives as
+    /// exact copies of the current states, 'movements' as zero.
+    virtual void ComputeNextStates(
+        const AgentBatch& /*batch*/,
+        std::span<OperationalModelState* const> /*next*/,
+        std::span<Point> /*movements*/) const
+    {
+        throw SimulationError(
+            "Operational model {} does not support batch steps", ToString(Type()));
+    }
+
+    /// Largest radius ComputeNextState queries neighbors in. Verlet lists are built for this
+    /// radius, a model returning 0 cannot use them.
+    virtual double NeighborRadius() const { return 0.0; }
+
+    /// Optional pair phase for models whose agent interaction is a sum of pair terms. A model
+    /// returning a radius > 0 gets ComputePairInteraction called once per step for every
+    /// unordered pair of agents within that radius instead of evaluating each pair from both
+    /// sides. A pair term only counts for an agent that has line of sight to the other one, like
+    /// AgentView::NoGeometryBetween decides it. The sum per agent is passed to
+    /// ComputeNextState as AgentStep::PairInteraction().
+    virtual double PairInteractionRadius() const { return 0.0; }
+
+    /// Interaction of the agents with states 'first' and 'second', where 'relative' is the
+    /// position of the second agent relative to the first one.
+    virtual PairInteraction ComputePairInteraction(
+        const OperationalModelState& /*first*/,
+        const OperationalModelState& /*second*/,
+        Point /*relative*/) const
+    {
+        return {};
+    }
+
+    /// Hooks for models that keep per agent state in storage of their own, so that agents only
+    /// carry a handle to it that is cheap to copy. AdoptState is called for every agent that
+    /// joins the simulation once it passed validation, and may replace its state with a handle.
+    /// ReleaseState is called for every agent that leaves the simulation. CommitStates is called
+    /// after every step, or sub-step with multi-rate stepping, once all agents got their next
+    /// state; a model that defers writing next states to its storage until then keeps them
+    /// invisible to agents that step later in the same step.
+    virtual void AdoptState(OperationalModelState& /*state*/) {}
+    virtual void ReleaseState(const OperationalModelState& /*state*/) {}
+    virtual void CommitStates() {}
+
+    /// Returns an independent copy of this model including its internal state. Used to fork
+    /// simulations. Models that cannot be copied keep the default, which throws.
+    virtual std::unique_ptr<OperationalModel> Clone() const
+    {
+        throw SimulationError("Operational model {} cannot be cloned", ToString(Type()));
+    }
 };
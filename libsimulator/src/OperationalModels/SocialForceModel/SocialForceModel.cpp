@@ -11,8 +11,8 @@
 #include <cmath>
 #include <string>
 
-SocialForceModel::SocialForceModel(double bodyForce, double friction)
-    : bodyForce(bodyForce), friction(friction)
+SocialForceModel::SocialForceModel(double bodyForce, double friction, bool pairwise)
+    : bodyForce(bodyForce), friction(friction), _pairwise(pairwise)
 {
 }
 
@@ -31,13 +31,14 @@ Point SocialForceModel::ComputeNextState(
 
     auto _w = step.WallsNearby();
     const std::vector<WallView> boundaries(_w.begin(), _w.end());
-    auto neighborhood =
-        step.OtherAgentsInRange(_cutOffRadius, [&step, &boundaries](const NeighborView& n) {
-            return step.NoGeometryBetween(n.RelativePosition, boundaries);
-        });
     Point F_rep;
-    for(const auto& neighbor : neighborhood) {
-        F_rep += AgentForce(currentState, neighbor);
+    if(_pairwise) {
+        F_rep = step.PairInteraction();
+    } else {
+        auto neighborhood = step.OtherAgentsInSight(_cutOffRadius, boundaries);
+        for(const auto& neighbor : neighborhood) {
+            F_rep += AgentForce(currentState, neighbor);
+        }
     }
     forces += F_rep / currentState.mass;
     Point obstacle_f{};
@@ -104,6 +105,49 @@ void SocialForceModel::CheckModelConstraint(const GenericAgent& agent, const Age
     }
 }
 
+double SocialForceModel::PairInteractionRadius() const
+{
+    return _pairwise ? _cutOffRadius : 0.0;
+}
+
+PairInteraction SocialForceModel::ComputePairInteraction(
+    const OperationalModelState& first,
+    const OperationalModelState& second,
+    Point relative) const
+{
+    const auto& firstState = std::get<State>(first);
+    const auto& secondState = std::get<State>(second);
+
+    // AgentForce from both sides: separation, normal and tangent only change sign, so do body
+    // force and friction. Only the exponential push uses each agent's own scale and distance.
+    const double total_radius = firstState.radius + secondState.radius;
+    const Point separation = -relative;
+    const double dist = separation.Norm();
+    const Point n_ij = separation.Normalized();
+    const Point tangent = n_ij.Rotate90Deg();
+    double contact_force_length = 0;
+    double friction_force_length = 0;
+    if(dist < total_radius) {
+        const Point velocity = secondState.velocity - firstState.velocity;
+        contact_force_length = bodyForce * (total_radius - dist);
+        friction_force_length =
+            friction * (total_radius - dist) * (velocity.ScalarProduct(tangent));
+    }
+    const double push_first =
+        PushingForceLength(firstState.agentScale, firstState.forceDistance, total_radius, dist) +
+        contact_force_length;
+    const double push_second =
+        (secondState.agentScale == firstState.agentScale &&
+         secondState.forceDistance == firstState.forceDistance) ?
+            push_first :
+            PushingForceLength(
+                secondState.agentScale, secondState.forceDistance, total_radius, dist) +
+                contact_force_length;
+    return {
+        n_ij * push_first + tangent * friction_force_length,
+        n_ij * -push_second + tangent * -friction_force_length};
+}
+
 Point SocialForceModel::DrivingForce(const State& currentState, Point ToNextTarget)
 {
     const Point e0 = ToNextTarget.Normalized();
@@ -8,6 +8,8 @@
 
 #include <fmt/core.h>
 
+#include <memory>
+
 struct NeighborView;
 struct WallView;
 
@@ -20,16 +22,28 @@ private:
     double _cutOffRadius{2.5};
     double bodyForce{120000}; // k
     double friction{240000}; // kappa
+    // Evaluate each pair of agents once per step, see OperationalModel::PairInteractionRadius.
+    bool _pairwise{false};
 
 public:
-    SocialForceModel(double bodyForce, double friction);
+    SocialForceModel(double bodyForce, double friction, bool pairwise = false);
     ~SocialForceModel() override = default;
+    std::unique_ptr<OperationalModel> Clone() const override
+    {
+        return std::make_unique<SocialForceModel>(*this);
+    }
     OperationalModelType Type() const override;
     Point ComputeNextState(
         const OperationalModelState& current,
         OperationalModelState& next,
         const AgentStep& step) const override;
     void CheckModelConstraint(const GenericAgent& agent, const AgentView& view) const override;
+    double NeighborRadius() const override { return _cutOffRadius; }
+    double PairInteractionRadius() const override;
+    PairInteraction ComputePairInteraction(
+        const OperationalModelState& first,
+        const OperationalModelState& second,
+        Point relative) const override;
 
 private:
     /**
@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "Point.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <vector>
+
+/// Intrinsic Field convolution and sample warping kernel of WarpDriverModel, see
+/// WarpDriverModel.cpp for the model itself.
+namespace warp_driver
+{
+/// I(ρ) = ∫_{|q|≤1} exp(-|p - q|² / 2σ²) dq for |p| = ρ, the Gaussian convolved with the unit
+/// disk. Integrating along q.y in closed form and substituting q.x = sin θ leaves the smooth
+/// 1-D integral
+///   I(ρ) = σ√(2π) ∫_{-π/2}^{π/2} cos θ · erf(cos θ / σ√2) · exp(-(ρ - sin θ)² / 2σ²) dθ
+/// Its nodes and weights do not depend on ρ, evaluating I costs one exp per node.
+class DiskConvolution
+{
+    double _invTwoSigmaSquared;
+    std::vector<double> _sinTheta{};
+    std::vector<double> _weight{};
+
+public:
+    explicit DiskConvolution(double sigma) : _invTwoSigmaSquared(1.0 / (2.0 * sigma * sigma))
+    {
+        // Composite Simpson rule. The integrand narrows with sigma, 8 / sigma intervals keep the
+        // error of the normalized field below 1e-12.
+        const int intervals = 2 * std::max(32, static_cast<int>(std::ceil(4.0 / sigma)));
+        const double h = std::numbers::pi / intervals;
+        const double scale = sigma * std::sqrt(2.0 * std::numbers::pi) * h / 3.0;
+        _sinTheta.reserve(intervals + 1);
+        _weight.reserve(intervals + 1);
+        for(int k = 0; k <= intervals; ++k) {
+            const double theta = -std::numbers::pi / 2 + k * h;
+            const double simpson = (k == 0 || k == intervals) ? 1.0 : (k % 2 == 1 ? 4.0 : 2.0);
+            const double cosTheta = std::cos(theta);
+            _sinTheta.push_back(std::sin(theta));
+            _weight.push_back(
+                simpson * scale * cosTheta * std::erf(cosTheta / (sigma * std::numbers::sqrt2)));
+        }
+    }
+
+    double operator()(double rho) const
+    {
+        double sum = 0.0;
+        for(size_t k = 0; k < _weight.size(); ++k) {
+            const double d = rho - _sinTheta[k];
+            sum += _weight[k] * std::exp(-d * d * _invTwoSigmaSquared);
+        }
+        return sum;
+    }
+};
+
+// The composed warp from a's frame into b's Intrinsic Field space is
+//   W_local -> W_v -> W_r -> W_tu -> W_vu, followed by the W_th time normalization.
+// All factors that depend on the neighbor only (rotation, offset, speed, Minkowski radius) are
+// collected once per (agent, neighbor) pair. All factors that depend on the sample only (time
+// uncertainty scale, probability scale, time validity) are collected once per agent and step.
+
+// Per (agent, neighbor) constants.
+struct NeighborWarp {
+    // W_local: rotation from a's frame into b's frame, R_b^T * R_a, and b's position in b's frame.
+    double cosAB;
+    double sinAB;
+    double offsetX;
+    double offsetY;
+    // W_v: velocity shear, x' = x - speed_b * t
+    double speedB;
+    // W_r: radius scaling (B.7), W_r(s) = s ★ (1/α, 1/α, 1).
+    double invRadius;
+};
+
+inline NeighborWarp
+MakeNeighborWarp(Point relPosB, Point orientA, Point orientB, double speedB, double radiusB)
+{
+    const double cosA = orientA.x;
+    const double sinA = orientA.y;
+    const double cosB = orientB.x;
+    const double sinB = orientB.y;
+    return NeighborWarp{
+        .cosAB = cosA * cosB + sinA * sinB,
+        .sinAB = sinA * cosB - cosA * sinB,
+        .offsetX = cosB * relPosB.x + sinB * relPosB.y,
+        .offsetY = -sinB * relPosB.x + cosB * relPosB.y,
+        .speedB = speedB,
+        .invRadius = 1.0 / std::max(radiusB, 1e-6)};
+}
+
+// B.13: β₁ = 1/(1 + α₁·v/v_pref), β₂ = 1 + α₂·v/v_pref.
+// Since we use v0 for both current and preferred speed, v/v_pref = 1.
+struct VelocityUncertaintyScale {
+    double beta1;
+    double beta2;
+};
+
+inline VelocityUncertaintyScale VelocityUncertaintyFactors(double uncertaintyX, double uncertaintyY)
+{
+    return {1.0 / (1.0 + uncertaintyX), 1.0 + uncertaintyY};
+}
+
+// Trajectory samples in structure of arrays layout. The per neighbor passes in
+// AccumulateNeighbor run over these as independent lanes without branches, which lets the
+// compiler vectorise them.
+class SampleLanes
+{
+    std::vector<double> _storage;
+    size_t _count;
+
+    std::span<double> column(size_t index)
+    {
+        return std::span<double>(_storage).subspan(index * _count, _count);
+    }
+
+public:
+    explicit SampleLanes(size_t count) : _storage(count * 14, 0.0), _count(count) {}
+
+    size_t Count() const { return _count; }
+
+    // Sample position in a's frame
+    std::span<double> x() { return column(0); }
+    std::span<double> y() { return column(1); }
+    std::span<double> t() { return column(2); }
+    // W_tu: time uncertainty, (x, y) scaled by β = 1/(1 + λt)
+    std::span<double> timeScale() { return column(3); }
+    // B.5 + B.14: W_tu^-1(p) = p·β², W_vu^-1(p) = p·β₁·β₂, times 1 for samples inside the
+    // time horizon (W_th) and 0 otherwise.
+    std::span<double> probabilityScale() { return column(4); }
+    // Combined probability and gradient over all neighbors processed so far
+    std::span<double> pTotal() { return column(5); }
+    std::span<double> gradX() { return column(6); }
+    std::span<double> gradY() { return column(7); }
+    std::span<double> gradT() { return column(8); }
+    // Scratch for one neighbor: coordinates at the input of W_tu and the field lookup
+    std::span<double> u() { return column(9); }
+    std::span<double> w() { return column(10); }
+    std::span<double> fieldValue() { return column(11); }
+    std::span<double> fieldGradX() { return column(12); }
+    std::span<double> fieldGradY() { return column(13); }
+};
+
+// Warps all samples into the Intrinsic Field space of one neighbor and unites the collision
+// probability found there, and its gradient in a's frame, with the totals in 'lanes'. 'Field'
+// provides Sample(x, y) -> (value, gradient) like WarpDriverModel's tabulated field.
+template <typename Field>
+void AccumulateNeighbor(
+    SampleLanes& lanes,
+    const NeighborWarp& nb,
+    const Field& field,
+    VelocityUncertaintyScale vu,
+    double lambda)
+{
+    const size_t count = lanes.Count();
+    const auto x = lanes.x();
+    const auto y = lanes.y();
+    const auto t = lanes.t();
+    const auto timeScale = lanes.timeScale();
+    const auto probabilityScale = lanes.probabilityScale();
+    const auto u = lanes.u();
+    const auto w = lanes.w();
+    const auto fieldValue = lanes.fieldValue();
+    const auto fieldGradX = lanes.fieldGradX();
+    const auto fieldGradY = lanes.fieldGradY();
+
+    // W_local -> W_v -> W_r
+    for(size_t i = 0; i < count; ++i) {
+        const double bx = nb.cosAB * x[i] - nb.sinAB * y[i] - nb.offsetX - nb.speedB * t[i];
+        const double by = nb.sinAB * x[i] + nb.cosAB * y[i] - nb.offsetY;
+        u[i] = bx * nb.invRadius;
+        w[i] = by * nb.invRadius;
+    }
+
+    // W_tu -> W_vu and the Intrinsic Field lookup, the only gather in the kernel
+    for(size_t i = 0; i < count; ++i) {
+        const auto [value, grad] =
+            field.Sample(u[i] * timeScale[i] * vu.beta1, w[i] * timeScale[i] * vu.beta2);
+        fieldValue[i] = value;
+        fieldGradX[i] = grad.x;
+        fieldGradY[i] = grad.y;
+    }
+
+    // Probability scaling, inverse gradient transform and union with the other neighbors
+    const auto pTotal = lanes.pTotal();
+    const auto gradX = lanes.gradX();
+    const auto gradY = lanes.gradY();
+    const auto gradT = lanes.gradT();
+    for(size_t i = 0; i < count; ++i) {
+        const double pScaled = fieldValue[i] * probabilityScale[i];
+        // Negligible contributions are masked instead of skipped to keep the loop branch free.
+        const double keep = pScaled < 1e-12 ? 0.0 : 1.0;
+        const double pB = pScaled * keep;
+
+        // W_vu^-1 (B.15): J_vu = diag(β₁, β₂, 1)
+        const double gx0 = fieldGradX[i] * vu.beta1;
+        const double gy0 = fieldGradY[i] * vu.beta2;
+        // W_tu^-1 (B.6): spatial gradient scaled by β, temporal gets cross-terms from the
+        // coordinates at the input of W_tu. dI/dt = 0 in field space.
+        const double beta = timeScale[i];
+        const double gamma = -lambda * beta * beta;
+        double gt = gamma * u[i] * gx0 + gamma * w[i] * gy0;
+        const double gx1 = gx0 * beta;
+        const double gy1 = gy0 * beta;
+        // W_r^-1: identity (B.9). W_v^-1 (B.12): g + (0, 0, -v·g.x).
+        gt -= nb.speedB * gx1;
+        // W_local^-1: rotate from b's frame back to a's frame
+        const double gbx = (nb.cosAB * gx1 + nb.sinAB * gy1) * keep;
+        const double gby = (-nb.sinAB * gx1 + nb.cosAB * gy1) * keep;
+        const double gbt = gt * keep;
+
+        // Union formula: p_new = p + pB - p * pB
+        const double pOld = pTotal[i];
+        pTotal[i] = pOld + pB - pOld * pB;
+        gradX[i] = gradX[i] + gbx - pOld * gbx - pB * gradX[i];
+        gradY[i] = gradY[i] + gby - pOld * gby - pB * gradY[i];
+        gradT[i] = gradT[i] + gbt - pOld * gbt - pB * gradT[i];
+    }
+}
+
+} // namespace warp_driver
@@ -31,11 +31,18 @@
 #include "GenericAgent.hpp"
 #include "OperationalModelType.hpp"
 #include "Point.hpp"
+#include "RandomStream.hpp"
 #include "SimulationError.hpp"
+#include "WarpDriverKernel.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <map>
+#include <mutex>
 #include <variant>
+#include <vector>
 
 // ============================================================================
 // IntrinsicField
@@ -45,34 +52,55 @@ void WarpDriverModel::IntrinsicField::Compute(double sigma)
 {
     nx = static_cast<int>(std::round((xMax - xMin) / dx)) + 1;
     ny = static_cast<int>(std::round((yMax - yMin) / dy)) + 1;
-    values.resize(static_cast<size_t>(nx * ny), 0.0);
-    gradients.resize(static_cast<size_t>(nx * ny), Point{0.0, 0.0});
 
-    const double sigma_squared = sigma * sigma;
+    // Parameter sweeps construct many models with few distinct sigmas. Fields are kept per sigma
+    // and grid, the least recently used one is evicted when the cache is full. Models hold their
+    // own reference, so evicting one never invalidates a table.
+    using Key = std::array<double, 7>;
+    struct CachedField {
+        std::shared_ptr<const std::vector<Entry>> table;
+        uint64_t lastUse;
+    };
+    constexpr size_t maxCachedFields = 64;
+    static std::mutex mutex;
+    static std::map<Key, CachedField> cache;
+    static uint64_t useCount = 0;
 
-    // Compute I(x,y) = (f * g)(x,y) where g = unit disk, f = Gaussian(sigma).
-    // For each grid point, numerically integrate the convolution over the disk.
-    const double integrationStep = 0.05;
-    const double integrationRadius = 1.0; // unit disk support
+    const Key key{sigma, xMin, xMax, yMin, yMax, dx, dy};
+    {
+        const std::lock_guard lock(mutex);
+        if(const auto iter = cache.find(key); iter != std::end(cache)) {
+            iter->second.lastUse = ++useCount;
+            table = iter->second.table;
+            return;
+        }
+    }
+    auto computed = std::make_shared<const std::vector<Entry>>(Tabulate(sigma));
+    const std::lock_guard lock(mutex);
+    if(cache.size() >= maxCachedFields && !cache.contains(key)) {
+        const auto leastRecentlyUsed = std::min_element(
+            std::begin(cache), std::end(cache), [](const auto& a, const auto& b) {
+                return a.second.lastUse < b.second.lastUse;
+            });
+        cache.erase(leastRecentlyUsed);
+    }
+    auto& cached = cache.try_emplace(key, CachedField{std::move(computed), 0}).first->second;
+    cached.lastUse = ++useCount;
+    table = cached.table;
+}
 
+std::vector<WarpDriverModel::IntrinsicField::Entry>
+WarpDriverModel::IntrinsicField::Tabulate(double sigma) const
+{
+    // I(x,y) = (f * g)(x,y) with g = unit disk, f = Gaussian(sigma) only depends on the distance
+    // to the origin.
+    const warp_driver::DiskConvolution convolution(sigma);
+    std::vector<double> values(static_cast<size_t>(nx * ny), 0.0);
     for(int ix = 0; ix < nx; ++ix) {
         for(int iy = 0; iy < ny; ++iy) {
             const double px = xMin + ix * dx;
             const double py = yMin + iy * dy;
-
-            double val = 0.0;
-            // Integrate f(px-u, py-v) * g(u,v) du dv over g's support (unit disk)
-            for(double u = -integrationRadius; u <= integrationRadius; u += integrationStep) {
-                for(double v = -integrationRadius; v <= integrationRadius; v += integrationStep) {
-                    if(u * u + v * v <= 1.0) {
-                        double dx2 = px - u;
-                        double dy2 = py - v;
-                        val += std::exp(-(dx2 * dx2 + dy2 * dy2) / (2.0 * sigma_squared));
-                    }
-                }
-            }
-            val *= integrationStep * integrationStep;
-            values[static_cast<size_t>(ix * ny + iy)] = val;
+            values[static_cast<size_t>(ix * ny + iy)] = convolution(std::hypot(px, py));
         }
     }
 
@@ -85,6 +113,7 @@ void WarpDriverModel::IntrinsicField::Compute(double sigma)
     }
 
     // Compute gradients via central differences
+    std::vector<Entry> entries(values.size());
     for(int ix = 0; ix < nx; ++ix) {
         for(int iy = 0; iy < ny; ++iy) {
             double dIdx = 0.0;
@@ -99,9 +128,11 @@ void WarpDriverModel::IntrinsicField::Compute(double sigma)
                         values[static_cast<size_t>(ix * ny + (iy - 1))]) /
                        (2.0 * dy);
             }
-            gradients[static_cast<size_t>(ix * ny + iy)] = Point{dIdx, dIdy};
+            entries[static_cast<size_t>(ix * ny + iy)] =
+                Entry{values[static_cast<size_t>(ix * ny + iy)], dIdx, dIdy};
         }
     }
+    return entries;
 }
 
 std::pair<double, Point> WarpDriverModel::IntrinsicField::Sample(double x, double y) const
@@ -117,200 +148,34 @@ std::pair<double, Point> WarpDriverModel::IntrinsicField::Sample(double x, doubl
     const double sx = fx - ix;
     const double sy = fy - iy;
 
-    const auto idx = [&](int i, int j) -> size_t { return static_cast<size_t>(i * ny + j); };
-
-    // Bilinear interpolation
-    const double v00 = values[idx(ix, iy)];
-    const double v10 = values[idx(ix + 1, iy)];
-    const double v01 = values[idx(ix, iy + 1)];
-    const double v11 = values[idx(ix + 1, iy + 1)];
-    const double val =
-        v00 * (1 - sx) * (1 - sy) + v10 * sx * (1 - sy) + v01 * (1 - sx) * sy + v11 * sx * sy;
-
-    const Point g00 = gradients[idx(ix, iy)];
-    const Point g10 = gradients[idx(ix + 1, iy)];
-    const Point g01 = gradients[idx(ix, iy + 1)];
-    const Point g11 = gradients[idx(ix + 1, iy + 1)];
-    const Point grad = g00 * ((1 - sx) * (1 - sy)) + g10 * (sx * (1 - sy)) + g01 * ((1 - sx) * sy) +
-                       g11 * (sx * sy);
-
-    return {val, grad};
+    const auto w00 = (1 - sx) * (1 - sy);
+    const auto w10 = sx * (1 - sy);
+    const auto w01 = (1 - sx) * sy;
+    const auto w11 = sx * sy;
+
+    // Bilinear interpolation, (ix, iy) and (ix, iy + 1) are adjacent in the table.
+    const auto* atIx = table->data() + static_cast<size_t>(ix * ny + iy);
+    const auto* atNextIx = atIx + ny;
+    const auto interpolate = [&](double Entry::*member) {
+        return atIx[0].*member * w00 + atNextIx[0].*member * w10 + atIx[1].*member * w01 +
+               atNextIx[1].*member * w11;
+    };
+    return {
+        interpolate(&Entry::value),
+        Point{interpolate(&Entry::gradX), interpolate(&Entry::gradY)}};
 }
 
 // ============================================================================
-// Warp Operators
+// Warp Operators, see WarpDriverKernel.hpp
 // ============================================================================
 
 namespace
 {
-
 using STP = WarpDriverModel::SpaceTimePoint;
-
-// W_local: change of reference frame from agent a to agent b. Everything is expressed
-// relative to a, so a sits at the origin and b at 'relPosB'.
-STP WarpLocalForward(const STP& s, Point relPosB, Point orientA, Point orientB)
-{
-    // Rotate from a's frame to the axis aligned frame around a
-    const double cosA = orientA.x;
-    const double sinA = orientA.y;
-    const double wx = cosA * s.x - sinA * s.y;
-    const double wy = sinA * s.x + cosA * s.y;
-
-    // ... and on into b's frame
-    const double dx = wx - relPosB.x;
-    const double dy = wy - relPosB.y;
-    const double cosB = orientB.x;
-    const double sinB = orientB.y;
-    return STP{cosB * dx + sinB * dy, -sinB * dx + cosB * dy, s.t};
-}
-
-// W_v: velocity shear. In b's frame, x' = x - speed_b * t
-STP WarpVelocityForward(const STP& s, double speedB)
-{
-    return STP{s.x - speedB * s.t, s.y, s.t};
-}
-
-// W_r: radius scaling (B.7). W_r(s) = s ★ (1/α, 1/α, 1).
-STP WarpRadiusForward(const STP& s, double radiusB)
-{
-    const double invR = 1.0 / std::max(radiusB, 1e-6);
-    return STP{s.x * invR, s.y * invR, s.t};
-}
-
-// W_ts: time uncertainty. Scale (x,y) by 1/(1 + lambda*t)
-STP WarpTimeUncertaintyForward(const STP& s, double lambda)
-{
-    const double scale = 1.0 / (1.0 + lambda * std::max(s.t, 0.0));
-    return STP{s.x * scale, s.y * scale, s.t};
-}
-
-struct VelocityUncertaintyScale {
-    double beta1;
-    double beta2;
-};
-
-// B.13: β₁ = 1/(1 + α₁·v/v_pref), β₂ = 1 + α₂·v/v_pref.
-// Since we use v0 for both current and preferred speed, v/v_pref = 1.
-VelocityUncertaintyScale VelocityUncertaintyFactors(double uncertaintyX, double uncertaintyY)
-{
-    return {1.0 / (1.0 + uncertaintyX), 1.0 + uncertaintyY};
-}
-
-// W_vu: velocity uncertainty (B.13). Anisotropic scaling:
-// β₁ = 1/(1 + α₁) compresses x, β₂ = 1 + α₂ expands y.
-STP WarpVelocityUncertaintyForward(const STP& s, double uncertaintyX, double uncertaintyY)
-{
-    const auto [beta1, beta2] = VelocityUncertaintyFactors(uncertaintyX, uncertaintyY);
-    return STP{s.x * beta1, s.y * beta2, s.t};
-}
-
-// Full composition: forward from a's frame to b's Intrinsic Field space
-// Order: W_local -> W_v -> W_r -> W_ts -> W_vu
-// Then check W_th (time validity)
-struct WarpParams {
-    Point relPosB;
-    Point orientA;
-    Point orientB;
-    double speedB;
-    double radiusB;
-    double lambda;
-    double velocityUncertaintyX;
-    double velocityUncertaintyY;
-    double timeHorizon;
-};
-
-// Probability scaling (B.5 + B.14): product of inverse probability transforms.
-// W_tu^{-1}(p) = p*beta^2, W_vu^{-1}(p) = p*beta1*beta2.
-double ProbabilityScale(const STP& sOriginal, const WarpParams& p)
-{
-    const double beta_tu = 1.0 / (1.0 + p.lambda * std::max(sOriginal.t, 0.0));
-    const auto [beta1, beta2] =
-        VelocityUncertaintyFactors(p.velocityUncertaintyX, p.velocityUncertaintyY);
-    return beta_tu * beta_tu * beta1 * beta2;
-}
-
-STP ComposeForward(const STP& s, const WarpParams& p)
-{
-    auto s1 = WarpLocalForward(s, p.relPosB, p.orientA, p.orientB);
-    auto s2 = WarpVelocityForward(s1, p.speedB);
-    auto s3 = WarpRadiusForward(s2, p.radiusB);
-    auto s4 = WarpTimeUncertaintyForward(s3, p.lambda);
-    auto s5 = WarpVelocityUncertaintyForward(s4, p.velocityUncertaintyX, p.velocityUncertaintyY);
-    // Normalize time: map [0, timeHorizon] -> [0, 1]
-    s5.t = (p.timeHorizon > 0.0) ? s5.t / p.timeHorizon : 0.0;
-    return s5;
-}
-
-// Gradient transform: takes 2D gradient from IntrinsicField, returns 3D space-time gradient
-// in a's frame. Applies inverse Jacobians in reverse order.
-STP ComposeGradientInverse(const Point& gradI, const STP& sOriginal, const WarpParams& p)
-{
-    // Start with 3-component gradient in Intrinsic Field space: (gradI.x, gradI.y, 0)
-    // since dI/dt = 0
-    double gx = gradI.x;
-    double gy = gradI.y;
-    double gt = 0.0;
-
-    // Time normalization inverse Jacobian: dt_original = dt_normalized * timeHorizon
-    // So dI/dt_original = dI/dt_normalized / timeHorizon
-    // But dI/dt = 0, so gt stays 0 at this point. However, the spatial components
-    // pick up time contributions from the velocity shear.
-
-    // W_vu^-1: anisotropic scaling (B.15). Inverse scales gradient by the
-    // forward factors (beta1, beta2) since J_vu = diag(beta1, beta2, 1).
-    {
-        const auto [beta1, beta2] =
-            VelocityUncertaintyFactors(p.velocityUncertaintyX, p.velocityUncertaintyY);
-        gx *= beta1;
-        gy *= beta2;
-    }
-
-    // W_tu^-1 (B.6): spatial gradient scaled by beta, temporal gets cross-terms.
-    // Coordinates at W_tu input = after W_ref -> W_v -> W_r on sOriginal.
-    // TODO(perf): ComposeForward already computes this intermediate; cache and
-    // reuse instead of recomputing the three warps here. ~15% per-sample saving.
-    {
-        const double t = sOriginal.t;
-        const double beta = 1.0 / (1.0 + p.lambda * std::max(t, 0.0));
-        auto sAtTu = WarpLocalForward(sOriginal, p.relPosB, p.orientA, p.orientB);
-        sAtTu = WarpVelocityForward(sAtTu, p.speedB);
-        sAtTu = WarpRadiusForward(sAtTu, p.radiusB);
-        const double gamma1 = -p.lambda * beta * beta * sAtTu.x;
-        const double gamma2 = -p.lambda * beta * beta * sAtTu.y;
-        const double gxOld = gx;
-        const double gyOld = gy;
-        gx *= beta;
-        gy *= beta;
-        gt = gamma1 * gxOld + gamma2 * gyOld + gt;
-    }
-
-    // W_r^-1: identity (B.9).
-
-    // W_v^-1 (B.12): g + (0, 0, -v·g.x).
-    {
-        gt -= p.speedB * gx;
-    }
-
-    // W_local inverse Jacobian: rotate from b's frame back to a's frame
-    {
-        const double cosA = p.orientA.x;
-        const double sinA = p.orientA.y;
-        const double cosB = p.orientB.x;
-        const double sinB = p.orientB.y;
-
-        // Combined rotation: b's frame -> world -> a's frame
-        // R_a^T * R_b applied to gradient
-        const double cos_ab = cosA * cosB + sinA * sinB;
-        const double sin_ab = sinA * cosB - cosA * sinB;
-        const double gx_new = cos_ab * gx + sin_ab * gy;
-        const double gy_new = -sin_ab * gx + cos_ab * gy;
-        gx = gx_new;
-        gy = gy_new;
-    }
-
-    return STP{gx, gy, gt};
-}
-
+using warp_driver::AccumulateNeighbor;
+using warp_driver::MakeNeighborWarp;
+using warp_driver::SampleLanes;
+using warp_driver::VelocityUncertaintyFactors;
 } // anonymous namespace
 
 // ============================================================================
@@ -337,7 +202,7 @@ WarpDriverModel::WarpDriverModel(
     // 2 * v_max * timeHorizon, plus their combined radii, plus a small margin.
     // v_max and r_max are hardcoded pedestrian defaults.
     , _cutOffRadius(2.0 * 1.5 * timeHorizon + 2.0 * 0.3 + 0.5)
-    , _rng(rngSeed)
+    , _rngSeed(rngSeed)
 {
     if(sigma <= 0.0) {
         throw SimulationError("WarpDriverModel: sigma must be > 0, got {}", sigma);
@@ -475,10 +340,7 @@ Point WarpDriverModel::ComputeNextState(
     // === Step 2: Perceive - build collision probability field ===
     auto _w = step.WallsInRange(_cutOffRadius);
     const std::vector<WallView> boundaries(_w.begin(), _w.end());
-    const auto neighbors =
-        step.OtherAgentsInRange(_cutOffRadius, [&step, &boundaries](const NeighborView& n) {
-            return step.NoGeometryBetween(n.RelativePosition, boundaries);
-        });
+    const auto neighbors = step.OtherAgentsInSight(_cutOffRadius, boundaries);
 
     // Short-range repulsion: not part of the original Wolinski et al. (2016)
     // model, which is purely anticipatory. Added as a practical safety net
@@ -505,22 +367,27 @@ Point WarpDriverModel::ComputeNextState(
     // Random perturbation: small lateral offset on trajectory samples to break
     // symmetry in perfectly aligned head-on encounters where the gradient field
     // cancels by symmetry, producing no lateral avoidance.
-    std::uniform_real_distribution<double> perturbDist(-0.05, 0.05);
-
-    // Storage for per-sample combined probability and gradient
-    struct Sample {
-        double t;
-        STP r; // trajectory point in agent-centric space-time
-        double pTotal;
-        STP gradTotal;
-    };
-    std::vector<Sample> samples(static_cast<size_t>(this->_numSamples));
+    auto rng = step.Random(_rngSeed);
 
-    for(int i = 0; i < this->_numSamples; ++i) {
-        const double t = i * dtSample;
-        const double lateralPerturbation = perturbDist(_rng);
-        samples[static_cast<size_t>(i)] =
-            Sample{t, STP{speed * t, lateralPerturbation, t}, 0.0, STP{0, 0, 0}};
+    const size_t sampleCount = static_cast<size_t>(this->_numSamples);
+    const auto vu = VelocityUncertaintyFactors(_velocityUncertaintyX, _velocityUncertaintyY);
+    SampleLanes lanes(sampleCount);
+    {
+        const auto x = lanes.x();
+        const auto y = lanes.y();
+        const auto t = lanes.t();
+        const auto timeScale = lanes.timeScale();
+        const auto probabilityScale = lanes.probabilityScale();
+        for(size_t i = 0; i < sampleCount; ++i) {
+            t[i] = static_cast<double>(i) * dtSample;
+            x[i] = speed * t[i];
+            y[i] = rng.Uniform(-0.05, 0.05);
+            timeScale[i] = 1.0 / (1.0 + _timeUncertainty * std::max(t[i], 0.0));
+            // W_th: normalized time must be in [0, 1]
+            const double tNormalized = (_timeHorizon > 0.0) ? t[i] / _timeHorizon : 0.0;
+            const bool valid = tNormalized >= 0.0 && tNormalized <= 1.0;
+            probabilityScale[i] = valid ? timeScale[i] * timeScale[i] * vu.beta1 * vu.beta2 : 0.0;
+        }
     }
 
     for(const auto& neighbor : neighbors) {
@@ -537,51 +404,13 @@ Point WarpDriverModel::ComputeNextState(
             nbOrient = nbOrient.Normalized();
         }
 
-        // Neighbor speed (from v0)
-        const double nbSpeed = nbData->v0;
-
-        // TODO(perf): WarpParams and all neighbor-derived constants (orientation,
-        // speed, Minkowski radius, rotation matrix cos_ab/sin_ab used in the
-        // gradient inverse) are loop-invariant w.r.t. the sample index. Hoist
-        // them out of the sample loop and precompute once per (ped, neighbor).
-        WarpParams wp{};
-        wp.relPosB = neighbor.RelativePosition;
-        wp.orientA = effectiveOrient;
-        wp.orientB = nbOrient;
-        wp.speedB = nbSpeed;
-        wp.radiusB = agentData.radius + nbData->radius; // Minkowski sum
-        wp.lambda = this->_timeUncertainty;
-        wp.velocityUncertaintyX = this->_velocityUncertaintyX;
-        wp.velocityUncertaintyY = this->_velocityUncertaintyY;
-        wp.timeHorizon = this->_timeHorizon;
-
-        for(auto& s : samples) {
-            // Forward warp sample point to neighbor's Intrinsic Field space
-            STP warped = ComposeForward(s.r, wp);
-
-            // Time validity check: must be in [0, 1] (normalized)
-            if(warped.t < 0.0 || warped.t > 1.0) {
-                continue;
-            }
-
-            // Lookup Intrinsic Field (2D) and apply probability scaling (B.5, B.14)
-            auto [intrinsicP, gradI] = _intrinsicField.Sample(warped.x, warped.y);
-            const double pB = intrinsicP * ProbabilityScale(s.r, wp);
-
-            if(pB < 1e-12) {
-                continue;
-            }
-
-            // Transform gradient back to agent's frame
-            STP gradB = ComposeGradientInverse(gradI, s.r, wp);
-
-            // Union formula: p_new = p + pB - p * pB
-            double pOld = s.pTotal;
-            s.pTotal = pOld + pB - pOld * pB;
-            s.gradTotal.x = s.gradTotal.x + gradB.x - pOld * gradB.x - pB * s.gradTotal.x;
-            s.gradTotal.y = s.gradTotal.y + gradB.y - pOld * gradB.y - pB * s.gradTotal.y;
-            s.gradTotal.t = s.gradTotal.t + gradB.t - pOld * gradB.t - pB * s.gradTotal.t;
-        }
+        const auto nb = MakeNeighborWarp(
+            neighbor.RelativePosition,
+            effectiveOrient,
+            nbOrient,
+            nbData->v0,
+            agentData.radius + nbData->radius); // Minkowski sum
+        AccumulateNeighbor(lanes, nb, _intrinsicField, vu, _timeUncertainty);
     }
 
     // === Step 3: Solve - gradient descent on trajectory ===
@@ -591,15 +420,24 @@ Point WarpDriverModel::ComputeNextState(
     STP G{0, 0, 0};
     STP S{0, 0, 0};
 
-    for(const auto& s : samples) {
-        N += s.pTotal * dtSample;
-        P += s.pTotal * s.pTotal * dtSample;
-        G.x += s.pTotal * s.gradTotal.x * dtSample;
-        G.y += s.pTotal * s.gradTotal.y * dtSample;
-        G.t += s.pTotal * s.gradTotal.t * dtSample;
-        S.x += s.pTotal * s.r.x * dtSample;
-        S.y += s.pTotal * s.r.y * dtSample;
-        S.t += s.pTotal * s.r.t * dtSample;
+    {
+        const auto x = lanes.x();
+        const auto y = lanes.y();
+        const auto t = lanes.t();
+        const auto pTotal = lanes.pTotal();
+        const auto gradX = lanes.gradX();
+        const auto gradY = lanes.gradY();
+        const auto gradT = lanes.gradT();
+        for(size_t i = 0; i < sampleCount; ++i) {
+            N += pTotal[i] * dtSample;
+            P += pTotal[i] * pTotal[i] * dtSample;
+            G.x += pTotal[i] * gradX[i] * dtSample;
+            G.y += pTotal[i] * gradY[i] * dtSample;
+            G.t += pTotal[i] * gradT[i] * dtSample;
+            S.x += pTotal[i] * x[i] * dtSample;
+            S.y += pTotal[i] * y[i] * dtSample;
+            S.t += pTotal[i] * t[i] * dtSample;
+        }
     }
 
     Point newVelLocal;
@@ -729,8 +567,7 @@ Point WarpDriverModel::ComputeNextState(
         displacement = Point{};
     } else if(stuckTime >= stuckThreshold) {
         // Stuck: no net progress for stuckThreshold seconds — enter detour
-        std::uniform_int_distribution<int> sideDist(0, 1);
-        detourSide = sideDist(_rng) * 2 - 1; // -1 or +1
+        detourSide = static_cast<int>(rng.Below(2)) * 2 - 1; // -1 or +1
         detourTime = detourDuration;
         stuckTime = 0.0;
     }
@@ -11,7 +11,7 @@ class EnvironmentQuery;
 #include <fmt/core.h>
 
 #include <cstdint>
-#include <random>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -33,8 +33,15 @@ private:
     /// Precomputed 2D collision probability field I(x,y) and its gradient.
     /// Constant along time axis; time is a validity window [0,1] normalized.
     struct IntrinsicField {
-        std::vector<double> values;
-        std::vector<Point> gradients; // (dI/dx, dI/dy)
+        /// Value and gradient (dI/dx, dI/dy) of one grid point. Interleaved so that a bilinear
+        /// lookup reads two pairs of adjacent entries instead of touching separate arrays.
+        struct Entry {
+            double value;
+            double gradX;
+            double gradY;
+        };
+        /// Shared by all models with the same sigma and grid, never modified once computed.
+        std::shared_ptr<const std::vector<Entry>> table;
         double xMin{-3.0};
         double xMax{3.0};
         double yMin{-3.0};
@@ -44,7 +51,10 @@ private:
         int nx{61};
         int ny{61};
 
+        /// Takes the table from the process wide cache, computes it on first use.
         void Compute(double sigma);
+        /// Builds the table for 'sigma' on the grid above.
+        std::vector<Entry> Tabulate(double sigma) const;
         /// Bilinear interpolation. Returns (0, {0,0}) for out-of-bounds.
         std::pair<double, Point> Sample(double x, double y) const;
     };
@@ -61,7 +71,8 @@ private:
     double _cutOffRadius;
 
     IntrinsicField _intrinsicField;
-    mutable std::mt19937 _rng;
+    // Seed of the per agent random streams, see AgentStep::Random.
+    uint64_t _rngSeed;
 
 public:
     WarpDriverModel(
@@ -75,6 +86,10 @@ public:
         uint64_t rngSeed = 42);
 
     ~WarpDriverModel() override = default;
+    std::unique_ptr<OperationalModel> Clone() const override
+    {
+        return std::make_unique<WarpDriverModel>(*this);
+    }
 
     OperationalModelType Type() const override;
 
@@ -84,4 +99,5 @@ public:
         const AgentStep& step) const override;
 
     void CheckModelConstraint(const GenericAgent& agent, const AgentView& view) const override;
+    double NeighborRadius() const override { return _cutOffRadius; }
 };
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "PoissonDiskSampler.hpp"
+
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace
+{
+uint64_t packCell(int64_t ix, int64_t iy)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(ix)) << 32) |
+           static_cast<uint32_t>(iy);
+}
+
+double distanceSquaredToSegment(Point p, Point a, Point b)
+{
+    const auto ab = b - a;
+    const auto lengthSquared = ab.NormSquare();
+    if(lengthSquared == 0.0) {
+        return DistanceSquared(p, a);
+    }
+    const auto t = std::clamp((p - a).ScalarProduct(ab) / lengthSquared, 0.0, 1.0);
+    return DistanceSquared(p, a + ab * t);
+}
+} // namespace
+
+PoissonDiskSampler::PoissonDiskSampler(
+    const std::vector<Point>& boundary,
+    const std::vector<std::vector<Point>>& holes,
+    double agentDistance,
+    double wallDistance,
+    uint64_t seed)
+    : _agentDistance(agentDistance), _wallDistance(wallDistance), _rng(seed)
+{
+    if(!(agentDistance > 0.0)) {
+        throw SimulationError("Agent distance needs to be positive, got {}", agentDistance);
+    }
+    if(!(wallDistance >= 0.0)) {
+        throw SimulationError("Wall distance may not be negative, got {}", wallDistance);
+    }
+    const auto addRing = [this](const std::vector<Point>& ring) {
+        if(ring.size() < 3) {
+            throw SimulationError("Polygon rings need at least 3 points, got {}", ring.size());
+        }
+        for(size_t index = 0; index < ring.size(); ++index) {
+            _edges.push_back({ring[index], ring[(index + 1) % ring.size()]});
+        }
+    };
+    addRing(boundary);
+    _bounds = AABB(boundary);
+    for(const auto& hole : holes) {
+        addRing(hole);
+        const AABB holeBounds(hole);
+        _bounds = {
+            {std::min(_bounds.xmin, holeBounds.xmin), std::min(_bounds.ymin, holeBounds.ymin)},
+            {std::max(_bounds.xmax, holeBounds.xmax), std::max(_bounds.ymax, holeBounds.ymax)}};
+    }
+    _sampleCellSize = agentDistance / std::numbers::sqrt2;
+    _edgeCellSize = std::max({wallDistance, agentDistance, 0.5});
+
+    _edgeRows.resize(rowOf(_bounds.ymax) + 1);
+    for(uint32_t edgeIndex = 0; edgeIndex < _edges.size(); ++edgeIndex) {
+        const auto& [from, to] = _edges[edgeIndex];
+        const auto rowFrom = rowOf(from.y);
+        const auto rowTo = rowOf(to.y);
+        for(auto row = std::min(rowFrom, rowTo); row <= std::max(rowFrom, rowTo); ++row) {
+            _edgeRows[row].push_back(edgeIndex);
+        }
+        if(wallDistance == 0.0) {
+            continue;
+        }
+        // Register the cells of points spaced half a cell apart along the edge. Every point of
+        // the edge is then at most a quarter cell away from a registered cell.
+        const auto steps = static_cast<size_t>(std::ceil(Distance(from, to) / (_edgeCellSize / 2)));
+        for(size_t step = 0; step <= steps; ++step) {
+            const auto t = steps == 0 ? 0.0 : static_cast<double>(step) / steps;
+            const auto [ix, iy] = cellOf(from + (to - from) * t, _edgeCellSize);
+            auto& cell = _edgeCells[packCell(ix, iy)];
+            if(cell.empty() || cell.back() != edgeIndex) {
+                cell.push_back(edgeIndex);
+            }
+        }
+    }
+}
+
+size_t PoissonDiskSampler::AddRandom(size_t count, size_t maxFailures)
+{
+    size_t placed = 0;
+    size_t failures = 0;
+    while(placed < count && failures <= maxFailures) {
+        const Point candidate{
+            uniform(_bounds.xmin, _bounds.xmax), uniform(_bounds.ymin, _bounds.ymax)};
+        if(tryAdd(candidate)) {
+            ++placed;
+            failures = 0;
+        } else {
+            ++failures;
+        }
+    }
+    return placed;
+}
+
+size_t PoissonDiskSampler::AddRandomInRing(
+    Point center,
+    double innerRadius,
+    double outerRadius,
+    size_t count,
+    size_t maxFailures)
+{
+    if(innerRadius < 0.0 || innerRadius >= outerRadius) {
+        throw SimulationError(
+            "Invalid ring, expected 0 <= inner radius < outer radius, got {} and {}",
+            innerRadius,
+            outerRadius);
+    }
+    const AABB ringBounds{
+        {center.x - outerRadius, center.y - outerRadius},
+        {center.x + outerRadius, center.y + outerRadius}};
+    if(!_bounds.Overlap(ringBounds)) {
+        return 0;
+    }
+    const AABB box{
+        {std::max(_bounds.xmin, ringBounds.xmin), std::max(_bounds.ymin, ringBounds.ymin)},
+        {std::min(_bounds.xmax, ringBounds.xmax), std::min(_bounds.ymax, ringBounds.ymax)}};
+    const auto innerSquared = innerRadius * innerRadius;
+    const auto outerSquared = outerRadius * outerRadius;
+    // Draw from whichever of ring and box has less area outside the other one.
+    const bool drawFromRing =
+        std::numbers::pi * (outerSquared - innerSquared) <
+        (box.xmax - box.xmin) * (box.ymax - box.ymin);
+
+    size_t placed = 0;
+    size_t failures = 0;
+    while(placed < count && failures <= maxFailures) {
+        Point candidate{};
+        if(drawFromRing) {
+            const auto rho = std::sqrt(uniform(innerSquared, outerSquared));
+            const auto theta = uniform(0.0, 2 * std::numbers::pi);
+            candidate = center + Point{rho * std::cos(theta), rho * std::sin(theta)};
+        } else {
+            candidate = {uniform(box.xmin, box.xmax), uniform(box.ymin, box.ymax)};
+            const auto distanceSquared = DistanceSquared(candidate, center);
+            if(distanceSquared < innerSquared || distanceSquared > outerSquared) {
+                ++failures;
+                continue;
+            }
+        }
+        if(tryAdd(candidate)) {
+            ++placed;
+            failures = 0;
+        } else {
+            ++failures;
+        }
+    }
+    return placed;
+}
+
+bool PoissonDiskSampler::Fill(size_t k, size_t maxIterations)
+{
+    if(_samples.empty() && AddRandom(1, maxIterations) == 0) {
+        return false;
+    }
+    std::vector<uint32_t> active(_samples.size());
+    for(uint32_t index = 0; index < active.size(); ++index) {
+        active[index] = index;
+    }
+
+    while(!active.empty()) {
+        const auto slot = static_cast<size_t>(_rng() % active.size());
+        const auto reference = _samples[active[slot]];
+        bool found = false;
+        for(size_t attempt = 0; attempt < k; ++attempt) {
+            const auto rho = std::sqrt(
+                uniform(_agentDistance * _agentDistance, 4 * _agentDistance * _agentDistance));
+            const auto theta = uniform(0.0, 2 * std::numbers::pi);
+            if(tryAdd(reference + Point{rho * std::cos(theta), rho * std::sin(theta)})) {
+                active.push_back(static_cast<uint32_t>(_samples.size() - 1));
+                found = true;
+                break;
+            }
+        }
+        if(!found) {
+            // Active samples are picked uniformly, so their order does not matter.
+            active[slot] = active.back();
+            active.pop_back();
+        }
+    }
+    return true;
+}
+
+bool PoissonDiskSampler::IsPlaceable(Point p) const
+{
+    return _bounds.Inside(p) && isInside(p) && keepsWallDistance(p);
+}
+
+double PoissonDiskSampler::uniform(double min, double max)
+{
+    // Not using std::uniform_real_distribution, its output differs between standard libraries.
+    const auto unit = static_cast<double>(_rng() >> 11) * 0x1.0p-53;
+    return min + (max - min) * unit;
+}
+
+bool PoissonDiskSampler::isInside(Point p) const
+{
+    // Even-odd rule with a ray in +x direction. Only edges overlapping the row of 'p' in y can
+    // cross the ray.
+    bool inside = false;
+    for(const auto edgeIndex : _edgeRows[rowOf(p.y)]) {
+        const auto& [a, b] = _edges[edgeIndex];
+        if((a.y > p.y) != (b.y > p.y)) {
+            const auto x = a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y);
+            if(x > p.x) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+bool PoissonDiskSampler::keepsWallDistance(Point p) const
+{
+    if(_wallDistance == 0.0) {
+        return true;
+    }
+    // The closest point of an edge within '_wallDistance' is at most one cell away, its
+    // registered neighbour at most another quarter cell.
+    const auto wallDistanceSquared = _wallDistance * _wallDistance;
+    const auto [ix, iy] = cellOf(p, _edgeCellSize);
+    for(int64_t dx = -2; dx <= 2; ++dx) {
+        for(int64_t dy = -2; dy <= 2; ++dy) {
+            const auto iter = _edgeCells.find(packCell(ix + dx, iy + dy));
+            if(iter == std::end(_edgeCells)) {
+                continue;
+            }
+            for(const auto edgeIndex : iter->second) {
+                const auto& [a, b] = _edges[edgeIndex];
+                if(distanceSquaredToSegment(p, a, b) < wallDistanceSquared) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool PoissonDiskSampler::keepsAgentDistance(Point p) const
+{
+    const auto agentDistanceSquared = _agentDistance * _agentDistance;
+    const auto [ix, iy] = cellOf(p, _sampleCellSize);
+    // A cell is agentDistance / sqrt(2) wide, so conflicting samples are at most two cells away.
+    for(int64_t dx = -2; dx <= 2; ++dx) {
+        for(int64_t dy = -2; dy <= 2; ++dy) {
+            const auto iter = _sampleCells.find(packCell(ix + dx, iy + dy));
+            if(iter != std::end(_sampleCells) &&
+               DistanceSquared(_samples[iter->second], p) < agentDistanceSquared) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool PoissonDiskSampler::tryAdd(Point p)
+{
+    if(!IsPlaceable(p) || !keepsAgentDistance(p)) {
+        return false;
+    }
+    const auto [ix, iy] = cellOf(p, _sampleCellSize);
+    _sampleCells.emplace(packCell(ix, iy), static_cast<uint32_t>(_samples.size()));
+    _samples.push_back(p);
+    return true;
+}
+
+std::pair<int64_t, int64_t> PoissonDiskSampler::cellOf(Point p, double cellSize) const
+{
+    return {
+        static_cast<int64_t>(std::floor((p.x - _bounds.xmin) / cellSize)),
+        static_cast<int64_t>(std::floor((p.y - _bounds.ymin) / cellSize))};
+}
+
+size_t PoissonDiskSampler::rowOf(double y) const
+{
+    return static_cast<size_t>(std::max(0.0, std::floor((y - _bounds.ymin) / _edgeCellSize)));
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AABB.hpp"
+#include "Point.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Random agent positions inside a polygon with holes.
+///
+/// All samples keep a distance of at least 'agentDistance' to each other and of at least
+/// 'wallDistance' to the polygon boundary. Samples accumulate over calls, later calls respect
+/// the samples placed by earlier ones. For a given build and platform results only depend on the
+/// seed, other compilers or math libraries may round differently and place other samples.
+class PoissonDiskSampler
+{
+    struct Edge {
+        Point from;
+        Point to;
+    };
+
+    AABB _bounds{};
+    double _agentDistance;
+    double _wallDistance;
+    std::mt19937_64 _rng;
+
+    // Boundary edges bucketed into square cells of '_edgeCellSize' for the wall distance test
+    // and into horizontal rows of the same height for the point in polygon test.
+    std::vector<Edge> _edges{};
+    double _edgeCellSize{};
+    std::unordered_map<uint64_t, std::vector<uint32_t>> _edgeCells{};
+    std::vector<std::vector<uint32_t>> _edgeRows{};
+
+    // Background grid of the samples, a cell is small enough to hold at most one sample.
+    double _sampleCellSize{};
+    std::unordered_map<uint64_t, uint32_t> _sampleCells{};
+    std::vector<Point> _samples{};
+
+public:
+    /// @param boundary outer boundary, not closed, any orientation
+    /// @param holes boundaries of the holes, not closed, any orientation
+    PoissonDiskSampler(
+        const std::vector<Point>& boundary,
+        const std::vector<std::vector<Point>>& holes,
+        double agentDistance,
+        double wallDistance,
+        uint64_t seed);
+
+    /// Draws uniformly distributed candidates from the bounding box of the polygon until 'count'
+    /// samples have been placed or 'maxFailures' consecutive candidates were rejected.
+    /// @return number of samples placed
+    size_t AddRandom(size_t count, size_t maxFailures);
+
+    /// Same as 'AddRandom' restricted to the ring around 'center' with the given radii.
+    size_t AddRandomInRing(
+        Point center,
+        double innerRadius,
+        double outerRadius,
+        size_t count,
+        size_t maxFailures);
+
+    /// Bridson's algorithm: Starts from one random sample and keeps placing samples in the annulus
+    /// [agentDistance, 2 * agentDistance] around active samples. A sample becomes inactive after
+    /// 'k' rejected candidates. Up to 'maxIterations' candidates are drawn to find the first
+    /// sample if no samples exist yet.
+    /// @return false if no first sample could be placed
+    bool Fill(size_t k, size_t maxIterations);
+
+    const std::vector<Point>& Samples() const { return _samples; }
+
+    /// Whether 'p' is inside the polygon and far enough from its boundary.
+    bool IsPlaceable(Point p) const;
+
+private:
+    double uniform(double min, double max);
+    bool isInside(Point p) const;
+    bool keepsWallDistance(Point p) const;
+    bool keepsAgentDistance(Point p) const;
+    bool tryAdd(Point p);
+    std::pair<int64_t, int64_t> cellOf(Point p, double cellSize) const;
+    size_t rowOf(double y) const;
+};
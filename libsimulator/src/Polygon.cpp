@@ -8,6 +8,7 @@
 #include <CGAL/number_utils.h>
 
 #include <algorithm>
+#include <iterator>
 #include <tuple>
 #include <vector>
 
@@ -55,6 +56,16 @@ Point Polygon::Centroid() const
     return sum / static_cast<double>(_polygon.size());
 }
 
+std::vector<Point> Polygon::Points() const
+{
+    std::vector<Point> points{};
+    points.reserve(_polygon.size());
+    std::transform(_polygon.begin(), _polygon.end(), std::back_inserter(points), [](const auto& p) {
+        return Point(CGAL::to_double(p.x()), CGAL::to_double(p.y()));
+    });
+    return points;
+}
+
 std::tuple<Point, double> Polygon::ContainingCircle() const
 {
     const auto center = Centroid();
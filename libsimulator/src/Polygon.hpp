@@ -23,6 +23,8 @@ public:
     bool IsInside(Point p) const;
     Point Centroid() const;
     std::tuple<Point, double> ContainingCircle() const;
+    /// Vertices in counter clockwise order.
+    std::vector<Point> Points() const;
 
     operator PolygonType() const { return _polygon; }
 };
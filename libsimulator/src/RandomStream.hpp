@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/// Counter based random numbers: Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy
+/// as 1, 2, 3", SC 2011).
+///
+/// A stream is fully determined by (seed, agent id, iteration). The n-th draw only depends on
+/// these and on n, not on how many numbers other agents drew before or in which order agents
+/// are updated. Streams hold no shared state and can be created wherever they are needed.
+class RandomStream
+{
+public:
+    using Block = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+    using result_type = uint32_t;
+
+private:
+    Key _key;
+    Block _counter;
+    Block _block{};
+    size_t _used{4};
+
+public:
+    RandomStream(uint64_t seed, uint64_t agentId, uint64_t iteration)
+        // The upper half of the iteration goes into the key so that all 128 counter bits are
+        // available for (draw block, iteration, agent id) without wrapping for 2^32 iterations.
+        : _key{static_cast<uint32_t>(seed) ^ static_cast<uint32_t>(iteration >> 32),
+               static_cast<uint32_t>(seed >> 32)}
+        , _counter{
+              0,
+              static_cast<uint32_t>(iteration),
+              static_cast<uint32_t>(agentId),
+              static_cast<uint32_t>(agentId >> 32)}
+    {
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<uint32_t>::max(); }
+
+    /// Next 32 random bits, satisfies UniformRandomBitGenerator.
+    result_type operator()()
+    {
+        if(_used == _block.size()) {
+            _block = Philox(_counter, _key);
+            ++_counter[0];
+            _used = 0;
+        }
+        return _block[_used++];
+    }
+
+    uint64_t NextUInt64()
+    {
+        const uint64_t high = (*this)();
+        return (high << 32) | (*this)();
+    }
+
+    /// Uniform in [0, 1) with 53 random bits.
+    double Uniform() { return static_cast<double>(NextUInt64() >> 11) * 0x1.0p-53; }
+
+    /// Uniform in [lower, upper).
+    double Uniform(double lower, double upper) { return lower + (upper - lower) * Uniform(); }
+
+    /// Uniform in [0, n), n > 0. Uses Lemire's multiply-shift, the bias is below 2^-32 * n.
+    uint32_t Below(uint32_t n) { return static_cast<uint32_t>((uint64_t{(*this)()} * n) >> 32); }
+
+    /// The raw Philox4x32-10 bijection.
+    static constexpr Block Philox(Block counter, Key key)
+    {
+        constexpr uint32_t M0 = 0xD2511F53;
+        constexpr uint32_t M1 = 0xCD9E8D57;
+        constexpr uint32_t W0 = 0x9E3779B9;
+        constexpr uint32_t W1 = 0xBB67AE85;
+        for(int round = 0; round < 10; ++round) {
+            const uint64_t p0 = uint64_t{M0} * counter[0];
+            const uint64_t p1 = uint64_t{M1} * counter[2];
+            counter = {
+                static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<uint32_t>(p0)};
+            key[0] += W0;
+            key[1] += W1;
+        }
+        return counter;
+    }
+};
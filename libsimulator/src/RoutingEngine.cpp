@@ -2,22 +2,29 @@
 #include "RoutingEngine.hpp"
 
 #include "CfgCgal.hpp"
+#include "Checkpoint.hpp"
 #include "GeometricFunctions.hpp"
 #include "LineSegment.hpp"
+#include "MemoryUsage.hpp"
 #include "Mesh.hpp"
 #include "Point.hpp"
 #include "SimulationError.hpp"
 
+#include <CGAL/Bbox_2.h>
 #include <CGAL/Constrained_Delaunay_triangulation_2.h>
 #include <CGAL/Distance_2/Point_2_Segment_2.h>
+#include <CGAL/IO/io.h>
 #include <CGAL/mark_domain_in_triangulation.h>
 #include <CGAL/number_utils.h>
 
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <limits>
+#include <memory>
+#include <sstream>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -38,9 +45,10 @@ RoutingEngine::RoutingEngine(const PolyWithHoles& poly)
     }
     CGAL::mark_domain_in_triangulation(cdt);
     mesh = std::make_unique<Mesh>(cdt);
+    buildFaceGrid();
 }
 
-Point RoutingEngine::ComputeWaypoint(Point currentPosition, Point destination)
+Point RoutingEngine::ComputeWaypoint(Point currentPosition, Point destination) const
 {
     return ComputeAllWaypoints(currentPosition, destination)[1];
 }
@@ -104,12 +112,35 @@ double length_of_path(const std::vector<Point>& path)
     return segment_sum;
 }
 
-std::vector<Point> RoutingEngine::ComputeAllWaypoints(Point currentPosition, Point destination)
+std::vector<Point>
+RoutingEngine::ComputeAllWaypoints(Point currentPosition, Point destination) const
+{
+    const auto from = find_face({currentPosition.x, currentPosition.y});
+    const auto to = find_face({destination.x, destination.y});
+    return computeAllWaypoints(currentPosition, destination, from, to);
+}
+
+std::vector<Point>
+RoutingEngine::ComputeWaypoints(const std::vector<Point>& positions, Point destination) const
+{
+    const auto to = find_face({destination.x, destination.y});
+    std::vector<Point> waypoints{};
+    waypoints.reserve(positions.size());
+    for(const auto& position : positions) {
+        const auto from = find_face({position.x, position.y});
+        waypoints.push_back(computeAllWaypoints(position, destination, from, to)[1]);
+    }
+    return waypoints;
+}
+
+std::vector<Point> RoutingEngine::computeAllWaypoints(
+    Point currentPosition,
+    Point destination,
+    CDT::Face_handle from,
+    CDT::Face_handle to) const
 {
     const auto from_pos = CDT::Point{currentPosition.x, currentPosition.y};
     const auto to_pos = CDT::Point{destination.x, destination.y};
-    const auto from = find_face(from_pos);
-    const auto to = find_face(to_pos);
 
     if(from == to) {
         return std::vector<Point>{currentPosition, destination};
@@ -269,24 +300,144 @@ bool RoutingEngine::IsRoutable(Point p) const
     return true;
 }
 
-void RoutingEngine::Update()
+size_t RoutingEngine::MemoryUsage() const
 {
+    using jps::memory::HeapBytes;
+    // Vertices and faces of the triangulation, including the infinite vertex and its faces.
+    const size_t triangulation = (cdt.number_of_vertices() + 1) * sizeof(CDT::Vertex) +
+                                 cdt.tds().number_of_faces() * sizeof(CDT::Face);
+    const size_t grid = HeapBytes(faceGrid.cellStart) + HeapBytes(faceGrid.faces);
+    return triangulation + grid + (mesh ? sizeof(Mesh) + mesh->MemoryUsage() : 0);
+}
+
+void RoutingEngine::Serialize(checkpoint::Writer& writer) const
+{
+    std::ostringstream triangulation{};
+    CGAL::IO::set_binary_mode(triangulation);
+    triangulation << cdt;
+    writer.WriteString(triangulation.str());
+    // The stream operators leave out the face info, it is stored in the order the faces are
+    // written in, which is also the order they are created in when reading.
+    std::vector<uint8_t> inDomain{};
+    for(const auto face : cdt.all_face_handles()) {
+        inDomain.push_back(face->get_in_domain() ? 1 : 0);
+    }
+    writer.WriteVector(inDomain);
+    mesh->Serialize(writer);
+}
+
+std::unique_ptr<RoutingEngine> RoutingEngine::Deserialize(checkpoint::Reader& reader)
+{
+    auto engine = std::make_unique<RoutingEngine>();
+    std::istringstream triangulation{reader.ReadString()};
+    CGAL::IO::set_binary_mode(triangulation);
+    triangulation >> engine->cdt;
+    const auto inDomain = reader.ReadVector<uint8_t>();
+    if(triangulation.fail() || inDomain.size() != engine->cdt.all_face_handles().size()) {
+        throw SimulationError("Corrupt geometry bundle: unreadable triangulation");
+    }
+    size_t index = 0;
+    for(const auto face : engine->cdt.all_face_handles()) {
+        face->set_in_domain(inDomain[index++] != 0);
+    }
+    engine->mesh = std::make_unique<Mesh>(Mesh::Deserialize(reader));
+    engine->buildFaceGrid();
+    return engine;
+}
+
+void RoutingEngine::buildFaceGrid()
+{
+    faceGrid = FaceGrid{};
+    std::vector<CDT::Face_handle> walkable{};
+    for(const auto face : cdt.finite_face_handles()) {
+        if(face->get_in_domain()) {
+            walkable.push_back(face);
+        }
+    }
+    if(walkable.empty()) {
+        return;
+    }
+    CGAL::Bbox_2 bounds = cdt.triangle(walkable.front()).bbox();
+    for(const auto face : walkable) {
+        bounds += cdt.triangle(face).bbox();
+    }
+
+    // About one face per cell.
+    const double width = bounds.xmax() - bounds.xmin();
+    const double height = bounds.ymax() - bounds.ymin();
+    const double area = std::max(width * height, std::numeric_limits<double>::min());
+    faceGrid.minX = bounds.xmin();
+    faceGrid.minY = bounds.ymin();
+    faceGrid.cellSize = std::sqrt(area / static_cast<double>(walkable.size()));
+    faceGrid.columns = static_cast<size_t>(width / faceGrid.cellSize) + 1;
+    faceGrid.rows = static_cast<size_t>(height / faceGrid.cellSize) + 1;
+
+    // Cells a face overlaps, computed the same way find_face computes the cell of a point, so
+    // that a point inside a face always lands in one of its cells.
+    const auto cellRange = [this](double min, double max, double origin, size_t count) {
+        const auto first = static_cast<size_t>(std::floor((min - origin) / faceGrid.cellSize));
+        const auto last = static_cast<size_t>(std::floor((max - origin) / faceGrid.cellSize));
+        return std::pair{std::min(first, count - 1), std::min(last, count - 1)};
+    };
+    const auto forEachCell = [&](CDT::Face_handle face, const auto& visit) {
+        const auto box = cdt.triangle(face).bbox();
+        const auto [firstColumn, lastColumn] =
+            cellRange(box.xmin(), box.xmax(), faceGrid.minX, faceGrid.columns);
+        const auto [firstRow, lastRow] =
+            cellRange(box.ymin(), box.ymax(), faceGrid.minY, faceGrid.rows);
+        for(size_t row = firstRow; row <= lastRow; ++row) {
+            for(size_t column = firstColumn; column <= lastColumn; ++column) {
+                visit(row * faceGrid.columns + column);
+            }
+        }
+    };
+
+    // Count the faces per cell, turn the counts into offsets and place the faces.
+    faceGrid.cellStart.assign(faceGrid.columns * faceGrid.rows + 1, 0);
+    for(const auto face : walkable) {
+        forEachCell(face, [this](size_t cell) { ++faceGrid.cellStart[cell + 1]; });
+    }
+    for(size_t cell = 1; cell < faceGrid.cellStart.size(); ++cell) {
+        faceGrid.cellStart[cell] += faceGrid.cellStart[cell - 1];
+    }
+    faceGrid.faces.resize(faceGrid.cellStart.back());
+    std::vector<size_t> next(faceGrid.cellStart.begin(), faceGrid.cellStart.end() - 1);
+    for(const auto face : walkable) {
+        forEachCell(
+            face, [this, &next, face](size_t cell) { faceGrid.faces[next[cell]++] = face; });
+    }
 }
 
 CDT::Face_handle RoutingEngine::find_face(K::Point_2 p) const
 {
-    const auto face = cdt.locate(p);
-    if(face == nullptr || cdt.is_infinite(face) || !face->get_in_domain()) {
-        throw SimulationError(
-            "Point ({}, {}) is outside of accessible area",
-            CGAL::to_double(p.x()),
-            CGAL::to_double(p.y()));
+    const double x = CGAL::to_double(p.x());
+    const double y = CGAL::to_double(p.y());
+    const double column = std::floor((x - faceGrid.minX) / faceGrid.cellSize);
+    const double row = std::floor((y - faceGrid.minY) / faceGrid.cellSize);
+    // Written so that NaN coordinates count as outside.
+    if(column >= 0 && row >= 0 && column < static_cast<double>(faceGrid.columns) &&
+       row < static_cast<double>(faceGrid.rows)) {
+        const auto cell = static_cast<size_t>(row) * faceGrid.columns + static_cast<size_t>(column);
+        for(size_t index = faceGrid.cellStart[cell]; index < faceGrid.cellStart[cell + 1];
+            ++index) {
+            const auto face = faceGrid.faces[index];
+            const auto& a = face->vertex(0)->point();
+            const auto& b = face->vertex(1)->point();
+            const auto& c = face->vertex(2)->point();
+            // Faces are counterclockwise, the point is inside or on the boundary if it is not
+            // right of any edge. The predicates are exact.
+            if(CGAL::orientation(a, b, p) != CGAL::RIGHT_TURN &&
+               CGAL::orientation(b, c, p) != CGAL::RIGHT_TURN &&
+               CGAL::orientation(c, a, p) != CGAL::RIGHT_TURN) {
+                return face;
+            }
+        }
     }
-    return face;
+    throw SimulationError("Point ({}, {}) is outside of accessible area", x, y);
 }
 
 std::vector<Point>
-RoutingEngine::straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path)
+RoutingEngine::straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path) const
 {
     // TODO(kkratz): Remove the 0.2m edge width adjustment and replace this with p[roper
     // arc-paths from the "Efficient Triangulation-Based Pathfinding" publication
@@ -10,13 +10,38 @@
 #include <variant>
 #include <vector>
 
+namespace checkpoint
+{
+class Reader;
+class Writer;
+} // namespace checkpoint
+
 using LocationID = size_t;
 using Location = std::variant<Point, LocationID>;
 
+/// Routes through the constrained Delaunay triangulation of the walkable area. Routing does not
+/// change the engine, so one engine can be shared by simulations running on different threads
+/// without locking.
 class RoutingEngine
 {
+    /// Bucket grid over the bounding box of the walkable faces of the triangulation. Cell 'index'
+    /// (row major) lists faces[cellStart[index]] up to faces[cellStart[index + 1]], the faces
+    /// whose bounding box overlaps the cell.
+    struct FaceGrid {
+        double minX{0.0};
+        double minY{0.0};
+        double cellSize{1.0};
+        size_t columns{0};
+        size_t rows{0};
+        std::vector<size_t> cellStart{};
+        std::vector<CDT::Face_handle> faces{};
+    };
+
     CDT cdt{};
     std::unique_ptr<Mesh> mesh{};
+    // Points are located in the grid instead of with CGAL's locate, which draws the order of its
+    // walk from a random generator stored in the triangulation and so changes shared state.
+    FaceGrid faceGrid{};
 
 public:
     RoutingEngine();
@@ -26,18 +51,38 @@ public:
     RoutingEngine(const RoutingEngine& other) = delete;
     RoutingEngine& operator=(const RoutingEngine& other) = delete;
 
-    RoutingEngine(RoutingEngine&& other) = default;
-    RoutingEngine& operator=(RoutingEngine&& other) = default;
+    RoutingEngine(RoutingEngine&& other) = delete;
+    RoutingEngine& operator=(RoutingEngine&& other) = delete;
 
-    Point ComputeWaypoint(Point currentPosition, Point destination);
-    std::vector<Point> ComputeAllWaypoints(Point currentPosition, Point destination);
+    Point ComputeWaypoint(Point currentPosition, Point destination) const;
+    std::vector<Point> ComputeAllWaypoints(Point currentPosition, Point destination) const;
+    /// Computes the next waypoint for several positions heading to the same destination.
+    /// The destination is located once.
+    std::vector<Point>
+    ComputeWaypoints(const std::vector<Point>& positions, Point destination) const;
     bool IsRoutable(Point p) const;
-    void Update();
 
     const Mesh* MeshData() const { return mesh.get(); };
+    /// Heap memory held by the triangulation and the navigation mesh, see
+    /// jps::memory::HeapBytes.
+    size_t MemoryUsage() const;
+    /// Appends the triangulation and the navigation mesh to 'writer', see GeometryBundle.
+    void Serialize(checkpoint::Writer& writer) const;
+    /// Restores an engine written by 'Serialize' without triangulating the polygon again.
+    static std::unique_ptr<RoutingEngine> Deserialize(checkpoint::Reader& reader);
 
 private:
+    /// Fills faceGrid from the faces of cdt that are in the domain, called once the triangulation
+    /// is complete.
+    void buildFaceGrid();
+    /// Walkable face containing the point, points on an edge or vertex get the first face of the
+    /// grid cell that touches them. Throws SimulationError if the point is not walkable.
     CDT::Face_handle find_face(K::Point_2) const;
+    std::vector<Point> computeAllWaypoints(
+        Point currentPosition,
+        Point destination,
+        CDT::Face_handle from,
+        CDT::Face_handle to) const;
     std::vector<Point>
-    straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path);
+    straightenPath(Point from, Point to, const std::vector<CDT::Face_handle>& path) const;
 };
@@ -1,10 +1,14 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "Simulation.hpp"
 
+#include "AgentSleepSystem.hpp"
+#include "Checkpoint.hpp"
 #include "CollisionGeometry.hpp"
 #include "GenericAgent.hpp"
 #include "IteratorPair.hpp"
 #include "Journey.hpp"
+#include "MemoryUsage.hpp"
+#include "MultiRateStepping.hpp"
 #include "OperationalModel.hpp"
 #include "OperationalModelType.hpp"
 #include "Point.hpp"
@@ -17,14 +21,19 @@
 #include "Tracing.hpp"
 #include "Visitor.hpp"
 
+#include <fmt/core.h>
+
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -43,6 +52,177 @@ public:
     IterationScope(const IterationScope&) = delete;
     IterationScope& operator=(const IterationScope&) = delete;
 };
+
+template <typename ID>
+std::vector<uint64_t> rawIds(const std::vector<ID>& ids)
+{
+    std::vector<uint64_t> raw{};
+    raw.reserve(ids.size());
+    std::transform(std::begin(ids), std::end(ids), std::back_inserter(raw), [](const auto& id) {
+        return id.getID();
+    });
+    return raw;
+}
+
+template <typename ID>
+std::vector<ID> idsFromRaw(const std::vector<uint64_t>& raw)
+{
+    std::vector<ID> ids{};
+    ids.reserve(raw.size());
+    std::transform(std::begin(raw), std::end(raw), std::back_inserter(ids), [](auto value) {
+        return ID{value};
+    });
+    return ids;
+}
+
+/// Constructs alternative 'index' of 'Variant' by calling 'decode' with a
+/// std::type_identity of the alternative.
+template <typename Variant, typename Decode, size_t... I>
+Variant decodeAlternative(uint32_t index, Decode&& decode, std::index_sequence<I...>)
+{
+    std::optional<Variant> result{};
+    ((index == I ? (void)result.emplace(
+                       decode(std::type_identity<std::variant_alternative_t<I, Variant>>{}))
+                 : void()),
+     ...);
+    if(!result) {
+        throw SimulationError("Corrupt checkpoint: unknown variant index {}", index);
+    }
+    return std::move(*result);
+}
+
+template <typename Variant, typename Decode>
+Variant decodeVariant(checkpoint::Reader& reader, Decode&& decode)
+{
+    const auto index = reader.Read<uint32_t>();
+    return decodeAlternative<Variant>(
+        index,
+        std::forward<Decode>(decode),
+        std::make_index_sequence<std::variant_size_v<Variant>>{});
+}
+
+void writeStageDescription(checkpoint::Writer& writer, const StageDescription& description)
+{
+    writer.Write(static_cast<uint32_t>(description.index()));
+    std::visit(
+        overloaded{
+            [](const DirectSteeringDescription&) {},
+            [&writer](const WaypointDescription& d) {
+                writer.Write(d.position);
+                writer.Write(d.distance);
+            },
+            [&writer](const ExitDescription& d) { writer.WriteVector(d.polygon.Points()); },
+            [&writer](const NotifiableWaitingSetDescription& d) { writer.WriteVector(d.slots); },
+            [&writer](const NotifiableQueueDescription& d) { writer.WriteVector(d.slots); }},
+        description);
+}
+
+StageDescription readStageDescription(checkpoint::Reader& reader)
+{
+    return decodeVariant<StageDescription>(reader, [&reader](auto type) -> StageDescription {
+        using T = typename decltype(type)::type;
+        if constexpr(std::is_same_v<T, DirectSteeringDescription>) {
+            return DirectSteeringDescription{};
+        } else if constexpr(std::is_same_v<T, WaypointDescription>) {
+            const auto position = reader.Read<Point>();
+            return WaypointDescription{position, reader.Read<double>()};
+        } else if constexpr(std::is_same_v<T, ExitDescription>) {
+            return ExitDescription{Polygon{reader.ReadVector<Point>()}};
+        } else {
+            return T{reader.ReadVector<Point>()};
+        }
+    });
+}
+
+void writeTransitionDescription(
+    checkpoint::Writer& writer,
+    const TransitionDescription& description)
+{
+    writer.Write(static_cast<uint32_t>(description.index()));
+    std::visit(
+        overloaded{
+            [](const NonTransitionDescription&) {},
+            [&writer](const FixedTransitionDescription& d) { writer.Write(d.NextId().getID()); },
+            [&writer](const RoundRobinTransitionDescription& d) {
+                writer.Write(static_cast<uint64_t>(d.WeightedStages().size()));
+                for(const auto& [stageId, weight] : d.WeightedStages()) {
+                    writer.Write(stageId.getID());
+                    writer.Write(weight);
+                }
+            },
+            [&writer](const LeastTargetedTransitionDescription& d) {
+                writer.WriteVector(rawIds(d.TargetCandidates()));
+            }},
+        description);
+}
+
+TransitionDescription readTransitionDescription(checkpoint::Reader& reader)
+{
+    return decodeVariant<TransitionDescription>(
+        reader, [&reader](auto type) -> TransitionDescription {
+            using T = typename decltype(type)::type;
+            if constexpr(std::is_same_v<T, NonTransitionDescription>) {
+                return NonTransitionDescription{};
+            } else if constexpr(std::is_same_v<T, FixedTransitionDescription>) {
+                return FixedTransitionDescription{BaseStage::ID{reader.Read<uint64_t>()}};
+            } else if constexpr(std::is_same_v<T, RoundRobinTransitionDescription>) {
+                const auto count = reader.Read<uint64_t>();
+                std::vector<std::tuple<BaseStage::ID, uint64_t>> weightedStages{};
+                for(uint64_t index = 0; index < count; ++index) {
+                    const BaseStage::ID stageId{reader.Read<uint64_t>()};
+                    weightedStages.emplace_back(stageId, reader.Read<uint64_t>());
+                }
+                return RoundRobinTransitionDescription{weightedStages};
+            } else {
+                return LeastTargetedTransitionDescription{
+                    idsFromRaw<BaseStage::ID>(reader.ReadVector<uint64_t>())};
+            }
+        });
+}
+
+void writeAgent(checkpoint::Writer& writer, const GenericAgent& agent)
+{
+    writer.Write(agent.id.getID());
+    writer.Write(agent.journeyId.getID());
+    writer.Write(agent.stageId.getID());
+    writer.Write(agent.Position());
+    writer.Write(agent.nextTarget);
+    writer.Write(agent.finalTarget);
+    writer.Write(static_cast<uint32_t>(agent.state.index()));
+    std::visit(
+        [&writer](const auto& state) {
+            using T = std::decay_t<decltype(state)>;
+            if constexpr(std::is_same_v<T, CustomModelState>) {
+                throw SimulationError("Checkpoints are not supported for custom models");
+            } else {
+                writer.Write(state);
+            }
+        },
+        agent.state);
+}
+
+GenericAgent readAgent(checkpoint::Reader& reader)
+{
+    const GenericAgent::ID id{reader.Read<uint64_t>()};
+    const Journey::ID journeyId{reader.Read<uint64_t>()};
+    const BaseStage::ID stageId{reader.Read<uint64_t>()};
+    const auto position = reader.Read<Point>();
+    const auto nextTarget = reader.Read<Point>();
+    const auto finalTarget = reader.Read<Point>();
+    auto state = decodeVariant<OperationalModelState>(
+        reader, [&reader](auto type) -> OperationalModelState {
+            using T = typename decltype(type)::type;
+            if constexpr(std::is_same_v<T, CustomModelState>) {
+                throw SimulationError("Checkpoints are not supported for custom models");
+            } else {
+                return reader.Read<T>();
+            }
+        });
+    GenericAgent agent{id, journeyId, stageId, position, std::move(state)};
+    agent.nextTarget = nextTarget;
+    agent.finalTarget = finalTarget;
+    return agent;
+}
 } // namespace
 
 void Simulation::ThrowIfIterating(const char* operation) const
@@ -59,10 +239,17 @@ Simulation::Simulation(
     std::unique_ptr<OperationalModel>&& operationalModel,
     std::unique_ptr<CollisionGeometry>&& geometry,
     double dT)
+    : Simulation(std::move(operationalModel), GeometryBundle{std::move(geometry)}, dT)
+{
+}
+
+Simulation::Simulation(
+    std::unique_ptr<OperationalModel>&& operationalModel,
+    GeometryBundle geometry,
+    double dT)
     : _clock(dT)
     , _operationalDecisionSystem(std::move(operationalModel))
     , _geometry(std::move(geometry))
-    , _routingEngine(std::make_unique<RoutingEngine>(_geometry->Polygon()))
 {
 }
 
@@ -84,11 +271,16 @@ void Simulation::Iterate()
 {
     ThrowIfIterating("Iterate");
     IterationScope iterationScope(_iterating);
+    _timer.setIteration(_clock.Iteration());
     JPS_SCOPED_TIMER_AND_TRACE(_timer, "Total Iteration", General);
 
     {
         JPS_SCOPED_TIMER_AND_TRACE(_timer, "Agent Removal System", Detailed);
-        _agentRemovalSystem.Run(_agents, _removedAgentsInLastIteration, _stageManager);
+        _agentRemovalSystem.Run(
+            _agents,
+            _removedAgentsInLastIteration,
+            _stageManager,
+            _operationalDecisionSystem.Model());
     }
 
     {
@@ -98,7 +290,7 @@ void Simulation::Iterate()
 
     {
         JPS_SCOPED_TIMER_AND_TRACE(_timer, "Stage System", Detailed);
-        _stageSystem.Run(_stageManager, _neighborhoodSearch, *_geometry);
+        _stageSystem.Run(_stageManager, _neighborhoodSearch, _geometry.Geometry());
     }
 
     {
@@ -106,28 +298,102 @@ void Simulation::Iterate()
         _stategicalDecisionSystem.Run(_journeys, _agents, _stageManager);
     }
 
+    {
+        JPS_SCOPED_TIMER_AND_TRACE(_timer, "Agent Sleep System", Detailed);
+        _agentSleepSystem.Wake(_neighborhoodSearch, _agents);
+    }
+
     {
         JPS_SCOPED_TIMER_AND_TRACE(_timer, "Tactical Decision System", General);
-        _tacticalDecisionSystem.Run(*_routingEngine, _agents);
+        _tacticalDecisionSystem.Run(_geometry.Routing(), _agents);
     }
 
     {
         JPS_SCOPED_TIMER_AND_TRACE(_timer, "Operational Decision System", General);
-        _operationalDecisionSystem.Run(
-            _clock.dT(), _clock.ElapsedTime(), _neighborhoodSearch, *_geometry, _agents);
+        if(_operationalDecisionSystem.MultiRate().Enabled()) {
+            _operationalDecisionSystem.RunMultiRate(
+                _clock.dT(),
+                _clock.Iteration(),
+                _neighborhoodSearch,
+                _geometry.Geometry(),
+                _agents);
+        } else {
+            _operationalDecisionSystem.Run(
+                _clock.dT(),
+                _clock.ElapsedTime(),
+                _clock.Iteration(),
+                _neighborhoodSearch,
+                _geometry.Geometry(),
+                _agents);
+        }
         // Agents moved during the operational step; rebuild the grid so cell membership
         // reflects the new positions for queries before the next iteration (AgentsInRange,
         // AddAgent validation).
         _neighborhoodSearch.Update(_agents);
     }
+
+    {
+        JPS_SCOPED_TIMER_AND_TRACE(_timer, "Agent Sleep System", Detailed);
+        _agentSleepSystem.Update(_agents);
+        _timer.setCounter("Sleeping Agents", _agentSleepSystem.Sleeping());
+        _timer.setCounter("Skipped Agent Steps", _agentSleepSystem.SkippedSteps());
+    }
+    if(Profiler::instance().isEnabled()) {
+        traceAgentSamples();
+    }
     _clock.Advance();
 }
 
+void Simulation::traceAgentSamples() const
+{
+    const auto& config = Profiler::instance().config();
+    if(config.agentSampleInterval == 0 || _clock.Iteration() % config.agentSampleInterval != 0) {
+        return;
+    }
+    JPS_TRACE_EVENT("Agent Samples");
+    struct Bucket {
+        size_t agents{0};
+        size_t neighbors{0};
+        size_t walls{0};
+    };
+    std::vector<Bucket> buckets(config.agentBuckets);
+    for(const auto& agent : _agents) {
+        auto& bucket = buckets[agent.id.getID() % buckets.size()];
+        ++bucket.agents;
+        _neighborhoodSearch.ForEachInRange(
+            agent.Position(), config.agentSampleRadius, [&bucket, &agent](const auto& neighbor) {
+                if(neighbor.id != agent.id) {
+                    ++bucket.neighbors;
+                }
+            });
+        for([[maybe_unused]] const auto& wall : _geometry.Geometry().LineSegmentsInDistanceTo(
+                config.agentSampleRadius, agent.Position())) {
+            ++bucket.walls;
+        }
+    }
+    for(size_t index = 0; index < buckets.size(); ++index) {
+        const auto& bucket = buckets[index];
+        if(bucket.agents == 0) {
+            continue;
+        }
+        const auto agents = static_cast<double>(bucket.agents);
+        TRACE_COUNTER(
+            "C++",
+            perfetto::CounterTrack(
+                perfetto::DynamicString{fmt::format("Agent Bucket {} Neighbors", index)}),
+            static_cast<double>(bucket.neighbors) / agents);
+        TRACE_COUNTER(
+            "C++",
+            perfetto::CounterTrack(
+                perfetto::DynamicString{fmt::format("Agent Bucket {} Walls", index)}),
+            static_cast<double>(bucket.walls) / agents);
+    }
+}
+
 Journey::ID Simulation::AddJourney(const std::map<BaseStage::ID, TransitionDescription>& stages)
 {
     ThrowIfIterating("AddJourney");
     JPS_SCOPED_TIMER_AND_TRACE(_timer, "Add Journey", Detailed);
-    std::map<BaseStage::ID, JourneyNode> nodes;
     bool containsDirectSteering =
         std::find_if(std::begin(stages), std::end(stages), [this](auto const& pair) {
             return std::holds_alternative<DirectSteeringProxy>(Stage(pair.first));
@@ -138,6 +404,13 @@ Journey::ID Simulation::AddJourney(const std::map<BaseStage::ID, TransitionDescr
             "Journeys containing a DirectSteeringStage, may only contain this stage.");
     }
 
+    return addJourney(stages, Journey::ID::Invalid);
+}
+
+Journey::ID
+Simulation::addJourney(const std::map<BaseStage::ID, TransitionDescription>& stages, Journey::ID id)
+{
+    std::map<BaseStage::ID, JourneyNode> nodes;
     std::transform(
         std::begin(stages),
         std::end(stages),
@@ -194,10 +467,12 @@ Journey::ID Simulation::AddJourney(const std::map<BaseStage::ID, TransitionDescr
                         desc)}};
         });
 
-    auto journey = std::make_unique<Journey>(std::move(nodes));
-    const auto id = journey->Id();
-    _journeys.emplace(id, std::move(journey));
-    return id;
+    auto journey = id != Journey::ID::Invalid ? std::make_unique<Journey>(std::move(nodes), id)
+                                              : std::make_unique<Journey>(std::move(nodes));
+    const auto journeyId = journey->Id();
+    _journeys.emplace(journeyId, std::move(journey));
+    _journeyDescriptions.emplace(journeyId, stages);
+    return journeyId;
 }
 
 BaseStage::ID Simulation::AddStage(const StageDescription stageDescription)
@@ -207,18 +482,18 @@ BaseStage::ID Simulation::AddStage(const StageDescription stageDescription)
     std::visit(
         overloaded{
             [this](const WaypointDescription& d) -> void {
-                if(!this->_geometry->InsideGeometry(d.position)) {
+                if(!this->_geometry.Geometry().InsideGeometry(d.position)) {
                     throw SimulationError("WayPoint {} not inside walkable area", d.position);
                 }
             },
             [this](const ExitDescription& d) -> void {
-                if(!this->_geometry->InsideGeometry(d.polygon.Centroid())) {
+                if(!this->_geometry.Geometry().InsideGeometry(d.polygon.Centroid())) {
                     throw SimulationError("Exit {} not inside walkable area", d.polygon.Centroid());
                 }
             },
             [this](const NotifiableWaitingSetDescription& d) -> void {
                 for(const auto& point : d.slots) {
-                    if(!this->_geometry->InsideGeometry(point)) {
+                    if(!this->_geometry.Geometry().InsideGeometry(point)) {
                         throw SimulationError(
                             "NotifiableWaitingSet point {} not inside walkable area", point);
                     }
@@ -226,7 +501,7 @@ BaseStage::ID Simulation::AddStage(const StageDescription stageDescription)
             },
             [this](const NotifiableQueueDescription& d) -> void {
                 for(const auto& point : d.slots) {
-                    if(!this->_geometry->InsideGeometry(point)) {
+                    if(!this->_geometry.Geometry().InsideGeometry(point)) {
                         throw SimulationError(
                             "NotifiableQueue point {} not inside walkable area", point);
                     }
@@ -237,14 +512,20 @@ BaseStage::ID Simulation::AddStage(const StageDescription stageDescription)
             }},
         stageDescription);
 
-    return _stageManager.AddStage(stageDescription, _removedAgentsInLastIteration);
+    return addStage(stageDescription, BaseStage::ID::Invalid);
 }
 
-GenericAgent::ID Simulation::AddAgent(GenericAgent agent)
+BaseStage::ID Simulation::addStage(const StageDescription& stageDescription, BaseStage::ID id)
 {
-    ThrowIfIterating("AddAgent");
-    JPS_SCOPED_TIMER_AND_TRACE(_timer, "Add Agent", Detailed);
-    if(!_geometry->InsideGeometry(agent.Position())) {
+    const auto stageId =
+        _stageManager.AddStage(stageDescription, _removedAgentsInLastIteration, id);
+    _stageDescriptions.emplace(stageId, stageDescription);
+    return stageId;
+}
+
+void Simulation::validateNewAgent(const GenericAgent& agent) const
+{
+    if(!_geometry.Geometry().InsideGeometry(agent.Position())) {
         throw SimulationError("Agent {} not inside walkable area", agent.Position());
     }
     if(_journeys.count(agent.journeyId) == 0) {
@@ -263,8 +544,15 @@ GenericAgent::ID Simulation::AddAgent(GenericAgent agent)
             ToString(agentModelType),
             ToString(_operationalDecisionSystem.ModelType()));
     }
+}
 
-    _operationalDecisionSystem.ValidateAgent(agent, _neighborhoodSearch, *_geometry);
+GenericAgent::ID Simulation::AddAgent(GenericAgent agent)
+{
+    ThrowIfIterating("AddAgent");
+    JPS_SCOPED_TIMER_AND_TRACE(_timer, "Add Agent", Detailed);
+    validateNewAgent(agent);
+    _operationalDecisionSystem.ValidateAgent(agent, _neighborhoodSearch, _geometry.Geometry());
+    _operationalDecisionSystem.Model().AdoptState(agent.state);
 
     _stageManager.HandleNewAgent(agent.stageId);
     _agents.emplace_back(std::move(agent));
@@ -272,10 +560,61 @@ GenericAgent::ID Simulation::AddAgent(GenericAgent agent)
 
     auto v = IteratorPair(std::prev(std::end(_agents)), std::end(_agents));
     _stategicalDecisionSystem.Run(_journeys, v, _stageManager);
-    _tacticalDecisionSystem.Run(*_routingEngine, v);
+    _tacticalDecisionSystem.Run(_geometry.Routing(), v);
     return _agents.back().id.getID();
 }
 
+std::vector<GenericAgent::ID> Simulation::AddAgents(std::vector<GenericAgent> agents)
+{
+    ThrowIfIterating("AddAgents");
+    JPS_SCOPED_TIMER_AND_TRACE(_timer, "Add Agents", Detailed);
+    for(size_t index = 0; index < agents.size(); ++index) {
+        try {
+            validateNewAgent(agents[index]);
+        } catch(const SimulationError& e) {
+            throw SimulationError("Agent {} of batch rejected: {}", index, e.what());
+        }
+    }
+
+    // Insert all agents up front so that the model constraints are checked against the
+    // existing agents and the rest of the batch with a single grid.
+    const auto firstNew = static_cast<std::ptrdiff_t>(_agents.size());
+    for(auto& agent : agents) {
+        _agents.emplace_back(std::move(agent));
+        _neighborhoodSearch.AddAgent(_agents.back());
+    }
+    const auto rollback = [this, firstNew]() {
+        _agents.erase(std::next(std::begin(_agents), firstNew), std::end(_agents));
+        _neighborhoodSearch.Update(_agents);
+    };
+    auto added = IteratorPair(std::next(std::begin(_agents), firstNew), std::end(_agents));
+    size_t index = 0;
+    try {
+        for(const auto& agent : added) {
+            _operationalDecisionSystem.ValidateAgent(
+                agent, _neighborhoodSearch, _geometry.Geometry());
+            ++index;
+        }
+    } catch(const SimulationError& e) {
+        rollback();
+        throw SimulationError("Agent {} of batch rejected: {}", index, e.what());
+    } catch(...) {
+        rollback();
+        throw;
+    }
+
+    std::vector<GenericAgent::ID> ids{};
+    ids.reserve(agents.size());
+    for(auto& agent : added) {
+        _operationalDecisionSystem.Model().AdoptState(agent.state);
+        _stageManager.HandleNewAgent(agent.stageId);
+        ids.push_back(agent.id);
+    }
+    _stategicalDecisionSystem.Run(_journeys, added, _stageManager);
+    _tacticalDecisionSystem.RunGrouped(_geometry.Routing(), added);
+    return ids;
+}
+
 void Simulation::MarkAgentForRemoval(GenericAgent::ID id)
 {
     ThrowIfIterating("MarkAgentForRemoval");
@@ -331,6 +670,39 @@ uint64_t Simulation::Iteration() const
     return _clock.Iteration();
 }
 
+void Simulation::SetVerletSkin(double skin)
+{
+    ThrowIfIterating("SetVerletSkin");
+    _operationalDecisionSystem.SetVerletSkin(skin);
+}
+
+double Simulation::VerletSkin() const
+{
+    return _operationalDecisionSystem.VerletSkin();
+}
+
+void Simulation::SetMultiRateStepping(const MultiRateStepping& settings)
+{
+    ThrowIfIterating("SetMultiRateStepping");
+    _operationalDecisionSystem.SetMultiRateStepping(settings);
+}
+
+const MultiRateStepping& Simulation::MultiRate() const
+{
+    return _operationalDecisionSystem.MultiRate();
+}
+
+void Simulation::SetAgentSleep(const AgentSleep& settings)
+{
+    ThrowIfIterating("SetAgentSleep");
+    _agentSleepSystem.SetSettings(settings);
+}
+
+const AgentSleep& Simulation::Sleep() const
+{
+    return _agentSleepSystem.Settings();
+}
+
 size_t Simulation::AgentCount() const
 {
     return _agents.size();
@@ -341,6 +713,11 @@ AgentContainer<GenericAgent>& Simulation::Agents()
     return _agents;
 };
 
+const AgentContainer<GenericAgent>& Simulation::Agents() const
+{
+    return _agents;
+};
+
 void Simulation::SwitchAgentJourney(
     GenericAgent::ID agent_id,
     Journey::ID journey_id,
@@ -401,7 +778,7 @@ StageProxy Simulation::Stage(BaseStage::ID stageId)
 }
 CollisionGeometry Simulation::Geo() const
 {
-    return *_geometry;
+    return _geometry.Geometry();
 }
 
 void Simulation::PushTimer(const std::string_view name, size_t probe_log_level)
@@ -423,3 +800,214 @@ std::map<std::string, TimerEntry::duration_type> Simulation::GetTimerDurations()
 {
     return _timer.getDurations();
 }
+
+std::map<std::string, uint64_t> Simulation::GetTimerCounters() const
+{
+    return _timer.getCounters();
+}
+
+const TimerEntry* Simulation::GetTimerEntry(const std::string_view name) const
+{
+    return _timer.getEntry(name);
+}
+
+std::map<std::string, IterationStatistics> Simulation::GetTimerIterationStatistics() const
+{
+    return _timer.getIterationStatistics();
+}
+
+std::map<std::string, std::map<std::string, uint64_t>> Simulation::GetTimerHardwareCounters() const
+{
+    return _timer.getHardwareCounters();
+}
+
+MemoryBreakdown Simulation::MemoryReport() const
+{
+    using jps::memory::HeapBytes;
+    MemoryBreakdown report{};
+    report.bytes["simulation"] = sizeof(Simulation) + HeapBytes(_removedAgentsInLastIteration);
+    report.bytes["agents"] = HeapBytes(_agents);
+    report.bytes["operational_decision_system"] = _operationalDecisionSystem.MemoryUsage();
+    report.bytes["neighborhood_search"] = _neighborhoodSearch.MemoryUsage();
+    report.sharedBytes["collision_geometry"] =
+        sizeof(CollisionGeometry) + _geometry.Geometry().MemoryUsage();
+    report.sharedBytes["routing_engine"] =
+        sizeof(RoutingEngine) + _geometry.Routing().MemoryUsage();
+
+    size_t journeys = HeapBytes(_journeys) + HeapBytes(_journeyDescriptions);
+    for(const auto& [_, journey] : _journeys) {
+        journeys += journey->MemoryUsage();
+    }
+    report.bytes["journeys"] = journeys;
+
+    size_t stages = HeapBytes(_stageManager.Stages()) + HeapBytes(_stageDescriptions);
+    for(const auto& [_, stage] : _stageManager.Stages()) {
+        stages += stage->MemoryUsage();
+    }
+    report.bytes["stages"] = stages;
+
+    report.bytes["timer"] = _timer.memoryUsage();
+    report.sharedBytes["profiler"] = Profiler::instance().memoryUsage();
+    return report;
+}
+
+std::vector<uint8_t> Simulation::SaveCheckpoint() const
+{
+    ThrowIfIterating("SaveCheckpoint");
+    JPS_TRACE_FUNC;
+    if(ModelType() == OperationalModelType::CUSTOM_MODEL) {
+        throw SimulationError("Checkpoints are not supported for custom models");
+    }
+    checkpoint::Writer writer{};
+    for(const auto c : checkpoint::MAGIC) {
+        writer.Write(c);
+    }
+    writer.Write(checkpoint::FORMAT_VERSION);
+    writer.Write(static_cast<uint32_t>(ModelType()));
+    writer.Write(_clock.dT());
+    writer.Write(_clock.Iteration());
+    writer.Write(GenericAgent::ID::currentCounter());
+    writer.Write(BaseStage::ID::currentCounter());
+    writer.Write(Journey::ID::currentCounter());
+
+    writer.Write(static_cast<uint64_t>(_stageDescriptions.size()));
+    for(const auto& [id, description] : _stageDescriptions) {
+        writer.Write(id.getID());
+        writeStageDescription(writer, description);
+        const auto* stage = _stageManager.Stage(id);
+        if(const auto* waitingSet = dynamic_cast<const NotifiableWaitingSet*>(stage)) {
+            writer.WriteVector(rawIds(waitingSet->Occupants()));
+            writer.Write(waitingSet->State());
+        } else if(const auto* queue = dynamic_cast<const NotifiableQueue*>(stage)) {
+            writer.WriteVector(rawIds(queue->Occupants()));
+            const auto& exiting = queue->ExitingThisUpdate();
+            writer.WriteVector(
+                rawIds(std::vector<GenericAgent::ID>(exiting.begin(), exiting.end())));
+        }
+    }
+
+    writer.Write(static_cast<uint64_t>(_journeyDescriptions.size()));
+    for(const auto& [id, stages] : _journeyDescriptions) {
+        writer.Write(id.getID());
+        writer.Write(static_cast<uint64_t>(stages.size()));
+        const auto& nodes = _journeys.at(id)->Stages();
+        for(const auto& [stageId, description] : stages) {
+            writer.Write(stageId.getID());
+            writeTransitionDescription(writer, description);
+            const auto* roundRobin =
+                dynamic_cast<const RoundRobinTransition*>(nodes.at(stageId).transition.get());
+            writer.Write(roundRobin != nullptr ? roundRobin->NextCalled() : uint64_t{0});
+        }
+    }
+
+    writer.Write(static_cast<uint64_t>(_agents.size()));
+    for(const auto& agent : _agents) {
+        writeAgent(writer, agent);
+    }
+    writer.WriteVector(rawIds(_removedAgentsInLastIteration));
+    return writer.Release();
+}
+
+void Simulation::RestoreCheckpoint(std::span<const uint8_t> data)
+{
+    ThrowIfIterating("RestoreCheckpoint");
+    JPS_SCOPED_TIMER_AND_TRACE(_timer, "Restore Checkpoint", Detailed);
+    if(!_agents.empty() || !_stageDescriptions.empty() || !_journeys.empty() ||
+       _clock.Iteration() != 0) {
+        throw SimulationError("Checkpoints can only be restored into a newly created simulation");
+    }
+    checkpoint::Reader reader{data};
+    for(const auto c : checkpoint::MAGIC) {
+        if(reader.Read<char>() != c) {
+            throw SimulationError("Data is not a simulation checkpoint");
+        }
+    }
+    if(const auto version = reader.Read<uint32_t>(); version != checkpoint::FORMAT_VERSION) {
+        throw SimulationError(
+            "Unsupported checkpoint version {}, expected {}", version, checkpoint::FORMAT_VERSION);
+    }
+    if(const auto modelType = static_cast<OperationalModelType>(reader.Read<uint32_t>());
+       modelType != ModelType()) {
+        throw SimulationError(
+            "Checkpoint was written for operational model '{}', simulation uses '{}'",
+            ToString(modelType),
+            ToString(ModelType()));
+    }
+    if(const auto dT = reader.Read<double>(); dT != _clock.dT()) {
+        throw SimulationError(
+            "Checkpoint was written with dT={}, simulation uses dT={}", dT, _clock.dT());
+    }
+    _clock.Restore(reader.Read<uint64_t>());
+    GenericAgent::ID::advanceCounterTo(reader.Read<uint64_t>());
+    BaseStage::ID::advanceCounterTo(reader.Read<uint64_t>());
+    Journey::ID::advanceCounterTo(reader.Read<uint64_t>());
+
+    const auto stageCount = reader.Read<uint64_t>();
+    for(uint64_t index = 0; index < stageCount; ++index) {
+        const BaseStage::ID id{reader.Read<uint64_t>()};
+        addStage(readStageDescription(reader), id);
+        auto* stage = _stageManager.Stage(id);
+        if(auto* waitingSet = dynamic_cast<NotifiableWaitingSet*>(stage)) {
+            auto occupants = idsFromRaw<GenericAgent::ID>(reader.ReadVector<uint64_t>());
+            waitingSet->Restore(std::move(occupants), reader.Read<WaitingSetState>());
+        } else if(auto* queue = dynamic_cast<NotifiableQueue*>(stage)) {
+            auto occupants = idsFromRaw<GenericAgent::ID>(reader.ReadVector<uint64_t>());
+            const auto exiting = idsFromRaw<GenericAgent::ID>(reader.ReadVector<uint64_t>());
+            queue->Restore(std::move(occupants), {exiting.begin(), exiting.end()});
+        }
+    }
+
+    const auto journeyCount = reader.Read<uint64_t>();
+    for(uint64_t index = 0; index < journeyCount; ++index) {
+        const Journey::ID id{reader.Read<uint64_t>()};
+        const auto nodeCount = reader.Read<uint64_t>();
+        std::map<BaseStage::ID, TransitionDescription> stages{};
+        std::map<BaseStage::ID, uint64_t> roundRobinCounters{};
+        for(uint64_t node = 0; node < nodeCount; ++node) {
+            const BaseStage::ID stageId{reader.Read<uint64_t>()};
+            stages.emplace(stageId, readTransitionDescription(reader));
+            roundRobinCounters.emplace(stageId, reader.Read<uint64_t>());
+        }
+        addJourney(stages, id);
+        const auto& nodes = _journeys.at(id)->Stages();
+        for(const auto& [stageId, counter] : roundRobinCounters) {
+            if(auto* roundRobin =
+                   dynamic_cast<RoundRobinTransition*>(nodes.at(stageId).transition.get())) {
+                roundRobin->NextCalled(counter);
+            }
+        }
+    }
+
+    const auto agentCount = reader.Read<uint64_t>();
+    for(uint64_t index = 0; index < agentCount; ++index) {
+        auto agent = readAgent(reader);
+        const auto journey = _journeys.find(agent.journeyId);
+        if(journey == std::end(_journeys) || !journey->second->ContainsStage(agent.stageId)) {
+            throw SimulationError("Corrupt checkpoint: agent {} has an unknown target", agent.id);
+        }
+        // Agents are restored as they were, the decision systems must not run on them.
+        _stageManager.HandleNewAgent(agent.stageId);
+        _agents.emplace_back(std::move(agent));
+        _neighborhoodSearch.AddAgent(_agents.back());
+    }
+    _removedAgentsInLastIteration =
+        idsFromRaw<GenericAgent::ID>(reader.ReadVector<uint64_t>());
+    if(!reader.AtEnd()) {
+        throw SimulationError("Corrupt checkpoint: trailing data");
+    }
+}
+
+std::unique_ptr<Simulation> Simulation::Fork() const
+{
+    ThrowIfIterating("Fork");
+    auto fork = std::make_unique<Simulation>(
+        _operationalDecisionSystem.Model().Clone(),
+        _geometry,
+        _clock.dT());
+    fork->RestoreCheckpoint(SaveCheckpoint());
+    fork->SetTimerLogLevel(_timer.getLogLevel());
+    fork->SetVerletSkin(VerletSkin());
+    fork->SetMultiRateStepping(MultiRate());
+    fork->SetAgentSleep(Sleep());
+    return fork;
+}
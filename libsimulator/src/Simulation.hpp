@@ -2,9 +2,13 @@
 #pragma once
 
 #include "AgentRemovalSystem.hpp"
+#include "AgentSleepSystem.hpp"
 #include "CollisionGeometry.hpp"
 #include "GenericAgent.hpp"
+#include "GeometryBundle.hpp"
 #include "Journey.hpp"
+#include "MemoryUsage.hpp"
+#include "MultiRateStepping.hpp"
 #include "NeighborhoodSearch.hpp"
 #include "OperationalDecisionSystem.hpp"
 #include "OperationalModel.hpp"
@@ -24,6 +28,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <span>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -35,14 +40,17 @@ class Simulation
     TacticalDecisionSystem _tacticalDecisionSystem{};
     OperationalDecisionSystem _operationalDecisionSystem;
     AgentRemovalSystem<GenericAgent> _agentRemovalSystem{};
+    AgentSleepSystem _agentSleepSystem{};
     StageManager _stageManager{};
     StageSystem _stageSystem{};
     NeighborhoodSearch<GenericAgent> _neighborhoodSearch{2.2};
-    std::unique_ptr<CollisionGeometry> _geometry{};
-    std::unique_ptr<RoutingEngine> _routingEngine{};
+    GeometryBundle _geometry;
     AgentContainer<GenericAgent> _agents;
     std::vector<GenericAgent::ID> _removedAgentsInLastIteration;
     std::unordered_map<Journey::ID, std::unique_ptr<Journey>> _journeys;
+    /// Descriptions of all stages and journeys, kept to be able to write checkpoints.
+    std::map<BaseStage::ID, StageDescription> _stageDescriptions{};
+    std::map<Journey::ID, std::map<BaseStage::ID, TransitionDescription>> _journeyDescriptions{};
     Timer _timer{};
     /// Set for the duration of Iterate(); mutating entry points must not run while the
     /// iteration pipeline works on the agent containers.
@@ -50,12 +58,24 @@ class Simulation
     enum LogLevel { General = 1, Detailed = 2, Debug = 3 };
 
     void ThrowIfIterating(const char* operation) const;
+    /// Checks position, journey, stage and model type of an agent about to be added.
+    void validateNewAgent(const GenericAgent& agent) const;
+    /// Records the agent samples of Profiler::config as counter tracks if they are due.
+    void traceAgentSamples() const;
+    BaseStage::ID addStage(const StageDescription& stageDescription, BaseStage::ID id);
+    Journey::ID
+    addJourney(const std::map<BaseStage::ID, TransitionDescription>& stages, Journey::ID id);
 
 public:
     Simulation(
         std::unique_ptr<OperationalModel>&& operationalModel,
         std::unique_ptr<CollisionGeometry>&& geometry,
         double dT);
+    /// Shares the geometry and routing engine of 'geometry' with all other simulations using it.
+    Simulation(
+        std::unique_ptr<OperationalModel>&& operationalModel,
+        GeometryBundle geometry,
+        double dT);
     Simulation(const Simulation& other) = delete;
     Simulation& operator=(const Simulation& other) = delete;
     Simulation(Simulation&& other) = delete;
@@ -63,6 +83,17 @@ public:
     ~Simulation() = default;
     const SimulationClock& Clock() const;
     void SetTracing(bool on);
+    /// Serves the neighbor queries of the operational model from Verlet lists built at its
+    /// cutoff plus 'skin', see VerletList. A skin of 0 switches them off.
+    void SetVerletSkin(double skin);
+    double VerletSkin() const;
+    /// Lets agents in dense spots advance in sub-steps of dT, see MultiRateStepping.
+    void SetMultiRateStepping(const MultiRateStepping& settings);
+    const MultiRateStepping& MultiRate() const;
+    /// Puts idle agents to sleep so that the tactical and operational systems skip them, see
+    /// AgentSleep. The number of sleeping agents is reported in the timer counters.
+    void SetAgentSleep(const AgentSleep& settings);
+    const AgentSleep& Sleep() const;
     void Iterate();
     Journey::ID AddJourney(const std::map<BaseStage::ID, TransitionDescription>& stages);
     BaseStage::ID AddStage(const StageDescription stageDescription);
@@ -79,15 +110,51 @@ public:
     /// @param polygon Required to be a simple convex polygon with CCW ordering.
     std::vector<GenericAgent::ID> AgentsInPolygon(const std::vector<Point>& polygon);
     GenericAgent::ID AddAgent(GenericAgent agent);
+    /// Adds all agents or, if any of them is invalid, none of them. Agents are validated
+    /// against the existing agents and each other. The error names the index of the first
+    /// rejected agent.
+    std::vector<GenericAgent::ID> AddAgents(std::vector<GenericAgent> agents);
     const GenericAgent& Agent(GenericAgent::ID id) const;
     GenericAgent& Agent(GenericAgent::ID id);
     AgentContainer<GenericAgent>& Agents();
+    const AgentContainer<GenericAgent>& Agents() const;
     OperationalModelType ModelType() const;
     StageProxy Stage(BaseStage::ID stageId);
     CollisionGeometry Geo() const;
+    const GeometryBundle& Bundle() const { return _geometry; }
     void PushTimer(const std::string_view name, size_t probe_log_level = 0);
     void PopTimer(const std::string_view name);
     void SetTimerLogLevel(int level) { _timer.setLogLevel(level); };
     TimerEntry::duration_type GetTimerDuration(const std::string_view name) const;
     std::map<std::string, TimerEntry::duration_type> GetTimerDurations() const;
+    std::map<std::string, uint64_t> GetTimerCounters() const;
+    /// Records one sample per iteration and timer probe from now on, off by default as the
+    /// samples grow with the number of iterations.
+    void SetTimerIterationSampling(bool enabled) { _timer.setIterationSampling(enabled); }
+    /// Per iteration samples of a timer probe, nullptr if the probe never ran.
+    const TimerEntry* GetTimerEntry(const std::string_view name) const;
+    std::map<std::string, IterationStatistics> GetTimerIterationStatistics() const;
+    /// Reads hardware counters around every timer probe, see Timer::enableHardwareCounters.
+    /// Returns false if they are not available.
+    bool EnableTimerHardwareCounters() { return _timer.enableHardwareCounters(); }
+    void DisableTimerHardwareCounters() { _timer.disableHardwareCounters(); }
+    std::map<std::string, std::map<std::string, uint64_t>> GetTimerHardwareCounters() const;
+    /// Bytes held by the parts of the simulation: "agents", "operational_decision_system"
+    /// (with the double buffer of the agents), "neighborhood_search", "journeys", "stages",
+    /// "timer" and the "simulation" object itself. The "collision_geometry" and "routing_engine"
+    /// of the GeometryBundle, which other simulations may share, and the process wide "profiler"
+    /// are reported apart in MemoryBreakdown::sharedBytes, so that summing the reports of several
+    /// simulations does not count them more than once. The numbers are estimates from the sizes
+    /// and capacities of the containers, see jps::memory::HeapBytes.
+    MemoryBreakdown MemoryReport() const;
+    /// Serialises stages, journeys, agents and the clock. Models keep no state of their own, their
+    /// random numbers are derived from the seed and the iteration, see AgentStep::Random.
+    /// Checkpoints of simulations using a custom model are not supported.
+    std::vector<uint8_t> SaveCheckpoint() const;
+    /// Restores a checkpoint written by 'SaveCheckpoint'. The simulation has to be newly
+    /// constructed with the same model and dT and may not contain stages, journeys or agents.
+    /// Stages, journeys and agents keep their ids. On error the simulation has to be discarded.
+    void RestoreCheckpoint(std::span<const uint8_t> data);
+    /// Creates an independent simulation in the same state.
+    std::unique_ptr<Simulation> Fork() const;
 };
@@ -12,6 +12,11 @@ void SimulationClock::Advance()
     ++_iteration;
 }
 
+void SimulationClock::Restore(uint64_t iteration)
+{
+    _iteration = iteration;
+}
+
 double SimulationClock::ElapsedTime() const
 {
     return _dT * _iteration;
@@ -13,6 +13,9 @@ public:
 
     void Advance();
 
+    /// Sets the iteration counter, used when restoring checkpoints.
+    void Restore(uint64_t iteration);
+
     double ElapsedTime() const;
 
     uint64_t Iteration() const;
@@ -0,0 +1,329 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "SqliteTrajectoryWriter.hpp"
+
+#include "Simulation.hpp"
+#include "SimulationError.hpp"
+
+#include <fmt/core.h>
+#include <sqlite3.h>
+
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <utility>
+
+SqliteTrajectoryWriter::SqliteTrajectoryWriter(Options options) : _options(std::move(options))
+{
+    if(_options.everyNthFrame < 1) {
+        throw SimulationError("'every_nth_frame' has to be > 0");
+    }
+    if(_options.bufferCount < 1) {
+        throw SimulationError("'buffer_count' has to be > 0");
+    }
+    if(_options.commitEveryNthWrite < 1) {
+        throw SimulationError("'commit_every_nth_write' has to be > 0");
+    }
+    _buffers.resize(_options.bufferCount);
+    _free.resize(_options.bufferCount);
+    std::iota(std::rbegin(_free), std::rend(_free), size_t{0});
+
+    const auto path = _options.outputFile.string();
+    if(sqlite3_open(path.c_str(), &_db) != SQLITE_OK) {
+        const std::string msg = _db ? sqlite3_errmsg(_db) : "out of memory";
+        sqlite3_close(_db);
+        _db = nullptr;
+        throw SimulationError("Error opening database {}: {}", path, msg);
+    }
+    // Don't wait for the OS to persist data
+    exec("PRAGMA synchronous=OFF;");
+    // Don't allow rollbacks (we don't have need for it)
+    exec("PRAGMA journal_mode=OFF;");
+}
+
+SqliteTrajectoryWriter::~SqliteTrajectoryWriter()
+{
+    try {
+        Close();
+    } catch(const std::exception&) {
+        // Errors cannot be reported from a destructor, call 'Close()' to observe them.
+    }
+}
+
+void SqliteTrajectoryWriter::BeginWriting(
+    double dT,
+    const std::string& geometryWkt,
+    int64_t geometryHash,
+    AABB bounds)
+{
+    if(!_db) {
+        throw SimulationError("Database not opened.");
+    }
+    if(_worker.joinable()) {
+        throw SimulationError("Trajectory writer has already begun writing");
+    }
+    _geometryHash = geometryHash;
+    const auto fps = 1.0 / dT / static_cast<double>(_options.everyNthFrame);
+
+    exec("BEGIN");
+    exec("DROP TABLE IF EXISTS trajectory_data");
+    exec("CREATE TABLE trajectory_data ("
+         "   frame INTEGER NOT NULL,"
+         "   id INTEGER NOT NULL,"
+         "   pos_x REAL NOT NULL,"
+         "   pos_y REAL NOT NULL)");
+    exec("DROP TABLE IF EXISTS metadata");
+    exec("CREATE TABLE metadata(key TEXT NOT NULL UNIQUE PRIMARY KEY, value TEXT NOT NULL)");
+    exec("DROP TABLE IF EXISTS geometry");
+    exec("CREATE TABLE geometry("
+         "   hash INTEGER NOT NULL, "
+         "   wkt TEXT NOT NULL)");
+    exec("CREATE UNIQUE INDEX geometry_hash on geometry( hash)");
+    exec("DROP TABLE IF EXISTS frame_data");
+    exec("CREATE TABLE frame_data("
+         "   frame INTEGER NOT NULL,"
+         "   geometry_hash INTEGER NOT NULL)");
+    exec("CREATE INDEX frame_id_idx ON trajectory_data(frame, id)");
+
+    sqlite3_stmt* stmt{nullptr};
+    auto prepare = [this](const char* sql, sqlite3_stmt** out) {
+        if(sqlite3_prepare_v2(_db, sql, -1, out, nullptr) != SQLITE_OK) {
+            throw SimulationError("Error preparing statement '{}': {}", sql, sqlite3_errmsg(_db));
+        }
+    };
+    auto step = [this](sqlite3_stmt* s) {
+        if(sqlite3_step(s) != SQLITE_DONE) {
+            throw SimulationError("Error writing to database: {}", sqlite3_errmsg(_db));
+        }
+        sqlite3_reset(s);
+    };
+
+    prepare("INSERT INTO metadata VALUES(?, ?)", &stmt);
+    const std::pair<std::string, std::string> metadata[] = {
+        {"version", std::to_string(DATABASE_VERSION)},
+        {"fps", fmt::format("{}", fps)},
+        {"xmin", fmt::format("{}", bounds.xmin)},
+        {"xmax", fmt::format("{}", bounds.xmax)},
+        {"ymin", fmt::format("{}", bounds.ymin)},
+        {"ymax", fmt::format("{}", bounds.ymax)}};
+    for(const auto& [key, value] : metadata) {
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+        step(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    prepare("INSERT INTO geometry VALUES(?, ?)", &stmt);
+    sqlite3_bind_int64(stmt, 1, geometryHash);
+    sqlite3_bind_text(stmt, 2, geometryWkt.c_str(), -1, SQLITE_TRANSIENT);
+    step(stmt);
+    sqlite3_finalize(stmt);
+    exec("COMMIT");
+
+    prepare("INSERT INTO trajectory_data VALUES(?, ?, ?, ?)", &_insertPosition);
+    prepare("INSERT INTO frame_data VALUES(?, ?)", &_insertFrame);
+
+    _worker = std::thread([this]() { run(); });
+}
+
+void SqliteTrajectoryWriter::WriteIterationState(const Simulation& simulation)
+{
+    const auto iteration = simulation.Iteration();
+    if(iteration % _options.everyNthFrame != 0) {
+        return;
+    }
+    if(!_worker.joinable()) {
+        throw SimulationError("Trajectory writer is not writing, call 'BeginWriting' first");
+    }
+
+    size_t index{};
+    {
+        std::unique_lock lock(_mutex);
+        if(_free.empty() && _options.backpressure == Backpressure::DropFrames) {
+            ++_droppedFrames;
+            return;
+        }
+        _bufferReleased.wait(lock, [this]() { return !_free.empty() || !_error.empty(); });
+        if(!_error.empty()) {
+            throw SimulationError("Error writing to database: {}", _error);
+        }
+        index = _free.back();
+        _free.pop_back();
+    }
+
+    // The buffer is exclusively owned by this thread until it is queued, vectors keep their
+    // capacity between frames so this does not allocate once the agent count has settled.
+    auto& buffer = _buffers[index];
+    const auto& agents = simulation.Agents();
+    buffer.frame = iteration / _options.everyNthFrame;
+    buffer.ids.clear();
+    buffer.xs.clear();
+    buffer.ys.clear();
+    buffer.ids.reserve(agents.size());
+    buffer.xs.reserve(agents.size());
+    buffer.ys.reserve(agents.size());
+    for(const auto& agent : agents) {
+        const auto pos = agent.Position();
+        buffer.ids.push_back(agent.id.getID());
+        buffer.xs.push_back(pos.x);
+        buffer.ys.push_back(pos.y);
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        _pending.push_back(index);
+    }
+    _workAvailable.notify_one();
+}
+
+void SqliteTrajectoryWriter::Flush()
+{
+    if(!_worker.joinable()) {
+        return;
+    }
+    {
+        std::unique_lock lock(_mutex);
+        _commitRequested = true;
+        _workAvailable.notify_one();
+        _bufferReleased.wait(
+            lock, [this]() { return _pending.empty() && !_busy && !_commitRequested; });
+    }
+    throwIfFailed();
+}
+
+void SqliteTrajectoryWriter::Close()
+{
+    if(_worker.joinable()) {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _workAvailable.notify_one();
+        _worker.join();
+    }
+    sqlite3_finalize(_insertPosition);
+    _insertPosition = nullptr;
+    sqlite3_finalize(_insertFrame);
+    _insertFrame = nullptr;
+    if(_db) {
+        sqlite3_close(_db);
+        _db = nullptr;
+    }
+    // Report a failure of the I/O thread once, later calls are no-ops.
+    std::string error{};
+    {
+        std::lock_guard lock(_mutex);
+        std::swap(error, _error);
+    }
+    if(!error.empty()) {
+        throw SimulationError("Error writing to database: {}", error);
+    }
+}
+
+uint64_t SqliteTrajectoryWriter::DroppedFrames() const
+{
+    std::lock_guard lock(_mutex);
+    return _droppedFrames;
+}
+
+void SqliteTrajectoryWriter::run()
+{
+    size_t uncommitted{0};
+    bool failed{false};
+    auto commit = [&]() {
+        if(uncommitted > 0 && !failed) {
+            exec("COMMIT");
+        }
+        uncommitted = 0;
+    };
+    auto fail = [&](const std::exception& ex) {
+        std::lock_guard lock(_mutex);
+        _error = ex.what();
+        failed = true;
+    };
+
+    std::unique_lock lock(_mutex);
+    while(true) {
+        _workAvailable.wait(
+            lock, [this]() { return !_pending.empty() || _commitRequested || _stop; });
+
+        if(!_pending.empty()) {
+            const auto index = _pending.front();
+            _pending.pop_front();
+            _busy = true;
+            lock.unlock();
+            // After a failure buffers are still recycled so the producer never deadlocks, the
+            // error is reported on its next call.
+            if(!failed) {
+                try {
+                    if(uncommitted == 0) {
+                        exec("BEGIN");
+                    }
+                    writeFrame(_buffers[index]);
+                    if(++uncommitted >= _options.commitEveryNthWrite) {
+                        commit();
+                    }
+                } catch(const std::exception& ex) {
+                    fail(ex);
+                }
+            }
+            lock.lock();
+            _free.push_back(index);
+            _busy = false;
+            _bufferReleased.notify_all();
+            continue;
+        }
+
+        lock.unlock();
+        try {
+            commit();
+        } catch(const std::exception& ex) {
+            fail(ex);
+        }
+        lock.lock();
+        _commitRequested = false;
+        _bufferReleased.notify_all();
+        if(_stop) {
+            return;
+        }
+    }
+}
+
+void SqliteTrajectoryWriter::writeFrame(const FrameBuffer& buffer)
+{
+    const auto frame = static_cast<sqlite3_int64>(buffer.frame);
+    for(size_t idx = 0; idx < buffer.ids.size(); ++idx) {
+        sqlite3_bind_int64(_insertPosition, 1, frame);
+        sqlite3_bind_int64(_insertPosition, 2, static_cast<sqlite3_int64>(buffer.ids[idx]));
+        sqlite3_bind_double(_insertPosition, 3, buffer.xs[idx]);
+        sqlite3_bind_double(_insertPosition, 4, buffer.ys[idx]);
+        if(sqlite3_step(_insertPosition) != SQLITE_DONE) {
+            throw SimulationError("Error writing to database: {}", sqlite3_errmsg(_db));
+        }
+        sqlite3_reset(_insertPosition);
+    }
+    sqlite3_bind_int64(_insertFrame, 1, frame);
+    sqlite3_bind_int64(_insertFrame, 2, _geometryHash);
+    if(sqlite3_step(_insertFrame) != SQLITE_DONE) {
+        throw SimulationError("Error writing to database: {}", sqlite3_errmsg(_db));
+    }
+    sqlite3_reset(_insertFrame);
+}
+
+void SqliteTrajectoryWriter::exec(const char* sql)
+{
+    char* err{nullptr};
+    if(sqlite3_exec(_db, sql, nullptr, nullptr, &err) != SQLITE_OK) {
+        const std::string msg = err ? err : "unknown error";
+        sqlite3_free(err);
+        throw SimulationError("Error executing '{}': {}", sql, msg);
+    }
+}
+
+void SqliteTrajectoryWriter::throwIfFailed()
+{
+    std::lock_guard lock(_mutex);
+    if(!_error.empty()) {
+        throw SimulationError("Error writing to database: {}", _error);
+    }
+}
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "AABB.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct sqlite3;
+struct sqlite3_stmt;
+class Simulation;
+
+/// Writes trajectory data into the same sqlite schema the Python 'SqliteTrajectoryWriter'
+/// produces, so 'Recording' can read the output unchanged.
+///
+/// Agent positions are copied into one of a fixed number of preallocated frame buffers on the
+/// simulation thread. A background thread drains the filled buffers and appends them to the
+/// database with prepared statements inside large transactions. If all buffers are in flight the
+/// configured 'Backpressure' decides whether the simulation thread waits or the frame is dropped.
+///
+/// Only built with the CMake option WITH_NATIVE_SQLITE_WRITER, which links against the SQLite
+/// installed on the build machine and defines JPS_WITH_NATIVE_SQLITE_WRITER.
+class SqliteTrajectoryWriter
+{
+public:
+    /// Must be kept in sync with 'DATABASE_VERSION' in sqlite_serialization.py
+    static constexpr int DATABASE_VERSION = 3;
+
+    enum class Backpressure {
+        /// Wait on the simulation thread until a buffer is available.
+        Block,
+        /// Skip the frame and count it, see 'DroppedFrames()'.
+        DropFrames
+    };
+
+    struct Options {
+        std::filesystem::path outputFile{};
+        uint64_t everyNthFrame{4};
+        /// Number of frame buffers shared between simulation and I/O thread.
+        size_t bufferCount{16};
+        /// Number of frames written per transaction.
+        size_t commitEveryNthWrite{100};
+        Backpressure backpressure{Backpressure::Block};
+    };
+
+private:
+    struct FrameBuffer {
+        uint64_t frame{};
+        std::vector<uint64_t> ids{};
+        std::vector<double> xs{};
+        std::vector<double> ys{};
+    };
+
+    Options _options;
+    int64_t _geometryHash{};
+    sqlite3* _db{nullptr};
+    sqlite3_stmt* _insertPosition{nullptr};
+    sqlite3_stmt* _insertFrame{nullptr};
+
+    std::vector<FrameBuffer> _buffers{};
+    // Indices into '_buffers', guarded by '_mutex'
+    std::vector<size_t> _free{};
+    std::deque<size_t> _pending{};
+    bool _busy{false};
+    bool _commitRequested{false};
+    bool _stop{false};
+    std::string _error{};
+    uint64_t _droppedFrames{0};
+    mutable std::mutex _mutex{};
+    std::condition_variable _workAvailable{};
+    std::condition_variable _bufferReleased{};
+    std::thread _worker{};
+
+public:
+    explicit SqliteTrajectoryWriter(Options options);
+    SqliteTrajectoryWriter(const SqliteTrajectoryWriter& other) = delete;
+    SqliteTrajectoryWriter& operator=(const SqliteTrajectoryWriter& other) = delete;
+    SqliteTrajectoryWriter(SqliteTrajectoryWriter&& other) = delete;
+    SqliteTrajectoryWriter& operator=(SqliteTrajectoryWriter&& other) = delete;
+    /// Flushes all pending frames, see 'Close()'.
+    ~SqliteTrajectoryWriter();
+
+    /// Creates the schema, writes metadata and geometry and starts the I/O thread.
+    /// @param dT simulation step size used to derive the fps metadata
+    /// @param geometryWkt walkable area as WKT
+    /// @param geometryHash key under which the geometry is stored and referenced by 'frame_data'
+    /// @param bounds bounding box of the walkable area
+    void BeginWriting(double dT, const std::string& geometryWkt, int64_t geometryHash, AABB bounds);
+    /// Snapshots all agent positions if the current iteration is to be written.
+    void WriteIterationState(const Simulation& simulation);
+    /// Blocks until all frames handed over so far are committed to disk.
+    void Flush();
+    /// Flushes, stops the I/O thread and closes the database. Calling it again has no effect.
+    void Close();
+
+    uint64_t EveryNthFrame() const { return _options.everyNthFrame; }
+    uint64_t DroppedFrames() const;
+
+private:
+    void run();
+    void writeFrame(const FrameBuffer& buffer);
+    void exec(const char* sql);
+    void throwIfFailed();
+};
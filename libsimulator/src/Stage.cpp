@@ -1,7 +1,9 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "Stage.hpp"
 
+#include "CfgCgal.hpp"
 #include "GenericAgent.hpp"
+#include "MemoryUsage.hpp"
 #include "Point.hpp"
 #include "Polygon.hpp"
 #include "Simulation.hpp"
@@ -11,10 +13,51 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <list>
+#include <span>
 #include <utility>
 #include <vector>
 
+namespace
+{
+/// Agents within this distance of a free slot, with nothing in between, can occupy it.
+constexpr double slotCaptureRadius = 2.0;
+/// Agents are noticed a bit further out, they still move until the stage updates next. This
+/// holds as long as no agent moves more than 1 m per iteration.
+constexpr double slotNoticeRadius = slotCaptureRadius + 1.0;
+
+/// Agents this close to the border of a stage are left to the exact IsCompleted test.
+constexpr double completionTolerance = 1e-6;
+
+bool nearSlot(const GenericAgent& agent, Point slot)
+{
+    return DistanceSquared(agent.Position(), slot) <= slotNoticeRadius * slotNoticeRadius;
+}
+
+/// Closest agent accepted by 'isCandidate' that can occupy 'slot', ID::Invalid if there is none.
+template <typename Pred>
+GenericAgent::ID closestCandidate(const EnvironmentQuery& envQuery, Point slot, Pred&& isCandidate)
+{
+    const auto& boundaries = envQuery.LineSegmentsInRange(slot);
+    GenericAgent::ID occupant = GenericAgent::ID::Invalid;
+    double min_distance = std::numeric_limits<double>::max();
+    envQuery.ForEachAgentInRange(slot, slotCaptureRadius, [&](const GenericAgent& agent) {
+        if(!isCandidate(agent)) {
+            return;
+        }
+        const auto distance = (agent.Position() - slot).Norm();
+        if(distance < min_distance &&
+           envQuery.NoGeometryBetween(slot, agent.Position(), boundaries)) {
+            min_distance = distance;
+            occupant = agent.id;
+        }
+    });
+    return occupant;
+}
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Base Proxy
 ////////////////////////////////////////////////////////////////////////////////
@@ -92,6 +135,18 @@ bool Waypoint::IsCompleted(const GenericAgent& agent)
     return actual_distance <= distance;
 }
 
+void Waypoint::FilterCompleted(std::span<const Point> positions, std::span<uint8_t> candidates)
+    const
+{
+    const double maxDistance = distance + completionTolerance;
+    const double maxDistanceSquared = maxDistance * maxDistance;
+    for(size_t index = 0; index < positions.size(); ++index) {
+        const Point relative = positions[index] - position;
+        const double distanceSquared = relative.x * relative.x + relative.y * relative.y;
+        candidates[index] &= distanceSquared <= maxDistanceSquared ? 1 : 0;
+    }
+}
+
 Point Waypoint::Target(const GenericAgent&)
 {
     return position;
@@ -111,6 +166,15 @@ Exit::Exit(Polygon area_, std::vector<GenericAgent::ID>& toRemove_)
     if(!area.IsConvex()) {
         throw SimulationError("Exit areas need to be bounded by convex polygons.");
     }
+    const auto points = area.Points();
+    for(size_t index = 0; index < points.size(); ++index) {
+        const Point from = points[index];
+        const Point to = points[(index + 1) % points.size()];
+        // The vertices are in counter clockwise order, the inside is left of each edge.
+        const Point normal = Point{from.y - to.y, to.x - from.x}.Normalized();
+        edgeNormals.push_back(normal);
+        edgeOffsets.push_back(normal.ScalarProduct(from));
+    }
 }
 
 bool Exit::IsCompleted(const GenericAgent& agent)
@@ -122,6 +186,20 @@ bool Exit::IsCompleted(const GenericAgent& agent)
     return hasReachedExit;
 }
 
+void Exit::FilterCompleted(std::span<const Point> positions, std::span<uint8_t> candidates) const
+{
+    // One edge at a time over all agents, a convex area contains the points on the inner side
+    // of all its edges.
+    for(size_t edge = 0; edge < edgeNormals.size(); ++edge) {
+        const Point normal = edgeNormals[edge];
+        const double offset = edgeOffsets[edge] - completionTolerance;
+        for(size_t index = 0; index < positions.size(); ++index) {
+            const double side = normal.x * positions[index].x + normal.y * positions[index].y;
+            candidates[index] &= side >= offset ? 1 : 0;
+        }
+    }
+}
+
 Point Exit::Target(const GenericAgent&)
 {
     return area.Centroid();
@@ -132,6 +210,12 @@ StageProxy Exit::Proxy(Simulation* simulation)
     return ExitProxy(simulation, this);
 }
 
+size_t Exit::MemoryUsage() const
+{
+    return sizeof(*this) + area.Points().size() * sizeof(K::Point_2) +
+           jps::memory::HeapBytes(edgeNormals) + jps::memory::HeapBytes(edgeOffsets);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// NotifiableWaitingSet
 ////////////////////////////////////////////////////////////////////////////////
@@ -145,8 +229,7 @@ bool NotifiableWaitingSet::IsCompleted(const GenericAgent& agent)
     if(state == WaitingSetState::Active) {
         return false;
     }
-    const auto find_iter = std::find(std::begin(occupants), std::end(occupants), agent.id);
-    if(find_iter != std::end(occupants)) {
+    if(occupantIds.contains(agent.id)) {
         return true;
     }
     const auto distance = (agent.Position() - slots[0]).Norm();
@@ -161,12 +244,17 @@ Point NotifiableWaitingSet::Target(const GenericAgent& agent)
 
     const auto next_slot_index = std::min(occupants.size(), slots.size() - 1);
 
-    for(size_t index = 0; index < next_slot_index; ++index) {
-        if(agent.id == occupants[index]) {
-            return slots[index];
+    if(occupantIds.contains(agent.id)) {
+        for(size_t index = 0; index < next_slot_index; ++index) {
+            if(agent.id == occupants[index]) {
+                return slots[index];
+            }
         }
     }
 
+    if(occupants.size() < slots.size() && nearSlot(agent, slots[next_slot_index])) {
+        pendingUpdate = true;
+    }
     return slots[next_slot_index];
 }
 
@@ -177,6 +265,8 @@ void NotifiableWaitingSet::State(WaitingSetState s)
     }
     if(s == WaitingSetState::Active) {
         occupants.clear();
+        occupantIds.clear();
+        pendingUpdate = true;
     }
     state = s;
 }
@@ -186,6 +276,12 @@ WaitingSetState NotifiableWaitingSet::State() const
     return state;
 }
 
+size_t NotifiableWaitingSet::MemoryUsage() const
+{
+    return sizeof(*this) + jps::memory::HeapBytes(slots) + jps::memory::HeapBytes(occupants) +
+           jps::memory::HeapBytes(occupantIds);
+}
+
 StageProxy NotifiableWaitingSet::Proxy(Simulation* simulation)
 {
     return NotifiableWaitingSetProxy(simulation, this);
@@ -196,42 +292,32 @@ const std::vector<GenericAgent::ID>& NotifiableWaitingSet::Occupants() const
     return occupants;
 }
 
+void NotifiableWaitingSet::Restore(
+    std::vector<GenericAgent::ID> occupants_,
+    WaitingSetState state_)
+{
+    occupants = std::move(occupants_);
+    occupantIds = {std::begin(occupants), std::end(occupants)};
+    state = state_;
+    pendingUpdate = true;
+}
+
 void NotifiableWaitingSet::Update(const EnvironmentQuery& envQuery)
 {
-    if(state == WaitingSetState::Inactive) {
-        return;
-    }
-    const auto count_occupants = occupants.size();
-    if(count_occupants == slots.size()) {
+    if(!pendingUpdate || state == WaitingSetState::Inactive) {
         return;
     }
+    pendingUpdate = false;
 
-    for(size_t index = count_occupants; index < slots.size(); ++index) {
-        const auto slot_pos = slots[index];
-        const auto& boundaries = envQuery.LineSegmentsInRange(slot_pos);
-        auto candidates = envQuery.AgentsInRange(slot_pos, 2, [&](const GenericAgent& candidate) {
-            return envQuery.NoGeometryBetween(slot_pos, candidate.Position(), boundaries);
+    for(size_t index = occupants.size(); index < slots.size(); ++index) {
+        const auto occupant = closestCandidate(envQuery, slots[index], [&](const auto& agent) {
+            return agent.stageId == id && !occupantIds.contains(agent.id);
         });
-
-        GenericAgent::ID occupant = GenericAgent::ID::Invalid;
-        double min_distance = std::numeric_limits<double>::max();
-        for(const auto& agent : candidates) {
-            if(agent.stageId == id) {
-                if(std::find(std::begin(occupants), std::end(occupants), agent.id) ==
-                   std::end(occupants)) {
-                    const auto distance = (agent.Position() - slots[index]).Norm();
-                    if(distance < min_distance) {
-                        min_distance = distance;
-                        occupant = agent.id;
-                    }
-                }
-            }
-        }
-        if(occupant != GenericAgent::ID::Invalid) {
-            occupants.push_back(occupant);
-        } else {
+        if(occupant == GenericAgent::ID::Invalid) {
             return;
         }
+        occupants.push_back(occupant);
+        occupantIds.insert(occupant);
     }
 }
 
@@ -253,12 +339,16 @@ bool NotifiableQueue::IsCompleted(const GenericAgent& agent)
 
 Point NotifiableQueue::Target(const GenericAgent& agent)
 {
-
-    if(const auto index_opt = IndexInContainer(occupants, agent.id); index_opt) {
-        return slots[*index_opt];
+    if(occupantIds.contains(agent.id)) {
+        if(const auto index_opt = IndexInContainer(occupants, agent.id); index_opt) {
+            return slots[*index_opt];
+        }
     }
 
     const auto next_target_index = std::min(occupants.size(), slots.size() - 1);
+    if(occupants.size() < slots.size() && nearSlot(agent, slots[next_target_index])) {
+        pendingUpdate = true;
+    }
     return slots[next_target_index];
 }
 
@@ -269,10 +359,18 @@ void NotifiableQueue::Pop(size_t count)
             return;
         }
         exitingThisUpdate.insert(occupants.front());
+        occupantIds.erase(occupants.front());
         occupants.erase(std::begin(occupants));
+        pendingUpdate = true;
     }
 }
 
+size_t NotifiableQueue::MemoryUsage() const
+{
+    return sizeof(*this) + jps::memory::HeapBytes(slots) + jps::memory::HeapBytes(occupants) +
+           jps::memory::HeapBytes(occupantIds) + jps::memory::HeapBytes(exitingThisUpdate);
+}
+
 StageProxy NotifiableQueue::Proxy(Simulation* simulation)
 {
     return NotifiableQueueProxy(simulation, this);
@@ -283,37 +381,32 @@ const std::vector<GenericAgent::ID>& NotifiableQueue::Occupants() const
     return occupants;
 }
 
+void NotifiableQueue::Restore(
+    std::vector<GenericAgent::ID> occupants_,
+    std::set<GenericAgent::ID> exitingThisUpdate_)
+{
+    occupants = std::move(occupants_);
+    occupantIds = {std::begin(occupants), std::end(occupants)};
+    exitingThisUpdate = std::move(exitingThisUpdate_);
+    pendingUpdate = true;
+}
+
 void NotifiableQueue::Update(const EnvironmentQuery& envQuery)
 {
-    const auto count_occupants = occupants.size();
-    if(count_occupants == slots.size()) {
+    if(!pendingUpdate) {
         return;
     }
+    pendingUpdate = false;
 
-    for(size_t index = count_occupants; index < slots.size(); ++index) {
-        const auto slot_pos = slots[index];
-        const auto& boundaries = envQuery.LineSegmentsInRange(slot_pos);
-        auto candidates = envQuery.AgentsInRange(slot_pos, 2, [&](const GenericAgent& candidate) {
-            return envQuery.NoGeometryBetween(slot_pos, candidate.Position(), boundaries);
+    for(size_t index = occupants.size(); index < slots.size(); ++index) {
+        const auto occupant = closestCandidate(envQuery, slots[index], [&](const auto& agent) {
+            return agent.stageId == id && !occupantIds.contains(agent.id) &&
+                   !exitingThisUpdate.contains(agent.id);
         });
-
-        GenericAgent::ID occupant = GenericAgent::ID::Invalid;
-        double min_distance = std::numeric_limits<double>::max();
-        for(const auto& agent : candidates) {
-            if(agent.stageId != id || Contains(occupants, agent.id) ||
-               exitingThisUpdate.contains(agent.id)) {
-                continue;
-            }
-            const auto distance = (agent.Position() - slots[index]).Norm();
-            if(distance < min_distance) {
-                min_distance = distance;
-                occupant = agent.id;
-            }
-        }
-        if(occupant != GenericAgent::ID::Invalid) {
-            occupants.emplace_back(occupant);
-        } else {
+        if(occupant == GenericAgent::ID::Invalid) {
             return;
         }
+        occupants.emplace_back(occupant);
+        occupantIds.insert(occupant);
     }
 }
@@ -17,9 +17,11 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <set>
+#include <span>
 #include <unordered_set>
 #include <variant>
 #include <vector>
@@ -103,6 +105,9 @@ using StageProxy = std::variant<
 
 class BaseStage
 {
+    // Restores stage ids when simulations are recreated from a checkpoint.
+    friend class StageManager;
+
 public:
     using ID = jps::UniqueID<BaseStage>;
 
@@ -113,8 +118,18 @@ protected:
 public:
     virtual ~BaseStage() = default;
     virtual bool IsCompleted(const GenericAgent& agent) = 0;
+    /// Clears the entries of 'candidates' whose agent, at the same index in 'positions', has
+    /// certainly not completed the stage. Only the remaining ones need to be asked IsCompleted.
+    /// Stages with cheap geometric completion override this with a loop over all agents.
+    virtual void
+    FilterCompleted(std::span<const Point> /*positions*/, std::span<uint8_t> /*candidates*/) const
+    {
+    }
     virtual Point Target(const GenericAgent& agent) = 0;
     virtual StageProxy Proxy(Simulation* simulation_) = 0;
+    /// Memory held by the stage, including the stage itself. Stages override this to count their
+    /// own size and the heap memory of their members.
+    virtual size_t MemoryUsage() const { return sizeof(BaseStage); }
     ID Id() const { return id; }
     size_t CountTargeting() const { return targeting; }
     void IncreaseTargeting() { targeting = targeting + 1; }
@@ -146,8 +161,11 @@ public:
     Waypoint(Point position_, double distance_);
     ~Waypoint() override = default;
     bool IsCompleted(const GenericAgent& agent) override;
+    void FilterCompleted(std::span<const Point> positions, std::span<uint8_t> candidates)
+        const override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    size_t MemoryUsage() const override { return sizeof(*this); }
     Point Position() const { return position; };
 };
 
@@ -155,22 +173,35 @@ public:
 class Exit : public BaseStage
 {
     Polygon area;
+    /// Inward unit normals and offsets of the edges of 'area', a point p is inside if
+    /// normal * p >= offset for all edges.
+    std::vector<Point> edgeNormals{};
+    std::vector<double> edgeOffsets{};
     std::vector<GenericAgent::ID>& toRemove;
 
 public:
     Exit(Polygon area, std::vector<GenericAgent::ID>& toRemove_);
     ~Exit() override = default;
     bool IsCompleted(const GenericAgent& agent) override;
+    void FilterCompleted(std::span<const Point> positions, std::span<uint8_t> candidates)
+        const override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    size_t MemoryUsage() const override;
     Polygon Position() const { return area; };
 };
 
+/// Waiting sets and queues fill their free slots in Update, which only does work when an agent
+/// came near the next free slot since the last update. Agents are noticed when Target is called
+/// for them, i.e. in the strategic pass.
 class NotifiableWaitingSet : public BaseStage
 {
     std::vector<Point> slots;
     std::vector<GenericAgent::ID> occupants{};
+    /// Same agents as 'occupants', for constant time membership tests.
+    std::unordered_set<GenericAgent::ID> occupantIds{};
     WaitingSetState state{WaitingSetState::Active};
+    bool pendingUpdate{true};
 
 public:
     NotifiableWaitingSet(std::vector<Point> slots_);
@@ -178,11 +209,14 @@ public:
     bool IsCompleted(const GenericAgent& agent) override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    size_t MemoryUsage() const override;
     void State(WaitingSetState s);
     WaitingSetState State() const;
     void Update(const EnvironmentQuery& envQuery);
     const std::vector<GenericAgent::ID>& Occupants() const;
     const std::vector<Point>& Slots() const { return slots; };
+    /// Overwrites the runtime state, used when restoring checkpoints.
+    void Restore(std::vector<GenericAgent::ID> occupants_, WaitingSetState state_);
 };
 
 class NotifiableQueue : public BaseStage
@@ -191,7 +225,10 @@ class NotifiableQueue : public BaseStage
 private:
     std::vector<Point> slots;
     std::vector<GenericAgent::ID> occupants{};
+    /// Same agents as 'occupants', for constant time membership tests.
+    std::unordered_set<GenericAgent::ID> occupantIds{};
     std::set<GenericAgent::ID> exitingThisUpdate{};
+    bool pendingUpdate{true};
 
 public:
     NotifiableQueue(std::vector<Point> slots_);
@@ -199,10 +236,16 @@ public:
     bool IsCompleted(const GenericAgent& agent) override;
     Point Target(const GenericAgent& agent) override;
     StageProxy Proxy(Simulation* simulation_) override;
+    size_t MemoryUsage() const override;
     void Update(const EnvironmentQuery& envQuery);
     void Pop(size_t count);
     const std::vector<GenericAgent::ID>& Occupants() const;
     const std::vector<Point>& Slots() const { return slots; };
+    const std::set<GenericAgent::ID>& ExitingThisUpdate() const { return exitingThisUpdate; };
+    /// Overwrites the runtime state, used when restoring checkpoints.
+    void Restore(
+        std::vector<GenericAgent::ID> occupants_,
+        std::set<GenericAgent::ID> exitingThisUpdate_);
 };
 
 class DirectSteering : public BaseStage
@@ -216,4 +259,5 @@ public:
     {
         return DirectSteeringProxy(simulation, this);
     };
+    size_t MemoryUsage() const override { return sizeof(*this); }
 };
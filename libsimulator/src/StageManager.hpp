@@ -17,6 +17,9 @@ class StageManager
 {
 private:
     std::unordered_map<BaseStage::ID, std::unique_ptr<BaseStage>> stages;
+    /// Stages that need to be updated each iteration, by type. Owned by 'stages'.
+    std::vector<NotifiableWaitingSet*> waitingSets{};
+    std::vector<NotifiableQueue*> queues{};
 
 public:
     StageManager() {}
@@ -26,9 +29,12 @@ public:
     StageManager(StageManager&& other) = delete;
     StageManager& operator=(StageManager&& other) = delete;
 
+    /// @param id id to assign to the new stage, a fresh id is used if invalid. Only set when
+    /// restoring a checkpoint.
     BaseStage::ID AddStage(
         const StageDescription stageDescription,
-        std::vector<GenericAgent::ID>& removedAgentsInLastIteration)
+        std::vector<GenericAgent::ID>& removedAgentsInLastIteration,
+        BaseStage::ID id = BaseStage::ID::Invalid)
     {
         std::unique_ptr<BaseStage> stage = std::visit(
             overloaded{
@@ -49,13 +55,21 @@ public:
                     return std::make_unique<DirectSteering>();
                 }},
             stageDescription);
+        if(id != BaseStage::ID::Invalid) {
+            stage->id = id;
+        }
         if(stages.find(stage->Id()) != stages.end()) {
             throw SimulationError("Internal error, stage id already in use.");
         }
-        const auto id = stage->Id();
-        stages.emplace(id, std::move(stage));
+        const auto stageId = stage->Id();
+        auto* added = stages.emplace(stageId, std::move(stage)).first->second.get();
+        if(std::holds_alternative<NotifiableWaitingSetDescription>(stageDescription)) {
+            waitingSets.push_back(static_cast<NotifiableWaitingSet*>(added));
+        } else if(std::holds_alternative<NotifiableQueueDescription>(stageDescription)) {
+            queues.push_back(static_cast<NotifiableQueue*>(added));
+        }
 
-        return id;
+        return stageId;
     }
 
     void MigrateAgent(BaseStage::ID prevTarget, BaseStage::ID newTarget)
@@ -87,6 +101,10 @@ public:
 
     std::unordered_map<BaseStage::ID, std::unique_ptr<BaseStage>>& Stages() { return stages; }
 
+    const std::vector<NotifiableWaitingSet*>& WaitingSets() const { return waitingSets; }
+
+    const std::vector<NotifiableQueue*>& Queues() const { return queues; }
+
     const std::unordered_map<BaseStage::ID, std::unique_ptr<BaseStage>>& Stages() const
     {
         return stages;
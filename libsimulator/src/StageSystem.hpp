@@ -25,14 +25,12 @@ public:
         const CollisionGeometry& geometry)
     {
         EnvironmentQuery envQuery(geometry, neighborhoodSearch);
-        for(auto& [_, stage] : stageManager.Stages()) {
-            if(auto* updatable_stage = dynamic_cast<NotifiableWaitingSet*>(stage.get());
-               updatable_stage != nullptr) {
-                updatable_stage->Update(envQuery);
-            } else if(auto* updatable_stage = dynamic_cast<NotifiableQueue*>(stage.get());
-                      updatable_stage != nullptr) {
-                updatable_stage->Update(envQuery);
-            }
+        // Both only do work if an agent came near one of their free slots.
+        for(auto* waitingSet : stageManager.WaitingSets()) {
+            waitingSet->Update(envQuery);
+        }
+        for(auto* queue : stageManager.Queues()) {
+            queue->Update(envQuery);
         }
     }
 };
@@ -1,14 +1,49 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "HashCombine.hpp"
 #include "Journey.hpp"
+#include "Point.hpp"
 #include "StageManager.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 class StrategicalDecisionSystem
 {
+    struct GroupKey {
+        Journey::ID journeyId;
+        BaseStage::ID stageId;
+        bool operator==(const GroupKey& other) const = default;
+    };
+
+    struct GroupKeyHash {
+        size_t operator()(const GroupKey& key) const
+        {
+            return jps::hash_combine(
+                std::hash<Journey::ID>{}(key.journeyId), std::hash<BaseStage::ID>{}(key.stageId));
+        }
+    };
+
+    /// Agents on the same stage of the same journey.
+    struct Group {
+        const JourneyNode* node;
+        std::vector<size_t> members;
+        std::vector<Point> positions;
+        std::vector<uint8_t> candidates;
+    };
+
+    // Buffers of Run, kept between iterations to reuse their memory.
+    std::unordered_map<GroupKey, size_t, GroupKeyHash> _groupIndex{};
+    std::vector<Group> _groups{};
+    std::vector<size_t> _groupOf{};
+    std::vector<uint8_t> _mayBeCompleted{};
+
 public:
     StrategicalDecisionSystem() = default;
     ~StrategicalDecisionSystem() = default;
@@ -17,16 +52,68 @@ public:
     StrategicalDecisionSystem(StrategicalDecisionSystem&& other) = delete;
     StrategicalDecisionSystem& operator=(StrategicalDecisionSystem&& other) = delete;
 
+    /// Moves agents on to their next stage and sets their final target. Agents are grouped by
+    /// journey and stage first, so that each stage can rule out completion for all of its agents
+    /// in one pass (see BaseStage::FilterCompleted). Transitions, IsCompleted and the stage
+    /// bookkeeping then run in agent order, as if every agent was handled on its own.
     void
     Run(const std::unordered_map<Journey::ID, std::unique_ptr<Journey>>& journeys,
         auto&& agents,
-        StageManager& stageManager) const
+        StageManager& stageManager)
     {
+        for(auto& group : _groups) {
+            group.members.clear();
+            group.positions.clear();
+        }
+        _groupIndex.clear();
+        _groupOf.clear();
+        size_t usedGroups = 0;
+        std::optional<GroupKey> lastKey{};
+        size_t lastGroup = 0;
+        for(const auto& agent : agents) {
+            const GroupKey key{agent.journeyId, agent.stageId};
+            if(key != lastKey) {
+                auto [iter, inserted] = _groupIndex.try_emplace(key, usedGroups);
+                if(inserted) {
+                    if(usedGroups == _groups.size()) {
+                        _groups.emplace_back();
+                    }
+                    _groups[usedGroups].node = &journeys.at(key.journeyId)->Node(key.stageId);
+                    ++usedGroups;
+                }
+                lastKey = key;
+                lastGroup = iter->second;
+            }
+            _groups[lastGroup].members.push_back(_groupOf.size());
+            _groups[lastGroup].positions.push_back(agent.Position());
+            _groupOf.push_back(lastGroup);
+        }
+
+        _mayBeCompleted.assign(_groupOf.size(), 1);
+        for(size_t index = 0; index < usedGroups; ++index) {
+            filterCompleted(_groups[index]);
+        }
+
+        size_t index = 0;
         for(auto& agent : agents) {
-            const auto [target, id] = journeys.at(agent.journeyId)->Target(agent);
+            const auto [target, id] =
+                Journey::Target(agent, *_groups[_groupOf[index]].node, _mayBeCompleted[index] != 0);
             agent.finalTarget = target;
-            stageManager.MigrateAgent(agent.stageId, id);
-            agent.stageId = id;
+            if(id != agent.stageId) {
+                stageManager.MigrateAgent(agent.stageId, id);
+                agent.stageId = id;
+            }
+            ++index;
+        }
+    }
+
+private:
+    void filterCompleted(Group& group)
+    {
+        group.candidates.assign(group.members.size(), 1);
+        group.node->stage->FilterCompleted(group.positions, group.candidates);
+        for(size_t index = 0; index < group.members.size(); ++index) {
+            _mayBeCompleted[group.members[index]] = group.candidates[index];
         }
     }
 };
@@ -1,8 +1,16 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "Point.hpp"
 #include "RoutingEngine.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
 class TacticalDecisionSystem
 {
 public:
@@ -13,11 +21,40 @@ public:
     TacticalDecisionSystem(TacticalDecisionSystem&& other) = delete;
     TacticalDecisionSystem& operator=(TacticalDecisionSystem&& other) = delete;
 
-    void Run(RoutingEngine& routingEngine, auto&& agents) const
+    void Run(const RoutingEngine& routingEngine, auto&& agents) const
     {
         for(auto& agent : agents) {
+            // Sleeping agents neither moved nor changed their target, their waypoint still holds.
+            if(agent.idle.sleeping) {
+                continue;
+            }
             const auto dest = agent.finalTarget;
             agent.nextTarget = routingEngine.ComputeWaypoint(agent.Position(), dest);
         }
     }
+
+    /// Same result as 'Run', but agents sharing a destination are routed together in
+    /// spatial order. Meant for adding many agents at once.
+    void RunGrouped(const RoutingEngine& routingEngine, auto&& agents) const
+    {
+        using Agent = std::remove_reference_t<std::ranges::range_reference_t<decltype(agents)>>;
+        std::map<Point, std::vector<Agent*>> byDestination{};
+        for(auto& agent : agents) {
+            byDestination[agent.finalTarget].push_back(&agent);
+        }
+        std::vector<Point> positions{};
+        for(auto& [destination, group] : byDestination) {
+            std::sort(std::begin(group), std::end(group), [](const auto* a, const auto* b) {
+                return a->Position() < b->Position();
+            });
+            positions.clear();
+            for(const auto* agent : group) {
+                positions.push_back(agent->Position());
+            }
+            const auto waypoints = routingEngine.ComputeWaypoints(positions, destination);
+            for(size_t index = 0; index < group.size(); ++index) {
+                group[index]->nextTarget = waypoints[index];
+            }
+        }
+    }
 };
@@ -1,41 +1,79 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "Timing.hpp"
 
+#include "Logger.hpp"
+#include "MemoryUsage.hpp"
+#include "Tracing.hpp"
+
 #include <fmt/core.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <mutex>
 #include <utility>
 
 namespace cr = std::chrono;
 
-TimerEntry::TimerEntry(TimerEntry&& other) noexcept
-    : started_at(std::move(other.started_at))
-    , duration_in_microseconds(other.duration_in_microseconds)
-    , running(other.running)
+namespace
+{
+struct ProbeNames {
+    std::mutex mutex{};
+    // A deque keeps the names in place, the map's keys view them.
+    std::deque<std::string> names{};
+    std::unordered_map<std::string_view, TimerProbeRegistry::ID> ids{};
+};
+
+ProbeNames& probeNames()
+{
+    static ProbeNames probes{};
+    return probes;
+}
+
+double nanosecondsToMicroseconds(uint64_t nanoseconds)
 {
-    other.duration_in_microseconds = 0;
-    other.running = false;
+    return static_cast<double>(nanoseconds) / 1000.0;
+}
+} // namespace
+
+TimerProbeRegistry::ID TimerProbeRegistry::Register(std::string_view name)
+{
+    auto& probes = probeNames();
+    std::lock_guard lock{probes.mutex};
+    if(const auto iter = probes.ids.find(name); iter != probes.ids.end()) {
+        return iter->second;
+    }
+    const auto id = static_cast<ID>(probes.names.size());
+    probes.ids.emplace(probes.names.emplace_back(name), id);
+    return id;
 }
 
-TimerEntry& TimerEntry::operator=(TimerEntry&& other) noexcept
+std::optional<TimerProbeRegistry::ID> TimerProbeRegistry::Find(std::string_view name)
 {
-    if(this != &other) {
-        started_at = std::move(other.started_at);
-        duration_in_microseconds = other.duration_in_microseconds;
-        running = other.running;
-        other.duration_in_microseconds = 0;
-        other.running = false;
+    auto& probes = probeNames();
+    std::lock_guard lock{probes.mutex};
+    if(const auto iter = probes.ids.find(name); iter != probes.ids.end()) {
+        return iter->second;
     }
-    return *this;
+    return std::nullopt;
+}
+
+std::string TimerProbeRegistry::Name(ID id)
+{
+    auto& probes = probeNames();
+    std::lock_guard lock{probes.mutex};
+    return probes.names.at(id);
 }
 
 void TimerEntry::start()
 {
     if(!running) {
         running = true;
-        started_at = cr::high_resolution_clock::now();
+        is_used = true;
+        started_at = clock::now();
     }
 }
 
@@ -43,21 +81,80 @@ void TimerEntry::stop()
 {
     if(running) {
         running = false;
-        duration_in_microseconds += std::chrono::duration_cast<std::chrono::microseconds>(
-                                        std::chrono::high_resolution_clock::now() - started_at)
-                                        .count();
+        duration_in_nanoseconds += static_cast<duration_type>(
+            cr::duration_cast<cr::nanoseconds>(clock::now() - started_at).count());
+    }
+}
+
+void TimerEntry::stop(uint64_t iteration)
+{
+    if(running) {
+        running = false;
+        const auto elapsed = static_cast<duration_type>(
+            cr::duration_cast<cr::nanoseconds>(clock::now() - started_at).count());
+        duration_in_nanoseconds += elapsed;
+        if(sample_iterations.empty() || sample_iterations.back() != iteration) {
+            sample_iterations.push_back(iteration);
+            sample_durations.push_back(elapsed);
+        } else {
+            sample_durations.back() += elapsed;
+        }
     }
 }
 
 uint64_t TimerEntry::getDurationInMicroseconds() const
 {
+    auto duration = duration_in_nanoseconds;
     if(running) {
-        return duration_in_microseconds +
-               std::chrono::duration_cast<std::chrono::microseconds>(
-                   std::chrono::high_resolution_clock::now() - started_at)
-                   .count();
+        duration += static_cast<duration_type>(
+            cr::duration_cast<cr::nanoseconds>(clock::now() - started_at).count());
     }
-    return duration_in_microseconds;
+    return duration / 1000;
+}
+
+IterationStatistics TimerEntry::getIterationStatistics() const
+{
+    IterationStatistics statistics{.iterations = sample_durations.size()};
+    if(sample_durations.empty()) {
+        return statistics;
+    }
+    auto sorted = sample_durations;
+    std::sort(std::begin(sorted), std::end(sorted));
+    // Nearest rank percentiles.
+    const auto percentile = [&sorted](double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+        return nanosecondsToMicroseconds(sorted[std::max<size_t>(rank, 1) - 1]);
+    };
+    statistics.p50 = percentile(0.50);
+    statistics.p95 = percentile(0.95);
+    statistics.p99 = percentile(0.99);
+    statistics.max = nanosecondsToMicroseconds(sorted.back());
+    return statistics;
+}
+
+void TimerEntry::startHardwareCounters(const HardwareCounterValues& now)
+{
+    if(!running) {
+        hardware_counters_at_start = now;
+        counting_hardware = true;
+    }
+}
+
+HardwareCounterValues TimerEntry::stopHardwareCounters(const HardwareCounterValues& now)
+{
+    if(!counting_hardware) {
+        return {};
+    }
+    counting_hardware = false;
+    counted_hardware = true;
+    const auto counted = now - hardware_counters_at_start;
+    hardware_counters += counted;
+    return counted;
+}
+
+size_t TimerEntry::memoryUsage() const
+{
+    return jps::memory::HeapBytes(sample_iterations) + jps::memory::HeapBytes(sample_durations);
 }
 
 void Timer::pushTimerProbe(std::string_view name, int timer_probe_level)
@@ -65,39 +162,139 @@ void Timer::pushTimerProbe(std::string_view name, int timer_probe_level)
     if(timer_probe_level > max_log_level) {
         return;
     }
-    std::string name_str(name);
-    auto iter = timer_map.find(name_str);
-    // use emplace to avoid multiple lookups and unnecessary default construction of TimerEntry
-    if(iter == timer_map.end()) {
-        timer_map.emplace(name_str, TimerEntry()).first->second.start();
-    } else {
-        iter->second.start();
-    }
+    pushTimerProbe(TimerProbeRegistry::Register(name));
 }
 
 void Timer::popTimerProbe(const std::string_view name)
 {
-    // use auto iter = timer_map.find(name) to avoid multiple lookups
-    auto iter = timer_map.find(std::string(name));
-    if(iter != timer_map.end()) {
-        iter->second.stop();
+    if(const auto id = TimerProbeRegistry::Find(name)) {
+        popTimerProbe(*id);
+    }
+}
+
+const TimerEntry* Timer::getEntry(std::string_view name) const
+{
+    const auto id = TimerProbeRegistry::Find(name);
+    if(!id || *id >= entries.size() || !entries[*id].used()) {
+        return nullptr;
     }
+    return &entries[*id];
 }
 
 TimerEntry::duration_type Timer::getDuration(const std::string_view name) const
 {
-    auto iter = timer_map.find(std::string(name));
-    if(iter != timer_map.end()) {
-        return iter->second.getDurationInMicroseconds();
+    if(const auto* entry = getEntry(name)) {
+        return entry->getDurationInMicroseconds();
     }
     return 0;
 }
 
 std::map<std::string, TimerEntry::duration_type> Timer::getDurations() const
 {
-    std::map<std::string, TimerEntry::duration_type> entries;
-    for(const auto& [name, trace] : timer_map) {
-        entries.emplace(name, trace.getDurationInMicroseconds());
+    std::map<std::string, TimerEntry::duration_type> durations;
+    for(size_t id = 0; id < entries.size(); ++id) {
+        if(entries[id].used()) {
+            durations.emplace(
+                TimerProbeRegistry::Name(static_cast<TimerProbeRegistry::ID>(id)),
+                entries[id].getDurationInMicroseconds());
+        }
+    }
+    return durations;
+}
+
+std::map<std::string, IterationStatistics> Timer::getIterationStatistics() const
+{
+    std::map<std::string, IterationStatistics> statistics;
+    for(size_t id = 0; id < entries.size(); ++id) {
+        if(entries[id].used()) {
+            statistics.emplace(
+                TimerProbeRegistry::Name(static_cast<TimerProbeRegistry::ID>(id)),
+                entries[id].getIterationStatistics());
+        }
+    }
+    return statistics;
+}
+
+bool Timer::enableHardwareCounters()
+{
+    if(hardware_counters) {
+        return true;
+    }
+    auto counters = std::make_unique<HardwareCounters>();
+    if(!counters->Available()) {
+        LOG_WARNING("Hardware counters are not available: {}", counters->Reason());
+        return false;
+    }
+    for(size_t index = 0; index < HardwareCounterValues::count; ++index) {
+        opened_hardware_counters[index] =
+            opened_hardware_counters[index] || counters->Opened(index);
+    }
+    hardware_counters = std::move(counters);
+    return true;
+}
+
+void Timer::stopHardwareCounters(TimerProbeRegistry::ID id)
+{
+    const auto counted = entries[id].stopHardwareCounters(hardware_counters->Read());
+    if(!Profiler::instance().isEnabled()) {
+        return;
+    }
+    const auto name = TimerProbeRegistry::Name(id);
+    for(size_t index = 0; index < HardwareCounterValues::count; ++index) {
+        if(opened_hardware_counters[index]) {
+            TRACE_COUNTER(
+                "C++",
+                perfetto::CounterTrack(perfetto::DynamicString{
+                    fmt::format("{} {}", name, HardwareCounterValues::names[index])}),
+                counted.values[index]);
+        }
+    }
+}
+
+std::map<std::string, std::map<std::string, uint64_t>> Timer::getHardwareCounters() const
+{
+    std::map<std::string, std::map<std::string, uint64_t>> counters;
+    for(size_t id = 0; id < entries.size(); ++id) {
+        if(!entries[id].countedHardware()) {
+            continue;
+        }
+        auto& entryCounters =
+            counters[TimerProbeRegistry::Name(static_cast<TimerProbeRegistry::ID>(id))];
+        for(size_t index = 0; index < HardwareCounterValues::count; ++index) {
+            if(opened_hardware_counters[index]) {
+                entryCounters.emplace(
+                    HardwareCounterValues::names[index],
+                    entries[id].getHardwareCounters().values[index]);
+            }
+        }
+    }
+    return counters;
+}
+
+void Timer::setCounter(std::string_view name, uint64_t value)
+{
+    counter_map.insert_or_assign(std::string(name), value);
+}
+
+uint64_t Timer::getCounter(std::string_view name) const
+{
+    auto iter = counter_map.find(std::string(name));
+    if(iter != counter_map.end()) {
+        return iter->second;
     }
-    return entries;
-}
\ No newline at end of file
+    return 0;
+}
+
+std::map<std::string, uint64_t> Timer::getCounters() const
+{
+    return {counter_map.begin(), counter_map.end()};
+}
+
+size_t Timer::memoryUsage() const
+{
+    size_t bytes = jps::memory::HeapBytes(entries) + jps::memory::HeapBytes(counter_map);
+    for(const auto& entry : entries) {
+        bytes += entry.memoryUsage();
+    }
+    return bytes + (hardware_counters ? sizeof(HardwareCounters) : 0);
+}
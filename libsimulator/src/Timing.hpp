@@ -1,7 +1,11 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #pragma once
 
+#include "HardwareCounters.hpp"
+
+#include <array>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <map>
@@ -11,11 +15,13 @@
 #include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 // Helper macro to create a scoped timer probe.
 // It creates a scope guard that starts the timer probe when it is created and stops the timer probe
 // when it goes out of scope. The log level is used to filter which
 // timer probes are active based on the log level set in the Timer object.
+// The probe name is registered once per call site, the guard only deals with its id.
 // Using it requires "Tracing.hpp". Do not pull it into this header though as it pulls in the huge
 // perfetto.h.
 #ifndef JPS_SCOPE_CONCAT_IMPL
@@ -26,46 +32,105 @@
 #endif
 #ifndef JPS_SCOPED_TIMER
 #define JPS_SCOPED_TIMER_AND_TRACE(timer_obj, name, loglevel)                                      \
-    auto JPS_SCOPE_CONCAT(_jps_scoped_timer_guard_, __COUNTER__) =                                 \
-        (timer_obj).scopedTimerProbe((name), (loglevel));                                          \
+    static const TimerProbeRegistry::ID JPS_SCOPE_CONCAT(_jps_timer_probe_, __LINE__) =           \
+        TimerProbeRegistry::Register(name);                                                        \
+    auto JPS_SCOPE_CONCAT(_jps_scoped_timer_guard_, __LINE__) = (timer_obj).scopedTimerProbe(     \
+        JPS_SCOPE_CONCAT(_jps_timer_probe_, __LINE__), (loglevel));                                \
     JPS_TRACE_EVENT(name)
 #endif
 
+// Process wide registry of timer probe names. A name is registered once, e.g. per call site by
+// JPS_SCOPED_TIMER_AND_TRACE, and timers identify probes by the returned id afterwards, so that
+// starting and stopping a probe neither allocates nor hashes its name.
+class TimerProbeRegistry
+{
+public:
+    using ID = uint32_t;
+    // Returns the id of the probe with the given name, registering it if it is new.
+    static ID Register(std::string_view name);
+    // Returns the id of the probe with the given name if it is registered.
+    static std::optional<ID> Find(std::string_view name);
+    // Returns the name of the probe with the given id.
+    static std::string Name(ID id);
+};
+
+// Summary of the per iteration durations of a timer entry in microseconds.
+struct IterationStatistics {
+    uint64_t iterations{0};
+    double p50{0.0};
+    double p95{0.0};
+    double p99{0.0};
+    double max{0.0};
+};
+
 // Helper class to store the start time and duration of a timer entry.
 // It also has a flag to indicate whether the timer is currently running or not.
-// The duration is summed, hence multiple calls to start and stop will accumulate the duration in
-// microseconds.
+// The duration is summed, hence multiple calls to start and stop will accumulate the duration.
+// Next to the total the duration can also be kept per iteration, see Timer::setIterationSampling.
 class TimerEntry
 {
 
 public:
     using duration_type = uint64_t;
+    using clock = std::chrono::steady_clock;
 
     TimerEntry() = default;
     ~TimerEntry() = default;
     TimerEntry(const TimerEntry& other) = delete;
     TimerEntry& operator=(const TimerEntry& other) = delete;
-    TimerEntry(TimerEntry&& other) noexcept;
-    TimerEntry& operator=(TimerEntry&& other) noexcept;
+    TimerEntry(TimerEntry&& other) noexcept = default;
+    TimerEntry& operator=(TimerEntry&& other) noexcept = default;
     // Starts the timer entry. If the timer entry is already running, this function does nothing.
     void start();
     // Stops the timer entry. If the timer entry is not running, this function does nothing.
     // Upon stopping the timer entry, the duration of the timer entry is updated with the time
     // elapsed since it was started.
     void stop();
+    // Same as 'stop', but also adds the elapsed time to the sample of 'iteration'.
+    void stop(uint64_t iteration);
+    // Whether the entry was started at least once.
+    bool used() const { return is_used; }
     // Get the duration of the timer entry in microseconds.
     // If the timer is still running, it returns the duration until now.
-    // If the timer entry does not exist, it returns 0.
     duration_type getDurationInMicroseconds() const;
+    // Iterations the entry was stopped in and the time spent in it during each of them.
+    const std::vector<uint64_t>& sampleIterations() const { return sample_iterations; }
+    const std::vector<duration_type>& sampleDurationsInNanoseconds() const
+    {
+        return sample_durations;
+    }
+    IterationStatistics getIterationStatistics() const;
+    // Remembers the hardware counters at the start of the entry. Does nothing if the entry is
+    // already running.
+    void startHardwareCounters(const HardwareCounterValues& now);
+    // Adds the hardware counters since startHardwareCounters to the entry and returns them.
+    // Returns 0 for all counters if they were not started.
+    HardwareCounterValues stopHardwareCounters(const HardwareCounterValues& now);
+    // Whether hardware counters were recorded for the entry.
+    bool countedHardware() const { return counted_hardware; }
+    // Sum of the hardware counters over all runs of the entry they were recorded for.
+    const HardwareCounterValues& getHardwareCounters() const { return hardware_counters; }
+    // Heap memory held by the per iteration samples.
+    size_t memoryUsage() const;
 
 private:
     // Last start time of the timer entry.
-    std::chrono::high_resolution_clock::time_point started_at;
-    // Duration of the timer entry in microseconds.
+    clock::time_point started_at{};
+    // Duration of the timer entry in nanoseconds.
     // It is updated with the time elapsed since the last start time when the timer is stopped.
-    duration_type duration_in_microseconds{0};
+    duration_type duration_in_nanoseconds{0};
+    // One sample per iteration the entry was stopped in, in nanoseconds.
+    std::vector<uint64_t> sample_iterations{};
+    std::vector<duration_type> sample_durations{};
+    // Hardware counters at the last start and their sum over all runs of the entry.
+    HardwareCounterValues hardware_counters_at_start{};
+    HardwareCounterValues hardware_counters{};
     // Flag to indicate whether the timer is currently running or not.
     bool running{false};
+    bool is_used{false};
+    // Whether the hardware counters were started with the current run.
+    bool counting_hardware{false};
+    bool counted_hardware{false};
 };
 
 class Timer
@@ -73,12 +138,23 @@ class Timer
     // Log level for the timer. Timer probes with a log level higher than
     // the set log level will not be active and will not record time.
     int max_log_level{0};
-    // Map of timer entry names to their corresponding TimerEntry objects.
-    std::unordered_map<std::string, TimerEntry> timer_map{};
+    // Iteration that stopped probes record their per iteration sample for.
+    uint64_t iteration{0};
+    // Whether stopped probes record per iteration samples. The samples grow with the number of
+    // iterations, so they are off unless asked for.
+    bool sample_iterations{false};
+    // Timer entries indexed by their TimerProbeRegistry::ID.
+    std::vector<TimerEntry> entries{};
+    // Map of counter names to their values, reported next to the timer entries.
+    std::unordered_map<std::string, uint64_t> counter_map{};
+    // Hardware counters read around every probe, only set while they are enabled.
+    std::unique_ptr<HardwareCounters> hardware_counters{};
+    // Which of the hardware counters could be opened while they were enabled.
+    std::array<bool, HardwareCounterValues::count> opened_hardware_counters{};
 
 public:
     // Helper class to create a scoped timer probe guard.
-    // It starts the timer probe with the given name and log level when
+    // It starts the timer probe with the given id and log level when
     // it is created and stops the timer probe when it goes out of scope.
     class ScopedTimerProbeGuard
     {
@@ -87,21 +163,21 @@ public:
         // higher than the log level set in the Timer object, in which case the guard will not be
         // active and will not record time.
         Timer* stats{nullptr};
-        // Name of the timer probe that the guard will operate on.
-        std::string name;
+        // Id of the timer probe that the guard will operate on.
+        TimerProbeRegistry::ID id{0};
 
     public:
-        ScopedTimerProbeGuard(Timer& stats_ref, std::string_view timer_name, int loglevel)
-            : stats((loglevel <= stats_ref.getLogLevel()) ? &stats_ref : nullptr), name(timer_name)
+        ScopedTimerProbeGuard(Timer& stats_ref, TimerProbeRegistry::ID probe_id, int loglevel)
+            : stats((loglevel <= stats_ref.getLogLevel()) ? &stats_ref : nullptr), id(probe_id)
         {
             if(stats) {
-                stats->pushTimerProbe(name, loglevel);
+                stats->pushTimerProbe(id);
             }
         }
         ~ScopedTimerProbeGuard()
         {
             if(stats) {
-                stats->popTimerProbe(name);
+                stats->popTimerProbe(id);
             }
         }
         // Delete copy constructor and copy assignment operator to prevent copying of the guard.
@@ -109,7 +185,7 @@ public:
         ScopedTimerProbeGuard& operator=(const ScopedTimerProbeGuard&) = delete;
         // Move constructor and move assignment operator to allow moving of the guard.
         ScopedTimerProbeGuard(ScopedTimerProbeGuard&& other) noexcept
-            : stats(other.stats), name(other.name)
+            : stats(other.stats), id(other.id)
         {
             other.stats = nullptr;
         }
@@ -117,10 +193,10 @@ public:
         {
             if(this != &other) {
                 if(stats) {
-                    stats->popTimerProbe(name);
+                    stats->popTimerProbe(id);
                 }
                 stats = other.stats;
-                name = std::move(other.name);
+                id = other.id;
                 other.stats = nullptr;
             }
             return *this;
@@ -128,27 +204,62 @@ public:
     };
 
     ~Timer() = default;
-    // Creates a scoped timer probe guard that starts the timer probe with the given name
+    // Creates a scoped timer probe guard that starts the timer probe with the given id
     // and log level when it is created and stops the timer probe when it goes out of scope.
     [[nodiscard]] inline ScopedTimerProbeGuard
+    scopedTimerProbe(TimerProbeRegistry::ID id, int loglevel = 0)
+    {
+        return ScopedTimerProbeGuard(*this, id, loglevel);
+    }
+    [[nodiscard]] inline ScopedTimerProbeGuard
     scopedTimerProbe(const std::string_view name, int loglevel = 0)
     {
-        return ScopedTimerProbeGuard(*this, name, loglevel);
+        return ScopedTimerProbeGuard(*this, TimerProbeRegistry::Register(name), loglevel);
+    }
+    // Starts the timer probe with the given id. The log level is checked by the caller.
+    // If the timer probe is already running, this function does nothing.
+    void pushTimerProbe(TimerProbeRegistry::ID id)
+    {
+        if(id >= entries.size()) {
+            entries.resize(id + 1);
+        }
+        if(countsHardware()) {
+            entries[id].startHardwareCounters(hardware_counters->Read());
+        }
+        entries[id].start();
+    }
+    // Stops the timer probe with the given id.
+    // If the timer probe does not exist, this function does nothing.
+    void popTimerProbe(TimerProbeRegistry::ID id)
+    {
+        if(id < entries.size()) {
+            if(sample_iterations) {
+                entries[id].stop(iteration);
+            } else {
+                entries[id].stop();
+            }
+            if(countsHardware()) {
+                stopHardwareCounters(id);
+            }
+        }
     }
     // Starts a timer probe with the given name.
     // If the log level of the timer probe is higher than the log level set in the Timer object,
     // the timer probe will not be active and will not record time.
     // If a timer probe with the same name already exists, that timer probe will be restarted.
-    // If tracing is enabled a trace with the same name will also be pushed to the ProfilerSingleton
-    // instance.
     void pushTimerProbe(std::string_view name, int loglevel = 0);
     // Stops the timer probe with the given name.
     // If the timer probe does not exist, this function does nothing.
     // Upon stopping the timer probe, the duration of the timer entry is updated with the time
     // elapsed since it was started.
-    // If tracing is enabled a trace with the same name will also be poped from the
-    // ProfilerSingleton instance.
     void popTimerProbe(const std::string_view name);
+    // Sets the iteration probes record their per iteration samples for. Probes stopped between
+    // two iterations count towards the one set last.
+    void setIteration(uint64_t current_iteration) { iteration = current_iteration; }
+    // Turns recording one sample per iteration and probe on or off. Samples recorded so far are
+    // kept.
+    void setIterationSampling(bool enabled) { sample_iterations = enabled; }
+    bool iterationSamplingEnabled() const { return sample_iterations; }
     // Returns the duration of the timer entry in microseconds. If the timer is still running, it
     // returns the duration until now. if the timer entry does not exist, it returns 0.
     TimerEntry::duration_type getDuration(const std::string_view name) const;
@@ -157,9 +268,41 @@ public:
     // If a timer entry does not exist, it is not included in the map.
     // PST: I choose a map here so that we always have the same order of entries when printing them.
     std::map<std::string, TimerEntry::duration_type> getDurations() const;
+    // Returns the timer entry with the given name, nullptr if it does not exist.
+    const TimerEntry* getEntry(std::string_view name) const;
+    // Returns a map of timer entry names to the statistics of their per iteration durations.
+    std::map<std::string, IterationStatistics> getIterationStatistics() const;
+    // Sets the counter with the given name to 'value', creating it if it does not exist.
+    void setCounter(std::string_view name, uint64_t value);
+    // Returns the value of the counter with the given name, 0 if it does not exist.
+    uint64_t getCounter(std::string_view name) const;
+    // Returns a map of counter names to their values.
+    std::map<std::string, uint64_t> getCounters() const;
+    // Opens the hardware counters and reads them around every probe from now on, see
+    // HardwareCounters. They count the calling thread, probes on other threads record none.
+    // Returns false and leaves them off if they are not available.
+    bool enableHardwareCounters();
+    void disableHardwareCounters() { hardware_counters.reset(); }
+    bool hardwareCountersEnabled() const { return hardware_counters != nullptr; }
+    // Returns a map of timer entry names to their hardware counters, by counter name. Only
+    // entries and counters that were recorded are included.
+    std::map<std::string, std::map<std::string, uint64_t>> getHardwareCounters() const;
+    // Memory held by the timer entries with their per iteration samples, the counters and the
+    // hardware counters, without the Timer itself.
+    size_t memoryUsage() const;
     // Sets the log level for the timer. Timer probes with a log level higher than the set log
     // level will not be active and will not record time.
     void setLogLevel(int level) { max_log_level = level; };
     // Returns the current log level of the timer.
     int getLogLevel() const { return max_log_level; };
+
+private:
+    // Whether hardware counters are enabled and count the calling thread. Probes running on other
+    // threads, e.g. in RunBatch, record no hardware counters.
+    bool countsHardware() const
+    {
+        return hardware_counters && hardware_counters->OnCallingThread();
+    }
+    // Records the hardware counters of the run of the entry that just stopped.
+    void stopHardwareCounters(TimerProbeRegistry::ID id);
 };
@@ -1,19 +1,37 @@
 #include "Tracing.hpp"
 
 #include "Logger.hpp"
+#include "MemoryUsage.hpp"
+#include "SimulationError.hpp"
 
 #include <fmt/core.h>
 #include <perfetto.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 PERFETTO_TRACK_EVENT_STATIC_STORAGE();
 
 namespace
 {
+// A slice that was begun and not yet ended on this thread.
+struct OpenSlice {
+    // Names of C++ slices are string literals, other names are copied.
+    const char* literal{nullptr};
+    std::string owned{};
+    std::chrono::steady_clock::time_point start{};
+    uint64_t childNanoseconds{0};
+
+    std::string_view name() const { return literal != nullptr ? literal : owned; }
+};
+
+thread_local std::vector<OpenSlice> openSlices{};
+
 std::string makeTempTracePath()
 {
     auto ts = std::chrono::steady_clock::now().time_since_epoch().count();
@@ -21,21 +39,19 @@ std::string makeTempTracePath()
     return (std::filesystem::temp_directory_path() / name).string();
 }
 
-perfetto::TraceConfig buildDefaultTraceConfig(const std::string& output_path)
+perfetto::TraceConfig buildTraceConfig(const ProfilerConfig& config, const std::string& output_path)
 {
     perfetto::TraceConfig cfg;
 
     auto* buffer = cfg.add_buffers();
-    buffer->set_size_kb(8192);
+    buffer->set_size_kb(config.bufferSizeKb);
 
     auto* ds_cfg = cfg.add_data_sources()->mutable_config();
     ds_cfg->set_name("track_event");
 
     cfg.set_write_into_file(true);
     cfg.set_output_path(output_path);
-    // How often accumulated trace data is written from the in-memory ring buffer
-    // to the file. Lower values reduce memory pressure; higher values reduce I/O.
-    cfg.set_file_write_period_ms(100);
+    cfg.set_file_write_period_ms(config.fileWritePeriodMs);
     // Maximum time to wait for a flush to complete before giving up.
     cfg.set_flush_timeout_ms(5000);
 
@@ -58,9 +74,13 @@ void Profiler::createSession()
     perfetto::TrackEvent::Register();
 
     temp_trace_path = makeTempTracePath();
+    {
+        std::lock_guard lock{slices_mutex};
+        slices.clear();
+    }
 
     tracing_session = perfetto::Tracing::NewTrace();
-    tracing_session->Setup(buildDefaultTraceConfig(temp_trace_path));
+    tracing_session->Setup(buildTraceConfig(session_config, temp_trace_path));
     tracing_session->StartBlocking();
 }
 
@@ -97,13 +117,24 @@ void Profiler::writeAndResetSession(const std::string& filename)
     }
 }
 
-void Profiler::enable()
+void Profiler::enable(const ProfilerConfig& config)
 {
     auto& instance = Profiler::instance();
     if(instance.enabled) {
         return;
     }
 
+    if(config.bufferSizeKb == 0) {
+        throw SimulationError("The trace buffer size has to be greater than 0");
+    }
+    if(config.agentBuckets == 0) {
+        throw SimulationError("The number of agent buckets has to be greater than 0");
+    }
+    if(config.agentSampleRadius <= 0) {
+        throw SimulationError(
+            "The agent sample radius has to be greater than 0, got {}", config.agentSampleRadius);
+    }
+    instance.session_config = config;
     instance.createSession();
     instance.enabled = true;
 }
@@ -126,4 +157,73 @@ void Profiler::dumpAndReset(const std::string& filename)
     instance.enabled = false;
 }
 
+void Profiler::beginSlice(const char* name)
+{
+    if(!enabled) {
+        return;
+    }
+    openSlices.push_back({name, {}, std::chrono::steady_clock::now(), 0});
+}
+
+void Profiler::beginSlice(std::string_view name)
+{
+    if(!enabled) {
+        return;
+    }
+    openSlices.push_back({nullptr, std::string(name), std::chrono::steady_clock::now(), 0});
+}
+
+void Profiler::endSlice()
+{
+    if(openSlices.empty()) {
+        return;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - openSlices.back().start;
+    const auto total = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    const auto self = total - std::min(total, openSlices.back().childNanoseconds);
+    if(enabled) {
+        std::lock_guard lock{slices_mutex};
+        const auto name = openSlices.back().name();
+        auto iter = slices.find(name);
+        if(iter == slices.end()) {
+            iter = slices.emplace(std::string(name), SliceSummary{.name = std::string(name)}).first;
+        }
+        ++iter->second.count;
+        iter->second.totalNanoseconds += total;
+        iter->second.selfNanoseconds += self;
+    }
+    openSlices.pop_back();
+    if(!openSlices.empty()) {
+        openSlices.back().childNanoseconds += total;
+    }
+}
+
+std::vector<SliceSummary> Profiler::sliceSummary(size_t top) const
+{
+    std::vector<SliceSummary> summary{};
+    {
+        std::lock_guard lock{slices_mutex};
+        summary.reserve(slices.size());
+        for(const auto& [name, slice] : slices) {
+            summary.push_back(slice);
+        }
+    }
+    std::stable_sort(
+        std::begin(summary), std::end(summary), [](const auto& lhs, const auto& rhs) {
+            return lhs.selfNanoseconds > rhs.selfNanoseconds;
+        });
+    if(summary.size() > top) {
+        summary.resize(top);
+    }
+    return summary;
+}
+
+size_t Profiler::memoryUsage() const
+{
+    const size_t buffer = enabled ? session_config.bufferSizeKb * size_t{1024} : 0;
+    std::lock_guard lock{slices_mutex};
+    return buffer + jps::memory::HeapBytes(slices);
+}
+
 Profiler Profiler::profiler{};
@@ -7,12 +7,23 @@ PERFETTO_DEFINE_CATEGORIES(
     perfetto::Category("C++").SetDescription("C++ Traces."),
     perfetto::Category("Python").SetDescription("Python Traces."));
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <vector>
 
+// Next to the Perfetto slice JPS_TRACE_EVENT records the slice for Profiler::sliceSummary.
 #ifndef JPS_TRACE_EVENT
-#define JPS_TRACE_EVENT(name) TRACE_EVENT("C++", name);
+#define JPS_TRACE_CONCAT_IMPL(x, y) x##y
+#define JPS_TRACE_CONCAT(x, y) JPS_TRACE_CONCAT_IMPL(x, y)
+#define JPS_TRACE_EVENT(name)                                                                      \
+    TRACE_EVENT("C++", name);                                                                      \
+    const ProfilerSlice JPS_TRACE_CONCAT(_jps_profiler_slice_, __LINE__)(name)
 #define JPS_TRACE_EVENT_BEGIN(name) TRACE_EVENT_BEGIN("C++", name)
 #define JPS_TRACE_EVENT_END TRACE_EVENT_END("C++")
 #if defined(_MSC_VER)
@@ -22,6 +33,30 @@ PERFETTO_DEFINE_CATEGORIES(
 #endif
 #endif
 
+// Settings of a tracing session.
+struct ProfilerConfig {
+    // Size of the in-memory ring buffer.
+    uint32_t bufferSizeKb{8192};
+    // How often the ring buffer is written to the trace file. Lower values reduce memory
+    // pressure, higher values reduce I/O.
+    uint32_t fileWritePeriodMs{100};
+    // Every 'agentSampleInterval' iterations the simulation records the mean number of neighbors
+    // and walls within 'agentSampleRadius' of the agents as counters, per bucket of
+    // 'agentBuckets' agents grouped by id. 0 disables the samples.
+    uint32_t agentSampleInterval{0};
+    uint32_t agentBuckets{16};
+    double agentSampleRadius{2.0};
+};
+
+// Time spent in the slices of one name, summed over all threads. The self time excludes the
+// time spent in slices nested into them on the same thread.
+struct SliceSummary {
+    std::string name;
+    uint64_t count{0};
+    uint64_t totalNanoseconds{0};
+    uint64_t selfNanoseconds{0};
+};
+
 // PorfilerSingleton is a wrapper around perfetto::TracingSession to provide a simple interface
 // for the rest of the codebase. It is implemented as a singleton to ensure that there is only
 // one instance of the profiler throughout the application. The Timer class also accesses the
@@ -34,11 +69,27 @@ class Profiler
 public:
     static Profiler& instance() noexcept { return profiler; };
 
-    static void enable();
+    static void enable(const ProfilerConfig& config = {});
     static void disable();
 
     static void dumpAndReset(const std::string& filename);
     inline bool isEnabled() const { return enabled; }
+    // Settings of the current session, or of the last one if tracing is disabled.
+    const ProfilerConfig& config() const { return session_config; }
+
+    // Starts and ends slices on the calling thread for the slice summary. beginSlice does
+    // nothing if tracing is disabled, endSlice closes the innermost open slice and only records
+    // it while tracing is enabled. A slice has to begin and end within one session. Use
+    // JPS_TRACE_EVENT or ProfilerSlice in C++ code.
+    void beginSlice(const char* name);
+    void beginSlice(std::string_view name);
+    void endSlice();
+    // Slices of the current or last session with the most self time first, at most 'top' of
+    // them. Kept after dumpAndReset until the next session starts.
+    std::vector<SliceSummary> sliceSummary(size_t top) const;
+    // Memory held by the trace buffer of the current session and the slice summary. The buffer
+    // is shared by all simulations of the process.
+    size_t memoryUsage() const;
 
 private:
     Profiler() = default;
@@ -50,6 +101,34 @@ private:
     void createSession();
     void writeAndResetSession(const std::string& filename);
     bool enabled{false};
+    ProfilerConfig session_config{};
     std::unique_ptr<perfetto::TracingSession> tracing_session{};
     std::string temp_trace_path{};
+    // Slice summary of all threads, by name.
+    mutable std::mutex slices_mutex{};
+    std::map<std::string, SliceSummary, std::less<>> slices{};
+};
+
+// Scope guard that records a slice for Profiler::sliceSummary, see JPS_TRACE_EVENT.
+class ProfilerSlice
+{
+    bool active;
+
+public:
+    explicit ProfilerSlice(const char* name) : active(Profiler::instance().isEnabled())
+    {
+        if(active) {
+            Profiler::instance().beginSlice(name);
+        }
+    }
+    ~ProfilerSlice()
+    {
+        if(active) {
+            Profiler::instance().endSlice();
+        }
+    }
+    ProfilerSlice(const ProfilerSlice&) = delete;
+    ProfilerSlice& operator=(const ProfilerSlice&) = delete;
+    ProfilerSlice(ProfilerSlice&&) = delete;
+    ProfilerSlice& operator=(ProfilerSlice&&) = delete;
 };
\ No newline at end of file
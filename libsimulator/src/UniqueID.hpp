@@ -59,6 +59,18 @@ public:
 
     Integer getID() const noexcept { return m_value; }
 
+    /// Last identifier handed out for this tag.
+    static Integer currentCounter() noexcept { return uid_counter.load(); }
+
+    /// Ensures no identifier up to and including 'value' is handed out again. The counter is
+    /// never lowered as ids are shared by all simulations in the process.
+    static void advanceCounterTo(Integer value) noexcept
+    {
+        auto current = uid_counter.load();
+        while(current < value && !uid_counter.compare_exchange_weak(current, value)) {
+        }
+    }
+
     bool operator==(const UniqueID& p_other) const noexcept { return m_value == p_other.m_value; };
 
     bool operator!=(const UniqueID& p_other) const noexcept { return m_value != p_other.m_value; };
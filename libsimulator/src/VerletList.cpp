@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "VerletList.hpp"
+
+#include "GeometricFunctions.hpp"
+#include "SimulationError.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+double distanceToPoint(const LineSegment& segment, Point p)
+{
+    return Distance(segment.ShortestPoint(p), p);
+}
+
+double distance(const LineSegment& first, const LineSegment& second)
+{
+    if(intersects(first, second)) {
+        return 0.0;
+    }
+    return std::min(
+        {distanceToPoint(first, second.p1),
+         distanceToPoint(first, second.p2),
+         distanceToPoint(second, first.p1),
+         distanceToPoint(second, first.p2)});
+}
+} // namespace
+
+VerletList::VerletList(double cutoff, double skin) : _cutoff(cutoff), _skin(skin)
+{
+    if(cutoff <= 0.0) {
+        throw SimulationError("Verlet list cutoff needs to be > 0, got {}", cutoff);
+    }
+    if(skin <= 0.0) {
+        throw SimulationError("Verlet list skin needs to be > 0, got {}", skin);
+    }
+}
+
+bool VerletList::Update(
+    const AgentContainer<GenericAgent>& agents,
+    const EnvironmentQuery& envQuery)
+{
+    _agents = &agents;
+    if(!NeedsRebuild(agents)) {
+        return false;
+    }
+    Rebuild(agents, envQuery);
+    return true;
+}
+
+bool VerletList::NeedsRebuild(const AgentContainer<GenericAgent>& agents) const
+{
+    if(_builds == 0 || agents.size() != _ids.size()) {
+        return true;
+    }
+    const double maxDisplacementSquared = 0.25 * _skin * _skin;
+    for(size_t index = 0; index < agents.size(); ++index) {
+        const auto& agent = agents[index];
+        if(agent.id != _ids[index] ||
+           DistanceSquared(agent.Position(), _positions[index]) > maxDisplacementSquared) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void VerletList::Rebuild(
+    const AgentContainer<GenericAgent>& agents,
+    const EnvironmentQuery& envQuery)
+{
+    const size_t count = agents.size();
+    _ids.clear();
+    _positions.clear();
+    _indices.clear();
+    for(size_t index = 0; index < count; ++index) {
+        const auto& agent = agents[index];
+        _ids.push_back(agent.id);
+        _positions.push_back(agent.Position());
+        _indices.emplace(&agent, index);
+    }
+
+    const double radius = _cutoff + _skin;
+    const double margin = 0.5 * _skin;
+    _offsets.assign(1, 0);
+    _candidates.clear();
+    for(size_t index = 0; index < count; ++index) {
+        const auto origin = _positions[index];
+        // Any wall within 'margin' of a line of sight shorter than 'radius' lies within
+        // 'radius + margin' of the agent.
+        const auto walls = envQuery.LineSegmentsInRange(origin, radius + margin);
+        _walls.assign(std::begin(walls), std::end(walls));
+        envQuery.ForEachAgentInRange(origin, radius, [&](const GenericAgent& candidate) {
+            const auto iter = _indices.find(&candidate);
+            if(iter == std::end(_indices) || iter->second == index) {
+                return;
+            }
+            const LineSegment sight{origin, candidate.Position()};
+            const bool clearSight =
+                std::all_of(std::begin(_walls), std::end(_walls), [&](const LineSegment& wall) {
+                    return distance(sight, wall) > margin;
+                });
+            _candidates.push_back({iter->second, clearSight});
+        });
+        _offsets.push_back(_candidates.size());
+    }
+    ++_builds;
+}
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "EnvironmentQuery.hpp"
+#include "GenericAgent.hpp"
+#include "LineSegment.hpp"
+#include "MemoryUsage.hpp"
+#include "Point.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+/// Candidate neighbors of every agent, collected within 'cutoff + skin' and reused across steps
+/// (Verlet lists). The lists are rebuilt once any agent moved more than half the skin since the
+/// last build or agents were added or removed. Until then every agent within 'cutoff' of another
+/// one is guaranteed to be among its candidates.
+class VerletList
+{
+public:
+    struct Candidate {
+        /// Index into the agent container the lists were built for.
+        size_t index;
+        /// No wall came closer than half the skin to the line of sight between both agents when
+        /// the lists were built, so no wall can block it while the lists are valid.
+        bool clearSight;
+    };
+
+private:
+    double _cutoff;
+    double _skin;
+    const AgentContainer<GenericAgent>* _agents{nullptr};
+    /// Ids and positions of the agents at the last build, in container order.
+    std::vector<GenericAgent::ID> _ids{};
+    std::vector<Point> _positions{};
+    /// Candidates of agent 'i' are _candidates[_offsets[i]] to _candidates[_offsets[i + 1]].
+    std::vector<size_t> _offsets{};
+    std::vector<Candidate> _candidates{};
+    std::unordered_map<const GenericAgent*, size_t> _indices{};
+    std::vector<LineSegment> _walls{};
+    uint64_t _builds{0};
+
+public:
+    VerletList(double cutoff, double skin);
+
+    double Cutoff() const { return _cutoff; }
+    double Skin() const { return _skin; }
+    /// Number of builds so far.
+    uint64_t Builds() const { return _builds; }
+    /// Heap memory held by the lists, see jps::memory::HeapBytes.
+    size_t MemoryUsage() const
+    {
+        return jps::memory::HeapBytes(_ids) + jps::memory::HeapBytes(_positions) +
+               jps::memory::HeapBytes(_offsets) + jps::memory::HeapBytes(_candidates) +
+               jps::memory::HeapBytes(_indices) + jps::memory::HeapBytes(_walls);
+    }
+
+    /// Rebuilds the lists if 'agents' are not the agents they were built for or any agent moved
+    /// more than half the skin since. 'envQuery' has to be up to date with 'agents'. Returns
+    /// whether the lists were rebuilt.
+    bool Update(const AgentContainer<GenericAgent>& agents, const EnvironmentQuery& envQuery);
+
+    /// Candidates of the agent at 'index', in the order the neighborhood search found them.
+    std::span<const Candidate> CandidatesOf(size_t index) const
+    {
+        return {_candidates.data() + _offsets[index], _offsets[index + 1] - _offsets[index]};
+    }
+
+    /// Agent at 'index' in the container passed to the last Update().
+    const GenericAgent& Agent(size_t index) const { return (*_agents)[index]; }
+
+private:
+    bool NeedsRebuild(const AgentContainer<GenericAgent>& agents) const;
+    void Rebuild(const AgentContainer<GenericAgent>& agents, const EnvironmentQuery& envQuery);
+};
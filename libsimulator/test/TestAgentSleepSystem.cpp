@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AgentSleepSystem.hpp"
+#include "GenericAgent.hpp"
+#include "NeighborhoodSearch.hpp"
+#include "OperationalModels/CollisionFreeSpeedModel/CollisionFreeSpeedModel.hpp"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+GenericAgent MakeAgent(Point pos)
+{
+    return GenericAgent(
+        GenericAgent::ID{},
+        jps::UniqueID<Journey>::Invalid,
+        jps::UniqueID<BaseStage>::Invalid,
+        pos,
+        CollisionFreeSpeedModel::State{});
+}
+
+// Runs the sleep system the way Simulation::Iterate does, without moving anybody.
+void Step(
+    AgentSleepSystem& system,
+    NeighborhoodSearch<GenericAgent>& neighborhoodSearch,
+    AgentContainer<GenericAgent>& agents)
+{
+    neighborhoodSearch.Update(agents);
+    system.Wake(neighborhoodSearch, agents);
+    system.Update(agents);
+}
+} // namespace
+
+TEST(AgentSleepSystem, DisabledByDefault)
+{
+    AgentSleepSystem system{};
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    AgentContainer<GenericAgent> agents{MakeAgent({0, 0})};
+    for(int step = 0; step < 100; ++step) {
+        Step(system, neighborhoodSearch, agents);
+    }
+    EXPECT_FALSE(system.Settings().Enabled());
+    EXPECT_FALSE(agents[0].idle.sleeping);
+    EXPECT_EQ(system.Sleeping(), 0u);
+}
+
+TEST(AgentSleepSystem, RejectsInvalidSettings)
+{
+    AgentSleepSystem system{};
+    EXPECT_THROW(system.SetSettings({.idleRadius = -0.1}), SimulationError);
+    EXPECT_THROW(system.SetSettings({.idleRadius = 0.1, .stepsToSleep = 0}), SimulationError);
+    EXPECT_THROW(
+        system.SetSettings({.idleRadius = 0.1, .stepsToSleep = 5, .wakeRadius = 0.0}),
+        SimulationError);
+}
+
+TEST(AgentSleepSystem, IdleAgentFallsAsleep)
+{
+    AgentSleepSystem system{};
+    system.SetSettings({.idleRadius = 0.1, .stepsToSleep = 5, .wakeRadius = 1.0});
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    AgentContainer<GenericAgent> agents{MakeAgent({0, 0})};
+
+    for(int step = 0; step < 4; ++step) {
+        Step(system, neighborhoodSearch, agents);
+        EXPECT_FALSE(agents[0].idle.sleeping);
+    }
+    Step(system, neighborhoodSearch, agents);
+    EXPECT_TRUE(agents[0].idle.sleeping);
+    EXPECT_EQ(system.Sleeping(), 1u);
+
+    Step(system, neighborhoodSearch, agents);
+    EXPECT_TRUE(agents[0].idle.sleeping);
+    EXPECT_EQ(system.SkippedSteps(), 1u);
+}
+
+TEST(AgentSleepSystem, MovingAgentStaysAwake)
+{
+    AgentSleepSystem system{};
+    system.SetSettings({.idleRadius = 0.1, .stepsToSleep = 5, .wakeRadius = 1.0});
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    AgentContainer<GenericAgent> agents{MakeAgent({0, 0})};
+    for(int step = 0; step < 20; ++step) {
+        agents[0].MoveAlongSurface({0.15, 0.0});
+        Step(system, neighborhoodSearch, agents);
+        EXPECT_EQ(agents[0].idle.steps, 0u);
+    }
+    EXPECT_FALSE(agents[0].idle.sleeping);
+}
+
+TEST(AgentSleepSystem, JitteringAgentFallsAsleep)
+{
+    AgentSleepSystem system{};
+    system.SetSettings({.idleRadius = 0.1, .stepsToSleep = 5, .wakeRadius = 1.0});
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    AgentContainer<GenericAgent> agents{MakeAgent({0, 0})};
+    for(int step = 0; step < 5; ++step) {
+        agents[0].MoveAlongSurface({step % 2 == 0 ? 0.05 : -0.05, 0.0});
+        Step(system, neighborhoodSearch, agents);
+    }
+    EXPECT_TRUE(agents[0].idle.sleeping);
+}
+
+TEST(AgentSleepSystem, TargetChangeWakesAgent)
+{
+    AgentSleepSystem system{};
+    system.SetSettings({.idleRadius = 0.1, .stepsToSleep = 5, .wakeRadius = 1.0});
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    AgentContainer<GenericAgent> agents{MakeAgent({0, 0})};
+    for(int step = 0; step < 5; ++step) {
+        Step(system, neighborhoodSearch, agents);
+    }
+    ASSERT_TRUE(agents[0].idle.sleeping);
+
+    agents[0].finalTarget = {10, 0};
+    system.Wake(neighborhoodSearch, agents);
+    EXPECT_FALSE(agents[0].idle.sleeping);
+    EXPECT_EQ(agents[0].idle.steps, 0u);
+}
+
+TEST(AgentSleepSystem, ApproachingAgentWakesSleepers)
+{
+    AgentSleepSystem system{};
+    system.SetSettings({.idleRadius = 0.1, .stepsToSleep = 5, .wakeRadius = 1.0});
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    AgentContainer<GenericAgent> agents{MakeAgent({0, 0}), MakeAgent({0.5, 0})};
+    for(int step = 0; step < 6; ++step) {
+        Step(system, neighborhoodSearch, agents);
+    }
+    // Sleeping neighbors do not keep each other awake.
+    ASSERT_TRUE(agents[0].idle.sleeping);
+    ASSERT_TRUE(agents[1].idle.sleeping);
+
+    agents.push_back(MakeAgent({5, 0}));
+    Step(system, neighborhoodSearch, agents);
+    // Far away the walking agent does not disturb anybody.
+    EXPECT_TRUE(agents[0].idle.sleeping);
+    EXPECT_TRUE(agents[1].idle.sleeping);
+
+    // The walking agent counts as moving once it took a step.
+    agents[2].MoveAlongSurface({-3.6, 0.0});
+    Step(system, neighborhoodSearch, agents);
+    EXPECT_TRUE(agents[1].idle.sleeping);
+    Step(system, neighborhoodSearch, agents);
+    EXPECT_TRUE(agents[0].idle.sleeping);
+    EXPECT_FALSE(agents[1].idle.sleeping);
+    EXPECT_EQ(system.Sleeping(), 1u);
+}
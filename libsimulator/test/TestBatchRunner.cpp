@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "BatchRunner.hpp"
+#include "CollisionFreeSpeedModel.hpp"
+#include "CollisionFreeSpeedModelState.hpp"
+#include "CollisionGeometry.hpp"
+#include "GenericAgent.hpp"
+#include "GeometryBuilder.hpp"
+#include "GeometryBundle.hpp"
+#include "Journey.hpp"
+#include "Point.hpp"
+#include "Polygon.hpp"
+#include "Simulation.hpp"
+#include "SimulationError.hpp"
+#include "StageDescription.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+GeometryBundle corridor()
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea({{0, 0}, {20, 0}, {20, 4}, {0, 4}});
+    return GeometryBundle{std::make_shared<const CollisionGeometry>(builder.Build())};
+}
+
+std::unique_ptr<Simulation> makeSimulation(const GeometryBundle& bundle, double startX)
+{
+    auto simulation = std::make_unique<Simulation>(
+        std::make_unique<CollisionFreeSpeedModel>(8.0, 0.1, 5.0, 0.02), bundle, 0.01);
+    const auto stageId =
+        simulation->AddStage(ExitDescription{Polygon{{{18, 0}, {20, 0}, {20, 4}, {18, 4}}}});
+    const auto journeyId = simulation->AddJourney({{stageId, NonTransitionDescription{}}});
+    std::vector<GenericAgent> agents{};
+    agents.emplace_back(
+        GenericAgent::ID{},
+        journeyId,
+        stageId,
+        Point{startX, 2},
+        CollisionFreeSpeedModelState{});
+    simulation->AddAgents(std::move(agents));
+    return simulation;
+}
+} // namespace
+
+TEST(GeometryBundle, IsSharedBetweenSimulations)
+{
+    const auto bundle = corridor();
+    const auto first = makeSimulation(bundle, 1);
+    const auto second = makeSimulation(bundle, 2);
+
+    ASSERT_EQ(first->Bundle().SharedGeometry(), second->Bundle().SharedGeometry());
+    ASSERT_EQ(first->Bundle().SharedRouting(), second->Bundle().SharedRouting());
+}
+
+TEST(GeometryBundle, RejectsMissingParts)
+{
+    ASSERT_THROW(GeometryBundle{nullptr}, SimulationError);
+    const auto bundle = corridor();
+    ASSERT_THROW((GeometryBundle{bundle.SharedGeometry(), nullptr}), SimulationError);
+}
+
+TEST(BatchRunner, MatchesSequentialRuns)
+{
+    const auto bundle = corridor();
+    std::vector<std::unique_ptr<Simulation>> batch{};
+    std::vector<Simulation*> simulations{};
+    for(int index = 0; index < 8; ++index) {
+        batch.emplace_back(makeSimulation(bundle, 1 + index));
+        simulations.push_back(batch.back().get());
+    }
+
+    const auto results = RunBatch(simulations, 10000, 3);
+
+    ASSERT_EQ(results.size(), simulations.size());
+    for(size_t index = 0; index < results.size(); ++index) {
+        const auto sequential = makeSimulation(bundle, 1 + static_cast<double>(index));
+        uint64_t iterations = 0;
+        while(sequential->AgentCount() > 0) {
+            sequential->Iterate();
+            ++iterations;
+        }
+        EXPECT_TRUE(results[index].finished);
+        EXPECT_TRUE(results[index].error.empty());
+        EXPECT_EQ(results[index].iterations, iterations);
+        EXPECT_EQ(simulations[index]->AgentCount(), 0);
+    }
+}
+
+TEST(BatchRunner, StopsAtMaxIterations)
+{
+    const auto bundle = corridor();
+    const auto simulation = makeSimulation(bundle, 1);
+    const std::vector<Simulation*> simulations{simulation.get()};
+
+    const auto results = RunBatch(simulations, 5);
+
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_FALSE(results[0].finished);
+    EXPECT_EQ(results[0].iterations, 5);
+    EXPECT_EQ(simulation->Iteration(), 5);
+}
+
+TEST(BatchRunner, RejectsDuplicateSimulations)
+{
+    const auto bundle = corridor();
+    const auto simulation = makeSimulation(bundle, 1);
+    const std::vector<Simulation*> simulations{simulation.get(), simulation.get()};
+
+    ASSERT_THROW(RunBatch(simulations, 5), SimulationError);
+}
@@ -10,6 +10,7 @@
 
 #include <any>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -54,6 +55,34 @@ public:
     void CheckModelConstraint(const GenericAgent&, const AgentView&) const override {}
 };
 
+class MinimalBatchModel : public MinimalCustomModel
+{
+public:
+    mutable int batches{};
+
+    bool SupportsBatchStep() const override { return true; }
+
+    void ComputeNextStates(
+        const AgentBatch& batch,
+        std::span<OperationalModelState* const> next,
+        std::span<Point> movements) const override
+    {
+        ++batches;
+        for(size_t index = 0; index < batch.Size(); ++index) {
+            movements[index] =
+                ComputeNextState(batch.Agents()[index].state, *next[index], batch.Step(index));
+        }
+    }
+};
+
+class CommittingModel : public MinimalCustomModel
+{
+public:
+    int commits{};
+
+    void CommitStates() override { ++commits; }
+};
+
 GenericAgent MakeAgent(OperationalModelState model, Point position = {})
 {
     return GenericAgent(
@@ -93,6 +122,23 @@ TEST(CustomModelState, StoresAndUpdatesTypedPayload)
     ASSERT_THROW((void) data.Get<double>(), std::bad_any_cast);
 }
 
+TEST(CustomModelState, CopiesInlineAndHeapPayloads)
+{
+    const CustomModel::State small{MinimalState{Point{1.0, 2.0}, 3}};
+    const CustomModel::State large{std::string(100, 'x')};
+
+    auto smallCopy = small;
+    auto largeCopy = large;
+    ASSERT_TRUE(smallCopy.Holds<MinimalState>());
+    ASSERT_EQ(smallCopy.Get<MinimalState>().velocity, Point(1.0, 2.0));
+    ASSERT_EQ(largeCopy.Get<std::string>(), std::string(100, 'x'));
+
+    smallCopy = largeCopy;
+    largeCopy.Set(std::string{"changed"});
+    ASSERT_EQ(smallCopy.Get<std::string>(), std::string(100, 'x'));
+    ASSERT_FALSE(smallCopy.Holds<MinimalState>());
+}
+
 TEST(CustomModelState, FormatsPayload)
 {
     const CustomModel::State data{std::string{"custom state"}};
@@ -130,7 +176,7 @@ TEST(CustomModel, RunsThroughOperationalDecisionSystem)
     neighborhoodSearch.Update(agents);
 
     OperationalDecisionSystem system{std::make_unique<MinimalCustomModel>()};
-    system.Run(0.5, 0.0, neighborhoodSearch, geometry, agents);
+    system.Run(0.5, 0.0, 0, neighborhoodSearch, geometry, agents);
 
     const auto& agent = agents.front();
     const auto& state = std::get<CustomModel::State>(agent.state).Get<MinimalState>();
@@ -138,6 +184,58 @@ TEST(CustomModel, RunsThroughOperationalDecisionSystem)
     ASSERT_EQ(state.applications, 1);
 }
 
+TEST(CustomModel, CommitsStatesAfterEachStep)
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea({{-10, -10}, {10, -10}, {10, 10}, {-10, 10}});
+    const auto geometry = builder.Build();
+
+    AgentContainer<GenericAgent> agents{};
+    agents.emplace_back(MakeAgent(CustomModel::State{MinimalState{Point{2.0, 0.0}, 0}}));
+    agents.emplace_back(
+        MakeAgent(CustomModel::State{MinimalState{Point{2.0, 0.0}, 0}}, Point{0.0, 5.0}));
+
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    neighborhoodSearch.Update(agents);
+
+    auto model = std::make_unique<CommittingModel>();
+    const auto& committingModel = *model;
+    OperationalDecisionSystem system{std::move(model)};
+    system.Run(0.5, 0.0, 0, neighborhoodSearch, geometry, agents);
+    system.Run(0.5, 0.0, 1, neighborhoodSearch, geometry, agents);
+
+    ASSERT_EQ(committingModel.commits, 2);
+}
+
+TEST(CustomModel, RunsBatchesThroughOperationalDecisionSystem)
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea({{-10, -10}, {10, -10}, {10, 10}, {-10, 10}});
+    const auto geometry = builder.Build();
+
+    AgentContainer<GenericAgent> agents{};
+    agents.emplace_back(MakeAgent(CustomModel::State{MinimalState{Point{2.0, 0.0}, 0}}));
+    agents.emplace_back(
+        MakeAgent(CustomModel::State{MinimalState{Point{2.0, 0.0}, 0}}, Point{0.0, 5.0}));
+    agents.back().idle.sleeping = true;
+
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    neighborhoodSearch.Update(agents);
+
+    auto model = std::make_unique<MinimalBatchModel>();
+    const auto& batchModel = *model;
+    OperationalDecisionSystem system{std::move(model)};
+    system.Run(0.5, 0.0, 0, neighborhoodSearch, geometry, agents);
+
+    ASSERT_EQ(batchModel.batches, 1);
+    ASSERT_EQ(agents[0].Position(), Point(1.0, 0.0));
+    ASSERT_EQ(std::get<CustomModel::State>(agents[0].state).Get<MinimalState>().applications, 1);
+    // Sleeping agents are part of the batch but keep their state and position.
+    ASSERT_EQ(agents[1].Position(), Point(0.0, 5.0));
+    ASSERT_EQ(std::get<CustomModel::State>(agents[1].state).Get<MinimalState>().applications, 0);
+    ASSERT_THROW(system.SetMultiRateStepping({.maxLevel = 1}), SimulationError);
+}
+
 TEST(ModelTypeOf, MapsEveryAgentModelDataToItsOperationalModelType)
 {
     ASSERT_EQ(
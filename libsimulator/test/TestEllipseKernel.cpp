@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "Ellipse.hpp"
+#include "EllipseKernel.hpp"
+#include "Point.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace
+{
+struct Agent {
+    Ellipse ellipse;
+    Point position;
+    Point orientation;
+    double speed;
+    double scale;
+
+    EllipseShape Shape() const { return {ellipse, scale, speed, orientation}; }
+};
+
+Agent randomAgent(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double angle = 2 * std::numbers::pi * unit(rng);
+    const double bMin = 0.1 + 0.2 * unit(rng);
+    return {
+        Ellipse{0.5 * unit(rng), 0.1 + 0.3 * unit(rng), bMin + 0.1 * unit(rng), bMin},
+        Point{4 * unit(rng) - 2, 4 * unit(rng) - 2},
+        Point{std::cos(angle), std::sin(angle)},
+        1.5 * unit(rng),
+        unit(rng)};
+}
+
+double reference(const Agent& first, const Agent& second)
+{
+    return first.ellipse.EffectiveDistanceToEllipse(
+        second.ellipse,
+        first.position,
+        second.position,
+        first.scale,
+        second.scale,
+        first.speed,
+        second.speed,
+        first.orientation,
+        second.orientation);
+}
+} // namespace
+
+TEST(EllipseKernel, BoundaryMatchesPointOnEllipse)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coordinate(-3.0, 3.0);
+    for(size_t index = 0; index < 1000; ++index) {
+        const auto agent = randomAgent(rng);
+        const Point p{coordinate(rng), coordinate(rng)};
+        const auto expected = agent.ellipse.PointOnEllipse(
+            p.TransformToEllipseCoordinates(Point{}, agent.orientation.x, agent.orientation.y),
+            agent.scale,
+            Point{},
+            agent.speed,
+            agent.orientation);
+        const auto actual = agent.Shape().BoundaryTowards(p);
+        EXPECT_NEAR(actual.x, expected.x, 1e-12);
+        EXPECT_NEAR(actual.y, expected.y, 1e-12);
+    }
+}
+
+TEST(EllipseKernel, EffectiveDistanceMatchesEllipse)
+{
+    std::mt19937 rng(1337);
+    for(size_t index = 0; index < 1000; ++index) {
+        const auto first = randomAgent(rng);
+        const auto second = randomAgent(rng);
+        EXPECT_NEAR(
+            EffectiveDistance(first.Shape(), second.Shape(), second.position - first.position),
+            reference(first, second),
+            1e-12);
+    }
+}
+
+TEST(EllipseKernel, CoincidingCentersMatchEllipse)
+{
+    std::mt19937 rng(7);
+    for(size_t index = 0; index < 100; ++index) {
+        auto first = randomAgent(rng);
+        auto second = randomAgent(rng);
+        second.position = first.position + Point{1e-4, -1e-4};
+        EXPECT_NEAR(
+            EffectiveDistance(first.Shape(), second.Shape(), second.position - first.position),
+            reference(first, second),
+            1e-12);
+    }
+}
+
+TEST(EllipseKernel, ZeroOrientationMatchesEllipse)
+{
+    std::mt19937 rng(3);
+    auto first = randomAgent(rng);
+    auto second = randomAgent(rng);
+    first.orientation = Point{};
+    EXPECT_NEAR(
+        EffectiveDistance(first.Shape(), second.Shape(), second.position - first.position),
+        reference(first, second),
+        1e-12);
+}
+
+TEST(EllipseKernel, AxisAligned)
+{
+    const Ellipse ellipse{0.0, 2.0, 1.5, 1.5};
+    const EllipseShape shape{ellipse, 0.0, 0.0, Point{1, 0}};
+    EXPECT_DOUBLE_EQ(EffectiveDistance(shape, shape, Point{10, 0}), 6.0);
+    EXPECT_DOUBLE_EQ(EffectiveDistance(shape, shape, Point{0, -5}), 2.0);
+    EXPECT_DOUBLE_EQ(EffectiveDistance(shape, shape, Point{3, 0}), 1.0);
+}
+
+TEST(EllipseKernel, BatchMatchesSinglePairs)
+{
+    std::mt19937 rng(99);
+    const auto self = randomAgent(rng);
+    std::vector<Agent> neighbors{};
+    EllipseBatch batch{};
+    for(size_t index = 0; index < 37; ++index) {
+        neighbors.push_back(randomAgent(rng));
+        batch.Push(neighbors.back().position - self.position, neighbors.back().Shape());
+    }
+    // One neighbor on top of the agent exercises the degenerate lane.
+    neighbors.push_back(randomAgent(rng));
+    neighbors.back().position = self.position;
+    batch.Push(Point{}, neighbors.back().Shape());
+
+    ASSERT_EQ(batch.Size(), neighbors.size());
+    std::vector<double> distances(batch.Size());
+    batch.EffectiveDistances(self.Shape(), distances);
+    for(size_t index = 0; index < neighbors.size(); ++index) {
+        EXPECT_NEAR(distances[index], reference(self, neighbors[index]), 1e-12);
+    }
+}
+
+TEST(EllipseKernel, ClearedBatchCanBeReused)
+{
+    std::mt19937 rng(7);
+    const auto self = randomAgent(rng);
+    EllipseBatch batch{};
+    for(size_t index = 0; index < 20; ++index) {
+        const auto neighbor = randomAgent(rng);
+        batch.Push(neighbor.position - self.position, neighbor.Shape());
+    }
+    batch.Clear();
+    EXPECT_EQ(batch.Size(), 0u);
+
+    const auto neighbor = randomAgent(rng);
+    batch.Push(neighbor.position - self.position, neighbor.Shape());
+    std::vector<double> distances(batch.Size());
+    batch.EffectiveDistances(self.Shape(), distances);
+    EXPECT_NEAR(distances[0], reference(self, neighbor), 1e-12);
+}
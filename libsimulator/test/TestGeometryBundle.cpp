@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "CollisionGeometry.hpp"
+#include "GeometryBuilder.hpp"
+#include "GeometryBundle.hpp"
+#include "LineSegment.hpp"
+#include "Point.hpp"
+#include "RoutingEngine.hpp"
+#include "SimulationError.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// A room with a pillar and a corridor leading out of it.
+GeometryBundle roomWithPillar()
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea({{0, 0}, {10, 0}, {10, 10}, {0, 10}});
+    builder.AddAccessibleArea({{10, 4}, {30, 4}, {30, 6}, {10, 6}});
+    builder.ExcludeFromAccessibleArea({{4, 4}, {6, 4}, {6, 6}, {4, 6}});
+    return GeometryBundle{std::make_shared<const CollisionGeometry>(builder.Build())};
+}
+
+std::vector<LineSegment> segmentsNear(const CollisionGeometry& geometry, Point p)
+{
+    const auto range = geometry.LineSegmentsInApproxDistanceTo(p);
+    return {range.begin(), range.end()};
+}
+} // namespace
+
+TEST(GeometryBundle, DeserializedBundleAnswersQueriesAlike)
+{
+    const auto bundle = roomWithPillar();
+    const auto restored = GeometryBundle::Deserialize(bundle.Serialize());
+
+    EXPECT_EQ(restored.Geometry().AccessibleArea(), bundle.Geometry().AccessibleArea());
+    for(const Point p : {Point{1, 1}, Point{5, 3}, Point{9, 5}, Point{25, 5}}) {
+        EXPECT_EQ(segmentsNear(restored.Geometry(), p), segmentsNear(bundle.Geometry(), p));
+        EXPECT_EQ(
+            restored.Geometry().IntersectsAny({{1, 1}, p}),
+            bundle.Geometry().IntersectsAny({{1, 1}, p}));
+        EXPECT_EQ(restored.Geometry().InsideGeometry(p), bundle.Geometry().InsideGeometry(p));
+        EXPECT_EQ(
+            restored.Routing().ComputeAllWaypoints({1, 5}, p),
+            bundle.Routing().ComputeAllWaypoints({1, 5}, p));
+    }
+    EXPECT_FALSE(restored.Routing().IsRoutable({5, 5}));
+    EXPECT_EQ(
+        restored.Routing().MeshData()->CountPolygons(),
+        bundle.Routing().MeshData()->CountPolygons());
+}
+
+TEST(GeometryBundle, RoutingLocatesExactlyTheWalkablePoints)
+{
+    const auto bundle = roomWithPillar();
+    const auto restored = GeometryBundle::Deserialize(bundle.Serialize());
+    // The step keeps the points off the walls, where both answers are allowed to differ.
+    for(double x = -1.0; x < 31.0; x += 0.37) {
+        for(double y = -1.0; y < 11.0; y += 0.37) {
+            const Point p{x, y};
+            const bool walkable = bundle.Geometry().InsideGeometry(p);
+            EXPECT_EQ(bundle.Routing().IsRoutable(p), walkable) << p.x << ", " << p.y;
+            EXPECT_EQ(restored.Routing().IsRoutable(p), walkable) << p.x << ", " << p.y;
+        }
+    }
+}
+
+TEST(GeometryBundle, RoutingFromSeveralThreadsMatchesSequentialRouting)
+{
+    const auto bundle = roomWithPillar();
+    std::vector<Point> positions{};
+    for(double x = 0.5; x < 10.0; x += 1.0) {
+        for(double y = 0.5; y < 10.0; y += 1.0) {
+            if(bundle.Routing().IsRoutable({x, y})) {
+                positions.emplace_back(x, y);
+            }
+        }
+    }
+    const Point destination{25, 5};
+    const auto expected = bundle.Routing().ComputeWaypoints(positions, destination);
+
+    std::vector<std::vector<Point>> results(8);
+    std::vector<std::thread> threads{};
+    for(auto& result : results) {
+        threads.emplace_back([&bundle, &positions, &result, destination]() {
+            for(size_t repetition = 0; repetition < 20; ++repetition) {
+                result = bundle.Routing().ComputeWaypoints(positions, destination);
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(const auto& result : results) {
+        EXPECT_EQ(result, expected);
+    }
+}
+
+TEST(GeometryBundle, SavedBundleCanBeLoaded)
+{
+    const auto bundle = roomWithPillar();
+    const auto file = std::filesystem::temp_directory_path() / "TestGeometryBundle.jpsgeom";
+    bundle.Save(file);
+
+    const auto loaded = GeometryBundle::Load(file);
+    std::filesystem::remove(file);
+
+    EXPECT_EQ(loaded.Geometry().AccessibleArea(), bundle.Geometry().AccessibleArea());
+    EXPECT_EQ(
+        loaded.Routing().ComputeAllWaypoints({1, 5}, {25, 5}),
+        bundle.Routing().ComputeAllWaypoints({1, 5}, {25, 5}));
+}
+
+TEST(GeometryBundle, RejectsInvalidData)
+{
+    auto data = roomWithPillar().Serialize();
+
+    auto wrongMagic = data;
+    wrongMagic[0] = 'X';
+    EXPECT_THROW(GeometryBundle::Deserialize(wrongMagic), SimulationError);
+
+    // Header: magic, byte order tag, format version and the library version as a string.
+    auto otherByteOrder = data;
+    std::reverse(otherByteOrder.begin() + 8, otherByteOrder.begin() + 12);
+    EXPECT_THROW(GeometryBundle::Deserialize(otherByteOrder), SimulationError);
+
+    auto wrongVersion = data;
+    wrongVersion[12] += 1;
+    EXPECT_THROW(GeometryBundle::Deserialize(wrongVersion), SimulationError);
+
+    auto wrongLibraryVersion = data;
+    wrongLibraryVersion[24] += 1;
+    EXPECT_THROW(GeometryBundle::Deserialize(wrongLibraryVersion), SimulationError);
+
+    const std::vector<uint8_t> truncated(data.begin(), data.begin() + data.size() / 2);
+    EXPECT_THROW(GeometryBundle::Deserialize(truncated), SimulationError);
+
+    EXPECT_THROW(
+        GeometryBundle::Load(std::filesystem::temp_directory_path() / "missing.jpsgeom"),
+        SimulationError);
+}
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "HardwareCounters.hpp"
+#include "Timing.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+uint64_t busyWork()
+{
+    volatile uint64_t sum = 0;
+    for(uint64_t index = 0; index < 100000; ++index) {
+        sum = sum + index * index;
+    }
+    return sum;
+}
+} // namespace
+
+TEST(HardwareCounterValues, DifferenceDoesNotUnderflow)
+{
+    const HardwareCounterValues before{{10, 20, 30, 40}};
+    const HardwareCounterValues after{{15, 20, 0, 41}};
+    EXPECT_EQ((after - before).values, (std::array<uint64_t, 4>{5, 0, 0, 1}));
+}
+
+TEST(HardwareCounters, CountInstructionsWhenAvailable)
+{
+    HardwareCounters counters{};
+    if(!counters.Available()) {
+        EXPECT_FALSE(counters.Reason().empty());
+        EXPECT_EQ(counters.Read().values, HardwareCounterValues{}.values);
+        GTEST_SKIP() << counters.Reason();
+    }
+    EXPECT_TRUE(counters.Reason().empty());
+    const auto before = counters.Read();
+    busyWork();
+    const auto counted = counters.Read() - before;
+    for(size_t index = 0; index < HardwareCounterValues::count; ++index) {
+        if(!counters.Opened(index)) {
+            EXPECT_EQ(counted.values[index], 0u);
+        }
+    }
+    if(counters.Opened(1)) {
+        EXPECT_GT(counted.values[1], 100000u);
+    }
+}
+
+TEST(Timer, RecordsHardwareCountersPerProbe)
+{
+    Timer timer{};
+    EXPECT_FALSE(timer.hardwareCountersEnabled());
+    const auto id = TimerProbeRegistry::Register("TestHardwareCounters probe");
+    timer.pushTimerProbe(id);
+    timer.popTimerProbe(id);
+    EXPECT_TRUE(timer.getHardwareCounters().empty());
+
+    if(!timer.enableHardwareCounters()) {
+        EXPECT_FALSE(timer.hardwareCountersEnabled());
+        GTEST_SKIP() << "Hardware counters are not available";
+    }
+    timer.pushTimerProbe(id);
+    busyWork();
+    timer.popTimerProbe(id);
+    timer.disableHardwareCounters();
+    timer.pushTimerProbe(id);
+    timer.popTimerProbe(id);
+
+    const auto counters = timer.getHardwareCounters();
+    ASSERT_EQ(counters.count("TestHardwareCounters probe"), 1u);
+    EXPECT_FALSE(counters.at("TestHardwareCounters probe").empty());
+}
+
+TEST(Timer, RecordsNoHardwareCountersOnOtherThreads)
+{
+    Timer timer{};
+    if(!timer.enableHardwareCounters()) {
+        GTEST_SKIP() << "Hardware counters are not available";
+    }
+    const auto id = TimerProbeRegistry::Register("TestHardwareCounters other thread");
+    std::thread{[&timer, id]() {
+        timer.pushTimerProbe(id);
+        busyWork();
+        timer.popTimerProbe(id);
+    }}.join();
+
+    EXPECT_EQ(timer.getHardwareCounters().count("TestHardwareCounters other thread"), 0u);
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "MemoryUsage.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TEST(MemoryUsage, VectorCountsCapacity)
+{
+    std::vector<uint64_t> values{};
+    EXPECT_EQ(jps::memory::HeapBytes(values), 0u);
+    values.reserve(10);
+    values.push_back(1);
+    EXPECT_EQ(jps::memory::HeapBytes(values), values.capacity() * sizeof(uint64_t));
+}
+
+TEST(MemoryUsage, NestedContainersCountTheirElements)
+{
+    const std::vector<std::vector<uint64_t>> nested(2, std::vector<uint64_t>(10));
+    EXPECT_EQ(
+        jps::memory::HeapBytes(nested),
+        2 * sizeof(std::vector<uint64_t>) + 2 * 10 * sizeof(uint64_t));
+
+    std::unordered_map<int, std::vector<uint64_t>> grid{};
+    const auto empty = jps::memory::HeapBytes(grid);
+    grid[0] = std::vector<uint64_t>(100);
+    EXPECT_GE(jps::memory::HeapBytes(grid), empty + 100 * sizeof(uint64_t));
+}
+
+TEST(MemoryUsage, ShortStringsAreInline)
+{
+    std::map<int, std::string> names{{1, "short"}};
+    const auto inlineBytes = jps::memory::HeapBytes(names);
+    names[1] = std::string(100, 'x');
+    EXPECT_GT(jps::memory::HeapBytes(names), inlineBytes + 100);
+}
+
+TEST(MemoryBreakdown, TotalSumsAllParts)
+{
+    MemoryBreakdown breakdown{};
+    EXPECT_EQ(breakdown.Total(), 0u);
+    breakdown.bytes["agents"] = 100;
+    breakdown.bytes["stages"] = 20;
+    EXPECT_EQ(breakdown.Total(), 120u);
+}
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AgentView.hpp"
+#include "GenericAgent.hpp"
+#include "GeometryBuilder.hpp"
+#include "MultiRateStepping.hpp"
+#include "NeighborhoodSearch.hpp"
+#include "OperationalDecisionSystem.hpp"
+#include "OperationalModels/CustomModel/CustomModel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+namespace
+{
+struct CountingState {
+    Point velocity{};
+    int steps{};
+    double time{};
+};
+
+class CountingModel : public CustomModel
+{
+public:
+    Point ComputeNextState(
+        const OperationalModelState& current,
+        OperationalModelState& next,
+        const AgentStep& step) const override
+    {
+        const auto& state = std::get<CustomModel::State>(current).Get<CountingState>();
+        auto& nextState = std::get<CustomModel::State>(next).Get<CountingState>();
+        nextState.steps = state.steps + 1;
+        nextState.time = state.time + step.dt();
+        return state.velocity * step.dt();
+    }
+
+    void CheckModelConstraint(const GenericAgent&, const AgentView&) const override {}
+};
+
+GenericAgent MakeAgent(Point position)
+{
+    return GenericAgent(
+        GenericAgent::ID{},
+        jps::UniqueID<Journey>::Invalid,
+        jps::UniqueID<BaseStage>::Invalid,
+        position,
+        CustomModel::State{CountingState{Point{1.0, 0.0}, 0, 0.0}});
+}
+
+const CountingState& stateOf(const GenericAgent& agent)
+{
+    return std::get<CustomModel::State>(agent.state).Get<CountingState>();
+}
+} // namespace
+
+TEST(MultiRateStepping, LevelGrowsWithNeighbors)
+{
+    const MultiRateStepping settings{.maxLevel = 2, .radius = 1.0, .neighborsPerLevel = 2};
+    EXPECT_EQ(settings.Level(0), 0u);
+    EXPECT_EQ(settings.Level(1), 0u);
+    EXPECT_EQ(settings.Level(2), 1u);
+    EXPECT_EQ(settings.Level(4), 2u);
+    EXPECT_EQ(settings.Level(100), 2u);
+}
+
+TEST(MultiRateStepping, DisabledByDefault)
+{
+    EXPECT_FALSE(MultiRateStepping{}.Enabled());
+}
+
+TEST(MultiRateStepping, RejectsInvalidSettings)
+{
+    OperationalDecisionSystem system{std::make_unique<CountingModel>()};
+    EXPECT_THROW(
+        system.SetMultiRateStepping({.maxLevel = MultiRateStepping::levelLimit + 1}),
+        SimulationError);
+    EXPECT_THROW(system.SetMultiRateStepping({.maxLevel = 1, .radius = 0.0}), SimulationError);
+    EXPECT_THROW(
+        system.SetMultiRateStepping({.maxLevel = 1, .radius = 1.0, .neighborsPerLevel = 0}),
+        SimulationError);
+}
+
+TEST(MultiRateStepping, DenseAgentsTakeSubSteps)
+{
+    GeometryBuilder builder{};
+    builder.AddAccessibleArea({{-20, -20}, {20, -20}, {20, 20}, {-20, 20}});
+    const auto geometry = builder.Build();
+
+    AgentContainer<GenericAgent> agents{};
+    // Three agents with two neighbors each and one on its own.
+    agents.push_back(MakeAgent({0.0, 0.0}));
+    agents.push_back(MakeAgent({0.5, 0.0}));
+    agents.push_back(MakeAgent({0.0, 0.5}));
+    agents.push_back(MakeAgent({10.0, 0.0}));
+
+    NeighborhoodSearch<GenericAgent> neighborhoodSearch{2.2};
+    neighborhoodSearch.Update(agents);
+
+    OperationalDecisionSystem system{std::make_unique<CountingModel>()};
+    system.SetMultiRateStepping({.maxLevel = 3, .radius = 1.0, .neighborsPerLevel = 2});
+    system.RunMultiRate(0.5, 0, neighborhoodSearch, geometry, agents);
+
+    for(size_t index = 0; index < 3; ++index) {
+        EXPECT_EQ(stateOf(agents[index]).steps, 2);
+        EXPECT_DOUBLE_EQ(stateOf(agents[index]).time, 0.5);
+    }
+    EXPECT_EQ(stateOf(agents[3]).steps, 1);
+    EXPECT_DOUBLE_EQ(stateOf(agents[3]).time, 0.5);
+    EXPECT_EQ(agents[0].Position(), Point(0.5, 0.0));
+    EXPECT_EQ(agents[3].Position(), Point(10.5, 0.0));
+}
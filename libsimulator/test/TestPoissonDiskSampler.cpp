@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "Point.hpp"
+#include "PoissonDiskSampler.hpp"
+#include "SimulationError.hpp"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+const std::vector<Point> square{{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+const std::vector<Point> hole{{4, 4}, {6, 4}, {6, 6}, {4, 6}};
+
+void expectAgentDistance(const std::vector<Point>& samples, double distance)
+{
+    for(size_t i = 0; i < samples.size(); ++i) {
+        for(size_t j = i + 1; j < samples.size(); ++j) {
+            EXPECT_GE(Distance(samples[i], samples[j]), distance);
+        }
+    }
+}
+
+void expectOutsideHoleAndInsideSquare(const std::vector<Point>& samples, double wallDistance)
+{
+    for(const auto& p : samples) {
+        EXPECT_GE(p.x, wallDistance);
+        EXPECT_LE(p.x, 10 - wallDistance);
+        EXPECT_GE(p.y, wallDistance);
+        EXPECT_LE(p.y, 10 - wallDistance);
+        const bool nearHole =
+            p.x > 4 - wallDistance && p.x < 6 + wallDistance && p.y > 4 - wallDistance &&
+            p.y < 6 + wallDistance;
+        const bool nearHoleCorner = (p.x < 4 || p.x > 6) && (p.y < 4 || p.y > 6);
+        EXPECT_TRUE(!nearHole || nearHoleCorner) << fmt::format("{}", p);
+    }
+}
+} // namespace
+
+TEST(PoissonDiskSampler, AddRandomRespectsConstraints)
+{
+    PoissonDiskSampler sampler(square, {hole}, 0.5, 0.3, 42);
+    ASSERT_EQ(sampler.AddRandom(150, 10000), 150);
+    ASSERT_EQ(sampler.Samples().size(), 150);
+    expectAgentDistance(sampler.Samples(), 0.5);
+    expectOutsideHoleAndInsideSquare(sampler.Samples(), 0.3);
+}
+
+TEST(PoissonDiskSampler, AddRandomStopsWhenFull)
+{
+    PoissonDiskSampler sampler(square, {}, 3.0, 1.0, 42);
+    const auto placed = sampler.AddRandom(100, 1000);
+    ASSERT_LT(placed, 100);
+    ASSERT_EQ(sampler.Samples().size(), placed);
+}
+
+TEST(PoissonDiskSampler, SameSeedSameSamples)
+{
+    PoissonDiskSampler a(square, {hole}, 0.4, 0.2, 1337);
+    PoissonDiskSampler b(square, {hole}, 0.4, 0.2, 1337);
+    a.AddRandom(100, 10000);
+    b.AddRandom(100, 10000);
+    ASSERT_EQ(a.Samples(), b.Samples());
+}
+
+TEST(PoissonDiskSampler, RingSamplesStayInRing)
+{
+    PoissonDiskSampler sampler(square, {}, 0.3, 0.3, 7);
+    ASSERT_EQ(sampler.AddRandomInRing({5, 5}, 0, 2, 30, 10000), 30);
+    ASSERT_EQ(sampler.AddRandomInRing({5, 5}, 3, 4.5, 40, 10000), 40);
+    const auto& samples = sampler.Samples();
+    for(size_t index = 0; index < samples.size(); ++index) {
+        const auto distance = Distance(samples[index], {5, 5});
+        if(index < 30) {
+            EXPECT_LE(distance, 2);
+        } else {
+            EXPECT_GE(distance, 3);
+            EXPECT_LE(distance, 4.5);
+        }
+    }
+    expectAgentDistance(samples, 0.3);
+}
+
+TEST(PoissonDiskSampler, FillCoversArea)
+{
+    PoissonDiskSampler sampler(square, {hole}, 0.5, 0.25, 3);
+    ASSERT_TRUE(sampler.Fill(30, 10000));
+    const auto& samples = sampler.Samples();
+    expectAgentDistance(samples, 0.5);
+    expectOutsideHoleAndInsideSquare(samples, 0.25);
+    // Maximal Poisson disk samplings reach well above half the hexagonal packing density.
+    const double area = 9.5 * 9.5 - 2.5 * 2.5;
+    ASSERT_GT(samples.size(), 0.5 * area / (0.5 * 0.5 * 0.866));
+}
+
+TEST(PoissonDiskSampler, FillFailsWithoutSpace)
+{
+    PoissonDiskSampler sampler(square, {}, 0.5, 6, 3);
+    ASSERT_FALSE(sampler.Fill(30, 1000));
+    ASSERT_TRUE(sampler.Samples().empty());
+}
+
+TEST(PoissonDiskSampler, RejectsInvalidParameters)
+{
+    ASSERT_THROW(PoissonDiskSampler(square, {}, 0, 0.1, 1), SimulationError);
+    ASSERT_THROW(PoissonDiskSampler(square, {}, 0.5, -1, 1), SimulationError);
+    ASSERT_THROW(PoissonDiskSampler({{0, 0}, {1, 1}}, {}, 0.5, 0.1, 1), SimulationError);
+    PoissonDiskSampler sampler(square, {}, 0.5, 0.1, 1);
+    ASSERT_THROW(sampler.AddRandomInRing({5, 5}, 2, 1, 1, 10), SimulationError);
+}
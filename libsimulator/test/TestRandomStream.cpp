@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "RandomStream.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+std::vector<uint32_t> draw(RandomStream stream, size_t count)
+{
+    std::vector<uint32_t> values(count);
+    for(auto& value : values) {
+        value = stream();
+    }
+    return values;
+}
+} // namespace
+
+TEST(RandomStream, MatchesPhiloxKnownAnswers)
+{
+    // Known answer tests of the Random123 reference implementation.
+    using Block = RandomStream::Block;
+    ASSERT_EQ(
+        RandomStream::Philox({0, 0, 0, 0}, {0, 0}),
+        (Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    ASSERT_EQ(
+        RandomStream::Philox(
+            {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}),
+        (Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    ASSERT_EQ(
+        RandomStream::Philox(
+            {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+        (Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(RandomStream, SameKeySameNumbers)
+{
+    ASSERT_EQ(draw({42, 7, 100}, 10), draw({42, 7, 100}, 10));
+}
+
+TEST(RandomStream, StreamsAreIndependentOfEachOther)
+{
+    const auto reference = draw({42, 7, 100}, 10);
+    ASSERT_NE(reference, draw({43, 7, 100}, 10));
+    ASSERT_NE(reference, draw({42, 8, 100}, 10));
+    ASSERT_NE(reference, draw({42, 7, 101}, 10));
+    ASSERT_NE(reference, draw({42, 7, 100 + (uint64_t{1} << 32)}, 10));
+    ASSERT_NE(reference, draw({42, 7 + (uint64_t{1} << 32), 100}, 10));
+}
+
+TEST(RandomStream, DrawsStayInRange)
+{
+    RandomStream stream{1, 2, 3};
+    double sum = 0;
+    constexpr int count = 100000;
+    for(int index = 0; index < count; ++index) {
+        const auto unit = stream.Uniform();
+        ASSERT_GE(unit, 0.0);
+        ASSERT_LT(unit, 1.0);
+        sum += unit;
+        const auto scaled = stream.Uniform(-0.05, 0.05);
+        ASSERT_GE(scaled, -0.05);
+        ASSERT_LT(scaled, 0.05);
+        ASSERT_LT(stream.Below(3), 3u);
+    }
+    ASSERT_NEAR(sum / count, 0.5, 0.01);
+}
@@ -56,3 +56,78 @@ TEST_F(StagesTests, NotifiableWaitingSetTargetIsCorrect)
         ASSERT_EQ(target, waitingPoints.back());
     }
 }
+
+TEST_F(StagesTests, NotifiableQueueUpdatesWhenAgentNearsFreeSlot)
+{
+    NotifiableQueue queue({{0, 0}, {1, 0}});
+    const EnvironmentQuery envQuery(*collisionGeometry, neighborhoodSearch);
+    // Nobody is around for the initial update.
+    queue.Update(envQuery);
+
+    AgentContainer<GenericAgent> agents{};
+    agents.emplace_back(
+        GenericAgent::ID::Invalid,
+        Journey::ID::Invalid,
+        queue.Id(),
+        Point{0.5, 0},
+        CollisionFreeSpeedModelState{});
+    neighborhoodSearch.Update(agents);
+
+    // The agent has not been noticed yet, the queue does not look for it.
+    queue.Update(envQuery);
+    ASSERT_TRUE(queue.Occupants().empty());
+
+    ASSERT_EQ(queue.Target(agents[0]), Point(0, 0));
+    queue.Update(envQuery);
+    ASSERT_EQ(queue.Occupants(), std::vector<GenericAgent::ID>{agents[0].id});
+    ASSERT_EQ(queue.Target(agents[0]), Point(0, 0));
+}
+
+TEST_F(StagesTests, NotifiableQueuePopRefillsSlots)
+{
+    NotifiableQueue queue({{0, 0}, {1, 0}});
+    const EnvironmentQuery envQuery(*collisionGeometry, neighborhoodSearch);
+    AgentContainer<GenericAgent> agents{};
+    for(const auto position : {Point{0, 0}, Point{1, 0}, Point{2, 0}}) {
+        agents.emplace_back(
+            GenericAgent::ID::Invalid,
+            Journey::ID::Invalid,
+            queue.Id(),
+            position,
+            CollisionFreeSpeedModelState{});
+    }
+    neighborhoodSearch.Update(agents);
+    queue.Update(envQuery);
+    ASSERT_EQ(queue.Occupants().size(), 2u);
+    // The third agent waits behind the queue.
+    ASSERT_EQ(queue.Target(agents[2]), Point(1, 0));
+
+    queue.Pop(1);
+    ASSERT_TRUE(queue.IsCompleted(agents[0]));
+    agents[0].stageId = BaseStage::ID::Invalid;
+    queue.Update(envQuery);
+    ASSERT_EQ(queue.Occupants(), (std::vector<GenericAgent::ID>{agents[1].id, agents[2].id}));
+    ASSERT_EQ(queue.Target(agents[1]), Point(0, 0));
+    ASSERT_EQ(queue.Target(agents[2]), Point(1, 0));
+}
+
+TEST_F(StagesTests, WaypointFilterCompletedKeepsAgentsInRange)
+{
+    const Waypoint waypoint({1, 1}, 0.5);
+    const std::vector<Point> positions{{1, 1}, {1.5, 1}, {1.6, 1}, {-3, 4}};
+    std::vector<uint8_t> candidates(positions.size(), 1);
+    waypoint.FilterCompleted(positions, candidates);
+    ASSERT_EQ(candidates, (std::vector<uint8_t>{1, 1, 0, 0}));
+}
+
+TEST_F(StagesTests, ExitFilterCompletedKeepsAgentsInside)
+{
+    std::vector<GenericAgent::ID> toRemove{};
+    // Clockwise on purpose, the polygon reorders its vertices.
+    const Exit exit(Polygon({{0, 0}, {0, 2}, {3, 2}, {3, 0}}), toRemove);
+    const std::vector<Point> positions{{1, 1}, {0, 1}, {3, 2}, {-0.1, 1}, {1, 2.1}, {4, 4}};
+    std::vector<uint8_t> candidates(positions.size(), 1);
+    exit.FilterCompleted(positions, candidates);
+    ASSERT_EQ(candidates, (std::vector<uint8_t>{1, 1, 1, 0, 0, 0}));
+    ASSERT_TRUE(toRemove.empty());
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "Timing.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+TEST(TimerProbeRegistry, RegistersEachNameOnce)
+{
+    const auto id = TimerProbeRegistry::Register("TestTiming probe");
+    EXPECT_EQ(TimerProbeRegistry::Register(std::string{"TestTiming probe"}), id);
+    EXPECT_EQ(TimerProbeRegistry::Find("TestTiming probe"), id);
+    EXPECT_EQ(TimerProbeRegistry::Name(id), "TestTiming probe");
+    EXPECT_FALSE(TimerProbeRegistry::Find("TestTiming unknown probe").has_value());
+}
+
+TEST(Timer, RecordsOneSamplePerIteration)
+{
+    Timer timer{};
+    timer.setIterationSampling(true);
+    const auto id = TimerProbeRegistry::Register("TestTiming iteration probe");
+    for(uint64_t iteration = 0; iteration < 3; ++iteration) {
+        timer.setIteration(iteration);
+        timer.pushTimerProbe(id);
+        timer.popTimerProbe(id);
+        timer.pushTimerProbe(id);
+        timer.popTimerProbe(id);
+    }
+
+    const auto* entry = timer.getEntry("TestTiming iteration probe");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->sampleIterations(), (std::vector<uint64_t>{0, 1, 2}));
+    EXPECT_EQ(entry->sampleDurationsInNanoseconds().size(), 3u);
+    EXPECT_EQ(timer.getIterationStatistics().at("TestTiming iteration probe").iterations, 3u);
+}
+
+TEST(Timer, RecordsNoSamplesByDefault)
+{
+    Timer timer{};
+    const auto id = TimerProbeRegistry::Register("TestTiming unsampled probe");
+    for(uint64_t iteration = 0; iteration < 3; ++iteration) {
+        timer.setIteration(iteration);
+        timer.pushTimerProbe(id);
+        timer.popTimerProbe(id);
+    }
+
+    const auto* entry = timer.getEntry("TestTiming unsampled probe");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->sampleIterations().empty());
+    EXPECT_EQ(entry->memoryUsage(), 0u);
+}
+
+TEST(Timer, SkipsProbesAboveLogLevel)
+{
+    Timer timer{};
+    timer.setLogLevel(0);
+    {
+        auto guard = timer.scopedTimerProbe("TestTiming filtered probe", 1);
+    }
+    EXPECT_EQ(timer.getEntry("TestTiming filtered probe"), nullptr);
+    EXPECT_EQ(timer.getDurations().count("TestTiming filtered probe"), 0u);
+}
+
+TEST(TimerEntry, ComputesNearestRankPercentiles)
+{
+    TimerEntry entry{};
+    EXPECT_EQ(entry.getIterationStatistics().iterations, 0u);
+    for(uint64_t iteration = 0; iteration < 100; ++iteration) {
+        entry.start();
+        entry.stop(iteration);
+    }
+    const auto statistics = entry.getIterationStatistics();
+    EXPECT_EQ(statistics.iterations, 100u);
+    EXPECT_LE(statistics.p50, statistics.p95);
+    EXPECT_LE(statistics.p95, statistics.p99);
+    EXPECT_LE(statistics.p99, statistics.max);
+}
@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AgentView.hpp"
+#include "EnvironmentQuery.hpp"
+#include "GenericAgent.hpp"
+#include "GeometryBuilder.hpp"
+#include "NeighborhoodSearch.hpp"
+#include "OperationalModels/CollisionFreeSpeedModel/CollisionFreeSpeedModel.hpp"
+#include "VerletList.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr double cutoff = 2.0;
+constexpr double skin = 0.4;
+
+GenericAgent MakeAgent(Point pos)
+{
+    return GenericAgent(
+        GenericAgent::ID{},
+        jps::UniqueID<Journey>::Invalid,
+        jps::UniqueID<BaseStage>::Invalid,
+        pos,
+        CollisionFreeSpeedModel::State{});
+}
+
+CollisionGeometry OpenGeometry()
+{
+    GeometryBuilder b{};
+    b.AddAccessibleArea({{-100, -100}, {100, -100}, {100, 100}, {-100, 100}});
+    return b.Build();
+}
+
+// Geometry with a block at 0.9 <= x <= 1.1, -1 <= y <= 1 that blocks line-of-sight across it.
+CollisionGeometry WalledGeometry()
+{
+    GeometryBuilder b{};
+    b.AddAccessibleArea({{-100, -100}, {100, -100}, {100, 100}, {-100, 100}});
+    b.ExcludeFromAccessibleArea({{0.9, -1}, {1.1, -1}, {1.1, 1}, {0.9, 1}});
+    return b.Build();
+}
+
+struct Environment {
+    AgentContainer<GenericAgent> agents{};
+    NeighborhoodSearch<GenericAgent> neighborhood_search{2.2};
+
+    void add_agent(Point pos) { agents.push_back(MakeAgent(pos)); }
+
+    void move_agent(size_t index, Point offset) { agents[index].MoveAlongSurface(offset); }
+
+    EnvironmentQuery query(const CollisionGeometry& geo)
+    {
+        neighborhood_search.Update(agents);
+        return {geo, neighborhood_search};
+    }
+};
+
+std::vector<size_t> candidateIndices(const VerletList& list, size_t index)
+{
+    std::vector<size_t> indices{};
+    for(const auto& candidate : list.CandidatesOf(index)) {
+        indices.push_back(candidate.index);
+    }
+    std::sort(std::begin(indices), std::end(indices));
+    return indices;
+}
+
+bool hasClearSight(const VerletList& list, size_t index, size_t other)
+{
+    const auto candidates = list.CandidatesOf(index);
+    const auto iter =
+        std::find_if(std::begin(candidates), std::end(candidates), [other](const auto& candidate) {
+            return candidate.index == other;
+        });
+    EXPECT_NE(iter, std::end(candidates));
+    return iter != std::end(candidates) && iter->clearSight;
+}
+} // namespace
+
+TEST(VerletList, RejectsInvalidParameters)
+{
+    EXPECT_THROW(VerletList(0.0, skin), SimulationError);
+    EXPECT_THROW(VerletList(cutoff, 0.0), SimulationError);
+    EXPECT_THROW(VerletList(cutoff, -1.0), SimulationError);
+}
+
+TEST(VerletList, CandidatesAreAllAgentsWithinCutoffPlusSkin)
+{
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> coordinate(-5.0, 5.0);
+    Environment env{};
+    for(size_t index = 0; index < 200; ++index) {
+        env.add_agent({coordinate(rng), coordinate(rng)});
+    }
+    const auto geo = OpenGeometry();
+    VerletList list{cutoff, skin};
+    EXPECT_TRUE(list.Update(env.agents, env.query(geo)));
+
+    const double radiusSquared = (cutoff + skin) * (cutoff + skin);
+    for(size_t index = 0; index < env.agents.size(); ++index) {
+        std::vector<size_t> expected{};
+        for(size_t other = 0; other < env.agents.size(); ++other) {
+            if(other != index &&
+               DistanceSquared(env.agents[index].Position(), env.agents[other].Position()) <=
+                   radiusSquared) {
+                expected.push_back(other);
+            }
+        }
+        EXPECT_EQ(candidateIndices(list, index), expected);
+    }
+}
+
+TEST(VerletList, ReusedUntilAnAgentMovedHalfTheSkin)
+{
+    Environment env{};
+    env.add_agent({0, 0});
+    env.add_agent({1, 0});
+    const auto geo = OpenGeometry();
+    VerletList list{cutoff, skin};
+    EXPECT_TRUE(list.Update(env.agents, env.query(geo)));
+    EXPECT_FALSE(list.Update(env.agents, env.query(geo)));
+
+    env.move_agent(1, {0.4 * skin, 0});
+    EXPECT_FALSE(list.Update(env.agents, env.query(geo)));
+
+    env.move_agent(1, {0.2 * skin, 0});
+    EXPECT_TRUE(list.Update(env.agents, env.query(geo)));
+    EXPECT_EQ(list.Builds(), 2u);
+}
+
+TEST(VerletList, RebuiltWhenAgentsChange)
+{
+    Environment env{};
+    env.add_agent({0, 0});
+    env.add_agent({1, 0});
+    env.add_agent({0, 1});
+    const auto geo = OpenGeometry();
+    VerletList list{cutoff, skin};
+    list.Update(env.agents, env.query(geo));
+
+    env.agents.pop_front();
+    EXPECT_TRUE(list.Update(env.agents, env.query(geo)));
+    EXPECT_EQ(candidateIndices(list, 0), std::vector<size_t>{1});
+
+    env.agents[0] = MakeAgent(env.agents[0].Position());
+    EXPECT_TRUE(list.Update(env.agents, env.query(geo)));
+}
+
+TEST(VerletList, ClearSightOnlyWithMarginToWalls)
+{
+    Environment env{};
+    env.add_agent({0, 0});
+    env.add_agent({2, 0}); // behind the wall
+    env.add_agent({0, 1.5}); // same side, far from the wall
+    env.add_agent({2, 0.9}); // sight passes the wall's corner closer than half the skin
+    const auto geo = WalledGeometry();
+    VerletList list{cutoff, skin};
+    list.Update(env.agents, env.query(geo));
+
+    EXPECT_FALSE(hasClearSight(list, 0, 1));
+    EXPECT_FALSE(hasClearSight(list, 1, 0));
+    EXPECT_TRUE(hasClearSight(list, 0, 2));
+    EXPECT_FALSE(hasClearSight(list, 2, 3));
+}
+
+TEST(VerletList, AgentViewMatchesNeighborhoodSearch)
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coordinate(-4.0, 4.0);
+    std::uniform_real_distribution<double> offset(-0.04, 0.04);
+    Environment env{};
+    for(size_t index = 0; index < 100; ++index) {
+        env.add_agent({coordinate(rng), coordinate(rng)});
+    }
+    const auto geo = WalledGeometry();
+    VerletList list{cutoff, skin};
+
+    const auto sorted = [](std::vector<NeighborView> neighbors) {
+        std::sort(std::begin(neighbors), std::end(neighbors), [](const auto& a, const auto& b) {
+            return a.state < b.state;
+        });
+        return neighbors;
+    };
+    for(size_t step = 0; step < 10; ++step) {
+        const auto q = env.query(geo);
+        list.Update(env.agents, q);
+        for(size_t index = 0; index < env.agents.size(); ++index) {
+            const AgentView plain{q, env.agents[index]};
+            const AgentView verlet{q, env.agents[index], &list, index};
+            const auto _w = plain.WallsNearby();
+            const std::vector<WallView> walls(_w.begin(), _w.end());
+            for(const double radius : {1.0, cutoff}) {
+                const auto expected = sorted(plain.OtherAgentsInSight(radius, walls));
+                const auto actual = sorted(verlet.OtherAgentsInSight(radius, walls));
+                ASSERT_EQ(actual.size(), expected.size());
+                for(size_t n = 0; n < expected.size(); ++n) {
+                    EXPECT_EQ(actual[n].state, expected[n].state);
+                    EXPECT_EQ(actual[n].RelativePosition, expected[n].RelativePosition);
+                }
+            }
+        }
+        for(size_t index = 0; index < env.agents.size(); ++index) {
+            env.move_agent(index, {offset(rng), offset(rng)});
+        }
+    }
+    EXPECT_LT(list.Builds(), 10u);
+}
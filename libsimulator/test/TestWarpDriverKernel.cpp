@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "Point.hpp"
+#include "WarpDriverKernel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+using namespace warp_driver;
+
+namespace
+{
+constexpr double timeHorizon = 2.0;
+constexpr double lambda = 0.5;
+constexpr double velocityUncertaintyX = 0.2;
+constexpr double velocityUncertaintyY = 0.3;
+constexpr size_t sampleCount = 20;
+
+/// Smooth stand-in for the tabulated Intrinsic Field, exp(-|p|² / 2) and its exact gradient.
+struct GaussianField {
+    std::pair<double, Point> Sample(double x, double y) const
+    {
+        const double value = std::exp(-(x * x + y * y) / 2.0);
+        return {value, Point{-x * value, -y * value}};
+    }
+};
+
+struct Neighbor {
+    Point relPos;
+    Point orient;
+    double speed;
+    double radius;
+};
+
+struct Totals {
+    double p{};
+    double gradX{};
+    double gradY{};
+    double gradT{};
+};
+
+// Per sample warp of the model before the kernel was restructured, kept as reference.
+struct STP {
+    double x;
+    double y;
+    double t;
+};
+
+STP referenceForward(const STP& s, const Neighbor& nb, Point orientA)
+{
+    // W_local
+    const double wx = orientA.x * s.x - orientA.y * s.y;
+    const double wy = orientA.y * s.x + orientA.x * s.y;
+    const double dx = wx - nb.relPos.x;
+    const double dy = wy - nb.relPos.y;
+    STP r{nb.orient.x * dx + nb.orient.y * dy, -nb.orient.y * dx + nb.orient.x * dy, s.t};
+    // W_v
+    r.x -= nb.speed * r.t;
+    // W_r
+    const double invR = 1.0 / std::max(nb.radius, 1e-6);
+    r.x *= invR;
+    r.y *= invR;
+    return r;
+}
+
+std::vector<Totals> reference(
+    const std::vector<STP>& samples,
+    const std::vector<Neighbor>& neighbors,
+    Point orientA,
+    const GaussianField& field)
+{
+    const double beta1 = 1.0 / (1.0 + velocityUncertaintyX);
+    const double beta2 = 1.0 + velocityUncertaintyY;
+    std::vector<Totals> totals(samples.size());
+    for(const auto& nb : neighbors) {
+        for(size_t i = 0; i < samples.size(); ++i) {
+            const auto& s = samples[i];
+            const auto atTu = referenceForward(s, nb, orientA);
+            // W_tu, W_vu, W_th
+            const double beta = 1.0 / (1.0 + lambda * std::max(s.t, 0.0));
+            const double fieldX = atTu.x * beta * beta1;
+            const double fieldY = atTu.y * beta * beta2;
+            const double tNormalized = s.t / timeHorizon;
+            if(tNormalized < 0.0 || tNormalized > 1.0) {
+                continue;
+            }
+            const auto [intrinsicP, gradI] = field.Sample(fieldX, fieldY);
+            const double pB = intrinsicP * beta * beta * beta1 * beta2;
+            if(pB < 1e-12) {
+                continue;
+            }
+
+            // Inverse Jacobians in reverse order
+            double gx = gradI.x * beta1;
+            double gy = gradI.y * beta2;
+            double gt = -lambda * beta * beta * (atTu.x * gx + atTu.y * gy);
+            gx *= beta;
+            gy *= beta;
+            gt -= nb.speed * gx;
+            const double cosAB = orientA.x * nb.orient.x + orientA.y * nb.orient.y;
+            const double sinAB = orientA.y * nb.orient.x - orientA.x * nb.orient.y;
+            const double gbx = cosAB * gx + sinAB * gy;
+            const double gby = -sinAB * gx + cosAB * gy;
+
+            auto& total = totals[i];
+            const double pOld = total.p;
+            total.p = pOld + pB - pOld * pB;
+            total.gradX = total.gradX + gbx - pOld * gbx - pB * total.gradX;
+            total.gradY = total.gradY + gby - pOld * gby - pB * total.gradY;
+            total.gradT = total.gradT + gt - pOld * gt - pB * total.gradT;
+        }
+    }
+    return totals;
+}
+
+// The Gaussian convolved with the unit disk by a midpoint sum in polar coordinates, which follows
+// the disk boundary exactly.
+double sampledDiskConvolution(double sigma, double rho)
+{
+    constexpr int radialSteps = 2000;
+    constexpr int angularSteps = 256;
+    const double dr = 1.0 / radialSteps;
+    const double dphi = 2 * std::numbers::pi / angularSteps;
+    double sum = 0.0;
+    for(int i = 0; i < radialSteps; ++i) {
+        const double r = (i + 0.5) * dr;
+        for(int k = 0; k < angularSteps; ++k) {
+            const double phi = (k + 0.5) * dphi;
+            const double distanceSquared = rho * rho + r * r - 2 * rho * r * std::cos(phi);
+            sum += r * std::exp(-distanceSquared / (2 * sigma * sigma));
+        }
+    }
+    return sum * dr * dphi;
+}
+} // namespace
+
+TEST(WarpDriverKernel, DiskConvolutionMatchesSampledField)
+{
+    for(const double sigma : {0.1, 0.3, 1.0}) {
+        const DiskConvolution convolution(sigma);
+        // At the center the convolution is 2πσ²(1 - exp(-1 / 2σ²)).
+        const double peak =
+            2 * std::numbers::pi * sigma * sigma * (1 - std::exp(-1 / (2 * sigma * sigma)));
+        EXPECT_NEAR(convolution(0.0), peak, 1e-12 * peak) << "sigma " << sigma;
+        for(const double rho : {0.0, 0.4, 0.9, 1.0, 1.1, 1.8, 3.0}) {
+            EXPECT_NEAR(convolution(rho), sampledDiskConvolution(sigma, rho), 1e-5 * peak)
+                << "sigma " << sigma << ", rho " << rho;
+        }
+    }
+}
+
+TEST(WarpDriverKernel, MatchesPerSampleReference)
+{
+    const Point orientA = Point{1.0, 0.5}.Normalized();
+    const double speed = 1.3;
+    const std::vector<Neighbor> neighbors{
+        {Point{1.5, 0.2}, Point{-1.0, 0.0}, 1.2, 0.4},
+        {Point{0.8, -0.9}, Point{0.6, 0.8}, 0.7, 0.35},
+        {Point{2.5, 1.0}, Point{0.0, -1.0}, 1.5, 0.45},
+        {Point{-0.6, 0.4}, Point{1.0, 0.0}, 0.0, 0.4}};
+    const GaussianField field{};
+    const auto vu = VelocityUncertaintyFactors(velocityUncertaintyX, velocityUncertaintyY);
+    const double dt = timeHorizon / (sampleCount - 1);
+
+    std::vector<STP> samples{};
+    SampleLanes lanes(sampleCount);
+    for(size_t i = 0; i < sampleCount; ++i) {
+        const double t = static_cast<double>(i) * dt;
+        const double lateral = 0.05 * std::sin(static_cast<double>(i));
+        samples.push_back(STP{speed * t, lateral, t});
+        lanes.t()[i] = t;
+        lanes.x()[i] = speed * t;
+        lanes.y()[i] = lateral;
+        lanes.timeScale()[i] = 1.0 / (1.0 + lambda * t);
+        lanes.probabilityScale()[i] =
+            lanes.timeScale()[i] * lanes.timeScale()[i] * vu.beta1 * vu.beta2;
+    }
+    for(const auto& nb : neighbors) {
+        AccumulateNeighbor(
+            lanes,
+            MakeNeighborWarp(nb.relPos, orientA, nb.orient, nb.speed, nb.radius),
+            field,
+            vu,
+            lambda);
+    }
+
+    const auto expected = reference(samples, neighbors, orientA, field);
+    bool anyCollision = false;
+    for(size_t i = 0; i < sampleCount; ++i) {
+        EXPECT_NEAR(lanes.pTotal()[i], expected[i].p, 1e-12) << "sample " << i;
+        EXPECT_NEAR(lanes.gradX()[i], expected[i].gradX, 1e-12) << "sample " << i;
+        EXPECT_NEAR(lanes.gradY()[i], expected[i].gradY, 1e-12) << "sample " << i;
+        EXPECT_NEAR(lanes.gradT()[i], expected[i].gradT, 1e-12) << "sample " << i;
+        anyCollision = anyCollision || expected[i].p > 0.1;
+    }
+    // The configuration has to actually exercise the union of several neighbors.
+    EXPECT_TRUE(anyCollision);
+}
@@ -0,0 +1,308 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""
+Runs a fixed matrix of scenarios and compares their timings and peak memory
+against a stored baseline
+"""
+
+import dataclasses
+import json
+import os
+import pathlib
+import platform
+import random
+import statistics
+import subprocess
+import sys
+import time
+from typing import Callable
+
+import shapely
+
+import jupedsim as jps
+
+WALL_TIME = "wall_time_s"
+PEAK_RSS = "peak_rss_mb"
+TIMER_PREFIX = "timer/"
+
+
+@dataclasses.dataclass(frozen=True)
+class Scenario:
+    name: str
+    model: Callable[[], object]
+    state: Callable[[], object]
+    walkable_area: shapely.Polygon
+    spawn_area: shapely.Polygon
+    exit_area: shapely.Polygon
+    agents: int
+    iterations: int
+
+
+def _corridor(model, state, name):
+    return Scenario(
+        name=f"corridor_{name}",
+        model=model,
+        state=state,
+        walkable_area=shapely.box(0, 0, 60, 6),
+        spawn_area=shapely.box(0, 0, 20, 6),
+        exit_area=shapely.box(58, 0, 60, 6),
+        agents=300,
+        iterations=2000,
+    )
+
+
+def _bottleneck(model, state, name):
+    return Scenario(
+        name=f"bottleneck_{name}",
+        model=model,
+        state=state,
+        walkable_area=shapely.union(
+            shapely.box(0, 0, 20, 20), shapely.box(20, 9.4, 28, 10.6)
+        ),
+        spawn_area=shapely.box(0, 0, 15, 20),
+        exit_area=shapely.box(27, 9.4, 28, 10.6),
+        agents=300,
+        iterations=2000,
+    )
+
+
+_MODELS = [
+    ("cfsm", jps.CollisionFreeSpeedModel, jps.CollisionFreeSpeedModelState),
+    ("sfm", jps.SocialForceModel, jps.SocialForceModelState),
+    (
+        "avm",
+        jps.AnticipationVelocityModel,
+        jps.AnticipationVelocityModelState,
+    ),
+]
+
+SCENARIOS = {
+    scenario.name: scenario
+    for layout in [_corridor, _bottleneck]
+    for name, model, state in _MODELS
+    for scenario in [layout(model, state, name)]
+}
+
+
+def run_scenario(scenario: Scenario) -> dict[str, float]:
+    """
+    Runs the scenario in this process.
+
+    Returns:
+        Wall time of the iterations and the time spent in every timer in
+        seconds.
+    """
+    simulation = jps.Simulation(
+        model=scenario.model(),
+        geometry=scenario.walkable_area,
+        timer_log_level=2,
+    )
+    exit_id = simulation.add_exit_stage(scenario.exit_area)
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    positions = jps.distribute_by_number(
+        polygon=scenario.spawn_area,
+        number_of_agents=scenario.agents,
+        distance_to_agents=0.4,
+        distance_to_polygon=0.3,
+        seed=1,
+    )
+    for position in positions:
+        simulation.add_agent(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            position=position,
+            state=scenario.state(),
+        )
+
+    start = time.perf_counter()
+    simulation.iterate(scenario.iterations)
+    metrics = {WALL_TIME: time.perf_counter() - start}
+    for key, duration_us in simulation.timer.durations_us.items():
+        metrics[f"{TIMER_PREFIX}{key}"] = duration_us / 1e6
+    return metrics
+
+
+def run_scenario_in_subprocess(
+    script: pathlib.Path, name: str
+) -> dict[str, float]:
+    """
+    Runs the scenario in a fresh interpreter by calling 'script run-once', so
+    that the peak RSS belongs to this scenario alone.
+
+    The peak RSS is only measured on Unix, which reports the resource usage
+    of a single child through os.wait4. Elsewhere the results have no
+    PEAK_RSS metric and comparisons skip it.
+    """
+    process = subprocess.Popen(
+        [sys.executable, str(script), "run-once", name],
+        stdout=subprocess.PIPE,
+    )
+    output = process.stdout.read()
+    process.stdout.close()
+    usage = None
+    if hasattr(os, "wait4"):
+        # Popen.wait does not return the resource usage of the child.
+        _, status, usage = os.wait4(process.pid, 0)
+        process.returncode = os.waitstatus_to_exitcode(status)
+    else:
+        process.wait()
+    if process.returncode != 0:
+        raise RuntimeError(
+            f"Scenario {name} failed with exit code {process.returncode}"
+        )
+    metrics = json.loads(output)
+    if usage is not None:
+        # ru_maxrss is in kilobytes on Linux and in bytes on macOS.
+        scale = 1 if sys.platform == "darwin" else 1024
+        metrics[PEAK_RSS] = usage.ru_maxrss * scale / 2**20
+    return metrics
+
+
+def run_matrix(
+    script: pathlib.Path, names: list[str], repeats: int
+) -> dict[str, object]:
+    """
+    Runs every scenario 'repeats' times, interleaved so that slow drifts of
+    the machine affect all scenarios alike.
+
+    Returns:
+        Results to be stored as JSON, with the samples of every metric per
+        scenario.
+    """
+    samples = {name: {} for name in names}
+    for _ in range(repeats):
+        for name in names:
+            metrics = run_scenario_in_subprocess(script, name)
+            for metric, value in metrics.items():
+                samples[name].setdefault(metric, []).append(value)
+    return {
+        "metadata": {
+            "commit_id": jps.get_build_info().git_commit_hash,
+            "jupedsim_version": jps.__version__,
+            "hostname": platform.node(),
+            "python_version": platform.python_version(),
+            "repeats": repeats,
+        },
+        "scenarios": samples,
+    }
+
+
+def median_ratio_interval(
+    baseline: list[float],
+    current: list[float],
+    confidence: float,
+    resamples: int = 2000,
+) -> tuple[float, float, float]:
+    """
+    Ratio of the median of 'current' to the median of 'baseline' with a
+    bootstrap confidence interval.
+
+    Returns:
+        The ratio and the lower and upper bound of its confidence interval.
+    """
+    rng = random.Random(1)
+    ratios = sorted(
+        statistics.median(rng.choices(current, k=len(current)))
+        / statistics.median(rng.choices(baseline, k=len(baseline)))
+        for _ in range(resamples)
+    )
+    alpha = (1 - confidence) / 2
+    lower = ratios[int(alpha * (resamples - 1))]
+    upper = ratios[int((1 - alpha) * (resamples - 1))]
+    return (
+        statistics.median(current) / statistics.median(baseline),
+        lower,
+        upper,
+    )
+
+
+@dataclasses.dataclass(frozen=True)
+class Comparison:
+    scenario: str
+    metric: str
+    baseline_median: float
+    current_median: float
+    ratio: float
+    lower: float
+    upper: float
+    gated: bool
+    regressed: bool
+
+
+def compare(
+    baseline: dict[str, object],
+    current: dict[str, object],
+    *,
+    threshold: float,
+    confidence: float,
+    min_share: float,
+) -> list[Comparison]:
+    """
+    Compares every metric the baseline and the current results have in
+    common.
+
+    A metric regressed if even the lower bound of the confidence interval of
+    its slowdown exceeds 'threshold', so that noise alone does not fail the
+    comparison. Timers are only gated if they took at least 'min_share' of
+    the wall time in the baseline, shorter ones are too noisy.
+    """
+    comparisons = []
+    for scenario, metrics in current["scenarios"].items():
+        baseline_metrics = baseline["scenarios"].get(scenario)
+        if baseline_metrics is None:
+            continue
+        wall_time = statistics.median(baseline_metrics[WALL_TIME])
+        for metric, samples in metrics.items():
+            baseline_samples = baseline_metrics.get(metric)
+            if baseline_samples is None:
+                continue
+            baseline_median = statistics.median(baseline_samples)
+            if baseline_median <= 0:
+                continue
+            ratio, lower, upper = median_ratio_interval(
+                baseline_samples, samples, confidence
+            )
+            gated = (
+                not metric.startswith(TIMER_PREFIX)
+                or baseline_median >= min_share * wall_time
+            )
+            comparisons.append(
+                Comparison(
+                    scenario=scenario,
+                    metric=metric,
+                    baseline_median=baseline_median,
+                    current_median=statistics.median(samples),
+                    ratio=ratio,
+                    lower=lower,
+                    upper=upper,
+                    gated=gated,
+                    regressed=gated and lower > 1 + threshold,
+                )
+            )
+    return comparisons
+
+
+def format_comparisons(comparisons: list[Comparison]) -> str:
+    lines = [
+        f"{'Scenario':<18} {'Metric':<40} {'Baseline':>10} {'Current':>10}"
+        f" {'Change':>8} {'CI':>18}"
+    ]
+    for c in comparisons:
+        marker = " REGRESSION" if c.regressed else ""
+        if not c.gated:
+            marker = " (not gated)"
+        lines.append(
+            f"{c.scenario:<18} {c.metric:<40} {c.baseline_median:>10.3f}"
+            f" {c.current_median:>10.3f} {(c.ratio - 1) * 100:>+7.1f}%"
+            f" [{(c.lower - 1) * 100:>+6.1f}%, {(c.upper - 1) * 100:>+6.1f}%]"
+            f"{marker}"
+        )
+    return "\n".join(lines)
+
+
+def write_results(results: dict[str, object], path: pathlib.Path) -> None:
+    path.write_text(json.dumps(results, indent=2))
+
+
+def read_results(path: pathlib.Path) -> dict[str, object]:
+    return json.loads(path.read_text())
+
@@ -0,0 +1,136 @@
+#! /usr/bin/env python3
+
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import argparse
+import json
+import pathlib
+import sys
+
+from performancetest.regression import (
+    SCENARIOS,
+    compare,
+    format_comparisons,
+    read_results,
+    run_matrix,
+    run_scenario,
+    write_results,
+)
+
+
+def parse_args():
+    ap = argparse.ArgumentParser(
+        description="Runs the performance regression scenarios and compares "
+        "them against a stored baseline"
+    )
+    commands = ap.add_subparsers(dest="command", required=True)
+
+    run = commands.add_parser(
+        "run", help="run the scenario matrix and store the results as JSON"
+    )
+    run.add_argument(
+        "--output",
+        "-o",
+        type=pathlib.Path,
+        required=True,
+        help="file to write the results to, keep it as baseline",
+    )
+    run.add_argument(
+        "--repeats",
+        "-r",
+        type=int,
+        default=5,
+        help="number of runs per scenario",
+    )
+    run.add_argument(
+        "--scenario",
+        "-s",
+        action="append",
+        choices=sorted(SCENARIOS),
+        help="scenario to run, may be repeated, defaults to all",
+    )
+    run.add_argument(
+        "--baseline",
+        "-b",
+        type=pathlib.Path,
+        help="compare the results against this baseline afterwards",
+    )
+    add_compare_arguments(run)
+
+    comparison = commands.add_parser(
+        "compare",
+        help="compare results against a baseline, exits with 1 on a "
+        "regression",
+    )
+    comparison.add_argument("baseline", type=pathlib.Path)
+    comparison.add_argument("results", type=pathlib.Path)
+    add_compare_arguments(comparison)
+
+    once = commands.add_parser(
+        "run-once",
+        help="run a single scenario once and print its metrics as JSON",
+    )
+    once.add_argument("scenario", choices=sorted(SCENARIOS))
+    return ap.parse_args()
+
+
+def add_compare_arguments(parser):
+    parser.add_argument(
+        "--threshold",
+        "-t",
+        type=float,
+        default=0.05,
+        help="relative slowdown that counts as regression",
+    )
+    parser.add_argument(
+        "--confidence",
+        type=float,
+        default=0.95,
+        help="confidence level of the intervals of the slowdowns",
+    )
+    parser.add_argument(
+        "--min-share",
+        type=float,
+        default=0.05,
+        help="share of the wall time below which timers are not gated",
+    )
+
+
+def compare_and_report(baseline, results, args):
+    comparisons = compare(
+        read_results(baseline),
+        results,
+        threshold=args.threshold,
+        confidence=args.confidence,
+        min_share=args.min_share,
+    )
+    print(format_comparisons(comparisons))
+    regressions = [c for c in comparisons if c.regressed]
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) beyond {args.threshold:.0%}")
+        return 1
+    return 0
+
+
+def main():
+    args = parse_args()
+    if args.command == "run-once":
+        print(json.dumps(run_scenario(SCENARIOS[args.scenario])))
+        return 0
+    if args.command == "compare":
+        return compare_and_report(
+            args.baseline, read_results(args.results), args
+        )
+
+    results = run_matrix(
+        pathlib.Path(__file__).resolve(),
+        args.scenario or list(SCENARIOS),
+        args.repeats,
+    )
+    write_results(results, args.output)
+    if args.baseline is not None:
+        return compare_and_report(args.baseline, results, args)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
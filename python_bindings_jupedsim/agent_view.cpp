@@ -2,6 +2,7 @@
 #include "AgentView.hpp"
 #include "EnvironmentQuery.hpp"
 #include "OperationalModels/CustomModel/CustomModel.hpp"
+#include "RandomStream.hpp"
 #include "conversion.hpp"
 #include "python_model.hpp"
 #include "type_casters.hpp" // IWYU pragma: keep
@@ -9,6 +10,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <cstdint>
 #include <variant>
 
 namespace py = pybind11;
@@ -22,7 +24,7 @@ void init_agent_view(py::module_& m)
             if(const auto* custom = std::get_if<CustomModel::State>(&state)) {
                 // Custom states are unwrapped so that the _CustomModelState transport type
                 // never reaches user code.
-                return custom->Get<GilSafePyObject>().Get();
+                return PythonStateOf(*custom);
             }
             return py::cast(state);
         });
@@ -66,7 +68,20 @@ void init_agent_view(py::module_& m)
             py::arg("distance"),
             "Walls within exact distance of the agent, as seen from it.");
 
+    py::class_<RandomStream>(m, "RandomStream")
+        .def(
+            "uniform",
+            py::overload_cast<double, double>(&RandomStream::Uniform),
+            py::arg("lower"),
+            py::arg("upper"))
+        .def("below", &RandomStream::Below, py::arg("n"));
+
     py::class_<AgentStep, AgentView>(m, "AgentStep")
         .def_property_readonly("dt", &AgentStep::dt)
-        .def_property_readonly("to_next_target", &AgentStep::ToNextTarget);
+        .def_property_readonly("to_next_target", &AgentStep::ToNextTarget)
+        .def(
+            "random",
+            [](const AgentStep& self, uint64_t seed) { return self.Random(seed); },
+            py::arg("seed"),
+            "Random numbers for this agent in this step.");
 }
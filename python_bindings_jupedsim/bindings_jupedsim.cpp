@@ -26,6 +26,9 @@ void init_simulation(py::module_& m);
 void init_linesegment(py::module_& m);
 void init_agent_view(py::module_& m);
 void init_python_model(py::module_& m);
+void init_trajectory_writer(py::module_& m);
+void init_columnar_trajectory(py::module_& m);
+void init_poisson_disk_sampler(py::module_& m);
 
 PYBIND11_MODULE(py_jupedsim, m)
 {
@@ -50,4 +53,7 @@ PYBIND11_MODULE(py_jupedsim, m)
     init_transition(m);
     init_stage(m);
     init_simulation(m);
+    init_trajectory_writer(m);
+    init_columnar_trajectory(m);
+    init_poisson_disk_sampler(m);
 }
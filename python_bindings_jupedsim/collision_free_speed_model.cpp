@@ -14,12 +14,13 @@ void init_collision_free_speed_model(py::module_& m)
     py::class_<CollisionFreeSpeedModel, OperationalModel, py::smart_holder>(
         m, "CollisionFreeSpeedModel")
         .def(
-            py::init<double, double, double, double>(),
+            py::init<double, double, double, double, bool>(),
             py::kw_only(),
             py::arg("strength_neighbor_repulsion") = 8.0,
             py::arg("range_neighbor_repulsion") = 0.1,
             py::arg("strength_geometry_repulsion") = 5.0,
-            py::arg("range_geometry_repulsion") = 0.02);
+            py::arg("range_geometry_repulsion") = 0.02,
+            py::arg("pairwise") = false);
     const CollisionFreeSpeedModel::State d{};
     py::class_<CollisionFreeSpeedModel::State>(m, "CollisionFreeSpeedModelState")
         .def(
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AABB.hpp"
+#include "ColumnarTrajectory.hpp"
+#include "Simulation.hpp"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h> // IWYU pragma: keep
+#include <pybind11/stl/filesystem.h> // IWYU pragma: keep
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace py = pybind11;
+
+void init_columnar_trajectory(py::module_& m)
+{
+    py::class_<ColumnarTrajectoryWriter>(m, "ColumnarTrajectoryWriter")
+        .def(
+            py::init([](const std::filesystem::path& output_file,
+                        uint64_t every_nth_frame,
+                        uint32_t frames_per_chunk,
+                        double quantisation) {
+                return std::make_unique<ColumnarTrajectoryWriter>(
+                    ColumnarTrajectoryWriter::Options{
+                        output_file, every_nth_frame, frames_per_chunk, quantisation});
+            }),
+            py::kw_only(),
+            py::arg("output_file"),
+            py::arg("every_nth_frame"),
+            py::arg("frames_per_chunk"),
+            py::arg("quantisation"))
+        .def(
+            "begin_writing",
+            [](ColumnarTrajectoryWriter& w,
+               double dt,
+               const std::string& wkt,
+               int64_t geometry_hash,
+               std::tuple<double, double, double, double> bounds) {
+                const auto [xmin, ymin, xmax, ymax] = bounds;
+                AABB aabb{};
+                aabb.xmin = xmin;
+                aabb.ymin = ymin;
+                aabb.xmax = xmax;
+                aabb.ymax = ymax;
+                w.BeginWriting(dt, wkt, geometry_hash, aabb);
+            },
+            py::kw_only(),
+            py::arg("dt"),
+            py::arg("wkt"),
+            py::arg("geometry_hash"),
+            py::arg("bounds"))
+        .def(
+            "write_iteration_state",
+            [](ColumnarTrajectoryWriter& w, const Simulation& sim) { w.WriteIterationState(sim); })
+        .def("close", &ColumnarTrajectoryWriter::Close)
+        .def("every_nth_frame", &ColumnarTrajectoryWriter::EveryNthFrame);
+
+    py::class_<ColumnarTrajectoryReader>(m, "ColumnarTrajectoryReader")
+        .def(py::init<const std::filesystem::path&>(), py::arg("file"))
+        .def("frame_count", &ColumnarTrajectoryReader::FrameCount)
+        .def("fps", &ColumnarTrajectoryReader::Fps)
+        .def("geometry_wkt", &ColumnarTrajectoryReader::GeometryWkt)
+        .def("geometry_hash", &ColumnarTrajectoryReader::GeometryHash)
+        .def(
+            "bounds",
+            [](const ColumnarTrajectoryReader& r) {
+                const auto b = r.Bounds();
+                return std::make_tuple(b.xmin, b.xmax, b.ymin, b.ymax);
+            })
+        .def(
+            "frame",
+            [](const ColumnarTrajectoryReader& r, uint64_t index) {
+                auto frame = r.Frame(index);
+                return std::make_tuple(
+                    std::move(frame.ids), std::move(frame.xs), std::move(frame.ys));
+            },
+            py::arg("index"))
+        .def("iteration", &ColumnarTrajectoryReader::Iteration, py::arg("index"))
+        .def(
+            "frame_index_of_iteration",
+            &ColumnarTrajectoryReader::FrameIndexOfIteration,
+            py::arg("iteration"));
+}
@@ -1,12 +1,18 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "CollisionGeometry.hpp"
 #include "GeometryBuilder.hpp"
+#include "GeometryBundle.hpp"
 #include "conversion.hpp"
 #include "type_casters.hpp" // IWYU pragma: keep
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> // IWYU pragma: keep
+#include <pybind11/stl/filesystem.h> // IWYU pragma: keep
 
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -50,4 +56,24 @@ void init_geometry(py::module_& m)
                 builder.ExcludeFromAccessibleArea(intoPoints(points));
             })
         .def("build", &GeometryBuilder::Build);
+    py::class_<GeometryBundle>(m, "GeometryBundle")
+        .def(py::init([](const CollisionGeometry& geometry) {
+            return GeometryBundle{std::make_shared<const CollisionGeometry>(geometry)};
+        }))
+        .def("geometry", [](const GeometryBundle& bundle) { return bundle.Geometry(); })
+        .def(
+            "serialize",
+            [](const GeometryBundle& bundle) {
+                const auto data = bundle.Serialize();
+                return py::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+            })
+        .def_static(
+            "deserialize",
+            [](const py::bytes& data) {
+                const std::string_view view = data;
+                return GeometryBundle::Deserialize(
+                    {reinterpret_cast<const uint8_t*>(view.data()), view.size()});
+            })
+        .def("save", &GeometryBundle::Save, py::arg("file"))
+        .def_static("load", &GeometryBundle::Load, py::arg("file"));
 }
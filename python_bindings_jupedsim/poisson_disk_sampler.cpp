@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "PoissonDiskSampler.hpp"
+#include "conversion.hpp"
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h> // IWYU pragma: keep
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace py = pybind11;
+
+void init_poisson_disk_sampler(py::module_& m)
+{
+    py::class_<PoissonDiskSampler>(m, "PoissonDiskSampler")
+        .def(
+            py::init([](const std::vector<std::tuple<double, double>>& boundary,
+                        const std::vector<std::vector<std::tuple<double, double>>>& holes,
+                        double distance_to_agents,
+                        double distance_to_polygon,
+                        uint64_t seed) {
+                std::vector<std::vector<Point>> holePoints{};
+                holePoints.reserve(holes.size());
+                for(const auto& hole : holes) {
+                    holePoints.emplace_back(intoPoints(hole));
+                }
+                return std::make_unique<PoissonDiskSampler>(
+                    intoPoints(boundary),
+                    holePoints,
+                    distance_to_agents,
+                    distance_to_polygon,
+                    seed);
+            }),
+            py::kw_only(),
+            py::arg("boundary"),
+            py::arg("holes"),
+            py::arg("distance_to_agents"),
+            py::arg("distance_to_polygon"),
+            py::arg("seed"))
+        .def(
+            "add_random",
+            &PoissonDiskSampler::AddRandom,
+            py::kw_only(),
+            py::arg("count"),
+            py::arg("max_failures"))
+        .def(
+            "add_random_in_ring",
+            [](PoissonDiskSampler& sampler,
+               std::tuple<double, double> center,
+               double inner_radius,
+               double outer_radius,
+               size_t count,
+               size_t max_failures) {
+                return sampler.AddRandomInRing(
+                    intoPoint(center), inner_radius, outer_radius, count, max_failures);
+            },
+            py::kw_only(),
+            py::arg("center"),
+            py::arg("inner_radius"),
+            py::arg("outer_radius"),
+            py::arg("count"),
+            py::arg("max_failures"))
+        .def(
+            "fill",
+            &PoissonDiskSampler::Fill,
+            py::kw_only(),
+            py::arg("k"),
+            py::arg("max_iterations"))
+        .def(
+            "samples",
+            [](const PoissonDiskSampler& sampler) {
+                const auto& samples = sampler.Samples();
+                py::array_t<double> result({samples.size(), size_t{2}});
+                auto out = result.mutable_unchecked<2>();
+                for(size_t index = 0; index < samples.size(); ++index) {
+                    out(index, 0) = samples[index].x;
+                    out(index, 1) = samples[index].y;
+                }
+                return result;
+            })
+        .def("__len__", [](const PoissonDiskSampler& sampler) {
+            return sampler.Samples().size();
+        });
+}
@@ -3,19 +3,23 @@
 
 #include "AgentView.hpp"
 #include "GenericAgent.hpp"
+#include "LineSegment.hpp"
 #include "OperationalModel.hpp"
 #include "OperationalModels/CustomModel/CustomModel.hpp"
 #include "SimulationError.hpp"
 #include "conversion.hpp"
 
 #include <fmt/format.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -74,6 +78,75 @@ void GilSafePyObject::Set(py::object obj)
     _obj = std::move(obj);
 }
 
+PythonStateStore::~PythonStateStore()
+{
+    py::gil_scoped_acquire gil;
+    _states.clear();
+    _staged.clear();
+}
+
+PythonState PythonStateStore::Add(py::object state)
+{
+    if(_freeSlots.empty()) {
+        _states.emplace_back(std::move(state));
+        _staged.emplace_back();
+        return {this, static_cast<uint32_t>(_states.size() - 1)};
+    }
+    const uint32_t slot = _freeSlots.back();
+    _freeSlots.pop_back();
+    _states[slot] = std::move(state);
+    return {this, slot};
+}
+
+void PythonStateStore::Release(uint32_t slot)
+{
+    _states[slot] = py::object();
+    _staged[slot] = py::object();
+    _freeSlots.push_back(slot);
+}
+
+const py::object& PythonStateStore::Get(uint32_t slot) const
+{
+    return _states[slot];
+}
+
+void PythonStateStore::Stage(uint32_t slot, py::object state)
+{
+    if(!_staged[slot]) {
+        _stagedSlots.push_back(slot);
+    }
+    _staged[slot] = std::move(state);
+}
+
+void PythonStateStore::Discard()
+{
+    for(const auto slot : _stagedSlots) {
+        _staged[slot] = py::object();
+    }
+    _stagedSlots.clear();
+}
+
+void PythonStateStore::Commit()
+{
+    for(const auto slot : _stagedSlots) {
+        // Empty if the slot got released after staging.
+        if(_staged[slot]) {
+            _states[slot] = std::move(_staged[slot]);
+            _staged[slot] = py::object();
+        }
+    }
+    _stagedSlots.clear();
+}
+
+py::object PythonStateOf(const CustomModel::State& state)
+{
+    if(state.Holds<PythonState>()) {
+        const auto& handle = state.Get<PythonState>();
+        return handle.store->Get(handle.slot);
+    }
+    return state.Get<GilSafePyObject>().Get();
+}
+
 PythonModel::PythonModel(py::object model) : _model(std::move(model))
 {
     py::gil_scoped_acquire gil;
@@ -84,6 +157,13 @@ PythonModel::PythonModel(py::object model) : _model(std::move(model))
        !py::hasattr(_model, "_check_model_constraint")) {
         throw std::invalid_argument("_PythonModel requires a CustomOperationalModel instance");
     }
+    if(py::hasattr(_model, "_compute_next_states")) {
+        _batch = true;
+        _neighborRadius = py::cast<double>(_model.attr("neighbor_radius"));
+        if(_neighborRadius < 0.0) {
+            throw SimulationError("Neighbor radius needs to be >= 0, got {}", _neighborRadius);
+        }
+    }
 }
 
 /// Best-effort "<repr> (of type <T>)" for an object that failed a conversion. The
@@ -106,12 +186,13 @@ static std::string Describe(const py::object& obj)
 
 Point PythonModel::ComputeNextState(
     const OperationalModelState& current,
-    OperationalModelState& next,
+    OperationalModelState& /*next*/,
     const AgentStep& step) const
 {
     py::gil_scoped_acquire gil;
 
-    py::object pythonState = std::get<CustomModel::State>(current).Get<GilSafePyObject>().Get();
+    const auto& handle = std::get<CustomModel::State>(current).Get<PythonState>();
+    py::object pythonState = _store.Get(handle.slot);
     py::object pythonStep = py::cast(&step, py::return_value_policy::reference);
 
     py::object pythonUpdate = _model.attr("_compute_next_state")(pythonState, pythonStep);
@@ -130,10 +211,9 @@ Point PythonModel::ComputeNextState(
     py::object nextState = update[0];
     py::object movementValue = update[1];
 
-    // "next" shares the Python state object with "current" (GilSafePyObject copies are
-    // refcounted, not cloned), so this also rejects returning the current state instance.
-    auto& customModelData = std::get<CustomModel::State>(next).Get<GilSafePyObject>();
-    if(nextState.is(customModelData.Get())) {
+    // "next" carries the same handle as "current", the next state is staged in the store and
+    // committed once all agents stepped.
+    if(nextState.is(pythonState)) {
         throw SimulationError(
             "Current and updated model state are the same instance. "
             "compute_next_state() must return a new state object, "
@@ -149,7 +229,7 @@ Point PythonModel::ComputeNextState(
             "expected tuple[float, float], got {}",
             Describe(movementValue));
     }
-    customModelData.Set(nextState);
+    _store.Stage(handle.slot, std::move(nextState));
     return movement;
 }
 
@@ -157,12 +237,184 @@ void PythonModel::CheckModelConstraint(const GenericAgent& agent, const AgentVie
 {
     py::gil_scoped_acquire gil;
 
-    py::object pythonState = std::get<CustomModel::State>(agent.state).Get<GilSafePyObject>().Get();
+    py::object pythonState = PythonStateOf(std::get<CustomModel::State>(agent.state));
     py::object pythonView = py::cast(&view, py::return_value_policy::reference);
 
     _model.attr("_check_model_constraint")(pythonState, pythonView);
 }
 
+bool PythonModel::SupportsBatchStep() const
+{
+    return _batch;
+}
+
+void PythonModel::ComputeNextStates(
+    const AgentBatch& batch,
+    std::span<OperationalModelState* const> next,
+    std::span<Point> movements) const
+{
+    py::gil_scoped_acquire gil;
+
+    const auto& world = batch.World();
+    const auto& agents = batch.Agents();
+    const size_t count = batch.Size();
+    // Left over if the last step failed half way.
+    _store.Discard();
+
+    py::array_t<uint64_t> ids(count);
+    py::array_t<double> positions({count, size_t{2}});
+    py::array_t<double> targets({count, size_t{2}});
+    py::array_t<bool> stepping(count);
+    py::list states(count);
+    auto idsView = ids.mutable_unchecked<1>();
+    auto positionsView = positions.mutable_unchecked<2>();
+    auto targetsView = targets.mutable_unchecked<2>();
+    auto steppingView = stepping.mutable_unchecked<1>();
+    std::unordered_map<const GenericAgent*, int64_t> indices{};
+    indices.reserve(count);
+    for(size_t index = 0; index < count; ++index) {
+        const auto& agent = agents[index];
+        idsView(index) = agent.id.getID();
+        positionsView(index, 0) = agent.Position().x;
+        positionsView(index, 1) = agent.Position().y;
+        targetsView(index, 0) = agent.nextTarget.x;
+        targetsView(index, 1) = agent.nextTarget.y;
+        steppingView(index) = batch.Steps(index);
+        const auto& handle = std::get<CustomModel::State>(agent.state).Get<PythonState>();
+        states[index] = _store.Get(handle.slot);
+        indices.emplace(&agent, static_cast<int64_t>(index));
+    }
+
+    // Neighbors in sight and nearby walls per stepping agent, the same ones
+    // AgentView::OtherAgentsInSight() and AgentView::WallsNearby() yield, CSR packed: the entries
+    // of agent i are [offsets[i], offsets[i + 1]).
+    std::vector<int64_t> neighborOffsets{0};
+    std::vector<int64_t> neighbors{};
+    std::vector<int64_t> wallOffsets{0};
+    std::vector<double> walls{};
+    std::vector<LineSegment> relativeWalls{};
+    neighborOffsets.reserve(count + 1);
+    wallOffsets.reserve(count + 1);
+    for(size_t index = 0; index < count; ++index) {
+        if(batch.Steps(index)) {
+            const auto& agent = agents[index];
+            const auto origin = agent.Position();
+            relativeWalls.clear();
+            for(const auto& segment : world.LineSegmentsInRange(origin)) {
+                relativeWalls.push_back({segment.p1 - origin, segment.p2 - origin});
+                walls.insert(
+                    std::end(walls), {segment.p1.x, segment.p1.y, segment.p2.x, segment.p2.y});
+            }
+            if(_neighborRadius > 0.0) {
+                world.ForEachAgentInRange(origin, _neighborRadius, [&](const GenericAgent& other) {
+                    const auto iter = indices.find(&other);
+                    if(other.id == agent.id || iter == std::end(indices)) {
+                        return;
+                    }
+                    if(world.NoGeometryBetween(Point{}, other.Position() - origin, relativeWalls)) {
+                        neighbors.push_back(iter->second);
+                    }
+                });
+            }
+        }
+        neighborOffsets.push_back(static_cast<int64_t>(neighbors.size()));
+        wallOffsets.push_back(static_cast<int64_t>(walls.size() / 4));
+    }
+
+    py::object pythonUpdate = _model.attr("_compute_next_states")(
+        py::arg("ids") = ids,
+        py::arg("positions") = positions,
+        py::arg("targets") = targets,
+        py::arg("stepping") = stepping,
+        py::arg("dt") = batch.dt(),
+        py::arg("states") = states,
+        py::arg("neighbor_offsets") =
+            py::array_t<int64_t>(neighborOffsets.size(), neighborOffsets.data()),
+        py::arg("neighbors") = py::array_t<int64_t>(neighbors.size(), neighbors.data()),
+        py::arg("wall_offsets") = py::array_t<int64_t>(wallOffsets.size(), wallOffsets.data()),
+        py::arg("walls") = py::array_t<double>({walls.size() / 4, size_t{4}}, walls.data()));
+
+    if(!py::isinstance<py::tuple>(pythonUpdate) || py::len(pythonUpdate) != 2) {
+        throw SimulationError(
+            "compute_next_states() must return a (states, movements) pair, got {}",
+            Describe(pythonUpdate));
+    }
+    auto update = py::reinterpret_borrow<py::tuple>(pythonUpdate);
+    py::object nextStates = update[0];
+    py::object movementsValue = update[1];
+
+    py::array_t<double, py::array::c_style | py::array::forcecast> movementsArray{};
+    try {
+        movementsArray =
+            py::cast<py::array_t<double, py::array::c_style | py::array::forcecast>>(
+                movementsValue);
+    } catch(const py::cast_error&) {
+        throw SimulationError(
+            "Movements returned by compute_next_states() are of wrong type: "
+            "expected an array of shape ({}, 2), got {}",
+            count,
+            Describe(movementsValue));
+    }
+    if(movementsArray.ndim() != 2 || static_cast<size_t>(movementsArray.shape(0)) != count ||
+       movementsArray.shape(1) != 2) {
+        throw SimulationError(
+            "Movements returned by compute_next_states() need to be of shape ({}, 2)", count);
+    }
+    if(!nextStates.is_none() && py::len(nextStates) != count) {
+        throw SimulationError(
+            "States returned by compute_next_states() need to contain {} entries, got {}",
+            count,
+            py::len(nextStates));
+    }
+
+    const auto movementsView = movementsArray.unchecked<2>();
+    for(size_t index = 0; index < count; ++index) {
+        if(!batch.Steps(index)) {
+            continue;
+        }
+        movements[index] = Point{movementsView(index, 0), movementsView(index, 1)};
+        if(nextStates.is_none()) {
+            continue;
+        }
+        py::object nextState = nextStates[py::int_(index)];
+        if(nextState.is_none()) {
+            continue;
+        }
+        // Same rule as in ComputeNextState, see there. None keeps the current state instead.
+        const auto slot = std::get<CustomModel::State>(*next[index]).Get<PythonState>().slot;
+        if(nextState.is(_store.Get(slot))) {
+            throw SimulationError(
+                "Current and updated model state of agent {} are the same instance. "
+                "compute_next_states() must return new state objects or None for unchanged "
+                "states.",
+                agents[index].id.getID());
+        }
+        _store.Stage(slot, std::move(nextState));
+    }
+}
+
+void PythonModel::AdoptState(OperationalModelState& state)
+{
+    auto& custom = std::get<CustomModel::State>(state);
+    if(custom.Holds<PythonState>()) {
+        return;
+    }
+    py::gil_scoped_acquire gil;
+    custom = CustomModel::State{_store.Add(custom.Get<GilSafePyObject>().Get())};
+}
+
+void PythonModel::ReleaseState(const OperationalModelState& state)
+{
+    py::gil_scoped_acquire gil;
+    _store.Release(std::get<CustomModel::State>(state).Get<PythonState>().slot);
+}
+
+void PythonModel::CommitStates()
+{
+    py::gil_scoped_acquire gil;
+    _store.Commit();
+}
+
 void init_python_model(py::module_& m)
 {
     py::class_<OperationalModel, py::smart_holder>(m, "OperationalModel");
@@ -172,7 +424,7 @@ void init_python_model(py::module_& m)
             return CustomModel::State{GilSafePyObject{std::move(model)}};
         }))
         .def_property_readonly(
-            "model", [](CustomModel::State& data) { return data.Get<GilSafePyObject>().Get(); });
+            "model", [](CustomModel::State& data) { return PythonStateOf(data); });
 
     py::class_<PythonModel, OperationalModel, py::smart_holder>(m, "_PythonModel")
         .def(py::init<py::object>(), py::arg("model"));
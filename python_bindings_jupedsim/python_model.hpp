@@ -6,15 +6,18 @@
 
 #include <pybind11/pybind11.h>
 
+#include <cstdint>
+#include <span>
+#include <vector>
+
 namespace py = pybind11;
 
 /// GIL-safe owner of a py::object, used as the type-erased payload for
-/// CustomModel::State (per-agent custom state).
+/// CustomModel::State (per-agent custom state) until the agent joins a simulation, see
+/// PythonModel::AdoptState.
 ///
 /// Copy and copy-assignment SHARE the wrapped object by reference: they incref
-/// the same Python object, they do NOT clone it. This is what makes per-step
-/// agent value-copies (e.g. neighbor queries) cheap -- the agent struct is
-/// copied, but its Python state is only ref-counted, not deep-copied.
+/// the same Python object, they do NOT clone it.
 ///
 /// Every operation that changes a Python reference count -- copy, copy-assign,
 /// move-assign, Set, and destruction -- acquires the GIL. The holder is therefore
@@ -39,6 +42,46 @@ private:
     py::object _obj;
 };
 
+class PythonStateStore;
+
+/// Per-agent custom state of an agent in a simulation: a slot in the PythonStateStore of its
+/// PythonModel. Trivially copyable, so agents are copied without touching Python reference
+/// counts or the GIL.
+struct PythonState {
+    PythonStateStore* store;
+    uint32_t slot;
+};
+
+/// Python state objects of the agents of one PythonModel. States computed during a step are
+/// staged and only become visible with Commit, so every agent of a step reads the states the
+/// step started with. All members except the destructor expect the GIL to be held.
+class PythonStateStore
+{
+    std::vector<py::object> _states{};
+    std::vector<py::object> _staged{};
+    std::vector<uint32_t> _stagedSlots{};
+    std::vector<uint32_t> _freeSlots{};
+
+public:
+    PythonStateStore() = default;
+    ~PythonStateStore();
+    PythonStateStore(const PythonStateStore& other) = delete;
+    PythonStateStore& operator=(const PythonStateStore& other) = delete;
+    PythonStateStore(PythonStateStore&& other) = delete;
+    PythonStateStore& operator=(PythonStateStore&& other) = delete;
+
+    PythonState Add(py::object state);
+    void Release(uint32_t slot);
+    const py::object& Get(uint32_t slot) const;
+    void Stage(uint32_t slot, py::object state);
+    /// Drops all staged states.
+    void Discard();
+    void Commit();
+};
+
+/// The Python object held by 'state', before or after the agent joined a simulation.
+py::object PythonStateOf(const CustomModel::State& state);
+
 class PythonModel final : public CustomModel
 {
 public:
@@ -51,6 +94,25 @@ public:
 
     void CheckModelConstraint(const GenericAgent& agent, const AgentView& view) const override;
 
+    /// True for CustomOperationalBatchModel instances.
+    bool SupportsBatchStep() const override;
+
+    /// Hands all agents to the model's compute_next_states() in one call. Positions, targets and
+    /// the CSR packed neighbors and walls of each agent are passed as numpy arrays.
+    void ComputeNextStates(
+        const AgentBatch& batch,
+        std::span<OperationalModelState* const> next,
+        std::span<Point> movements) const override;
+
+    /// Moves the Python state of a new agent into the store.
+    void AdoptState(OperationalModelState& state) override;
+    void ReleaseState(const OperationalModelState& state) override;
+    void CommitStates() override;
+
 private:
     py::object _model;
+    // Written to by the const ComputeNextState(s), like the agents' next states.
+    mutable PythonStateStore _store{};
+    bool _batch{false};
+    double _neighborRadius{0.0};
 };
@@ -23,14 +23,14 @@ void init_routing(py::module_& m)
         }))
         .def(
             "compute_waypoints",
-            [](RoutingEngine& engine,
+            [](const RoutingEngine& engine,
                std::tuple<double, double> from,
                std::tuple<double, double> to) {
                 return intoTuples(engine.ComputeAllWaypoints(intoPoint(from), intoPoint(to)));
             })
         .def(
             "is_routable",
-            [](RoutingEngine& engine, std::tuple<double, double> point) {
+            [](const RoutingEngine& engine, std::tuple<double, double> point) {
                 return engine.IsRoutable(intoPoint(point));
             })
         .def("mesh", [](const RoutingEngine& routingEngine) {
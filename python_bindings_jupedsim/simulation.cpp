@@ -1,11 +1,16 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 #include "Simulation.hpp"
 
+#include "AgentSleepSystem.hpp"
+#include "BatchRunner.hpp"
 #include "CollisionGeometry.hpp"
 #include "GenericAgent.hpp"
+#include "GeometryBundle.hpp"
 #include "Journey.hpp"
+#include "MultiRateStepping.hpp"
 #include "OperationalModel.hpp"
 #include "Polygon.hpp"
+#include "SimulationError.hpp"
 #include "Stage.hpp"
 #include "StageDescription.hpp"
 #include "conversion.hpp"
@@ -14,13 +19,17 @@
 #include <pybind11/attr.h>
 #include <pybind11/cast.h>
 #include <pybind11/detail/common.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> // IWYU pragma: keep
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -45,6 +54,19 @@ void init_simulation(py::module_& m)
             py::arg("model"),
             py::arg("geometry"),
             py::arg("dt"))
+        .def(
+            py::init([](std::unique_ptr<OperationalModel> model,
+                        const GeometryBundle& geometry,
+                        double dT) {
+                if(!model) {
+                    throw std::invalid_argument("model must not be None");
+                }
+                return std::make_unique<Simulation>(std::move(model), geometry, dT);
+            }),
+            py::kw_only(),
+            py::arg("model"),
+            py::arg("geometry"),
+            py::arg("dt"))
         .def(
             "add_waypoint_stage",
             [](Simulation& sim, std::tuple<double, double> position, double distance) {
@@ -99,6 +121,49 @@ void init_simulation(py::module_& m)
             py::arg("stage_id"),
             py::arg("position"),
             py::arg("state"))
+        .def(
+            "add_agents",
+            [](Simulation& sim,
+               uint64_t journeyId,
+               uint64_t stageId,
+               py::array_t<double, py::array::c_style | py::array::forcecast> positions,
+               const std::vector<OperationalModelState>& states) {
+                if(positions.ndim() != 2 || positions.shape(1) != 2) {
+                    throw SimulationError("positions need to be of shape (n, 2)");
+                }
+                const auto count = static_cast<size_t>(positions.shape(0));
+                if(states.size() != 1 && states.size() != count) {
+                    throw SimulationError(
+                        "states need to contain either one state or one state per position, got "
+                        "{} states for {} positions",
+                        states.size(),
+                        count);
+                }
+                const auto xy = positions.unchecked<2>();
+                std::vector<GenericAgent> agents{};
+                agents.reserve(count);
+                for(size_t index = 0; index < count; ++index) {
+                    const auto& state = states.size() == 1 ? states.front() : states[index];
+                    agents.emplace_back(
+                        GenericAgent::ID::Invalid,
+                        journeyId,
+                        stageId,
+                        Point{xy(index, 0), xy(index, 1)},
+                        state);
+                }
+                const auto ids = sim.AddAgents(std::move(agents));
+                py::array_t<uint64_t> result(ids.size());
+                auto out = result.mutable_unchecked<1>();
+                for(size_t index = 0; index < ids.size(); ++index) {
+                    out(index) = ids[index].getID();
+                }
+                return result;
+            },
+            py::kw_only(),
+            py::arg("journey_id"),
+            py::arg("stage_id"),
+            py::arg("positions"),
+            py::arg("states"))
         .def(
             "mark_agent_for_removal",
             [](Simulation& sim, uint64_t id) { sim.MarkAgentForRemoval(id); })
@@ -164,6 +229,32 @@ void init_simulation(py::module_& m)
             })
         .def("get_stage_proxy", [](Simulation& sim, uint64_t id) { return sim.Stage(id); })
         .def("set_tracing", [](Simulation& sim, bool status) { sim.SetTracing(status); })
+        .def("set_verlet_skin", [](Simulation& sim, double skin) { sim.SetVerletSkin(skin); })
+        .def("verlet_skin", [](const Simulation& sim) { return sim.VerletSkin(); })
+        .def(
+            "set_multi_rate_stepping",
+            [](Simulation& sim, uint32_t maxLevel, double radius, uint32_t neighborsPerLevel) {
+                sim.SetMultiRateStepping(MultiRateStepping{
+                    .maxLevel = maxLevel,
+                    .radius = radius,
+                    .neighborsPerLevel = neighborsPerLevel});
+            },
+            py::kw_only(),
+            py::arg("max_level"),
+            py::arg("radius"),
+            py::arg("neighbors_per_level"))
+        .def(
+            "set_agent_sleep",
+            [](Simulation& sim, double idleRadius, uint32_t stepsToSleep, double wakeRadius) {
+                sim.SetAgentSleep(AgentSleep{
+                    .idleRadius = idleRadius,
+                    .stepsToSleep = stepsToSleep,
+                    .wakeRadius = wakeRadius});
+            },
+            py::kw_only(),
+            py::arg("idle_radius"),
+            py::arg("steps_to_sleep"),
+            py::arg("wake_radius"))
         .def(
             "set_timer_log_level",
             [](Simulation& sim, size_t level) { sim.SetTimerLogLevel(level); })
@@ -177,5 +268,84 @@ void init_simulation(py::module_& m)
         .def(
             "get_duration",
             [](Simulation& sim, const std::string_view name) { return sim.GetTimerDuration(name); })
-        .def("get_durations", [](Simulation& sim) { return sim.GetTimerDurations(); });
+        .def("get_durations", [](Simulation& sim) { return sim.GetTimerDurations(); })
+        .def("get_counters", [](Simulation& sim) { return sim.GetTimerCounters(); })
+        .def(
+            "set_timer_iteration_sampling",
+            [](Simulation& sim, bool enabled) { sim.SetTimerIterationSampling(enabled); })
+        .def(
+            "get_iteration_durations",
+            [](Simulation& sim, const std::string_view name) {
+                const auto* entry = sim.GetTimerEntry(name);
+                const size_t count = entry != nullptr ? entry->sampleIterations().size() : 0;
+                py::array_t<uint64_t> iterations(count);
+                py::array_t<double> durations(count);
+                auto iterationsView = iterations.mutable_unchecked<1>();
+                auto durationsView = durations.mutable_unchecked<1>();
+                for(size_t index = 0; index < count; ++index) {
+                    iterationsView(index) = entry->sampleIterations()[index];
+                    durationsView(index) =
+                        static_cast<double>(entry->sampleDurationsInNanoseconds()[index]) / 1000.0;
+                }
+                return std::make_tuple(iterations, durations);
+            })
+        .def(
+            "get_iteration_statistics",
+            [](Simulation& sim) {
+                std::map<std::string, std::map<std::string, double>> result{};
+                for(const auto& [name, statistics] : sim.GetTimerIterationStatistics()) {
+                    result.emplace(
+                        name,
+                        std::map<std::string, double>{
+                            {"iterations", static_cast<double>(statistics.iterations)},
+                            {"p50", statistics.p50},
+                            {"p95", statistics.p95},
+                            {"p99", statistics.p99},
+                            {"max", statistics.max}});
+                }
+                return result;
+            })
+        .def(
+            "enable_hardware_counters",
+            [](Simulation& sim) { return sim.EnableTimerHardwareCounters(); })
+        .def(
+            "disable_hardware_counters",
+            [](Simulation& sim) { sim.DisableTimerHardwareCounters(); })
+        .def(
+            "get_hardware_counters",
+            [](const Simulation& sim) { return sim.GetTimerHardwareCounters(); })
+        .def("memory_report", [](const Simulation& sim) { return sim.MemoryReport().bytes; })
+        .def(
+            "shared_memory_report",
+            [](const Simulation& sim) { return sim.MemoryReport().sharedBytes; })
+        .def(
+            "save_checkpoint",
+            [](const Simulation& sim) {
+                const auto data = sim.SaveCheckpoint();
+                return py::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+            })
+        .def(
+            "restore_checkpoint",
+            [](Simulation& sim, const py::bytes& data) {
+                const std::string_view view = data;
+                sim.RestoreCheckpoint(
+                    {reinterpret_cast<const uint8_t*>(view.data()), view.size()});
+            })
+        .def("fork", [](const Simulation& sim) { return sim.Fork(); });
+    py::class_<BatchRunResult>(m, "BatchRunResult")
+        .def_readonly("iterations", &BatchRunResult::iterations)
+        .def_readonly("finished", &BatchRunResult::finished)
+        .def_readonly("error", &BatchRunResult::error);
+    m.def(
+        "run_batch",
+        [](const std::vector<Simulation*>& simulations, uint64_t maxIterations, size_t threads) {
+            // The simulations run without the interpreter, custom models are rejected by
+            // RunBatch and log callbacks acquire the GIL themselves.
+            py::gil_scoped_release release;
+            return RunBatch(simulations, maxIterations, threads);
+        },
+        py::arg("simulations"),
+        py::kw_only(),
+        py::arg("max_iterations"),
+        py::arg("threads") = 0);
 }
@@ -13,10 +13,11 @@ void init_social_force_model(py::module_& m)
 {
     py::class_<SocialForceModel, OperationalModel, py::smart_holder>(m, "SocialForceModel")
         .def(
-            py::init<double, double>(),
+            py::init<double, double, bool>(),
             py::kw_only(),
             py::arg("body_force") = 120000,
-            py::arg("friction") = 240000);
+            py::arg("friction") = 240000,
+            py::arg("pairwise") = false);
     const SocialForceModel::State d{};
     py::class_<SocialForceModel::State>(m, "SocialForceModelState")
         .def(
@@ -7,6 +7,10 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
 namespace py = pybind11;
 
 void init_trace(py::module_& m)
@@ -16,13 +20,55 @@ void init_trace(py::module_& m)
         .def(py::init([]() {
             return std::unique_ptr<Profiler, py::nodelete>(&Profiler::instance());
         }))
-        .def_static("enable", &Profiler::enable)
+        .def_static(
+            "enable",
+            [](uint32_t buffer_size_kb,
+               uint32_t file_write_period_ms,
+               uint32_t agent_sample_interval,
+               uint32_t agent_buckets,
+               double agent_sample_radius) {
+                Profiler::enable(
+                    {.bufferSizeKb = buffer_size_kb,
+                     .fileWritePeriodMs = file_write_period_ms,
+                     .agentSampleInterval = agent_sample_interval,
+                     .agentBuckets = agent_buckets,
+                     .agentSampleRadius = agent_sample_radius});
+            },
+            py::kw_only(),
+            py::arg("buffer_size_kb") = ProfilerConfig{}.bufferSizeKb,
+            py::arg("file_write_period_ms") = ProfilerConfig{}.fileWritePeriodMs,
+            py::arg("agent_sample_interval") = ProfilerConfig{}.agentSampleInterval,
+            py::arg("agent_buckets") = ProfilerConfig{}.agentBuckets,
+            py::arg("agent_sample_radius") = ProfilerConfig{}.agentSampleRadius)
         .def_static("disable", &Profiler::disable)
         .def_static("dump_and_reset", &Profiler::dumpAndReset)
         .def_property_readonly("is_enabled", &Profiler::isEnabled)
         // Hard-coded "main" category for trace events
         .def_static(
             "start_trace_event",
-            [](const char* name) { TRACE_EVENT_BEGIN("Python", perfetto::DynamicString{name}); })
-        .def_static("end_trace_event", [] { TRACE_EVENT_END("Python"); });
+            [](const char* name) {
+                TRACE_EVENT_BEGIN("Python", perfetto::DynamicString{name});
+                Profiler::instance().beginSlice(std::string_view{name});
+            })
+        .def_static(
+            "end_trace_event",
+            [] {
+                Profiler::instance().endSlice();
+                TRACE_EVENT_END("Python");
+            })
+        .def_static(
+            "slice_summary",
+            [](size_t top) {
+                py::list summary{};
+                for(const auto& slice : Profiler::instance().sliceSummary(top)) {
+                    py::dict entry{};
+                    entry["name"] = slice.name;
+                    entry["count"] = slice.count;
+                    entry["total_us"] = static_cast<double>(slice.totalNanoseconds) / 1000.0;
+                    entry["self_us"] = static_cast<double>(slice.selfNanoseconds) / 1000.0;
+                    summary.append(entry);
+                }
+                return summary;
+            },
+            py::arg("top"));
 }
\ No newline at end of file
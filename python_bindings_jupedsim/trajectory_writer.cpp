@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#include "AABB.hpp"
+#include "Simulation.hpp"
+#include "SqliteTrajectoryWriter.hpp"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h> // IWYU pragma: keep
+#include <pybind11/stl/filesystem.h> // IWYU pragma: keep
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace py = pybind11;
+
+void init_trajectory_writer(py::module_& m)
+{
+    py::enum_<SqliteTrajectoryWriter::Backpressure>(m, "TrajectoryWriterBackpressure")
+        .value("Block", SqliteTrajectoryWriter::Backpressure::Block)
+        .value("DropFrames", SqliteTrajectoryWriter::Backpressure::DropFrames);
+
+    // Only built with WITH_NATIVE_SQLITE_WRITER, as it needs SQLite on the build machine.
+#ifdef JPS_WITH_NATIVE_SQLITE_WRITER
+    py::class_<SqliteTrajectoryWriter>(m, "SqliteTrajectoryWriter")
+        .def(
+            py::init([](const std::filesystem::path& output_file,
+                        uint64_t every_nth_frame,
+                        size_t buffer_count,
+                        size_t commit_every_nth_write,
+                        SqliteTrajectoryWriter::Backpressure backpressure) {
+                return std::make_unique<SqliteTrajectoryWriter>(SqliteTrajectoryWriter::Options{
+                    output_file,
+                    every_nth_frame,
+                    buffer_count,
+                    commit_every_nth_write,
+                    backpressure});
+            }),
+            py::kw_only(),
+            py::arg("output_file"),
+            py::arg("every_nth_frame"),
+            py::arg("buffer_count"),
+            py::arg("commit_every_nth_write"),
+            py::arg("backpressure"))
+        .def(
+            "begin_writing",
+            [](SqliteTrajectoryWriter& w,
+               double dt,
+               const std::string& wkt,
+               int64_t geometry_hash,
+               std::tuple<double, double, double, double> bounds) {
+                const auto [xmin, ymin, xmax, ymax] = bounds;
+                AABB aabb{};
+                aabb.xmin = xmin;
+                aabb.ymin = ymin;
+                aabb.xmax = xmax;
+                aabb.ymax = ymax;
+                w.BeginWriting(dt, wkt, geometry_hash, aabb);
+            },
+            py::kw_only(),
+            py::arg("dt"),
+            py::arg("wkt"),
+            py::arg("geometry_hash"),
+            py::arg("bounds"))
+        .def(
+            "write_iteration_state",
+            [](SqliteTrajectoryWriter& w, const Simulation& sim) { w.WriteIterationState(sim); })
+        // The I/O thread never touches Python objects, release the GIL while waiting for it.
+        .def("flush", &SqliteTrajectoryWriter::Flush, py::call_guard<py::gil_scoped_release>())
+        .def("close", &SqliteTrajectoryWriter::Close, py::call_guard<py::gil_scoped_release>())
+        .def("every_nth_frame", &SqliteTrajectoryWriter::EveryNthFrame)
+        .def("dropped_frames", &SqliteTrajectoryWriter::DroppedFrames);
+#endif
+}
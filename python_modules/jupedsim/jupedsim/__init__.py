@@ -2,7 +2,14 @@
 
 import jupedsim.native as py_jps
 from jupedsim.agent import Agent
-from jupedsim.agent_view import AgentStep, AgentView, NeighborView, WallView
+from jupedsim.agent_view import (
+    AgentStep,
+    AgentView,
+    NeighborView,
+    RandomStream,
+    WallView,
+)
+from jupedsim.batch import BatchResult, GeometryBundle, run_batch
 from jupedsim.distributions import (
     AgentNumberError,
     IncorrectParameterError,
@@ -24,6 +31,7 @@ from jupedsim.internal.tracing import (
     end_trace_event,
     start_trace_event,
     trace_event,
+    trace_summary,
 )
 from jupedsim.journey import JourneyDescription, Transition
 from jupedsim.library import (
@@ -51,7 +59,11 @@ from jupedsim.models.collision_free_speed_v3 import (
     CollisionFreeSpeedModelV3,
     CollisionFreeSpeedModelV3State,
 )
-from jupedsim.models.custom_model import CustomOperationalModel
+from jupedsim.models.custom_model import (
+    AgentBatch,
+    CustomOperationalBatchModel,
+    CustomOperationalModel,
+)
 from jupedsim.models.generalized_centrifugal_force import (
     GeneralizedCentrifugalForceModel,
     GeneralizedCentrifugalForceModelState,
@@ -64,11 +76,19 @@ from jupedsim.models.warp_driver import (
     WarpDriverModel,
     WarpDriverModelState,
 )
+from jupedsim.columnar_serialization import (
+    ColumnarRecording,
+    ColumnarTrajectoryWriter,
+)
 from jupedsim.recording import Recording, RecordingAgent, RecordingFrame
 from jupedsim.routing import RoutingEngine
 from jupedsim.serialization import TrajectoryWriter
 from jupedsim.simulation import Simulation
-from jupedsim.sqlite_serialization import SqliteTrajectoryWriter
+from jupedsim.sqlite_serialization import (
+    AsyncSqliteTrajectoryWriter,
+    SqliteTrajectoryWriter,
+    TrajectoryWriterBackpressure,
+)
 
 try:
     from jupedsim.hdf5_serialization import Hdf5TrajectoryWriter
@@ -107,11 +127,14 @@ Id of the compiler used to build the native portion of this module.
 
 __all__ = [
     "Agent",
+    "AgentBatch",
     "AgentNumberError",
     "AgentStep",
     "AgentView",
     "AnticipationVelocityModel",
     "AnticipationVelocityModelState",
+    "AsyncSqliteTrajectoryWriter",
+    "BatchResult",
     "BuildInfo",
     "CollisionFreeSpeedModel",
     "CollisionFreeSpeedModelState",
@@ -119,11 +142,15 @@ __all__ = [
     "CollisionFreeSpeedModelV2State",
     "CollisionFreeSpeedModelV3",
     "CollisionFreeSpeedModelV3State",
+    "ColumnarRecording",
+    "ColumnarTrajectoryWriter",
+    "CustomOperationalBatchModel",
     "CustomOperationalModel",
     "ExitStage",
     "GeneralizedCentrifugalForceModel",
     "GeneralizedCentrifugalForceModelState",
     "Geometry",
+    "GeometryBundle",
     "Hdf5TrajectoryWriter",
     "IncorrectParameterError",
     "JourneyDescription",
@@ -132,6 +159,7 @@ __all__ = [
     "NeighborView",
     "NotifiableQueueStage",
     "OverlappingCirclesError",
+    "RandomStream",
     "Recording",
     "RecordingAgent",
     "RecordingFrame",
@@ -143,6 +171,7 @@ __all__ = [
     "SqliteTrajectoryWriter",
     "Timer",
     "TrajectoryWriter",
+    "TrajectoryWriterBackpressure",
     "Transition",
     "WaitingSetStage",
     "WaitingSetState",
@@ -164,10 +193,12 @@ __all__ = [
     "enable_tracing",
     "end_trace_event",
     "get_build_info",
+    "run_batch",
     "set_debug_callback",
     "set_error_callback",
     "set_info_callback",
     "set_warning_callback",
     "start_trace_event",
     "trace_event",
+    "trace_summary",
 ]
@@ -86,6 +86,30 @@ class WallView:
         return f"WallView(distance={self.distance}, normal={self.normal})"
 
 
+class RandomStream:
+    """Random numbers of one agent in one simulation step.
+
+    Obtained from :meth:`AgentStep.random`. The numbers only depend on the
+    seed, the agent id and the iteration, not on the order in which agents are
+    updated.
+    """
+
+    def __init__(self, obj: py_jps.RandomStream) -> None:
+        """Do not use.
+
+        Random streams are created by :meth:`AgentStep.random`.
+        """
+        self._obj = obj
+
+    def uniform(self, lower: float = 0.0, upper: float = 1.0) -> float:
+        """Uniformly distributed number in [lower, upper)."""
+        return self._obj.uniform(lower, upper)
+
+    def below(self, n: int) -> int:
+        """Uniformly distributed integer in [0, n)."""
+        return self._obj.below(n)
+
+
 class AgentView:
     """What an agent perceives of its surroundings, relative to where it stands.
 
@@ -202,3 +226,15 @@ class AgentStep(AgentView):
     def to_next_target(self) -> tuple[float, float]:
         """Vector from the agent to its next target."""
         return self._obj.to_next_target
+
+    def random(self, seed: int) -> RandomStream:
+        """Random numbers for this agent in this step.
+
+        Each call starts the same sequence again, take one stream per step and
+        draw all numbers from it.
+
+        Arguments:
+            seed: seed of the model, agents and iterations get distinct
+                streams for the same seed.
+        """
+        return RandomStream(self._obj.random(seed))
@@ -0,0 +1,199 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+
+import dataclasses
+import pathlib
+from typing import TYPE_CHECKING, Any
+
+import shapely
+
+import jupedsim.native as py_jps
+from jupedsim.geometry import Geometry
+from jupedsim.geometry_utils import build_geometry
+
+if TYPE_CHECKING:
+    from jupedsim.simulation import Simulation
+
+
+class GeometryBundle:
+    """Walkable area with its navigation mesh, built once and shared.
+
+    Every :class:`~jupedsim.Simulation` created from a geometry builds its
+    own collision geometry and navigation mesh. Simulations created from the
+    same bundle share them instead, which makes creating many simulations of
+    the same walkable area, e.g. for parameter sweeps, cheap. The bundle is
+    immutable, simulations using it may run on different threads with
+    :func:`run_batch`.
+
+    .. code :: python
+
+        bundle = jps.GeometryBundle(walkable_area)
+        simulations = [
+            jps.Simulation(model=make_model(p), geometry=bundle)
+            for p in parameters
+        ]
+
+    Building the navigation mesh of a large walkable area takes seconds. Save
+    the bundle once with :meth:`save` and load it in every run with
+    :meth:`load`, which maps the file into memory and builds nothing again.
+    """
+
+    def __init__(
+        self,
+        geometry: (
+            str
+            | shapely.GeometryCollection
+            | shapely.Polygon
+            | shapely.MultiPolygon
+            | shapely.MultiPoint
+            | list[tuple[float, float]]
+        ),
+        **kwargs: Any,
+    ) -> None:
+        """Builds the collision geometry and navigation mesh of 'geometry'.
+
+        Arguments:
+            geometry: Walkable area, accepts the same data as the geometry
+                argument of :class:`~jupedsim.Simulation`.
+
+        Keyword Arguments:
+            excluded_areas: describes exclusions
+                from the walkable area. Only use this argument if `geometry` was
+                provided as list[tuple[float, float]].
+        """
+        self._obj = py_jps.GeometryBundle(
+            build_geometry(geometry, **kwargs)._obj
+        )
+
+    def geometry(self) -> Geometry:
+        """Walkable area of this bundle.
+
+        Returns:
+            The geometry of this bundle.
+        """
+        return Geometry(self._obj.geometry())
+
+    def serialize(self) -> bytes:
+        """Encodes the bundle, restore it with :meth:`deserialize`.
+
+        Like checkpoints, the data is meant for the same JuPedSim version on
+        the same machine type, it is not an exchange format.
+
+        Returns:
+            The encoded bundle.
+        """
+        return self._obj.serialize()
+
+    @staticmethod
+    def deserialize(data: bytes) -> "GeometryBundle":
+        """Restores a bundle encoded with :meth:`serialize`.
+
+        Arguments:
+            data: Encoded bundle
+
+        Returns:
+            The restored bundle.
+
+        Raises:
+            RuntimeError: if the data was written by another JuPedSim version
+                or on a machine with another byte order, or is corrupt.
+        """
+        return GeometryBundle._from_native(
+            py_jps.GeometryBundle.deserialize(data)
+        )
+
+    def save(self, file: str | pathlib.Path) -> None:
+        """Writes the encoded bundle to a file, load it with :meth:`load`.
+
+        Arguments:
+            file: File to write to, it is overwritten if it exists.
+        """
+        self._obj.save(pathlib.Path(file))
+
+    @staticmethod
+    def load(file: str | pathlib.Path) -> "GeometryBundle":
+        """Loads a bundle written with :meth:`save`.
+
+        Arguments:
+            file: File to load from
+
+        Returns:
+            The loaded bundle.
+        """
+        return GeometryBundle._from_native(
+            py_jps.GeometryBundle.load(pathlib.Path(file))
+        )
+
+    @staticmethod
+    def _from_native(obj: py_jps.GeometryBundle) -> "GeometryBundle":
+        bundle = GeometryBundle.__new__(GeometryBundle)
+        bundle._obj = obj
+        return bundle
+
+
+@dataclasses.dataclass(frozen=True)
+class BatchResult:
+    """Outcome of one simulation run by :func:`run_batch`.
+
+    Attributes:
+        iterations: Iterations the simulation was advanced by.
+        finished: True if all agents left the simulation before
+            `max_iterations` was reached.
+        error: Message of the error that stopped the simulation, None if it
+            ran without error.
+    """
+
+    iterations: int
+    finished: bool
+    error: str | None
+
+
+def run_batch(
+    simulations: "list[Simulation]",
+    *,
+    max_iterations: int,
+    threads: int = 0,
+) -> list[BatchResult]:
+    """Runs independent simulations in parallel on native threads.
+
+    Every simulation is iterated until it has no agents left or it was
+    advanced by `max_iterations`. The simulations run without holding the
+    GIL, so all cores are used without multiprocessing. Share the walkable
+    area between them with a :class:`~jupedsim.GeometryBundle`.
+
+    .. note::
+
+        Simulations with a trajectory writer or a
+        :class:`~jupedsim.CustomOperationalModel` cannot run in a batch, as
+        both would need the GIL in every iteration.
+
+    Arguments:
+        simulations: Simulations to run, each may appear only once.
+        max_iterations: Maximum number of iterations per simulation.
+        threads: Number of threads to use, 0 uses one thread per core.
+
+    Returns:
+        The outcome of every simulation, in the order of `simulations`. An
+        error in one simulation stops only this simulation.
+
+    Raises:
+        SimulationError: if a simulation has a trajectory writer.
+    """
+    for index, simulation in enumerate(simulations):
+        if simulation._writer is not None:
+            raise py_jps.SimulationError(
+                f"Simulation {index} has a trajectory writer, which cannot "
+                "run in a batch"
+            )
+    results = py_jps.run_batch(
+        [simulation._obj for simulation in simulations],
+        max_iterations=max_iterations,
+        threads=threads,
+    )
+    return [
+        BatchResult(
+            iterations=result.iterations,
+            finished=result.finished,
+            error=result.error or None,
+        )
+        for result in results
+    ]
@@ -0,0 +1,179 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""Compressed, columnar trajectory format.
+
+Trajectories are stored in chunks of frames. Ids are delta encoded, positions
+are quantised and stored as differences to the previous frame. A per-frame
+index of file offsets and simulation iterations allows random access, the
+reader memory maps the file and only decodes the chunk containing the
+requested frame.
+"""
+
+from pathlib import Path
+
+import shapely
+from shapely import from_wkt
+
+import jupedsim.native as py_jps
+from jupedsim.internal.aabb import AABB
+from jupedsim.recording import RecordingAgent, RecordingFrame
+from jupedsim.serialization import TrajectoryWriter
+from jupedsim.simulation import Simulation
+
+
+class ColumnarTrajectoryWriter(TrajectoryWriter):
+    """Write trajectory data into a compressed columnar file.
+
+    Use :class:`ColumnarRecording` to read the output.
+    """
+
+    def __init__(
+        self,
+        *,
+        output_file: Path,
+        every_nth_frame: int = 4,
+        frames_per_chunk: int = 32,
+        quantisation: float = 1e-4,
+    ) -> None:
+        """ColumnarTrajectoryWriter constructor
+
+        Args:
+            output_file : pathlib.Path
+                name of the output file.
+            every_nth_frame: int
+                indicates interval between writes, 1 means every frame, 5 every 5th
+            frames_per_chunk: int
+                number of frames between two frames stored with absolute
+                positions. Reading a frame decodes at most this many frames.
+            quantisation: float
+                positions are rounded to multiples of this value (in m).
+        """
+        if every_nth_frame < 1:
+            raise TrajectoryWriter.Exception("'every_nth_frame' has to be > 0")
+        if frames_per_chunk < 1:
+            raise TrajectoryWriter.Exception("'frames_per_chunk' has to be > 0")
+        if quantisation <= 0:
+            raise TrajectoryWriter.Exception("'quantisation' has to be > 0")
+        self._obj = py_jps.ColumnarTrajectoryWriter(
+            output_file=Path(output_file),
+            every_nth_frame=every_nth_frame,
+            frames_per_chunk=frames_per_chunk,
+            quantisation=quantisation,
+        )
+
+    def begin_writing(self, simulation: Simulation) -> None:
+        """Write the file header."""
+        geo = simulation.get_geometry().as_wkt()
+        self._obj.begin_writing(
+            dt=simulation.delta_time(),
+            wkt=geo,
+            geometry_hash=hash(geo),
+            bounds=from_wkt(geo).bounds,
+        )
+
+    def write_iteration_state(self, simulation: Simulation) -> None:
+        """Encode the agent positions of this iteration."""
+        self._obj.write_iteration_state(simulation._obj)
+
+    def close(self) -> None:
+        """Write the frame index. Call at simulation end."""
+        self._obj.close()
+
+    def every_nth_frame(self) -> int:
+        return self._obj.every_nth_frame()
+
+
+class ColumnarRecording:
+    """Provides access to a recording written by :class:`ColumnarTrajectoryWriter`.
+
+    Offers the same interface as :class:`~jupedsim.Recording`. The file is
+    memory mapped, memory use and access time per frame do not depend on the
+    length of the recording.
+    """
+
+    def __init__(self, file: str | Path) -> None:
+        self._obj = py_jps.ColumnarTrajectoryReader(Path(file))
+
+    def frame(self, index: int) -> RecordingFrame:
+        """Access a single frame of the recording.
+
+        Arguments:
+            index (int): index of the frame to access.
+
+        Returns:
+            A single frame.
+
+        """
+        ids, xs, ys = self._obj.frame(index)
+        return RecordingFrame(
+            index,
+            [
+                RecordingAgent(agent_id, (x, y))
+                for agent_id, x, y in zip(ids, xs, ys, strict=True)
+            ],
+        )
+
+    def iteration(self, index: int) -> int:
+        """Simulation iteration a frame was written at.
+
+        Frames are numbered consecutively, with ``every_nth_frame > 1`` the
+        frame index and the iteration differ.
+
+        Arguments:
+            index (int): index of the frame.
+
+        Returns:
+            Iteration of the simulation when the frame was written.
+
+        """
+        return self._obj.iteration(index)
+
+    def frame_at_iteration(self, iteration: int) -> RecordingFrame:
+        """Access the frame written at a simulation iteration.
+
+        Arguments:
+            iteration (int): iteration of the simulation.
+
+        Returns:
+            The frame written at this iteration.
+
+        Raises:
+            SimulationError: if no frame was written at this iteration.
+
+        """
+        return self.frame(self._obj.frame_index_of_iteration(iteration))
+
+    def geometry(self) -> shapely.GeometryCollection:
+        """Access this recordings' geometry.
+
+        Returns:
+            walkable area of the simulation that created this recording.
+
+        """
+        return shapely.union_all([from_wkt(self._obj.geometry_wkt())])
+
+    def geometry_id_for_frame(self, frame_id) -> int:
+        return self._obj.geometry_hash()
+
+    def bounds(self) -> AABB:
+        xmin, xmax, ymin, ymax = self._obj.bounds()
+        return AABB(xmin=xmin, xmax=xmax, ymin=ymin, ymax=ymax)
+
+    @property
+    def num_frames(self) -> int:
+        """Access the number of frames stored in this recording.
+
+        Returns:
+            Number of frames in this recording.
+
+        """
+        return self._obj.frame_count()
+
+    @property
+    def fps(self) -> float:
+        """How many frames are stored per second.
+
+        Returns:
+            Frames per second of this recording.
+
+        """
+        return self._obj.fps()
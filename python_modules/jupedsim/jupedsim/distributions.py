@@ -1,8 +1,10 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
+import secrets
+
 import numpy as np
 import shapely
 
-from jupedsim.internal.grid import Grid
+import jupedsim.native as py_jps
 
 
 class AgentNumberError(Exception):
@@ -35,36 +37,25 @@ def __intersecting_area_polygon_circle(mid_point, radius, polygon):
     return polygon.intersection(circle).area
 
 
-def __is_inside_circle(point, mid, min_r, max_r):
-    """checks if a point is inside a Circle segment reaching from minimum radius to maximum radius"""
-    dif_x = point[0] - mid[0]
-    dif_y = point[1] - mid[1]
-    circle_equation = dif_x**2 + dif_y**2
-    return min_r**2 <= circle_equation <= max_r**2
-
+def __create_sampler(polygon, distance_to_agents, distance_to_polygon, seed):
+    """returns a native sampler for the polygon, rings are passed unclosed"""
 
-def __get_bounding_box(polygon):
-    """returns an Axis Aligned Bounding Box containing the minimal/maximal x and y values
-    formatted like : [(min(x_values), min(y_values)), (max(x_values), max(y_values))]
-    polygon needs to be a shapely polygon
-    """
-    corner_points = list(polygon.exterior.coords)
-    x_values, y_values = [], []
-    for point in corner_points:
-        x_values.append(point[0])
-        y_values.append(point[1])
+    def ring(linear_ring):
+        return shapely.get_coordinates(linear_ring)[:-1].tolist()
 
-    return [(min(x_values), min(y_values)), ((max(x_values)), max(y_values))]
+    if seed is None:
+        seed = secrets.randbits(64)
+    return py_jps.PoissonDiskSampler(
+        boundary=ring(polygon.exterior),
+        holes=[ring(hole) for hole in polygon.interiors],
+        distance_to_agents=distance_to_agents,
+        distance_to_polygon=distance_to_polygon,
+        seed=seed,
+    )
 
 
-def __min_distance_to_polygon(pt, polygon):
-    """returns the minimal distance between a point and every line segment of a polygon"""
-    pt = shapely.Point(pt)
-    min_dist = polygon.exterior.distance(pt)
-    for hole in polygon.interiors:
-        candidate_dist = hole.distance(pt)
-        min_dist = min(min_dist, candidate_dist)
-    return min_dist
+def __samples_as_tuples(sampler):
+    return [(x, y) for x, y in sampler.samples().tolist()]
 
 
 def distribute_by_number(
@@ -108,35 +99,20 @@ def distribute_by_number(
         raise IncorrectParameterError(
             "Polygon is expected to be a shapely Polygon"
         )
-    box = __get_bounding_box(polygon)
-
-    np.random.seed(seed)
-
-    grid = Grid(box, distance_to_agents)
-    created_points = 0
-    iterations = 0
-    while created_points < number_of_agents:
-        if iterations > max_iterations:
-            msg = (
-                f"Only {created_points} of {number_of_agents}  could be placed."
-                f" density: {round(created_points / polygon.area, 2)} p/m²"
-            )
-            raise AgentNumberError(msg)
-        temp_point = (
-            np.random.uniform(box[0][0], box[1][0]),
-            np.random.uniform(box[0][1], box[1][1]),
+    sampler = __create_sampler(
+        polygon, distance_to_agents, distance_to_polygon, seed
+    )
+    created_points = sampler.add_random(
+        count=number_of_agents, max_failures=max_iterations
+    )
+    if created_points < number_of_agents:
+        msg = (
+            f"Only {created_points} of {number_of_agents}  could be placed."
+            f" density: {round(created_points / polygon.area, 2)} p/m²"
         )
-        if __check_distance_constraints(
-            temp_point, distance_to_polygon, grid, polygon
-        ):
-            grid.append_point(temp_point)
-
-            iterations = 0
-            created_points += 1
-        else:
-            iterations += 1
+        raise AgentNumberError(msg)
 
-    return grid.get_samples()
+    return __samples_as_tuples(sampler)
 
 
 def distribute_by_density(
@@ -296,93 +272,33 @@ def distribute_in_circles_by_number(
         circle_segment_radii=circle_segment_radii,
         fill_parameters=numbers_of_agents,
     )
-    np.random.seed(seed)
-    box = __get_bounding_box(polygon)
-    grid = Grid(box, distance_to_agents)
+    sampler = __create_sampler(
+        polygon, distance_to_agents, distance_to_polygon, seed
+    )
 
     for circle_segment, number in zip(circle_segment_radii, numbers_of_agents):
-        outer_radius = circle_segment[1]
-        inner_radius = circle_segment[0]
-        big_circle_area = __intersecting_area_polygon_circle(
-            center_point, outer_radius, polygon
-        )
-        small_circle_area = __intersecting_area_polygon_circle(
-            center_point, inner_radius, polygon
+        inner_radius, outer_radius = circle_segment
+        placed_count = sampler.add_random_in_ring(
+            center=center_point,
+            inner_radius=inner_radius,
+            outer_radius=outer_radius,
+            count=number,
+            max_failures=max_iterations,
         )
-        placeable_area = big_circle_area - small_circle_area
-
-        # checking whether to place points
-        # inside the circle segment or
-        # inside the bounding box of the intersection of polygon and Circle Segment
-
-        # determine the entire area of the circle segment
-        entire_circle_area = np.pi * (outer_radius**2 - inner_radius**2)
-        # determine the area where a point might be placed around the polygon
-        sec_box = __box_of_intersection(polygon, center_point, outer_radius)
-        dif_x, dif_y = (
-            sec_box[1][0] - sec_box[0][0],
-            sec_box[1][1] - sec_box[0][1],
-        )
-        bounding_box_area = dif_x * dif_y
-
-        if entire_circle_area < bounding_box_area:
-            # inside the circle it is more likely to find a random point that is inside the polygon
-            for placed_count in range(number):
-                i = 0
-                while i < max_iterations:
-                    i += 1
-                    # determines a random radius within the circle segment
-                    rho = np.sqrt(
-                        np.random.uniform(inner_radius**2, outer_radius**2)
-                    )
-                    # determines a random degree
-                    theta = np.random.uniform(0, 2 * np.pi)
-                    pt = (
-                        center_point[0] + rho * np.cos(theta),
-                        center_point[1] + rho * np.sin(theta),
-                    )
-                    if __check_distance_constraints(
-                        pt, distance_to_polygon, grid, polygon
-                    ):
-                        grid.append_point(pt)
-                        break
-
-                if i >= max_iterations and placed_count != number:
-                    message = (
-                        f"the desired amount of agents in the Circle segment from"
-                        f" {inner_radius} to {outer_radius} could not be achieved."
-                        f"\nOnly {placed_count} of {number}  could be placed."
-                        f"\nactual density: {round(placed_count / placeable_area, 2)} p/m²"
-                    )
-                    raise AgentNumberError(message)
-        else:
-            # placing point inside the bounding box is more likely to find a random point that is inside the circle
-            placed_count = 0
-            iterations = 0
-            while placed_count < number:
-                if iterations > max_iterations:
-                    message = (
-                        f"the desired amount of agents in the Circle segment from"
-                        f" {inner_radius} to {outer_radius} could not be achieved."
-                        f"\nOnly {placed_count} of {number}  could be placed."
-                        f"\nactual density: {round(placed_count / placeable_area, 2)} p/m²"
-                    )
-                    raise AgentNumberError(message)
-                temp_point = (
-                    np.random.uniform(sec_box[0][0], sec_box[1][0]),
-                    np.random.uniform(sec_box[0][1], sec_box[1][1]),
-                )
-                if __is_inside_circle(
-                    temp_point, center_point, inner_radius, outer_radius
-                ) and __check_distance_constraints(
-                    temp_point, distance_to_polygon, grid, polygon
-                ):
-                    grid.append_point(temp_point)
-                    iterations = 0
-                    placed_count += 1
-                else:
-                    iterations += 1
-    return grid.get_samples()
+        if placed_count < number:
+            placeable_area = __intersecting_area_polygon_circle(
+                center_point, outer_radius, polygon
+            ) - __intersecting_area_polygon_circle(
+                center_point, inner_radius, polygon
+            )
+            message = (
+                f"the desired amount of agents in the Circle segment from"
+                f" {inner_radius} to {outer_radius} could not be achieved."
+                f"\nOnly {placed_count} of {number}  could be placed."
+                f"\nactual density: {round(placed_count / placeable_area, 2)} p/m²"
+            )
+            raise AgentNumberError(message)
+    return __samples_as_tuples(sampler)
 
 
 def distribute_in_circles_by_density(
@@ -501,100 +417,16 @@ def distribute_until_filled(
         raise IncorrectParameterError(
             "Polygon is expected to be a shapely Polygon"
         )
-    rng = np.random.default_rng(seed)
-    # Shrinking the polygon up front turns the "distance to boundary" constraint
-    # into a plain point-in-polygon test for all subsequent samples.
-    polygon_buffered = polygon.buffer(-distance_to_polygon)
-    if polygon_buffered.is_empty:
-        raise IncorrectParameterError(
-            "distance_to_polygon is too large for this polygon."
-        )
-
-    # One sample per cell is sufficient with this cell size, so distance checks
-    # only need to inspect a fixed neighbourhood around the candidate cell.
-    cell_size = distance_to_agents / np.sqrt(2.0)
-    xmin, ymin, xmax, ymax = polygon_buffered.bounds
-    grid = {}
-
-    def _cell_index(point):
-        i = int((point[0] - xmin) / cell_size)
-        j = int((point[1] - ymin) / cell_size)
-        return (i, j)
-
-    initial_sample = None
-    batch_size = 1000
-    attempts = max(1, max_iterations // batch_size)
-    for _ in range(attempts):
-        x = rng.uniform(xmin, xmax, size=batch_size)
-        y = rng.uniform(ymin, ymax, size=batch_size)
-        # Vectorized checking avoids spending max_iterations scalar shapely calls
-        # just to find the first valid point.
-        inside = shapely.contains_xy(polygon_buffered, x, y)
-        valid = np.column_stack((x[inside], y[inside]))
-        if len(valid) > 0:
-            initial_sample = (valid[0][0], valid[0][1])
-            break
-
-    if initial_sample is None:
+    sampler = __create_sampler(
+        polygon, distance_to_agents, distance_to_polygon, seed
+    )
+    if not sampler.fill(k=k, max_iterations=max_iterations):
         raise IncorrectParameterError(
             "The first point could not be placed inside the polygon."
             " Check if there is enough space for agents provided inside the polygon"
         )
 
-    samples = [initial_sample]
-    active_list = [0]
-    grid[_cell_index(initial_sample)] = initial_sample
-
-    r2_min = distance_to_agents**2
-    r2_max = (2 * distance_to_agents) ** 2
-
-    while active_list:
-        idx = rng.integers(0, len(active_list))
-        ref_pt = samples[active_list[idx]]
-        found = False
-
-        for _ in range(k):
-            radius = np.sqrt(rng.uniform(r2_min, r2_max))
-            theta = rng.uniform(0, 2 * np.pi)
-            pt = (
-                ref_pt[0] + radius * np.cos(theta),
-                ref_pt[1] + radius * np.sin(theta),
-            )
-
-            if not (xmin <= pt[0] <= xmax and ymin <= pt[1] <= ymax):
-                continue
-            if not polygon_buffered.contains(shapely.Point(pt)):
-                continue
-
-            i_cell, j_cell = _cell_index(pt)
-            conflict = False
-            for di in range(-2, 3):
-                for dj in range(-2, 3):
-                    neighbour = grid.get((i_cell + di, j_cell + dj))
-                    if neighbour is not None:
-                        dx = neighbour[0] - pt[0]
-                        dy = neighbour[1] - pt[1]
-                        if dx * dx + dy * dy < r2_min:
-                            conflict = True
-                            break
-                if conflict:
-                    break
-            if conflict:
-                continue
-
-            samples.append(pt)
-            active_list.append(len(samples) - 1)
-            grid[(i_cell, j_cell)] = pt
-            found = True
-            break
-
-        if not found:
-            # Remove inactive samples in O(1): order is irrelevant because active
-            # points are selected uniformly by index.
-            active_list[idx] = active_list[-1]
-            active_list.pop()
-
-    return samples
+    return __samples_as_tuples(sampler)
 
 
 def distribute_by_percentage(
@@ -649,38 +481,6 @@ def distribute_by_percentage(
     )
     sample_amount = len(samples)
     needed_amount = round(sample_amount * (percent / 100))
-    np.random.seed(seed)
-    np.random.shuffle(samples)
+    np.random.default_rng(seed).shuffle(samples)
 
     return samples[:needed_amount]
-
-
-def __check_distance_constraints(pt, wall_distance, grid, polygon):
-    """Determines if a point has enough distance to other points and to the walls
-     Uses a Grid to determine neighbours
-    :param grid: the grid of the polygon
-    :param pt: point that is being checked
-    :param wall_distance: minimal distance between point and the polygon
-    :param polygon: shapely Polygon in which the points must lie
-    :return:True or False"""
-    if not polygon.contains(shapely.Point(pt)):
-        return False
-    if __min_distance_to_polygon(pt, polygon) < wall_distance:
-        return False
-    return grid.no_neighbours_in_distance(pt)
-
-
-def __box_of_intersection(polygon, center_point, outer_radius):
-    """returns an Axis Aligned Bounding Box containing the intersection of a Circle and the polygon
-     @:param polygon is a shapely Polygon
-     @:param center_point is the Center point of the Circle
-    @:param outer_radius is the radius of the Circle
-    @:return bounding box formatted like [(min(x_values), min(y_values)), (max(x_values), max(y_values))]
-    """
-    # creates a point
-    point = shapely.Point(center_point)
-    # creates a layer with the size of the radius all around this point
-    circle = point.buffer(outer_radius)
-    # returns the size of the intersecting area
-    shapely_bounds = polygon.intersection(circle).bounds
-    return [shapely_bounds[:2], shapely_bounds[2:]]
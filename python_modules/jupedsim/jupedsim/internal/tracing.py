@@ -3,6 +3,9 @@
 import functools
 from contextlib import contextmanager
 
+import numpy as np
+import numpy.typing as npt
+
 import jupedsim.native as py_jps
 
 
@@ -49,6 +52,113 @@ class Timer:
         """
         return self._obj.get_duration(key)
 
+    @property
+    def durations_us(self) -> dict[str, int]:
+        """
+        Returns:
+            Accumulated time in microseconds of every timer that ran.
+        """
+        return self._obj.get_durations()
+
+    @property
+    def counters(self) -> dict[str, int]:
+        """
+        Returns:
+            Counters of the simulation next to the timings, e.g. the number
+            of sleeping agents.
+        """
+        return self._obj.get_counters()
+
+    def enable_iteration_sampling(self) -> None:
+        """
+        Records the duration of every timer per iteration from now on, see
+        :meth:`iteration_durations_us`. Off by default, as the samples take
+        memory in proportion to the number of iterations.
+        """
+        self._obj.set_timer_iteration_sampling(True)
+
+    def disable_iteration_sampling(self) -> None:
+        """Stops recording per iteration durations, recorded ones are kept."""
+        self._obj.set_timer_iteration_sampling(False)
+
+    def iteration_durations_us(
+        self, key: str
+    ) -> tuple[npt.NDArray[np.uint64], npt.NDArray[np.float64]]:
+        """
+        Per iteration durations of a timer, to find the iterations that took
+        long, e.g. because of mass removals or many rerouted agents. Only
+        iterations run while :meth:`enable_iteration_sampling` was on are
+        recorded.
+
+        Args:
+            key: Name of the timer, e.g. "Operational Decision System".
+
+        Returns:
+            The iterations the timer ran in and the time in microseconds
+            spent in it during each of them. Time measured between two
+            iterations counts towards the iteration before.
+        """
+        return self._obj.get_iteration_durations(key)
+
+    @property
+    def iteration_statistics(self) -> dict[str, dict[str, float]]:
+        """
+        Returns:
+            Per timer the number of iterations it ran in and the p50, p95,
+            p99 and max of its per iteration durations in microseconds.
+        """
+        return self._obj.get_iteration_statistics()
+
+    def iteration_histogram(
+        self, key: str, bins: int = 50
+    ) -> tuple[npt.NDArray[np.int64], npt.NDArray[np.float64]]:
+        """
+        Histogram of the per iteration durations of a timer.
+
+        Args:
+            key: Name of the timer.
+            bins: Number of bins.
+
+        Returns:
+            Counts per bin and the bin edges in microseconds, as returned by
+            numpy.histogram.
+        """
+        _, durations = self.iteration_durations_us(key)
+        return np.histogram(durations, bins=bins)
+
+    def enable_hardware_counters(self) -> bool:
+        """
+        Reads hardware performance counters (cycles, instructions, last level
+        cache misses and branch misses) around every timer from now on. They
+        are reported per timer in :attr:`hardware_counters` and as Perfetto
+        counter tracks while tracing is enabled.
+
+        Hardware counters are only available on Linux and only if the kernel
+        allows it, see /proc/sys/kernel/perf_event_paranoid. They count the
+        calling thread only, simulations iterated on other threads, e.g. by
+        :func:`~jupedsim.run_batch`, record none.
+
+        Returns:
+            Whether the hardware counters could be enabled.
+        """
+        return self._obj.enable_hardware_counters()
+
+    def disable_hardware_counters(self) -> None:
+        """Stops reading hardware performance counters around timers."""
+        self._obj.disable_hardware_counters()
+
+    @property
+    def hardware_counters(self) -> dict[str, dict[str, int]]:
+        """
+        Returns:
+            Per timer the sum of the hardware counters over the time it ran
+            while they were enabled, e.g. ``{"Neighborhood Search":
+            {"cycles": ..., "instructions": ..., "llc_misses": ...,
+            "branch_misses": ...}}``. Counters the hardware does not provide
+            are left out.
+        """
+        return self._obj.get_hardware_counters()
+
     def push_timer(self, name: str, probe_log_level: int = 0) -> None:
         """
         Pushes a timer with the given name. The timer will be stopped when the corresponding pop_timer is called.
@@ -142,9 +252,36 @@ def is_tracing_enabled() -> bool:
     return py_jps.Profiler().is_enabled
 
 
-def enable_tracing() -> None:
-    """Enable the profiler."""
-    py_jps.Profiler().enable()
+def enable_tracing(
+    *,
+    buffer_size_kb: int = 8192,
+    file_write_period_ms: int = 100,
+    agent_sample_interval: int = 0,
+    agent_buckets: int = 16,
+    agent_sample_radius: float = 2.0,
+) -> None:
+    """Enable the profiler.
+
+    Args:
+        buffer_size_kb: Size of the in-memory ring buffer of the trace.
+        file_write_period_ms: How often the ring buffer is written to the
+            trace file. Lower values reduce memory pressure, higher values
+            reduce I/O.
+        agent_sample_interval: Every ``agent_sample_interval`` iterations
+            the mean number of neighbors and walls within
+            ``agent_sample_radius`` of the agents is recorded as counter
+            tracks, one per bucket of agents. 0 disables the samples.
+        agent_buckets: Number of buckets agents are grouped into by id for
+            the agent samples.
+        agent_sample_radius: Radius of the agent samples in meters.
+    """
+    py_jps.Profiler().enable(
+        buffer_size_kb=buffer_size_kb,
+        file_write_period_ms=file_write_period_ms,
+        agent_sample_interval=agent_sample_interval,
+        agent_buckets=agent_buckets,
+        agent_sample_radius=agent_sample_radius,
+    )
 
 
 def disable_tracing() -> None:
@@ -152,6 +289,24 @@ def disable_tracing() -> None:
     py_jps.Profiler().disable()
 
 
+def trace_summary(top: int = 10) -> list[dict[str, float | int | str]]:
+    """Summary of the trace events of the current or last tracing session.
+
+    The summary is kept after :func:`dump_traces` until tracing is enabled
+    again, so that e.g. CI jobs can check it without opening the trace.
+
+    Args:
+        top: Maximum number of events to return.
+
+    Returns:
+        Per event name the number of events ("count") and the time spent in
+        them in microseconds, in total ("total_us") and without the events
+        nested into them on the same thread ("self_us"), sorted by self time
+        in descending order.
+    """
+    return py_jps.Profiler().slice_summary(top)
+
+
 def start_trace_event(name: str) -> None:
     """Starts a named trace event."""
     py_jps.Profiler().start_trace_event(name)
@@ -30,7 +30,12 @@ is passed to the simulation:
 :class:`CollisionFreeSpeedModel` exposes the model-level parameters as
 keyword-only constructor arguments with sensible defaults:
 ``strength_neighbor_repulsion``, ``range_neighbor_repulsion``,
-``strength_geometry_repulsion`` and ``range_geometry_repulsion``.
+``strength_geometry_repulsion``, ``range_geometry_repulsion`` and
+``pairwise``. With ``pairwise=True`` the repulsion between two agents is
+evaluated once per pair and step instead of once from each side, and the
+neighbors for the spacing come from the same pass instead of a query per
+agent. The result only differs by the order in which the repulsions on an
+agent are summed.
 
 :class:`CollisionFreeSpeedModelState` exposes the complete per-agent state of
 the model as keyword-only constructor arguments with sensible defaults:
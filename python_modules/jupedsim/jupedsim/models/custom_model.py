@@ -2,8 +2,13 @@
 from __future__ import annotations
 
 from abc import ABC, abstractmethod
+from collections.abc import Sequence
+from dataclasses import dataclass
 from typing import TYPE_CHECKING, Any
 
+import numpy as np
+import numpy.typing as npt
+
 if TYPE_CHECKING:
     from jupedsim.agent_view import AgentStep, AgentView
 
@@ -108,3 +113,109 @@ class CustomOperationalModel(ABC):
             self.check_model_constraint(state, wrapper)
         finally:
             wrapper._obj = None
+
+
+@dataclass(frozen=True)
+class AgentBatch:
+    """All agents of one step, as passed to
+    :meth:`CustomOperationalBatchModel.compute_next_states`.
+
+    Agents are identified by their row in the arrays. Unlike
+    :class:`~jupedsim.AgentStep` positions are absolute. Neighbors and walls
+    are packed per agent: the neighbors of agent ``i`` are
+    ``neighbors[neighbor_offsets[i]:neighbor_offsets[i + 1]]``, see
+    :meth:`neighbors_of` and :meth:`walls_of`. Both are only filled for agents
+    that step.
+
+    The arrays are only valid for the duration of the call, do not store
+    them.
+    """
+
+    ids: npt.NDArray[np.uint64]
+    """Agent ids, shape (n,)."""
+    positions: npt.NDArray[np.float64]
+    """Agent positions, shape (n, 2)."""
+    targets: npt.NDArray[np.float64]
+    """Next target of each agent, shape (n, 2)."""
+    stepping: npt.NDArray[np.bool_]
+    """Whether an agent steps, shape (n,). Agents that do not step, e.g.
+    sleeping ones, are only part of the batch as neighbors of others. Their
+    movements and states are ignored."""
+    dt: float
+    """Duration of the step in seconds."""
+    states: list[Any]
+    """Current model state of each agent."""
+    neighbor_offsets: npt.NDArray[np.int64]
+    """Offsets into :attr:`neighbors`, shape (n + 1,)."""
+    neighbors: npt.NDArray[np.int64]
+    """Rows of the agents within
+    :attr:`CustomOperationalBatchModel.neighbor_radius` that are in sight."""
+    wall_offsets: npt.NDArray[np.int64]
+    """Offsets into :attr:`walls`, shape (n + 1,)."""
+    walls: npt.NDArray[np.float64]
+    """Walls near the agents as rows (x1, y1, x2, y2), shape (m, 4)."""
+
+    def neighbors_of(self, index: int) -> npt.NDArray[np.int64]:
+        """Rows of the neighbors in sight of the agent in row *index*."""
+        return self.neighbors[
+            self.neighbor_offsets[index] : self.neighbor_offsets[index + 1]
+        ]
+
+    def walls_of(self, index: int) -> npt.NDArray[np.float64]:
+        """Walls near the agent in row *index*, shape (k, 4)."""
+        return self.walls[
+            self.wall_offsets[index] : self.wall_offsets[index + 1]
+        ]
+
+
+class CustomOperationalBatchModel(CustomOperationalModel):
+    """Base class for operational models implemented in Python that advance
+    all agents at once.
+
+    :meth:`compute_next_states` is called once per step with all agents as
+    numpy arrays, instead of once per agent as
+    :meth:`CustomOperationalModel.compute_next_state` is. This keeps the cost
+    of crossing into Python independent of the number of agents and allows to
+    compute the step with vectorized numpy code.
+
+    The rules for states of :class:`CustomOperationalModel` apply: never
+    mutate a state in place, return new state objects instead.
+
+    Batch models do not support multi-rate stepping.
+    """
+
+    neighbor_radius: float = 2.0
+    """Radius in m in which neighbors are collected for each agent, 0 skips
+    the neighbor search."""
+
+    @abstractmethod
+    def compute_next_states(
+        self,
+        batch: AgentBatch,
+    ) -> tuple[Sequence[Any] | None, npt.ArrayLike]:
+        """Compute one update for all agents.
+
+        Args:
+            batch: All agents of this step.
+
+        Returns:
+            A pair ``(new_states, movements)``. ``new_states`` holds one entry
+            per agent, a new state object or ``None`` to keep the current
+            state; ``None`` instead of a sequence keeps all states.
+            ``movements`` is an array of shape (n, 2) with the offset each
+            agent wants to move by.
+        """
+
+    def compute_next_state(
+        self,
+        state: Any,
+        step: "AgentStep",
+    ) -> tuple[Any, tuple[float, float]]:
+        raise NotImplementedError(
+            "Batch models are advanced through compute_next_states()"
+        )
+
+    def _compute_next_states(
+        self, **arrays
+    ) -> tuple[Sequence[Any] | None, npt.ArrayLike]:
+        return self.compute_next_states(AgentBatch(**arrays))
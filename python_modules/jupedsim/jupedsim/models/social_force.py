@@ -28,8 +28,11 @@ the model instance, which is passed to the simulation:
     not be reused afterwards.
 
 :class:`SocialForceModel` exposes the model-level parameters as keyword-only
-constructor arguments with sensible defaults: ``body_force`` (k) and
-``friction`` (kappa).
+constructor arguments with sensible defaults: ``body_force`` (k),
+``friction`` (kappa) and ``pairwise``. With ``pairwise=True`` the force
+between two agents is evaluated once per pair and step instead of once from
+each side. The result only differs by the order in which the forces on an
+agent are summed.
 
 :class:`SocialForceModelState` exposes the complete per-agent state of the
 model as keyword-only constructor arguments with sensible defaults:
@@ -5,8 +5,8 @@ Based on Wolinski, Lin, and Pettré (2016) -- probabilistic collision
 avoidance using warped intrinsic fields.
 
 The model-level parameters (the precomputed intrinsic collision-probability
-field controlled by ``sigma``, the sampling and look-ahead parameters and a
-random number generator seeded by ``rng_seed``) are carried by the model
+field controlled by ``sigma``, the sampling and look-ahead parameters and the
+seed ``rng_seed`` of the per agent random numbers) are carried by the model
 instance, which is passed to the simulation:
 
 .. code:: python
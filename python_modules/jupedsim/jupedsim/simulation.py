@@ -1,11 +1,15 @@
 # SPDX-License-Identifier: LGPL-3.0-or-later
 
-from typing import Any, Iterator
+import copy
+from typing import Any, Iterator, Sequence
 
+import numpy as np
+import numpy.typing as npt
 import shapely
 
 import jupedsim.native as py_jps
 from jupedsim.agent import Agent
+from jupedsim.batch import GeometryBundle
 from jupedsim.geometry import Geometry
 from jupedsim.geometry_utils import build_geometry
 from jupedsim.internal.tracing import Timer
@@ -88,10 +92,12 @@ class Simulation:
             | shapely.MultiPolygon
             | shapely.MultiPoint
             | list[tuple[float, float]]
+            | GeometryBundle
         ),
         dt: float = 0.01,
         trajectory_writer: TrajectoryWriter | None = None,
         timer_log_level: int = 1,
+        verlet_skin: float = 0.0,
         **kwargs: Any,
     ) -> None:
         """Creates a Simulation.
@@ -104,7 +110,9 @@ class Simulation:
                 :class:`~jupedsim.CollisionFreeSpeedModel` or
                 :class:`~jupedsim.SocialForceModel`. Custom Python models are
                 passed as instances of a
-                :class:`~jupedsim.CustomOperationalModel` subclass.
+                :class:`~jupedsim.CustomOperationalModel` subclass, or of a
+                :class:`~jupedsim.CustomOperationalBatchModel` subclass to
+                advance all agents in one call per step.
 
                 .. warning::
 
@@ -125,12 +133,21 @@ class Simulation:
 
                 * str with a valid Well Known Text. In this format the same WKT types as mentioned for the shapely types are supported: GEOMETRYCOLLETION, MULTIPOLYGON, POLYGON, MULTIPOINT. The same restrictions as mentioned for the shapely types apply.
 
+                * :class:`~jupedsim.GeometryBundle` to share the walkable area and its navigation mesh with other simulations instead of building them again.
+
             dt: Iteration step size in seconds. It is recommended to
                 leave this at its default value.
             trajectory_writer: Any object implementing the
                 TrajectoryWriter interface. JuPedSim provides a writer that outputs trajectory data
                 in a sqlite database. If you want other formats such as CSV you need to provide
                 your own custom implementation.
+            verlet_skin: Extra distance in meters the neighbor lists of the
+                operational model are collected in. With a skin > 0 the lists
+                are reused across iterations until an agent moved more than
+                half the skin, instead of searching all neighbors again in
+                every iteration. Results only differ in the order neighbors
+                are visited in. 0 disables the lists. Not supported by
+                custom models.
 
         Keyword Arguments:
             excluded_areas: describes exclusions
@@ -148,9 +165,17 @@ class Simulation:
                 f"{type(model).__name__}"
             )
         self._writer = trajectory_writer
+        self._writer_started = False
+        if isinstance(geometry, GeometryBundle):
+            native_geometry = geometry._obj
+        else:
+            native_geometry = build_geometry(geometry)._obj
         self._obj = py_jps.Simulation(
-            model=py_jps_model, geometry=build_geometry(geometry)._obj, dt=dt
+            model=py_jps_model, geometry=native_geometry, dt=dt
         )
+        if verlet_skin != 0:
+            self._obj.set_verlet_skin(verlet_skin)
+        self._timer_log_level = timer_log_level
         self._timer = Timer(self._obj, timer_log_level=timer_log_level)
 
     def add_waypoint_stage(
@@ -311,6 +336,67 @@ class Simulation:
             state=py_jps._CustomModelState(state),
         )
 
+    def add_agents(
+        self,
+        *,
+        journey_id: int,
+        stage_id: int,
+        positions: Sequence[tuple[float, float]] | npt.ArrayLike,
+        state: (
+            GeneralizedCentrifugalForceModelState
+            | CollisionFreeSpeedModelState
+            | CollisionFreeSpeedModelV2State
+            | CollisionFreeSpeedModelV3State
+            | AnticipationVelocityModelState
+            | SocialForceModelState
+            | WarpDriverModelState
+            | Any
+        ),
+    ) -> npt.NDArray[np.uint64]:
+        """Add many agents sharing journey, stage and initial state at once.
+
+        This is considerably faster than calling :func:`add_agent` for each
+        agent, e.g. for the output of :func:`~jupedsim.distribute_by_density`.
+        All agents are validated against the existing agents and each other
+        before any of them is added. If one agent is invalid none is added and
+        the error names the index of the offending position.
+
+        Arguments:
+            journey_id: Id of the journey the agents follow.
+            stage_id: Id of the stage the agents initially target.
+            positions: Spawn positions, anything convertible to a numpy array
+                of shape ``(n, 2)``.
+            state: Initial per-agent model state, see :func:`add_agent`. Every
+                agent receives its own copy.
+
+        Returns:
+            Ids of the added agents in the order of ``positions``.
+
+        Raises:
+            SimulationError: if ``positions`` is not of shape ``(n, 2)`` or
+                any agent is invalid.
+        """
+        positions = np.asarray(positions, dtype=np.float64)
+        if positions.shape == (0,):
+            positions = positions.reshape(0, 2)
+        if positions.ndim != 2 or positions.shape[1] != 2:
+            raise py_jps.SimulationError(
+                f"positions need to be of shape (n, 2), got {positions.shape}"
+            )
+        if isinstance(state, _STATE_TYPES):
+            states = [state]
+        else:
+            states = [
+                py_jps._CustomModelState(copy.deepcopy(state))
+                for _ in range(len(positions))
+            ]
+        return self._obj.add_agents(
+            journey_id=journey_id,
+            stage_id=stage_id,
+            positions=positions,
+            states=states,
+        )
+
     def mark_agent_for_removal(self, agent_id: int):
         """Marks an agent for removal.
 
@@ -342,15 +428,71 @@ class Simulation:
         Arguments:
             count: Number of iterations to advance
         """
-        if self._writer and self.iteration_count() == 0:
+        if self._writer and not self._writer_started:
             self._writer.begin_writing(self)
             self._writer.write_iteration_state(self)
+            self._writer_started = True
 
         for _ in range(0, count):
             self._obj.iterate()
             if self._writer:
                 self._writer.write_iteration_state(self)
 
+    def save_checkpoint(self) -> bytes:
+        """Serializes the complete state of the simulation.
+
+        The checkpoint contains all stages, journeys, agents and the iteration
+        count. Operational models keep no state of their own, their random
+        numbers only depend on their seed and the iteration. It can be
+        restored with :func:`restore_checkpoint`. Checkpoints are meant for
+        warm starts with the same JuPedSim version on the same machine type,
+        they are not an exchange format. Simulations using a
+        :class:`~jupedsim.CustomOperationalModel` cannot be checkpointed.
+
+        Returns:
+            The checkpoint data.
+        """
+        return self._obj.save_checkpoint()
+
+    def restore_checkpoint(self, data: bytes) -> None:
+        """Restores a checkpoint created with :func:`save_checkpoint`.
+
+        The simulation has to be newly created with the same model, geometry
+        and dt as the simulation the checkpoint was taken from and may not
+        contain any stages, journeys or agents yet. Stages, journeys and
+        agents keep their ids.
+
+        Arguments:
+            data: Checkpoint data
+        """
+        self._obj.restore_checkpoint(data)
+
+    def fork(
+        self, *, trajectory_writer: TrajectoryWriter | None = None
+    ) -> "Simulation":
+        """Creates an independent copy of this simulation in its current state.
+
+        Continuing either simulation does not affect the other one. This
+        allows to run several scenarios from a common, already warmed up
+        state.
+
+        Arguments:
+            trajectory_writer: Writer for the forked simulation, the writer
+                of this simulation is not shared.
+
+        Returns:
+            The forked simulation.
+        """
+        forked = Simulation.__new__(Simulation)
+        forked._writer = trajectory_writer
+        forked._writer_started = False
+        forked._obj = self._obj.fork()
+        forked._timer_log_level = self._timer_log_level
+        forked._timer = Timer(
+            forked._obj, timer_log_level=self._timer_log_level
+        )
+        return forked
+
     def switch_agent_journey(
         self, agent_id: int, journey_id: int, stage_id: int
     ) -> None:
@@ -397,6 +539,41 @@ class Simulation:
         """
         return self._obj.iteration_count()
 
+    def memory_report(self) -> dict[str, int]:
+        """Memory held by the parts of the simulation.
+
+        The parts are "agents", "operational_decision_system" (including the
+        double buffer of the agents), "neighborhood_search", "journeys",
+        "stages", "timer" and "simulation" for the rest. The numbers are
+        estimates from the sizes and capacities of the containers; memory of
+        the Python interpreter and of custom model states held by Python is
+        not included.
+
+        The geometry, which several simulations may share, and the trace
+        buffer of the profiler, which all simulations of the process share,
+        are not included either, see :func:`shared_memory_report`. Summing
+        the reports of several simulations therefore counts nothing twice.
+
+        Returns:
+            Bytes by part, sum the values for the total.
+        """
+        return self._obj.memory_report()
+
+    def shared_memory_report(self) -> dict[str, int]:
+        """Memory the simulation may share with others.
+
+        The parts are "collision_geometry" and "routing_engine" of the
+        geometry, which simulations created from the same
+        :class:`~jupedsim.GeometryBundle` share, and "profiler", the trace
+        buffer shared by all simulations of the process. Count them once per
+        geometry and once per process when adding up the memory of several
+        simulations.
+
+        Returns:
+            Bytes by part.
+        """
+        return self._obj.shared_memory_report()
+
     def agents(self) -> Iterator[Agent]:
         """Agents in the simulation.
 
@@ -514,6 +691,65 @@ class Simulation:
                     f"Internal error, unexpected type: {type(stage)}"
                 )
 
+    def set_multi_rate_stepping(
+        self,
+        *,
+        max_level: int,
+        radius: float = 1.0,
+        neighbors_per_level: int = 2,
+    ) -> None:
+        """Lets agents in dense spots advance in sub-steps of the iteration.
+
+        At the start of every iteration each agent is put on a level from the
+        number of other agents within ``radius``: each ``neighbors_per_level``
+        of them raise it by one, up to ``max_level``. An agent on level k
+        advances in 2^k steps of ``dt / 2^k``. This allows to choose ``dt``
+        for the free walking crowd while agents in tight contact still get
+        the small steps force based models need there.
+
+        Arguments:
+            max_level: Highest level, at most 8. 0 disables multi-rate
+                stepping.
+            radius: Radius in meters the neighbors of an agent are counted
+                in.
+            neighbors_per_level: Neighbors needed per level.
+        """
+        self._obj.set_multi_rate_stepping(
+            max_level=max_level,
+            radius=radius,
+            neighbors_per_level=neighbors_per_level,
+        )
+
+    def set_agent_sleep(
+        self,
+        *,
+        idle_radius: float,
+        steps_to_sleep: int = 50,
+        wake_radius: float = 1.0,
+    ) -> None:
+        """Puts idle agents to sleep so that their update is skipped.
+
+        An agent that kept its target and stayed within ``idle_radius`` of
+        one spot for ``steps_to_sleep`` consecutive iterations falls asleep:
+        it keeps its position and state and is skipped by the tactical and
+        operational level. It wakes up as soon as its target changes, e.g.
+        when its stage releases it, or when a moving agent comes within
+        ``wake_radius``. The number of sleeping agents is reported in
+        :attr:`Timer.counters`.
+
+        Arguments:
+            idle_radius: Distance in meters an agent may move and still
+                count as idle. 0 disables sleeping and wakes all agents.
+            steps_to_sleep: Idle iterations after which an agent sleeps.
+            wake_radius: Radius in meters around a sleeping agent in which
+                a moving agent wakes it.
+        """
+        self._obj.set_agent_sleep(
+            idle_radius=idle_radius,
+            steps_to_sleep=steps_to_sleep,
+            wake_radius=wake_radius,
+        )
+
     def set_tracing(self, status: bool) -> None:
         self._obj.set_tracing(status)
 
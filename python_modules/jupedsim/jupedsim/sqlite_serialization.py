@@ -2,11 +2,13 @@
 
 import itertools
 import sqlite3
+from enum import Enum
 from pathlib import Path
 from typing import Final
 
 from shapely import from_wkt
 
+import jupedsim.native as py_jps
 from jupedsim.serialization import TrajectoryWriter
 from jupedsim.simulation import Simulation
 
@@ -226,6 +228,111 @@ class SqliteTrajectoryWriter(TrajectoryWriter):
         return self._value_or_default(cur, "ymax", float("-inf"))
 
 
+class TrajectoryWriterBackpressure(Enum):
+    """What :class:`AsyncSqliteTrajectoryWriter` does if no buffer is free."""
+
+    BLOCK = py_jps.TrajectoryWriterBackpressure.Block
+    """Wait until the I/O thread released a buffer."""
+    DROP_FRAMES = py_jps.TrajectoryWriterBackpressure.DropFrames
+    """Skip the frame, see :meth:`AsyncSqliteTrajectoryWriter.dropped_frames`."""
+
+
+class AsyncSqliteTrajectoryWriter(TrajectoryWriter):
+    """Write trajectory data into a sqlite db from a background thread.
+
+    Produces the same database layout as :class:`SqliteTrajectoryWriter`, so
+    the output can be read with :class:`~jupedsim.Recording`. Agent positions
+    are copied natively into preallocated buffers and written to disk by a
+    background thread, the simulation only waits for I/O if all buffers are in
+    use and ``backpressure`` is :attr:`TrajectoryWriterBackpressure.BLOCK`.
+
+    The writer is only available in builds configured with
+    ``-DWITH_NATIVE_SQLITE_WRITER=ON``, see :func:`is_available`; use
+    :class:`SqliteTrajectoryWriter` otherwise.
+    """
+
+    @staticmethod
+    def is_available() -> bool:
+        """Whether the native writer was built into this installation."""
+        return hasattr(py_jps, "SqliteTrajectoryWriter")
+
+    def __init__(
+        self,
+        *,
+        output_file: Path,
+        every_nth_frame: int = 4,
+        commit_every_nth_write: int = 100,
+        buffer_count: int = 16,
+        backpressure: TrajectoryWriterBackpressure = (
+            TrajectoryWriterBackpressure.BLOCK
+        ),
+    ) -> None:
+        """AsyncSqliteTrajectoryWriter constructor
+
+        Args:
+            output_file : pathlib.Path
+                name of the output file.
+            every_nth_frame: int
+                indicates interval between writes, 1 means every frame, 5 every 5th
+            commit_every_nth_write: int
+                number of frames written to disk per transaction.
+            buffer_count: int
+                number of frames that can be in flight between simulation
+                and I/O thread.
+            backpressure: TrajectoryWriterBackpressure
+                what to do if all buffers are in flight.
+        """
+        if every_nth_frame < 1:
+            raise TrajectoryWriter.Exception("'every_nth_frame' has to be > 0")
+        if commit_every_nth_write < 1:
+            raise TrajectoryWriter.Exception(
+                "'commit_every_nth_write' has to be > 0"
+            )
+        if buffer_count < 1:
+            raise TrajectoryWriter.Exception("'buffer_count' has to be > 0")
+        if not AsyncSqliteTrajectoryWriter.is_available():
+            raise TrajectoryWriter.Exception(
+                "AsyncSqliteTrajectoryWriter is not available, JuPedSim was "
+                "built without WITH_NATIVE_SQLITE_WRITER"
+            )
+        self._obj = py_jps.SqliteTrajectoryWriter(
+            output_file=Path(output_file),
+            every_nth_frame=every_nth_frame,
+            buffer_count=buffer_count,
+            commit_every_nth_write=commit_every_nth_write,
+            backpressure=backpressure.value,
+        )
+
+    def begin_writing(self, simulation: Simulation) -> None:
+        """Create the database layout and start the I/O thread."""
+        geo = simulation.get_geometry().as_wkt()
+        self._obj.begin_writing(
+            dt=simulation.delta_time(),
+            wkt=geo,
+            geometry_hash=hash(geo),
+            bounds=from_wkt(geo).bounds,
+        )
+
+    def write_iteration_state(self, simulation: Simulation) -> None:
+        """Hand the agent positions of this iteration to the I/O thread."""
+        self._obj.write_iteration_state(simulation._obj)
+
+    def flush(self) -> None:
+        """Block until all frames handed over so far are on disk."""
+        self._obj.flush()
+
+    def close(self) -> None:
+        """Flush pending frames and close the database. Call at simulation end."""
+        self._obj.close()
+
+    def every_nth_frame(self) -> int:
+        return self._obj.every_nth_frame()
+
+    def dropped_frames(self) -> int:
+        """Number of frames skipped because of backpressure."""
+        return self._obj.dropped_frames()
+
+
 def update_database_to_latest_version(connection: sqlite3.Connection):
     version = get_database_version(connection)
 
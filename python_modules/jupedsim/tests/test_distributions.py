@@ -4,9 +4,15 @@ import math
 import pytest
 import shapely
 from jupedsim import distributions
+from jupedsim.internal.grid import Grid
 
 
-class GridMock(distributions.Grid):
+def _is_inside_ring(point, mid, min_r, max_r):
+    squared_distance = (point[0] - mid[0]) ** 2 + (point[1] - mid[1]) ** 2
+    return min_r**2 <= squared_distance <= max_r**2
+
+
+class GridMock(Grid):
     def __init__(self):
         pass
 
@@ -22,7 +28,7 @@ def test_cell_coord_determination():
 def test_grid_creation():
     box = [(0, 0), (3, 3)]
     distance_to_agents = 0.3
-    grid = distributions.Grid(box, distance_to_agents)
+    grid = Grid(box, distance_to_agents)
     acceptance_rate = 0.01
     assert grid.box == box
     assert abs(grid.c_s_l - 0.21213203435596423) < acceptance_rate
@@ -46,73 +52,6 @@ def test_neighbour_determination():
     assert mock.has_neighbour_in_distance((10, 0), (10, 0)) is False
 
 
-def test_point_in_circle():
-    mid = (0, 0)
-    min_radius, max_radius = 5, 10
-    test_point = (2, 2)
-    assert (
-        distributions.__is_inside_circle(
-            test_point, mid, min_radius, max_radius
-        )
-        is False
-    )
-    test_point = (10, 10)
-    assert (
-        distributions.__is_inside_circle(
-            test_point, mid, min_radius, max_radius
-        )
-        is False
-    )
-    test_point = (7, 7)
-    assert (
-        distributions.__is_inside_circle(
-            test_point, mid, min_radius, max_radius
-        )
-        is True
-    )
-
-
-def test_bounding_box_determination():
-    polygon = [
-        (6, 0),
-        (9, 2),
-        (11, 4),
-        (12, 7),
-        (11.5, 9.5),
-        (9.5, 10.5),
-        (7.5, 10),
-        (6, 9),
-        (4.5, 10),
-        (2.5, 10.5),
-        (0.6, 9.5),
-        (0, 7),
-        (1, 4),
-        (3, 2),
-    ]
-    s_polygon = shapely.Polygon(polygon)
-    expected_box = [(0, 0), (12, 10.5)]
-    assert distributions.__get_bounding_box(s_polygon) == expected_box
-
-
-def test_minimal_distance_to_polygon():
-    polygon = shapely.Polygon([(0, 0), (4, 1), (5, 3), (4, 5), (2, 5), (0, 3)])
-    pt = (3, 3)
-    expected_result = min(
-        [
-            2.182820625326997,
-            1.7888543819998317,
-            1.7888543819998317,
-            2.0,
-            2.1213203435596424,
-            3.0,
-        ]
-    )
-    acceptance_rate = 0.01
-    actual_result = distributions.__min_distance_to_polygon(pt, polygon)
-    difference = actual_result - expected_result
-    assert abs(difference) < acceptance_rate
-
-
 def test_seed_works_correct_for_determination_by_number():
     polygon = [(0, 0), (10, 0), (10, 10), (0, 10)]
     polygon = shapely.Polygon(polygon)
@@ -280,7 +219,7 @@ def test_distribution_in_circle_by_number_creates_correct_points():
 
     # all created points inside their corresponding circle segment
     while i < number_of_agents[0]:
-        assert distributions.__is_inside_circle(
+        assert _is_inside_ring(
             samples[i],
             center_point,
             circle_segment_radii[0][0],
@@ -288,7 +227,7 @@ def test_distribution_in_circle_by_number_creates_correct_points():
         )
         i = i + 1
     while i < number_of_agents[0] + number_of_agents[1]:
-        assert distributions.__is_inside_circle(
+        assert _is_inside_ring(
             samples[i],
             center_point,
             circle_segment_radii[1][0],
@@ -392,8 +331,16 @@ def test_distribution_by_percentage_creates_correct_points():
         seed=set_seed,
         max_iterations=750,
     )
+    filled = distributions.distribute_until_filled(
+        polygon=polygon,
+        distance_to_agents=distance_to_agents,
+        distance_to_polygon=distance_to_polygon,
+        seed=set_seed,
+        max_iterations=750,
+    )
     # as many points created as intended
-    assert len(samples) == round(16 * (percent / 100))
+    assert len(samples) == round(len(filled) * (percent / 100))
+    assert set(samples) <= set(filled)
 
     # all created points contained inside polygon
     for sample in samples:
@@ -438,36 +385,6 @@ def test_seed_works_correct_for_distribution_by_percentage():
     assert samples1 == samples2
 
 
-def test_box_of_intersection():
-    polygon = [
-        (0, 0),
-        (8, 0),
-        (8, 2),
-        (2, 2),
-        (2, 4),
-        (6, 4),
-        (6, 6),
-        (2, 6),
-        (2, 8),
-        (8, 8),
-        (8, 10),
-        (0, 10),
-    ]
-    s_polygon = shapely.Polygon(polygon)
-    center_point = (4, 7)
-    outer_radius = 3.5
-    expected_box = [(0.5, 4), (7.35329, 10)]
-    actual_box = distributions.__box_of_intersection(
-        s_polygon, center_point, outer_radius
-    )
-    exception_rate = 0.01
-
-    assert abs(expected_box[0][0] - actual_box[0][0]) < exception_rate
-    assert abs(expected_box[0][1] - actual_box[0][1]) < exception_rate
-    assert abs(expected_box[1][0] - actual_box[1][0]) < exception_rate
-    assert abs(expected_box[1][1] - actual_box[1][1]) < exception_rate
-
-
 def test_catch_wrong_inputs_for_wrong_polygon_type():
     polygon = [(0, 0), (10, 0), (10, 10), (0, 10)]
     center_point = (0, 0)
@@ -28,6 +28,7 @@ def test_timer_integration_small_simulation(tmp_path):
     dur = timer.elapsed_time_us("integration_test")
     assert isinstance(dur, int)
     assert dur >= 0
+    assert timer.durations_us["integration_test"] == dur
 
     @timer.timer_event
     def sleep():
@@ -46,6 +47,59 @@ def test_timer_integration_small_simulation(tmp_path):
     assert "sleep" in s
 
 
+def test_timer_iteration_durations():
+    from jupedsim.simulation import Simulation
+
+    geom = [(0.0, 0.0), (1.0, 0.0), (1.0, 1.0), (0.0, 1.0)]
+    sim = Simulation(model=CollisionFreeSpeedModel(), geometry=geom, dt=0.01)
+    sim.iterate(5)
+    iterations, _ = sim.timer.iteration_durations_us("Total Iteration")
+    assert len(iterations) == 0
+
+    sim.timer.enable_iteration_sampling()
+    sim.iterate(20)
+
+    iterations, durations = sim.timer.iteration_durations_us("Total Iteration")
+    assert iterations.tolist() == list(range(5, 25))
+    assert durations.shape == (20,)
+    assert (durations >= 0).all()
+
+    statistics = sim.timer.iteration_statistics["Total Iteration"]
+    assert statistics["iterations"] == 20
+    assert statistics["p50"] <= statistics["p99"] <= statistics["max"]
+
+    counts, edges = sim.timer.iteration_histogram("Total Iteration", bins=5)
+    assert counts.sum() == 20
+    assert len(edges) == 6
+
+    iterations, durations = sim.timer.iteration_durations_us("unknown")
+    assert len(iterations) == 0
+
+
+def test_timer_hardware_counters():
+    from jupedsim.simulation import Simulation
+
+    geom = [(0.0, 0.0), (1.0, 0.0), (1.0, 1.0), (0.0, 1.0)]
+    sim = Simulation(model=CollisionFreeSpeedModel(), geometry=geom, dt=0.01)
+    assert sim.timer.hardware_counters == {}
+
+    if not sim.timer.enable_hardware_counters():
+        sim.iterate(5)
+        assert sim.timer.hardware_counters == {}
+        pytest.skip("hardware counters are not available")
+
+    sim.iterate(5)
+    sim.timer.disable_hardware_counters()
+    counters = sim.timer.hardware_counters["Total Iteration"]
+    assert set(counters) <= {
+        "cycles",
+        "instructions",
+        "llc_misses",
+        "branch_misses",
+    }
+    assert counters
+
+
 def test_profiler_integration_with_cpp_extension(tmp_path):
     """
     Integration test: exercise the real C++ Trace/Profiler API.
@@ -77,3 +131,43 @@ def test_profiler_integration_with_cpp_extension(tmp_path):
     # dump to a temp file; some backends may not write immediately but should accept the call
     out_file = tmp_path / "trace_out.ptrace"
     tracing.dump_traces(str(out_file))
+
+
+def test_profiler_summarizes_slices_by_self_time(tmp_path):
+    import jupedsim.internal.tracing as tracing
+    from jupedsim.simulation import Simulation
+
+    geom = [(0.0, 0.0), (10.0, 0.0), (10.0, 10.0), (0.0, 10.0)]
+    sim = Simulation(model=CollisionFreeSpeedModel(), geometry=geom, dt=0.01)
+
+    tracing.enable_tracing(
+        buffer_size_kb=1024, file_write_period_ms=50, agent_sample_interval=2
+    )
+    with tracing.trace_event("outer"):
+        with tracing.trace_event("inner"):
+            time.sleep(0.01)
+    sim.iterate(4)
+    tracing.dump_traces(str(tmp_path / "summary.pftrace"))
+
+    summary = {
+        entry["name"]: entry for entry in tracing.trace_summary(top=100)
+    }
+    assert summary["inner"]["count"] == 1
+    assert summary["inner"]["self_us"] >= 10000
+    assert summary["outer"]["total_us"] >= summary["inner"]["total_us"]
+    assert summary["outer"]["self_us"] < summary["inner"]["self_us"]
+    assert summary["Total Iteration"]["count"] == 4
+    assert summary["Agent Samples"]["count"] == 2
+
+    top = tracing.trace_summary(top=1)
+    assert len(top) == 1
+    assert top[0]["self_us"] == max(e["self_us"] for e in summary.values())
+
+
+def test_profiler_rejects_invalid_config():
+    import jupedsim as jps
+    import jupedsim.internal.tracing as tracing
+
+    with pytest.raises(jps.SimulationError, match="buckets"):
+        tracing.enable_tracing(agent_buckets=0)
+    assert not tracing.is_tracing_enabled()
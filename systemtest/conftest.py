@@ -0,0 +1,43 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+import shapely
+
+
+@pytest.fixture
+def pillar_room():
+    """Room with a pillar, so that some pairs have no line of sight to each
+    other."""
+    return shapely.Polygon(
+        [(0, 0), (12, 0), (12, 8), (0, 8)],
+        holes=[[(5, 3), (6, 3), (6, 5), (5, 5)]],
+    )
+
+
+@pytest.fixture
+def run_pillar_room(pillar_room):
+    """Runs 24 agents through the pillar room towards an exit behind the
+    pillar and returns their final positions by id.
+
+    Keyword arguments besides ``iterations`` are passed on to the Simulation.
+    """
+
+    def run(model, make_state, iterations=200, **simulation_args):
+        sim = jps.Simulation(
+            model=model, geometry=pillar_room, dt=0.01, **simulation_args
+        )
+        exit_id = sim.add_exit_stage([(11, 3), (12, 3), (12, 5), (11, 5)])
+        journey_id = sim.add_journey(jps.JourneyDescription([exit_id]))
+        for row in range(6):
+            for column in range(4):
+                sim.add_agent(
+                    journey_id=journey_id,
+                    stage_id=exit_id,
+                    position=(1 + 0.8 * column, 1 + 1.1 * row + 0.1 * column),
+                    state=make_state(),
+                )
+        for _ in range(iterations):
+            sim.iterate()
+        return {agent.id: agent.position for agent in sim.agents()}
+
+    return run
@@ -0,0 +1,116 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""Tests for the batched Simulation.add_agents."""
+
+import jupedsim as jps
+import numpy as np
+import pytest
+import shapely
+
+AREA = shapely.Polygon([(0, 0), (20, 0), (20, 10), (0, 10)])
+
+
+def _simulation():
+    sim = jps.Simulation(model=jps.CollisionFreeSpeedModelV2(), geometry=AREA)
+    exit_id = sim.add_exit_stage([(19, 0), (20, 0), (20, 10), (19, 10)])
+    journey_id = sim.add_journey(jps.JourneyDescription([exit_id]))
+    return sim, journey_id, exit_id
+
+
+def test_batch_matches_single_adds():
+    positions = jps.distribute_by_number(
+        polygon=shapely.box(1, 1, 9, 9),
+        number_of_agents=40,
+        distance_to_agents=0.5,
+        distance_to_polygon=0.3,
+        seed=7,
+    )
+
+    single, journey_id, exit_id = _simulation()
+    for position in positions:
+        single.add_agent(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            position=position,
+            state=jps.CollisionFreeSpeedModelV2State(),
+        )
+
+    batch, journey_id, exit_id = _simulation()
+    ids = batch.add_agents(
+        journey_id=journey_id,
+        stage_id=exit_id,
+        positions=positions,
+        state=jps.CollisionFreeSpeedModelV2State(),
+    )
+    assert len(ids) == len(positions)
+    assert list(ids) == [agent.id for agent in batch.agents()]
+
+    for _ in range(200):
+        single.iterate()
+        batch.iterate()
+    assert [a.position for a in single.agents()] == [
+        a.position for a in batch.agents()
+    ]
+
+
+def test_batch_is_all_or_nothing():
+    sim, journey_id, exit_id = _simulation()
+    sim.add_agent(
+        journey_id=journey_id,
+        stage_id=exit_id,
+        position=(5, 5),
+        state=jps.CollisionFreeSpeedModelV2State(),
+    )
+    with pytest.raises(RuntimeError, match="Agent 2 of batch rejected"):
+        sim.add_agents(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            positions=np.array([(2, 2), (3, 3), (5.1, 5)]),
+            state=jps.CollisionFreeSpeedModelV2State(),
+        )
+    assert sim.agent_count() == 1
+
+    with pytest.raises(RuntimeError, match="Agent 0 of batch rejected"):
+        sim.add_agents(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            positions=[(2, 2), (2.1, 2)],
+            state=jps.CollisionFreeSpeedModelV2State(),
+        )
+    assert sim.agent_count() == 1
+
+    with pytest.raises(RuntimeError, match="not inside walkable area"):
+        sim.add_agents(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            positions=[(2, 2), (30, 2)],
+            state=jps.CollisionFreeSpeedModelV2State(),
+        )
+    assert sim.agent_count() == 1
+
+
+def test_agents_get_independent_state():
+    sim, journey_id, exit_id = _simulation()
+    ids = sim.add_agents(
+        journey_id=journey_id,
+        stage_id=exit_id,
+        positions=[(2, 2), (2, 5)],
+        state=jps.CollisionFreeSpeedModelV2State(desired_speed=1.0),
+    )
+    sim.agent(ids[0]).state.desired_speed = 0.5
+    assert sim.agent(ids[1]).state.desired_speed == pytest.approx(1.0)
+
+
+@pytest.mark.parametrize(
+    "positions",
+    [[1, 2, 3, 4], [(1, 2, 3), (4, 5, 6)], np.zeros((2, 2, 2))],
+)
+def test_rejects_positions_not_of_shape_n_by_2(positions):
+    sim, journey_id, exit_id = _simulation()
+    with pytest.raises(jps.SimulationError, match="shape"):
+        sim.add_agents(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            positions=positions,
+            state=jps.CollisionFreeSpeedModelV2State(),
+        )
+    assert sim.agent_count() == 0
@@ -0,0 +1,59 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+import shapely
+
+AREA = shapely.Polygon([(0, 0), (20, 0), (20, 10), (0, 10)])
+
+
+def make_simulation():
+    sim = jps.Simulation(model=jps.CollisionFreeSpeedModel(), geometry=AREA)
+    queue_id = sim.add_queue_stage([(12, 5), (11, 5), (10, 5), (9, 5)])
+    exit_id = sim.add_exit_stage([(18, 4), (20, 4), (20, 6), (18, 6)])
+    journey = jps.JourneyDescription([queue_id, exit_id])
+    journey.set_transition_for_stage(
+        queue_id, jps.Transition.create_fixed_transition(exit_id)
+    )
+    journey_id = sim.add_journey(journey)
+    for x, y in [(1, 2), (1, 5), (1, 8), (3, 3)]:
+        sim.add_agent(
+            journey_id=journey_id,
+            stage_id=queue_id,
+            position=(x, y),
+            state=jps.CollisionFreeSpeedModelState(),
+        )
+    return sim, sim.get_stage(queue_id)
+
+
+def test_queued_agents_sleep_and_wake_on_release():
+    sim, queue = make_simulation()
+    sim.set_agent_sleep(idle_radius=0.05, steps_to_sleep=20)
+    sim.iterate(2000)
+    assert sim.agent_count() == 4
+    assert sim.timer.counters["Sleeping Agents"] > 0
+
+    queue.pop(4)
+    while sim.agent_count() > 0 and sim.elapsed_time() < 60:
+        sim.iterate()
+    assert sim.agent_count() == 0
+    assert sim.timer.counters["Skipped Agent Steps"] > 0
+
+
+def test_agents_stay_awake_by_default():
+    sim, _ = make_simulation()
+    sim.iterate(2000)
+    assert sim.timer.counters["Sleeping Agents"] == 0
+
+
+@pytest.mark.parametrize(
+    "settings, message",
+    [
+        ({"idle_radius": -1.0}, "Idle radius"),
+        ({"idle_radius": 0.1, "steps_to_sleep": 0}, "Steps to sleep"),
+        ({"idle_radius": 0.1, "wake_radius": 0.0}, "Wake radius"),
+    ],
+)
+def test_invalid_sleep_settings_are_rejected(settings, message):
+    sim, _ = make_simulation()
+    with pytest.raises(RuntimeError, match=message):
+        sim.set_agent_sleep(**settings)
@@ -0,0 +1,103 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""Round-trip tests for AsyncSqliteTrajectoryWriter."""
+
+import pathlib
+import sqlite3
+
+import jupedsim as jps
+import pytest
+import shapely
+from shapely import GeometryCollection
+
+pytestmark = pytest.mark.skipif(
+    not jps.AsyncSqliteTrajectoryWriter.is_available(),
+    reason="built without WITH_NATIVE_SQLITE_WRITER",
+)
+
+
+def _run(writer, iterations=50):
+    area = GeometryCollection(
+        shapely.Polygon([(0, 0), (10, 0), (10, 10), (0, 10)])
+    )
+    sim = jps.Simulation(
+        model=jps.CollisionFreeSpeedModelV2(),
+        geometry=area,
+        trajectory_writer=writer,
+        dt=0.01,
+    )
+    exit_id = sim.add_exit_stage(
+        shapely.Polygon([(9, 0), (10, 0), (10, 10), (9, 10)])
+    )
+    journey_id = sim.add_journey(jps.JourneyDescription([exit_id]))
+    for x, y in [(2, 5), (3, 4), (3, 6)]:
+        sim.add_agent(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            position=(x, y),
+            state=jps.CollisionFreeSpeedModelV2State(),
+        )
+    sim.iterate(iterations)
+    writer.close()
+    return sim
+
+
+@pytest.mark.parametrize("every_nth_frame", [1, 4])
+def test_output_matches_python_writer(tmp_path: pathlib.Path, every_nth_frame):
+    native_file = tmp_path / "native.sqlite"
+    python_file = tmp_path / "python.sqlite"
+    _run(
+        jps.AsyncSqliteTrajectoryWriter(
+            output_file=native_file,
+            every_nth_frame=every_nth_frame,
+            commit_every_nth_write=3,
+            buffer_count=2,
+        )
+    )
+    _run(
+        jps.SqliteTrajectoryWriter(
+            output_file=python_file, every_nth_frame=every_nth_frame
+        )
+    )
+
+    native = jps.Recording(native_file.as_posix())
+    python = jps.Recording(python_file.as_posix())
+    assert native.num_frames == python.num_frames
+    assert native.fps == pytest.approx(python.fps)
+    native_bounds, python_bounds = native.bounds(), python.bounds()
+    for attr in ("xmin", "xmax", "ymin", "ymax"):
+        assert getattr(native_bounds, attr) == getattr(python_bounds, attr)
+    assert native.geometry().equals(python.geometry())
+    for idx in range(native.num_frames):
+        assert native.frame(idx).agents == python.frame(idx).agents
+
+
+def test_dropped_frames_are_counted(tmp_path: pathlib.Path):
+    writer = jps.AsyncSqliteTrajectoryWriter(
+        output_file=tmp_path / "drop.sqlite",
+        every_nth_frame=1,
+        buffer_count=1,
+        backpressure=jps.TrajectoryWriterBackpressure.DROP_FRAMES,
+    )
+    _run(writer)
+    with sqlite3.connect(tmp_path / "drop.sqlite") as con:
+        written = con.execute("SELECT count(*) FROM frame_data").fetchone()[0]
+    assert written + writer.dropped_frames() == 51
+
+
+def test_close_is_idempotent(tmp_path: pathlib.Path):
+    writer = jps.AsyncSqliteTrajectoryWriter(
+        output_file=tmp_path / "close.sqlite", every_nth_frame=1
+    )
+    _run(writer, iterations=3)
+    writer.close()
+
+
+def test_invalid_parameters_raise(tmp_path: pathlib.Path):
+    with pytest.raises(jps.TrajectoryWriter.Exception):
+        jps.AsyncSqliteTrajectoryWriter(
+            output_file=tmp_path / "x.sqlite", every_nth_frame=0
+        )
+    with pytest.raises(jps.TrajectoryWriter.Exception):
+        jps.AsyncSqliteTrajectoryWriter(
+            output_file=tmp_path / "x.sqlite", buffer_count=0
+        )
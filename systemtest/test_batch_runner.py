@@ -0,0 +1,102 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import pytest
+
+import jupedsim as jps
+
+WALKABLE_AREA = [(0, 0), (20, 0), (20, 4), (0, 4)]
+EXIT_AREA = [(18, 0), (20, 0), (20, 4), (18, 4)]
+
+
+def _simulation(geometry, start_x):
+    sim = jps.Simulation(model=jps.CollisionFreeSpeedModel(), geometry=geometry)
+    exit_id = sim.add_exit_stage(EXIT_AREA)
+    journey_id = sim.add_journey(jps.JourneyDescription([exit_id]))
+    sim.add_agent(
+        journey_id=journey_id,
+        stage_id=exit_id,
+        position=(start_x, 2),
+        state=jps.CollisionFreeSpeedModelState(),
+    )
+    return sim
+
+
+def _run_to_completion(sim):
+    iterations = 0
+    while sim.agent_count() > 0:
+        sim.iterate()
+        iterations += 1
+    return iterations
+
+
+def test_simulation_from_bundle_matches_simulation_from_geometry():
+    bundle = jps.GeometryBundle(WALKABLE_AREA)
+
+    from_bundle = _simulation(bundle, 1)
+    from_geometry = _simulation(WALKABLE_AREA, 1)
+
+    assert _run_to_completion(from_bundle) == _run_to_completion(
+        from_geometry
+    )
+    assert (
+        bundle.geometry().boundary()
+        == from_geometry.get_geometry().boundary()
+    )
+
+
+def test_run_batch_matches_sequential_runs():
+    bundle = jps.GeometryBundle(WALKABLE_AREA)
+    simulations = [_simulation(bundle, 1 + index) for index in range(8)]
+
+    results = jps.run_batch(simulations, max_iterations=10000, threads=3)
+
+    assert len(results) == len(simulations)
+    for index, (sim, result) in enumerate(zip(simulations, results)):
+        assert result.finished
+        assert result.error is None
+        assert sim.agent_count() == 0
+        assert result.iterations == _run_to_completion(
+            _simulation(bundle, 1 + index)
+        )
+        assert sim.iteration_count() == result.iterations
+
+
+def test_run_batch_stops_at_max_iterations():
+    sim = _simulation(jps.GeometryBundle(WALKABLE_AREA), 1)
+
+    (result,) = jps.run_batch([sim], max_iterations=5)
+
+    assert not result.finished
+    assert result.iterations == 5
+    assert sim.iteration_count() == 5
+
+
+def test_run_batch_rejects_custom_models():
+    class Model(jps.CustomOperationalModel):
+        def compute_next_state(self, state, step):
+            return state, (0.0, 0.0)
+
+    sim = jps.Simulation(model=Model(), geometry=WALKABLE_AREA)
+
+    with pytest.raises(jps.SimulationError, match="custom model"):
+        jps.run_batch([sim], max_iterations=5)
+
+
+def test_run_batch_rejects_trajectory_writers():
+    class Writer(jps.TrajectoryWriter):
+        def begin_writing(self, simulation):
+            pass
+
+        def write_iteration_state(self, simulation):
+            pass
+
+        def every_nth_frame(self):
+            return 1
+
+    sim = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=WALKABLE_AREA,
+        trajectory_writer=Writer(),
+    )
+
+    with pytest.raises(jps.SimulationError, match="trajectory writer"):
+        jps.run_batch([sim], max_iterations=5)
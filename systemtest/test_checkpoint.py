@@ -0,0 +1,123 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""Checkpoint, restore and fork of simulations."""
+
+import jupedsim as jps
+import pytest
+import shapely
+
+AREA = shapely.Polygon([(0, 0), (20, 0), (20, 10), (0, 10)])
+
+
+def _model():
+    return jps.AnticipationVelocityModel(rng_seed=42)
+
+
+def _populate(sim):
+    wp = sim.add_waypoint_stage((6, 5), 0.5)
+    queue = sim.add_queue_stage([(12, 5), (11, 5), (10, 5)])
+    exit_top = sim.add_exit_stage([(18, 6), (20, 6), (20, 10), (18, 10)])
+    exit_bottom = sim.add_exit_stage([(18, 0), (20, 0), (20, 4), (18, 4)])
+    journey = jps.JourneyDescription([wp, queue, exit_top, exit_bottom])
+    journey.set_transition_for_stage(
+        wp, jps.Transition.create_fixed_transition(queue)
+    )
+    journey.set_transition_for_stage(
+        queue,
+        jps.Transition.create_round_robin_transition(
+            [(exit_top, 2), (exit_bottom, 1)]
+        ),
+    )
+    journey_id = sim.add_journey(journey)
+    for x, y in [(1, 2), (1, 5), (1, 8), (3, 3), (3, 7)]:
+        sim.add_agent(
+            journey_id=journey_id,
+            stage_id=wp,
+            position=(x, y),
+            state=jps.AnticipationVelocityModelState(),
+        )
+    return queue
+
+
+def _snapshot(sim):
+    return sorted(
+        (agent.id, agent.position, agent.stage_id) for agent in sim.agents()
+    )
+
+
+def _advance(sim, queue, iterations):
+    for _ in range(iterations):
+        sim.iterate()
+        if sim.iteration_count() % 300 == 0:
+            sim.get_stage(queue).pop(1)
+
+
+def test_restore_continues_identically():
+    sim = jps.Simulation(model=_model(), geometry=AREA)
+    queue = _populate(sim)
+    _advance(sim, queue, 600)
+    data = sim.save_checkpoint()
+
+    restored = jps.Simulation(model=_model(), geometry=AREA)
+    restored.restore_checkpoint(data)
+    assert restored.iteration_count() == sim.iteration_count()
+    assert _snapshot(restored) == _snapshot(sim)
+
+    _advance(sim, queue, 900)
+    _advance(restored, queue, 900)
+    assert restored.agent_count() == sim.agent_count()
+    assert _snapshot(restored) == _snapshot(sim)
+
+
+def test_fork_is_independent():
+    sim = jps.Simulation(model=_model(), geometry=AREA)
+    queue = _populate(sim)
+    _advance(sim, queue, 400)
+    forked = sim.fork()
+    before = _snapshot(sim)
+    _advance(forked, queue, 200)
+    assert _snapshot(sim) == before
+    _advance(sim, queue, 200)
+    assert _snapshot(forked) == _snapshot(sim)
+
+
+def test_new_ids_do_not_collide_after_restore():
+    sim = jps.Simulation(model=_model(), geometry=AREA)
+    _populate(sim)
+    restored = jps.Simulation(model=_model(), geometry=AREA)
+    restored.restore_checkpoint(sim.save_checkpoint())
+    stage = restored.add_waypoint_stage((2, 2), 0.5)
+    journey = restored.add_journey(jps.JourneyDescription([stage]))
+    agent = restored.add_agent(
+        journey_id=journey,
+        stage_id=stage,
+        position=(15, 2),
+        state=jps.AnticipationVelocityModelState(),
+    )
+    assert agent not in {a.id for a in sim.agents()}
+
+
+def test_restore_requires_new_simulation():
+    sim = jps.Simulation(model=_model(), geometry=AREA)
+    _populate(sim)
+    data = sim.save_checkpoint()
+    with pytest.raises(RuntimeError, match="newly created simulation"):
+        sim.restore_checkpoint(data)
+
+
+def test_restore_rejects_other_model():
+    sim = jps.Simulation(model=_model(), geometry=AREA)
+    _populate(sim)
+    other = jps.Simulation(
+        model=jps.CollisionFreeSpeedModelV2(), geometry=AREA
+    )
+    with pytest.raises(RuntimeError, match="operational model"):
+        other.restore_checkpoint(sim.save_checkpoint())
+
+
+def test_restore_rejects_truncated_data():
+    sim = jps.Simulation(model=_model(), geometry=AREA)
+    _populate(sim)
+    data = sim.save_checkpoint()
+    restored = jps.Simulation(model=_model(), geometry=AREA)
+    with pytest.raises(RuntimeError, match="Corrupt checkpoint"):
+        restored.restore_checkpoint(data[: len(data) // 2])
@@ -0,0 +1,113 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""Round-trip tests for the columnar trajectory format."""
+
+import pathlib
+
+import jupedsim as jps
+import pytest
+import shapely
+from shapely import GeometryCollection
+
+
+def _run(writer, iterations=120):
+    area = GeometryCollection(
+        shapely.Polygon([(0, 0), (10, 0), (10, 10), (0, 10)])
+    )
+    sim = jps.Simulation(
+        model=jps.CollisionFreeSpeedModelV2(),
+        geometry=area,
+        trajectory_writer=writer,
+        dt=0.01,
+    )
+    exit_id = sim.add_exit_stage(
+        shapely.Polygon([(9, 0), (10, 0), (10, 10), (9, 10)])
+    )
+    journey_id = sim.add_journey(jps.JourneyDescription([exit_id]))
+    for x, y in [(2, 5), (3, 4), (3, 6), (8.5, 5)]:
+        sim.add_agent(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            position=(x, y),
+            state=jps.CollisionFreeSpeedModelV2State(),
+        )
+    sim.iterate(iterations)
+    writer.close()
+
+
+@pytest.mark.parametrize("frames_per_chunk", [1, 7])
+def test_matches_sqlite_recording(tmp_path: pathlib.Path, frames_per_chunk):
+    columnar_file = tmp_path / "traj.jpst"
+    sqlite_file = tmp_path / "traj.sqlite"
+    quantisation = 1e-4
+    _run(
+        jps.ColumnarTrajectoryWriter(
+            output_file=columnar_file,
+            every_nth_frame=2,
+            frames_per_chunk=frames_per_chunk,
+            quantisation=quantisation,
+        )
+    )
+    _run(jps.SqliteTrajectoryWriter(output_file=sqlite_file, every_nth_frame=2))
+
+    columnar = jps.ColumnarRecording(columnar_file)
+    reference = jps.Recording(sqlite_file.as_posix())
+    assert columnar.num_frames == reference.num_frames
+    assert columnar.fps == pytest.approx(reference.fps)
+    assert columnar.geometry().equals(reference.geometry())
+    # Access frames out of order to exercise chunk decoding
+    for idx in reversed(range(columnar.num_frames)):
+        frame = columnar.frame(idx)
+        expected = reference.frame(idx)
+        assert frame.index == idx
+        assert [a.id for a in frame.agents] == [a.id for a in expected.agents]
+        for agent, expected_agent in zip(frame.agents, expected.agents):
+            assert agent.position == pytest.approx(
+                expected_agent.position, abs=quantisation / 2 + 1e-12
+            )
+
+
+def test_frame_out_of_range_raises(tmp_path: pathlib.Path):
+    columnar_file = tmp_path / "traj.jpst"
+    _run(
+        jps.ColumnarTrajectoryWriter(
+            output_file=columnar_file, every_nth_frame=10
+        ),
+        iterations=20,
+    )
+    recording = jps.ColumnarRecording(columnar_file)
+    assert recording.num_frames == 3
+    with pytest.raises(jps.SimulationError):
+        recording.frame(3)
+
+
+def test_frames_keep_their_iteration(tmp_path: pathlib.Path):
+    columnar_file = tmp_path / "traj.jpst"
+    _run(
+        jps.ColumnarTrajectoryWriter(
+            output_file=columnar_file, every_nth_frame=10, frames_per_chunk=2
+        ),
+        iterations=50,
+    )
+    recording = jps.ColumnarRecording(columnar_file)
+    assert [recording.iteration(i) for i in range(recording.num_frames)] == [
+        0,
+        10,
+        20,
+        30,
+        40,
+        50,
+    ]
+    frame = recording.frame_at_iteration(30)
+    assert frame.index == 3
+    assert frame.agents == recording.frame(3).agents
+    with pytest.raises(jps.SimulationError, match="not recorded"):
+        recording.frame_at_iteration(35)
+    with pytest.raises(jps.SimulationError, match="not recorded"):
+        recording.frame_at_iteration(60)
+
+
+def test_rejects_foreign_file(tmp_path: pathlib.Path):
+    not_a_recording = tmp_path / "foreign.bin"
+    not_a_recording.write_bytes(b"\0" * 200)
+    with pytest.raises(jps.SimulationError):
+        jps.ColumnarRecording(not_a_recording)
@@ -0,0 +1,147 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import dataclasses
+
+import jupedsim as jps
+import numpy as np
+import pytest
+
+SPEED = 1.0
+
+
+@dataclasses.dataclass(frozen=True)
+class _State:
+    steps: int = 0
+
+
+def _movements_to_targets(positions, targets, dt):
+    direction = targets - positions
+    norm = np.linalg.norm(direction, axis=1, keepdims=True)
+    return np.divide(
+        direction * SPEED * dt,
+        norm,
+        out=np.zeros_like(direction),
+        where=norm > 0,
+    )
+
+
+class _PerAgentModel(jps.CustomOperationalModel):
+    def compute_next_state(self, state, step):
+        movement = _movements_to_targets(
+            np.zeros((1, 2)), np.array([step.to_next_target]), step.dt
+        )[0]
+        return _State(state.steps + 1), tuple(movement)
+
+
+class _BatchModel(jps.CustomOperationalBatchModel):
+    def __init__(self):
+        self.calls = 0
+        self.batches = []
+
+    def compute_next_states(self, batch):
+        self.calls += 1
+        self.batches.append(
+            {
+                "ids": batch.ids.copy(),
+                "neighbors": [
+                    batch.ids[batch.neighbors_of(i)].tolist()
+                    for i in range(len(batch.ids))
+                ],
+                "walls": [
+                    len(batch.walls_of(i)) for i in range(len(batch.ids))
+                ],
+            }
+        )
+        states = [_State(state.steps + 1) for state in batch.states]
+        movements = _movements_to_targets(
+            batch.positions, batch.targets, batch.dt
+        )
+        return states, movements
+
+
+class _ReturningModel(jps.CustomOperationalBatchModel):
+    def __init__(self, result):
+        self._result = result
+
+    def compute_next_states(self, batch):
+        return self._result(batch)
+
+
+def _simulation(model, positions):
+    simulation = jps.Simulation(
+        model=model,
+        geometry=[(-50, -50), (50, -50), (50, 50), (-50, 50)],
+    )
+    exit_id = simulation.add_exit_stage([(40, -3), (40, 3), (45, 3), (45, -3)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    ids = [
+        simulation.add_agent(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            position=position,
+            state=_State(),
+        )
+        for position in positions
+    ]
+    return simulation, ids
+
+
+POSITIONS = [(0, 0), (1, 0), (0, 1), (10, 10)]
+
+
+def test_batch_model_moves_agents_like_per_agent_model():
+    per_agent, per_agent_ids = _simulation(_PerAgentModel(), POSITIONS)
+    model = _BatchModel()
+    batch, batch_ids = _simulation(model, POSITIONS)
+    per_agent.iterate(50)
+    batch.iterate(50)
+
+    assert model.calls == 50
+    for per_agent_id, batch_id in zip(per_agent_ids, batch_ids):
+        assert batch.agent(batch_id).position == pytest.approx(
+            per_agent.agent(per_agent_id).position
+        )
+        assert batch.agent(batch_id).state.steps == 50
+
+
+def test_batch_contains_neighbors_in_radius():
+    model = _BatchModel()
+    simulation, ids = _simulation(model, POSITIONS)
+    simulation.iterate()
+
+    batch = model.batches[0]
+    neighbors = dict(zip(batch["ids"].tolist(), batch["neighbors"]))
+    assert sorted(neighbors[ids[0]]) == sorted([ids[1], ids[2]])
+    assert sorted(neighbors[ids[1]]) == sorted([ids[0], ids[2]])
+    assert neighbors[ids[3]] == []
+    assert len(batch["walls"]) == len(ids)
+
+
+def test_batch_state_none_keeps_states():
+    model = _ReturningModel(lambda batch: (None, np.zeros((len(batch.ids), 2))))
+    simulation, ids = _simulation(model, POSITIONS)
+    simulation.iterate(5)
+    for agent_id, position in zip(ids, POSITIONS):
+        assert simulation.agent(agent_id).position == pytest.approx(position)
+        assert simulation.agent(agent_id).state.steps == 0
+
+
+def test_batch_movements_of_wrong_shape_are_rejected():
+    model = _ReturningModel(lambda batch: (None, np.zeros((1, 2))))
+    simulation, _ = _simulation(model, POSITIONS)
+    with pytest.raises(jps.SimulationError, match="shape"):
+        simulation.iterate()
+
+
+def test_batch_returning_current_state_is_rejected():
+    model = _ReturningModel(
+        lambda batch: (batch.states, np.zeros((len(batch.ids), 2)))
+    )
+    simulation, _ = _simulation(model, POSITIONS)
+    with pytest.raises(jps.SimulationError, match="same instance"):
+        simulation.iterate()
+
+
+def test_batch_model_rejects_multi_rate_stepping():
+    simulation, _ = _simulation(_BatchModel(), POSITIONS)
+    with pytest.raises(jps.SimulationError, match="multi-rate"):
+        simulation.set_multi_rate_stepping(max_level=1)
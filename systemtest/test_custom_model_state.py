@@ -0,0 +1,79 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import dataclasses
+
+import jupedsim as jps
+
+
+@dataclasses.dataclass(frozen=True)
+class _State:
+    name: str
+    steps: int = 0
+
+
+class _CountingModel(jps.CustomOperationalModel):
+    def __init__(self):
+        self.neighbor_steps_seen = []
+
+    def compute_next_state(self, state, step):
+        for neighbor in step.other_agents_in_range(5.0):
+            self.neighbor_steps_seen.append(
+                (state.steps, neighbor.state.steps)
+            )
+        return dataclasses.replace(state, steps=state.steps + 1), (0.1, 0.0)
+
+
+def _simulation(model):
+    simulation = jps.Simulation(
+        model=model,
+        geometry=[(-50, -50), (50, -50), (50, 50), (-50, 50)],
+    )
+    exit_id = simulation.add_exit_stage([(5, -3), (5, 3), (6, 3), (6, -3)])
+    journey_id = simulation.add_journey(jps.JourneyDescription([exit_id]))
+    return simulation, journey_id, exit_id
+
+
+def test_agents_see_the_states_their_step_started_with():
+    model = _CountingModel()
+    simulation, journey_id, exit_id = _simulation(model)
+    for position in [(0, 0), (0, 1), (0, 2)]:
+        simulation.add_agent(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            position=position,
+            state=_State("a"),
+        )
+    simulation.iterate(10)
+
+    assert model.neighbor_steps_seen
+    assert all(own == other for own, other in model.neighbor_steps_seen)
+
+
+def test_states_stay_with_their_agents_when_agents_leave():
+    simulation, journey_id, exit_id = _simulation(_CountingModel())
+    leaving = simulation.add_agent(
+        journey_id=journey_id,
+        stage_id=exit_id,
+        position=(4.5, 0),
+        state=_State("leaving"),
+    )
+    staying = simulation.add_agent(
+        journey_id=journey_id,
+        stage_id=exit_id,
+        position=(-40, 0),
+        state=_State("staying"),
+    )
+    while simulation.agent_count() == 2:
+        simulation.iterate()
+    assert leaving not in [agent.id for agent in simulation.agents()]
+
+    joining = simulation.add_agent(
+        journey_id=journey_id,
+        stage_id=exit_id,
+        position=(-40, 5),
+        state=_State("joining"),
+    )
+    steps = simulation.agent(staying).state.steps
+    simulation.iterate(3)
+
+    assert simulation.agent(staying).state == _State("staying", steps + 3)
+    assert simulation.agent(joining).state == _State("joining", 3)
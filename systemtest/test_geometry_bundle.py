@@ -0,0 +1,60 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import pathlib
+
+import pytest
+import shapely
+
+import jupedsim as jps
+
+WALKABLE_AREA = shapely.union(
+    shapely.box(0, 0, 10, 10).difference(shapely.box(4, 4, 6, 6)),
+    shapely.box(10, 4, 30, 6),
+)
+EXIT_AREA = [(28, 4), (30, 4), (30, 6), (28, 6)]
+
+
+def _positions(bundle):
+    sim = jps.Simulation(model=jps.CollisionFreeSpeedModel(), geometry=bundle)
+    exit_id = sim.add_exit_stage(EXIT_AREA)
+    journey_id = sim.add_journey(jps.JourneyDescription([exit_id]))
+    for position in [(1, 1), (1, 9), (8, 8)]:
+        sim.add_agent(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            position=position,
+            state=jps.CollisionFreeSpeedModelState(),
+        )
+    sim.iterate(500)
+    return sorted(agent.position for agent in sim.agents())
+
+
+def test_loaded_bundle_simulates_like_the_built_one(tmp_path: pathlib.Path):
+    bundle = jps.GeometryBundle(WALKABLE_AREA)
+    file = tmp_path / "venue.jpsgeom"
+    bundle.save(file)
+
+    loaded = jps.GeometryBundle.load(file)
+
+    assert loaded.geometry().as_wkt() == bundle.geometry().as_wkt()
+    assert _positions(loaded) == _positions(bundle)
+
+
+def test_deserialized_bundle_simulates_like_the_built_one():
+    bundle = jps.GeometryBundle(WALKABLE_AREA)
+
+    restored = jps.GeometryBundle.deserialize(bundle.serialize())
+
+    assert _positions(restored) == _positions(bundle)
+
+
+def test_invalid_bundles_are_rejected(tmp_path: pathlib.Path):
+    data = jps.GeometryBundle(WALKABLE_AREA).serialize()
+
+    with pytest.raises(RuntimeError, match="not a geometry bundle"):
+        jps.GeometryBundle.deserialize(b"X" + data[1:])
+    with pytest.raises(RuntimeError, match="byte order"):
+        jps.GeometryBundle.deserialize(data[:8] + data[8:12][::-1] + data[12:])
+    with pytest.raises(RuntimeError, match="Corrupt geometry bundle"):
+        jps.GeometryBundle.deserialize(data[: len(data) // 2])
+    with pytest.raises(RuntimeError, match="not a geometry bundle"):
+        jps.GeometryBundle.load(tmp_path / "missing.jpsgeom")
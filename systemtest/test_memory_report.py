@@ -0,0 +1,71 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+
+PARTS = {
+    "agents",
+    "operational_decision_system",
+    "neighborhood_search",
+    "journeys",
+    "stages",
+    "timer",
+    "simulation",
+}
+SHARED_PARTS = {"collision_geometry", "routing_engine", "profiler"}
+
+
+def _simulation():
+    sim = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=[(0, 0), (40, 0), (40, 40), (0, 40)],
+    )
+    exit_id = sim.add_exit_stage([(39, 0), (40, 0), (40, 40), (39, 40)])
+    journey_id = sim.add_journey(jps.JourneyDescription([exit_id]))
+    return sim, journey_id, exit_id
+
+
+def test_memory_report_breaks_down_all_parts():
+    sim, _, _ = _simulation()
+    report = sim.memory_report()
+
+    assert set(report) == PARTS
+    assert all(value >= 0 for value in report.values())
+    assert report["journeys"] > 0
+    assert report["stages"] > 0
+
+
+def test_shared_memory_report_holds_geometry_and_profiler():
+    sim, _, _ = _simulation()
+    shared = sim.shared_memory_report()
+
+    assert set(shared) == SHARED_PARTS
+    assert shared["collision_geometry"] > 0
+    assert shared["routing_engine"] > 0
+
+
+def test_simulations_sharing_a_bundle_report_the_same_geometry():
+    bundle = jps.GeometryBundle([(0, 0), (40, 0), (40, 40), (0, 40)])
+    first = jps.Simulation(model=jps.CollisionFreeSpeedModel(), geometry=bundle)
+    second = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(), geometry=bundle
+    )
+
+    assert first.shared_memory_report() == second.shared_memory_report()
+
+
+def test_memory_report_grows_with_agents():
+    sim, journey_id, exit_id = _simulation()
+    before = sim.memory_report()
+    for x in range(1, 30):
+        for y in range(1, 30):
+            sim.add_agent(
+                journey_id=journey_id,
+                stage_id=exit_id,
+                position=(x, y),
+                state=jps.CollisionFreeSpeedModelState(),
+            )
+    sim.iterate()
+    after = sim.memory_report()
+
+    assert after["agents"] > before["agents"]
+    assert after["neighborhood_search"] > before["neighborhood_search"]
+    assert after["operational_decision_system"] >= after["agents"] // 2
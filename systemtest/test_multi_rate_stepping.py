@@ -0,0 +1,57 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+import shapely
+
+
+def make_simulation(dt):
+    sim = jps.Simulation(
+        model=jps.SocialForceModel(),
+        geometry=shapely.Polygon([(0, 0), (20, 0), (20, 6), (0, 6)]),
+        dt=dt,
+    )
+    exit_id = sim.add_exit_stage([(19, 0), (20, 0), (20, 6), (19, 6)])
+    journey_id = sim.add_journey(jps.JourneyDescription([exit_id]))
+    # A dense block and a few agents walking on their own.
+    positions = [
+        (1 + 0.45 * x, 1 + 0.45 * y) for x in range(4) for y in range(4)
+    ]
+    positions += [(8, 1), (8, 3), (8, 5)]
+    for position in positions:
+        sim.add_agent(
+            journey_id=journey_id,
+            stage_id=exit_id,
+            position=position,
+            state=jps.SocialForceModelState(desired_speed=1.2),
+        )
+    return sim
+
+
+def test_multi_rate_stepping_evacuates():
+    sim = make_simulation(dt=0.04)
+    sim.set_multi_rate_stepping(max_level=2, radius=1.0, neighbors_per_level=2)
+    while sim.agent_count() > 0 and sim.elapsed_time() < 60:
+        sim.iterate()
+    assert sim.agent_count() == 0
+
+
+def test_multi_rate_stepping_keeps_elapsed_time():
+    sim = make_simulation(dt=0.04)
+    sim.set_multi_rate_stepping(max_level=3)
+    sim.iterate(10)
+    assert sim.iteration_count() == 10
+    assert sim.elapsed_time() == pytest.approx(0.4)
+
+
+@pytest.mark.parametrize(
+    "settings, message",
+    [
+        ({"max_level": 9}, "max level"),
+        ({"max_level": 1, "radius": 0.0}, "radius"),
+        ({"max_level": 1, "neighbors_per_level": 0}, "neighbors per level"),
+    ],
+)
+def test_invalid_multi_rate_settings_are_rejected(settings, message):
+    sim = make_simulation(dt=0.04)
+    with pytest.raises(RuntimeError, match=message):
+        sim.set_multi_rate_stepping(**settings)
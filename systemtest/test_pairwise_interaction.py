@@ -0,0 +1,24 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+
+
+@pytest.mark.parametrize(
+    "make_model, make_state",
+    [
+        (
+            lambda pairwise: jps.SocialForceModel(pairwise=pairwise),
+            lambda: jps.SocialForceModelState(desired_speed=1.2),
+        ),
+        (
+            lambda pairwise: jps.CollisionFreeSpeedModel(pairwise=pairwise),
+            lambda: jps.CollisionFreeSpeedModelState(desired_speed=1.2),
+        ),
+    ],
+)
+def test_pairwise_matches_per_agent(run_pillar_room, make_model, make_state):
+    expected = run_pillar_room(make_model(False), make_state)
+    actual = run_pillar_room(make_model(True), make_state)
+    assert actual.keys() == expected.keys()
+    for agent_id, position in expected.items():
+        assert actual[agent_id] == pytest.approx(position, abs=1e-6)
@@ -0,0 +1,93 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+"""Tests for the comparison of the performance regression runner."""
+
+import pytest
+from performancetest.regression import (
+    TIMER_PREFIX,
+    WALL_TIME,
+    compare,
+    median_ratio_interval,
+)
+
+# Relative noise of single runs, the same pattern for baseline and current.
+NOISE = [0.97, 1.02, 0.99, 1.04, 0.96, 1.01, 1.03, 0.98, 1.0, 1.05]
+
+
+def _results(samples_by_metric):
+    return {"scenarios": {"corridor_cfsm": samples_by_metric}}
+
+
+def _samples(median, noise=NOISE):
+    return [median * factor for factor in noise]
+
+
+def _compare(baseline, current, **kwargs):
+    options = {"threshold": 0.05, "confidence": 0.95, "min_share": 0.01}
+    options.update(kwargs)
+    return {
+        c.metric: c
+        for c in compare(_results(baseline), _results(current), **options)
+    }
+
+
+def test_interval_contains_the_ratio_of_the_medians():
+    ratio, lower, upper = median_ratio_interval(
+        _samples(1.0), _samples(1.5), confidence=0.95
+    )
+    assert ratio == pytest.approx(1.5)
+    assert lower <= ratio <= upper
+    assert lower > 1.3
+
+
+def test_clear_regression_is_reported():
+    comparisons = _compare(
+        {WALL_TIME: _samples(10.0)}, {WALL_TIME: _samples(13.0)}
+    )
+    wall_time = comparisons[WALL_TIME]
+    assert wall_time.gated
+    assert wall_time.regressed
+    assert wall_time.ratio == pytest.approx(1.3)
+
+
+def test_noise_inside_the_interval_is_not_a_regression():
+    # The median moves by 6 %, more than the threshold, but the runs scatter
+    # by up to 10 % around it, so the lower bound stays below the threshold.
+    current_noise = [0.92, 1.1, 0.95, 1.08, 0.9, 1.06, 1.0, 0.93, 1.04, 1.09]
+    comparisons = _compare(
+        {WALL_TIME: _samples(10.0)},
+        {WALL_TIME: _samples(10.6, current_noise)},
+    )
+    wall_time = comparisons[WALL_TIME]
+    assert wall_time.ratio > 1.05
+    assert wall_time.lower <= 1.05
+    assert not wall_time.regressed
+
+
+def test_timer_below_min_share_is_not_gated():
+    short_timer = f"{TIMER_PREFIX}Stage System"
+    long_timer = f"{TIMER_PREFIX}Operational Decision System"
+    comparisons = _compare(
+        {
+            WALL_TIME: _samples(10.0),
+            short_timer: _samples(0.05),
+            long_timer: _samples(5.0),
+        },
+        {
+            WALL_TIME: _samples(10.0),
+            short_timer: _samples(0.2),
+            long_timer: _samples(10.0),
+        },
+    )
+    assert not comparisons[short_timer].gated
+    assert not comparisons[short_timer].regressed
+    assert comparisons[long_timer].gated
+    assert comparisons[long_timer].regressed
+    assert not comparisons[WALL_TIME].regressed
+
+
+def test_metrics_missing_on_one_side_are_skipped():
+    comparisons = _compare(
+        {WALL_TIME: _samples(10.0), "peak_rss_mb": _samples(100.0)},
+        {WALL_TIME: _samples(10.0)},
+    )
+    assert set(comparisons) == {WALL_TIME}
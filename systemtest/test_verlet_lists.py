@@ -0,0 +1,50 @@
+# SPDX-License-Identifier: LGPL-3.0-or-later
+import jupedsim as jps
+import pytest
+
+
+@pytest.mark.parametrize(
+    "make_model, make_state",
+    [
+        (
+            jps.CollisionFreeSpeedModel,
+            lambda: jps.CollisionFreeSpeedModelState(desired_speed=1.2),
+        ),
+        (
+            jps.GeneralizedCentrifugalForceModel,
+            lambda: jps.GeneralizedCentrifugalForceModelState(
+                desired_speed=1.2
+            ),
+        ),
+        (
+            jps.SocialForceModel,
+            lambda: jps.SocialForceModelState(desired_speed=1.2),
+        ),
+    ],
+)
+def test_verlet_lists_match_neighborhood_search(
+    run_pillar_room, make_model, make_state
+):
+    expected = run_pillar_room(make_model(), make_state, verlet_skin=0.0)
+    actual = run_pillar_room(make_model(), make_state, verlet_skin=0.3)
+    assert actual.keys() == expected.keys()
+    for agent_id, position in expected.items():
+        assert actual[agent_id] == pytest.approx(position, abs=1e-6)
+
+
+def test_negative_verlet_skin_is_rejected(pillar_room):
+    with pytest.raises(RuntimeError, match="Verlet skin needs to be >= 0"):
+        jps.Simulation(
+            model=jps.CollisionFreeSpeedModel(),
+            geometry=pillar_room,
+            verlet_skin=-0.1,
+        )
+
+
+def test_fork_keeps_verlet_skin(pillar_room):
+    sim = jps.Simulation(
+        model=jps.CollisionFreeSpeedModel(),
+        geometry=pillar_room,
+        verlet_skin=0.3,
+    )
+    assert sim.fork()._obj.verlet_skin() == pytest.approx(0.3)